@@ -0,0 +1,102 @@
+#include "AlgorithmWorker.h"
+#include "Log.h"
+#include <QMutexLocker>
+
+// Constructor
+AlgorithmWorker::AlgorithmWorker(QObject* parent) : QObject(parent), nextId(1)
+{
+}
+
+// Destructor
+AlgorithmWorker::~AlgorithmWorker()
+{
+    cancelAll();
+    waitForDone();
+}
+
+// Register a job
+int AlgorithmWorker::beginJob(const QString& name, shared_ptr<JobToken> token)
+{
+    int jobId;
+    {
+        QMutexLocker locker(&mutex);
+
+        // A newer request of the same kind replaces the running one
+        for (auto it = names.constBegin(); it != names.constEnd(); ++it)
+        {
+            if (it.value() == name)
+            {
+                tokens[it.key()]->cancel();
+            }
+        }
+
+        jobId = nextId++;
+        tokens.insert(jobId, token);
+        names.insert(jobId, name);
+    }
+
+    emit jobStarted(jobId, name);
+    return jobId;
+}
+
+// Forget a finished job
+void AlgorithmWorker::endJob(int jobId, const QString& name, bool cancelled, qint64 elapsedMs)
+{
+    {
+        QMutexLocker locker(&mutex);
+        tokens.remove(jobId);
+        names.remove(jobId);
+    }
+
+    if (cancelled)
+    {
+        LOG_INFO << "[INFO] Tarea cancelada:" << name;
+    }
+    else
+    {
+        LOG_INFO << "[INFO] Tarea completada:" << name << "en" << elapsedMs << "ms";
+    }
+
+    emit jobFinished(jobId, name, cancelled, elapsedMs);
+}
+
+// Cancel one job
+void AlgorithmWorker::cancel(int jobId)
+{
+    QMutexLocker locker(&mutex);
+    if (tokens.contains(jobId))
+    {
+        tokens[jobId]->cancel();
+    }
+}
+
+// Cancel every running job
+void AlgorithmWorker::cancelAll()
+{
+    QMutexLocker locker(&mutex);
+    for (const shared_ptr<JobToken>& token : tokens)
+    {
+        token->cancel();
+    }
+}
+
+// Check if a job is still running
+bool AlgorithmWorker::isRunning(int jobId) const
+{
+    QMutexLocker locker(&mutex);
+    return tokens.contains(jobId);
+}
+
+// Get number of running jobs
+int AlgorithmWorker::runningCount() const
+{
+    QMutexLocker locker(&mutex);
+    return tokens.size();
+}
+
+// Wait for every job
+void AlgorithmWorker::waitForDone()
+{
+    pool.waitForDone();
+}
+
@@ -0,0 +1,102 @@
+#pragma once
+
+#include "Graph.h"
+#include "JobToken.h"
+#include <QObject>
+#include <QString>
+#include <QHash>
+#include <QMutex>
+#include <QThreadPool>
+#include <QElapsedTimer>
+#include <QMetaObject>
+#include <memory>
+#include <utility>
+
+using namespace std;
+
+// Runs graph algorithms on a worker pool so the GUI stays responsive.
+// Each job gets its own snapshot of the graph (a copy; the containers are implicitly
+// shared, so taking it is cheap and later edits in the GUI do not reach the job) and a
+// JobToken that the algorithm polls for cancellation and progress.
+// Progress and completion are posted back as queued signals; the result callback runs
+// on the worker's thread (the GUI thread) just before jobFinished().
+// Starting a job with the name of one that is still running cancels the older one.
+class AlgorithmWorker : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit AlgorithmWorker(QObject* parent = nullptr);
+    ~AlgorithmWorker();   // Cancels the running jobs and waits for them
+
+    // Start a job: 'work(const Graph&, JobToken&)' runs on the pool and returns the result,
+    // 'done(const Result&)' receives it on this object's thread (not called if cancelled).
+    // Returns the job ID.
+    template <typename Work, typename Done>
+    int start(const QString& name, const Graph& graph, Work work, Done done);
+
+    // Cancel one job, or every running job
+    void cancel(int jobId);
+    void cancelAll();
+
+    // Jobs not finished yet
+    bool isRunning(int jobId) const;
+    int runningCount() const;
+
+    // Block until every job has ended
+    void waitForDone();
+
+signals:
+    void jobStarted(int jobId, const QString& name);
+    void jobProgress(int jobId, int percent);
+    void jobFinished(int jobId, const QString& name, bool cancelled, qint64 elapsedMs);
+
+private:
+    QThreadPool pool;
+    mutable QMutex mutex;
+    QHash<int, shared_ptr<JobToken>> tokens;    // Running jobs
+    QHash<int, QString> names;
+    int nextId;
+
+    // Register a job (cancels an older one with the same name) and announce it
+    int beginJob(const QString& name, shared_ptr<JobToken> token);
+
+    // Forget a job and announce its end (on this object's thread)
+    void endJob(int jobId, const QString& name, bool cancelled, qint64 elapsedMs);
+};
+
+template <typename Work, typename Done>
+int AlgorithmWorker::start(const QString& name, const Graph& graph, Work work, Done done)
+{
+    // The snapshot only reads; it must not report changes to the original's listener
+    Graph snapshot(graph);
+    snapshot.setChangeListener(nullptr);
+
+    auto token = make_shared<JobToken>();
+    int jobId = beginJob(name, token);
+
+    // Emitted from the pool thread: delivered queued to receivers on the GUI thread
+    token->setProgressListener([this, jobId](int percent) {
+        emit jobProgress(jobId, percent);
+    });
+
+    pool.start([this, jobId, name, snapshot, token, work, done]() {
+        QElapsedTimer timer;
+        timer.start();
+
+        auto result = work(snapshot, *token);
+        qint64 elapsed = timer.elapsed();
+
+        QMetaObject::invokeMethod(this, [this, jobId, name, token, done, result = std::move(result), elapsed]() {
+            bool cancelled = token->isCancelled();
+            if (!cancelled)
+            {
+                done(result);
+            }
+            endJob(jobId, name, cancelled, elapsed);
+        }, Qt::QueuedConnection);
+    });
+
+    return jobId;
+}
+
@@ -0,0 +1,463 @@
+#include "BatchRouter.h"
+#include "FileManager.h"
+#include "Log.h"
+#include <QElapsedTimer>
+#include <QHash>
+#include <QSet>
+#include <QThread>
+#include <limits>
+
+// Destinations of one origin up to which A* beats one whole Dijkstra
+static const int MaxAltDestinations = 4;
+
+// Result of a query that could not be answered
+static QString errorResult(const QString& message)
+{
+    return "error: " + message;
+}
+
+// Constructor
+BatchRouter::BatchRouter(const Graph& graph)
+    : analysis(graph), landmarkCount(0), landmarkSelection(LandmarkIndex::Avoid), blockSize(4096),
+      errorCount(0), elapsedMs(0)
+{
+}
+
+// Parse one query line
+bool BatchRouter::parse(const QString& line, Query& query)
+{
+    query = Query();
+    query.text = line.trimmed();
+
+    if (query.text.isEmpty() || query.text.startsWith('#'))
+    {
+        return false;
+    }
+
+    QStringList parts = query.text.simplified().split(' ');
+    QString command = parts[0].toLower();
+
+    // Station IDs after the command
+    auto readIds = [&parts, &query](int count) -> bool
+    {
+        if (parts.size() != count + 1)
+        {
+            query.error = QString("se esperaban %1 estaciones").arg(count);
+            return false;
+        }
+
+        bool ok = true;
+        int* targets[2] = { &query.first, &query.second };
+        for (int i = 0; i < count && ok; i++)
+        {
+            *targets[i] = parts[i + 1].toInt(&ok);
+        }
+        if (!ok)
+        {
+            query.error = "ID de estacion no valido";
+        }
+        return ok;
+    };
+
+    if (command == "ruta" || command == "path")
+    {
+        query.type = readIds(2) ? ShortestPath : Invalid;
+    }
+    else if (command == "distancia" || command == "distance")
+    {
+        query.type = readIds(2) ? Distance : Invalid;
+    }
+    else if (command == "bfs")
+    {
+        query.type = readIds(1) ? Bfs : Invalid;
+    }
+    else if (command == "dfs")
+    {
+        query.type = readIds(1) ? Dfs : Invalid;
+    }
+    else if (command == "conectado" || command == "connected")
+    {
+        query.type = readIds(2) ? Connected : Invalid;
+    }
+    else if (command == "componentes" || command == "components")
+    {
+        query.type = Components;
+    }
+    else if (command == "mst")
+    {
+        QString algorithm = parts.size() > 1 ? parts[1].toLower() : QString("kruskal");
+        if (parts.size() > 2 || (algorithm != "kruskal" && algorithm != "prim"))
+        {
+            query.error = "algoritmo de MST desconocido (kruskal o prim)";
+        }
+        else
+        {
+            query.type = Mst;
+            query.prim = (algorithm == "prim");
+        }
+    }
+    else
+    {
+        query.error = QString("consulta desconocida '%1'").arg(parts[0]);
+    }
+
+    return true;
+}
+
+// Set worker threads
+void BatchRouter::setMaxThreads(int threads)
+{
+    pool.setMaxThreadCount(threads > 0 ? threads : QThread::idealThreadCount());
+}
+
+// Set queries per block
+void BatchRouter::setBlockSize(int queries)
+{
+    blockSize = qMax(1, queries);
+}
+
+// Set ALT landmarks
+void BatchRouter::setLandmarks(int count, LandmarkIndex::Selection selection)
+{
+    landmarkCount = qMax(0, count);
+    landmarkSelection = selection;
+    landmarks.clear();
+}
+
+// Set the hub label file
+void BatchRouter::setHubLabelsFile(const QString& filename)
+{
+    hubLabelsFile = filename;
+    hubLabels.clear();
+}
+
+// Get queries that could not be answered in the last run
+qint64 BatchRouter::getErrorCount() const
+{
+    return errorCount;
+}
+
+// Get duration of the last run
+qint64 BatchRouter::getElapsedMs() const
+{
+    return elapsedMs;
+}
+
+// Compute the whole-network results the block needs (once per router)
+void BatchRouter::prepare(const QList<Query>& queries)
+{
+    bool directed = analysis.getGraph().isDirected();
+    int parts = 0;
+    bool paths = false;
+    bool distances = false;
+
+    for (const Query& query : queries)
+    {
+        paths = paths || query.type == ShortestPath;
+        distances = distances || query.type == Distance;
+        if (query.type == Mst)
+        {
+            parts |= query.prim ? NetworkAnalysis::PrimMST : NetworkAnalysis::KruskalMST;
+        }
+        else if (query.type == Components || (query.type == Connected && !directed))
+        {
+            parts |= NetworkAnalysis::Components;
+        }
+    }
+
+    if (parts != 0)
+    {
+        analysis.compute(parts);
+    }
+
+    if (paths && landmarkCount > 0 && !landmarks.isBuilt())
+    {
+        landmarks.setThreads(pool.maxThreadCount());
+        landmarks.build(analysis.getGraph(), landmarkCount, landmarkSelection);
+    }
+
+    // Hub labels: the saved ones if they describe this network, otherwise build and save them
+    const Graph& graph = analysis.getGraph();
+    if (distances && !hubLabels.isCurrent(graph))
+    {
+        FileManager fileManager;
+        bool loaded = !hubLabelsFile.isEmpty() && fileManager.fileExists(hubLabelsFile) &&
+                      fileManager.loadHubLabels(hubLabelsFile, graph, hubLabels);
+
+        if (!loaded)
+        {
+            hubLabels.setThreads(pool.maxThreadCount());
+            hubLabels.build(graph);
+
+            if (!hubLabelsFile.isEmpty() && hubLabels.isBuilt() && !fileManager.saveHubLabels(hubLabelsFile, hubLabels))
+            {
+                LOG_WARNING << "Advertencia:" << fileManager.getLastError();
+            }
+        }
+    }
+}
+
+// Answer a block of queries
+QStringList BatchRouter::answer(const QList<Query>& queries)
+{
+    prepare(queries);
+
+    QStringList results;
+    results.resize(queries.size());
+    QString* answers = results.data();
+    bool directed = analysis.getGraph().isDirected();
+
+    // Group the searches by kind and origin; the rest only read prepared results
+    QHash<QPair<int, int>, QList<int>> groups;
+    for (int i = 0; i < queries.size(); i++)
+    {
+        const Query& query = queries[i];
+        bool search = query.type == ShortestPath || query.type == Bfs || query.type == Dfs ||
+                      (query.type == Connected && directed);
+
+        if (search)
+        {
+            groups[qMakePair(static_cast<int>(query.type), query.first)].append(i);
+        }
+        else
+        {
+            answers[i] = answerShared(query);
+        }
+    }
+
+    // Each task writes only the answers of its own group
+    for (auto it = groups.constBegin(); it != groups.constEnd(); ++it)
+    {
+        QList<int> group = it.value();
+        pool.start([this, &queries, group, answers]() {
+            answerGroup(queries, group, answers);
+        });
+    }
+    pool.waitForDone();
+
+    return results;
+}
+
+// Answer the queries of one group with one search
+void BatchRouter::answerGroup(const QList<Query>& queries, const QList<int>& group, QString* answers) const
+{
+    const Graph& graph = analysis.getGraph();
+    const Query& head = queries[group.first()];
+
+    if (!graph.containsStation(head.first))
+    {
+        for (int i : group)
+        {
+            answers[i] = errorResult(QString("la estacion %1 no existe").arg(head.first));
+        }
+        return;
+    }
+
+    if (head.type == Bfs || head.type == Dfs)
+    {
+        QString result = formatStations(head.type == Bfs ? graph.bfs(head.first) : graph.dfs(head.first));
+        for (int i : group)
+        {
+            answers[i] = result;
+        }
+        return;
+    }
+
+    if (head.type == Connected)
+    {
+        QList<int> reached = graph.bfs(head.first);
+        QSet<int> reachable(reached.begin(), reached.end());
+        for (int i : group)
+        {
+            int destination = queries[i].second;
+            if (!graph.containsStation(destination))
+            {
+                answers[i] = errorResult(QString("la estacion %1 no existe").arg(destination));
+            }
+            else
+            {
+                answers[i] = reachable.contains(destination) ? "si" : "no";
+            }
+        }
+        return;
+    }
+
+    // Shortest paths, few destinations: one A* each
+    if (landmarks.isBuilt() && group.size() <= MaxAltDestinations)
+    {
+        for (int i : group)
+        {
+            int destination = queries[i].second;
+            QList<int> route;
+            double distance = 0.0;
+
+            if (!landmarks.findPath(graph, head.first, destination, route, distance))
+            {
+                answers[i] = errorResult(QString("la estacion %1 no existe").arg(destination));
+            }
+            else
+            {
+                answers[i] = route.isEmpty() ? QString("sin ruta") : QString::number(distance) + "\t" + formatStations(route);
+            }
+        }
+        return;
+    }
+
+    // Shortest paths: one Dijkstra for every destination of this origin
+    QPair<QHash<int, double>, QHash<int, int>> result = graph.dijkstraWithPath(head.first);
+    const QHash<int, double>& distances = result.first;
+    const QHash<int, int>& predecessors = result.second;
+
+    for (int i : group)
+    {
+        int destination = queries[i].second;
+        if (!graph.containsStation(destination))
+        {
+            answers[i] = errorResult(QString("la estacion %1 no existe").arg(destination));
+            continue;
+        }
+
+        double distance = distances.value(destination, std::numeric_limits<double>::infinity());
+        if (distance >= std::numeric_limits<double>::infinity())
+        {
+            answers[i] = "sin ruta";
+            continue;
+        }
+
+        // Walk the predecessors back to the origin
+        QList<int> route;
+        int current = destination;
+        while (current != -1 && route.size() <= distances.size())
+        {
+            route.prepend(current);
+            if (current == head.first)
+            {
+                break;
+            }
+            current = predecessors.value(current, -1);
+        }
+
+        answers[i] = QString::number(distance) + "\t" + formatStations(route);
+    }
+}
+
+// Answer a query from the prepared results
+QString BatchRouter::answerShared(const Query& query) const
+{
+    switch (query.type)
+    {
+    case Mst:
+        return query.prim ? formatMST(analysis.getPrimEdges(), analysis.getPrimWeight())
+                          : formatMST(analysis.getKruskalEdges(), analysis.getKruskalWeight());
+    case Components:
+        return QString("%1 componentes, la mayor con %2 estaciones")
+            .arg(analysis.getComponentCount()).arg(analysis.getLargestComponentSize());
+    case Connected:
+    {
+        const StationTable& table = analysis.getStationTable();
+        for (int id : { query.first, query.second })
+        {
+            if (!table.contains(id))
+            {
+                return errorResult(QString("la estacion %1 no existe").arg(id));
+            }
+        }
+
+        int component = analysis.componentAt(table.indexOf(query.first));
+        return (component >= 0 && component == analysis.componentAt(table.indexOf(query.second))) ? "si" : "no";
+    }
+    case Distance:
+    {
+        const StationTable& table = analysis.getStationTable();
+        for (int id : { query.first, query.second })
+        {
+            if (!table.contains(id))
+            {
+                return errorResult(QString("la estacion %1 no existe").arg(id));
+            }
+        }
+        if (!hubLabels.isCurrent(analysis.getGraph()))
+        {
+            return errorResult("no hay etiquetas de hubs para la red");
+        }
+
+        double distance = hubLabels.distanceAt(table.indexOf(query.first), table.indexOf(query.second));
+        return (distance >= std::numeric_limits<double>::infinity()) ? QString("sin ruta") : QString::number(distance);
+    }
+    default:
+        return errorResult(query.error);
+    }
+}
+
+// Station IDs separated by spaces
+QString BatchRouter::formatStations(const QList<int>& ids) const
+{
+    QString result;
+    result.reserve(ids.size() * 6);
+    for (int i = 0; i < ids.size(); i++)
+    {
+        if (i > 0)
+        {
+            result += ' ';
+        }
+        result += QString::number(ids[i]);
+    }
+    return result;
+}
+
+// MST weight, size and edges
+QString BatchRouter::formatMST(const QList<Edge>& edges, double weight) const
+{
+    QString result = QString("peso %1, %2 rutas:").arg(weight).arg(edges.size());
+    for (const Edge& edge : edges)
+    {
+        result += QString(" %1-%2").arg(edge.from).arg(edge.to);
+    }
+    return result;
+}
+
+// Answer every query of a stream
+qint64 BatchRouter::run(QTextStream& in, QTextStream& out)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    qint64 answered = 0;
+    errorCount = 0;
+
+    QString line;
+    QList<Query> block;
+    block.reserve(blockSize);
+
+    while (!in.atEnd())
+    {
+        // Read one block
+        block.clear();
+        while (block.size() < blockSize && in.readLineInto(&line))
+        {
+            Query query;
+            if (parse(line, query))
+            {
+                block.append(query);
+            }
+        }
+
+        // Answer it and write the answers in input order
+        QStringList answers = answer(block);
+        for (int i = 0; i < block.size(); i++)
+        {
+            if (answers[i].startsWith("error: "))
+            {
+                errorCount++;
+            }
+            out << block[i].text << '\t' << answers[i] << '\n';
+        }
+        out.flush();
+
+        answered += block.size();
+    }
+
+    elapsedMs = timer.elapsed();
+    return answered;
+}
+
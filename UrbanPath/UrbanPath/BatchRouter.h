@@ -0,0 +1,108 @@
+#pragma once
+
+#include "NetworkAnalysis.h"
+#include "LandmarkIndex.h"
+#include "HubLabelIndex.h"
+#include <QString>
+#include <QStringList>
+#include <QList>
+#include <QVector>
+#include <QTextStream>
+#include <QThreadPool>
+
+using namespace std;
+
+// Answers batches of text queries against a copy of the network (no GUI needed).
+// One query per line; blank lines and lines starting with '#' are skipped:
+//   ruta <origen> <destino>       shortest path (alias: path)
+//   distancia <origen> <destino>  distance only, from hub labels (alias: distance)
+//   bfs <origen>                  breadth-first traversal
+//   dfs <origen>                  depth-first traversal
+//   mst [kruskal|prim]            minimum spanning tree (Kruskal by default)
+//   conectado <a> <b>             whether b can be reached from a (alias: connected)
+//   componentes                   connected components (alias: components)
+// Each answer is one line: the query, a tab and the result ("error: ..." for bad queries).
+// Queries are read in blocks; inside a block the queries that share an origin run
+// one search between them, the searches run on all cores and the answers are
+// written in input order. With landmarks on, an origin with only a few destinations
+// gets one A* search per destination instead of a whole Dijkstra. Distance queries merge
+// two hub labels; the labels are loaded from setHubLabelsFile() when they match the
+// network, otherwise built with the first block that needs them (and saved there).
+class BatchRouter
+{
+public:
+    // Query kinds
+    enum QueryType
+    {
+        ShortestPath,
+        Bfs,
+        Dfs,
+        Mst,
+        Connected,
+        Components,
+        Distance,
+        Invalid
+    };
+
+    // One parsed query line
+    struct Query
+    {
+        QueryType type = Invalid;
+        int first = -1;         // Origin station ID
+        int second = -1;        // Destination station ID
+        bool prim = false;      // MST: Prim instead of Kruskal
+        QString text;           // Original line (trimmed)
+        QString error;          // Why the line is Invalid
+    };
+
+    // Constructor (copies the graph; call from the thread that owns it)
+    explicit BatchRouter(const Graph& graph);
+
+    // Parse one line; false for blank lines and comments
+    static bool parse(const QString& line, Query& query);
+
+    // Answer a block of queries (same order as the input)
+    QStringList answer(const QList<Query>& queries);
+
+    // Read queries until the end of 'in' and write the answers to 'out'.
+    // Returns the number of queries answered.
+    qint64 run(QTextStream& in, QTextStream& out);
+
+    // Worker threads (0 = one per core) and queries read per block
+    void setMaxThreads(int threads);
+    void setBlockSize(int queries);
+
+    // ALT landmarks for the shortest paths (0 = off); built with the first block that needs them
+    void setLandmarks(int count, LandmarkIndex::Selection selection = LandmarkIndex::Avoid);
+
+    // Hub label file for the distance queries (empty: build the labels, keep them in memory only)
+    void setHubLabelsFile(const QString& filename);
+
+    // Statistics of the last run()
+    qint64 getErrorCount() const;
+    qint64 getElapsedMs() const;
+
+private:
+    NetworkAnalysis analysis;      // Own copy of the graph plus the whole-network results
+    LandmarkIndex landmarks;
+    int landmarkCount;
+    LandmarkIndex::Selection landmarkSelection;
+    HubLabelIndex hubLabels;
+    QString hubLabelsFile;
+    QThreadPool pool;
+    int blockSize;
+    qint64 errorCount;
+    qint64 elapsedMs;
+
+    // Whole-network results, computed on the first block that needs them
+    void prepare(const QList<Query>& queries);
+
+    // Queries of one block that can share one search (same kind and origin)
+    void answerGroup(const QList<Query>& queries, const QList<int>& group, QString* answers) const;
+    QString answerShared(const Query& query) const;
+
+    // Formatting helpers
+    QString formatStations(const QList<int>& ids) const;
+    QString formatMST(const QList<Edge>& edges, double weight) const;
+};
+
@@ -0,0 +1,261 @@
+#include "EdgeBatchItem.h"
+#include <QPainter>
+#include <QElapsedTimer>
+#include <QStyleOptionGraphicsItem>
+#include <algorithm>
+#include <cmath>
+
+// Constructor
+EdgeBatchItem::EdgeBatchItem(QGraphicsItem* parent) : QGraphicsItem(parent), paintNs(0)
+{
+}
+
+// Distance from a point to a segment
+double EdgeBatchItem::distanceToLine(const QPointF& point, const QLineF& line)
+{
+    double dx = line.x2() - line.x1();
+    double dy = line.y2() - line.y1();
+    double lengthSquared = dx * dx + dy * dy;
+
+    double t = 0.0;
+    if (lengthSquared > 0.0)
+    {
+        t = ((point.x() - line.x1()) * dx + (point.y() - line.y1()) * dy) / lengthSquared;
+        t = std::max(0.0, std::min(t, 1.0));
+    }
+
+    double px = line.x1() + t * dx - point.x();
+    double py = line.y1() + t * dy - point.y();
+    return std::sqrt(px * px + py * py);
+}
+
+// Set the pen of a style
+void EdgeBatchItem::setStylePen(Style style, const QPen& pen)
+{
+    if (pens[style] == pen)
+    {
+        return;
+    }
+
+    prepareGeometryChange();  // The width changes the bounding rect
+    pens[style] = pen;
+    update();
+}
+
+// Get the pen of a style
+QPen EdgeBatchItem::stylePen(Style style) const
+{
+    return pens[style];
+}
+
+// Add a route or update its line and style
+void EdgeBatchItem::setRoute(const QPair<int, int>& key, const QLineF& line, Style style)
+{
+    auto it = locations.find(key);
+    if (it != locations.end())
+    {
+        Location location = it.value();
+        if (location.style == style)
+        {
+            // Same array: update in place
+            QLineF& current = lines[style][location.position];
+            if (current != line)
+            {
+                current = line;
+                growBounds(line);
+                update();
+            }
+            return;
+        }
+        removeRoute(key);
+    }
+
+    locations.insert(key, { style, static_cast<int>(lines[style].size()) });
+    lines[style].append(line);
+    owners[style].append(key);
+    growBounds(line);
+    update();
+}
+
+// Remove a route (the last line of its style fills the hole)
+bool EdgeBatchItem::removeRoute(const QPair<int, int>& key)
+{
+    auto it = locations.find(key);
+    if (it == locations.end())
+    {
+        return false;
+    }
+
+    Location location = it.value();
+    locations.erase(it);
+
+    QVector<QLineF>& styleLines = lines[location.style];
+    QVector<QPair<int, int>>& styleOwners = owners[location.style];
+    int last = styleLines.size() - 1;
+
+    if (location.position != last)
+    {
+        styleLines[location.position] = styleLines[last];
+        styleOwners[location.position] = styleOwners[last];
+        locations[styleOwners[last]].position = location.position;
+    }
+    styleLines.removeLast();
+    styleOwners.removeLast();
+
+    update();
+    return true;
+}
+
+// Check if a route is present
+bool EdgeBatchItem::containsRoute(const QPair<int, int>& key) const
+{
+    return locations.contains(key);
+}
+
+// Remove every route
+void EdgeBatchItem::clearRoutes()
+{
+    prepareGeometryChange();
+    for (int style = 0; style < StyleCount; style++)
+    {
+        lines[style].clear();
+        owners[style].clear();
+    }
+    locations.clear();
+    bounds = QRectF();
+}
+
+// Get number of routes
+int EdgeBatchItem::routeCount() const
+{
+    return locations.size();
+}
+
+// Get route keys
+QList<QPair<int, int>> EdgeBatchItem::routeKeys() const
+{
+    return locations.keys();
+}
+
+// Find the route closest to a point
+bool EdgeBatchItem::routeAt(const QPointF& pos, double tolerance, QPair<int, int>& key) const
+{
+    double best = -1.0;
+
+    // Later styles are painted on top, so they win ties
+    for (int style = StyleCount - 1; style >= 0; style--)
+    {
+        double limit = tolerance + pens[style].widthF() / 2.0;
+        const QVector<QLineF>& styleLines = lines[style];
+
+        for (int i = 0; i < styleLines.size(); i++)
+        {
+            const QLineF& line = styleLines[i];
+
+            // Quick reject by bounding box
+            if (pos.x() < std::min(line.x1(), line.x2()) - limit || pos.x() > std::max(line.x1(), line.x2()) + limit ||
+                pos.y() < std::min(line.y1(), line.y2()) - limit || pos.y() > std::max(line.y1(), line.y2()) + limit)
+            {
+                continue;
+            }
+
+            double distance = distanceToLine(pos, line);
+            if (distance <= limit && (best < 0.0 || distance < best))
+            {
+                best = distance;
+                key = owners[style][i];
+            }
+        }
+    }
+
+    return best >= 0.0;
+}
+
+// Get memory used by the arrays
+qint64 EdgeBatchItem::memoryUsage() const
+{
+    qint64 bytes = sizeof(EdgeBatchItem);
+    for (int style = 0; style < StyleCount; style++)
+    {
+        bytes += lines[style].capacity() * static_cast<qint64>(sizeof(QLineF));
+        bytes += owners[style].capacity() * static_cast<qint64>(sizeof(QPair<int, int>));
+    }
+
+    // Hash nodes: key, value and bucket overhead (approximate)
+    bytes += locations.size() * static_cast<qint64>(sizeof(QPair<int, int>) + sizeof(Location) + 2 * sizeof(void*));
+    return bytes;
+}
+
+// Get duration of the last paint
+qint64 EdgeBatchItem::lastPaintNanoseconds() const
+{
+    return paintNs;
+}
+
+// Bounding rect (lines plus half the widest pen)
+QRectF EdgeBatchItem::boundingRect() const
+{
+    if (bounds.isNull())
+    {
+        return QRectF();
+    }
+
+    double margin = maxPenWidth() / 2.0;
+    return bounds.adjusted(-margin, -margin, margin, margin);
+}
+
+// Hit test on the lines themselves, not the bounding rect
+bool EdgeBatchItem::contains(const QPointF& point) const
+{
+    QPair<int, int> key;
+    return routeAt(point, 0.0, key);
+}
+
+// Paint every style with one call
+void EdgeBatchItem::paint(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget* widget)
+{
+    Q_UNUSED(option);
+    Q_UNUSED(widget);
+
+    QElapsedTimer timer;
+    timer.start();
+
+    for (int style = 0; style < StyleCount; style++)
+    {
+        if (!lines[style].isEmpty())
+        {
+            painter->setPen(pens[style]);
+            painter->drawLines(lines[style].constData(), lines[style].size());
+        }
+    }
+
+    paintNs = timer.nsecsElapsed();
+}
+
+// Extend the bounds to a line
+void EdgeBatchItem::growBounds(const QLineF& line)
+{
+    QRectF lineRect = QRectF(line.p1(), line.p2()).normalized();
+    if (bounds.isNull())
+    {
+        prepareGeometryChange();
+        bounds = lineRect;
+    }
+    else if (!bounds.contains(lineRect))
+    {
+        prepareGeometryChange();
+        bounds = bounds.united(lineRect);
+    }
+}
+
+// Get the widest pen
+double EdgeBatchItem::maxPenWidth() const
+{
+    double width = 0.0;
+    for (int style = 0; style < StyleCount; style++)
+    {
+        width = std::max(width, pens[style].widthF());
+    }
+    return width;
+}
+
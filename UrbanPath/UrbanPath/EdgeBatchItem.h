@@ -0,0 +1,85 @@
+#pragma once
+
+#include <QGraphicsItem>
+#include <QLineF>
+#include <QPen>
+#include <QRectF>
+#include <QVector>
+#include <QHash>
+#include <QPair>
+#include <QList>
+
+using namespace std;
+
+// One scene item that paints every route line.
+// Lines are kept in one contiguous array per style and painted with a single
+// drawLines() call per style, instead of one QGraphicsLineItem per route (which
+// costs an item, a pen and a scene index entry each). Routes are addressed by
+// their key (smaller station ID first); removing one moves the last line of its
+// style into the hole, so every update is O(1).
+class EdgeBatchItem : public QGraphicsItem
+{
+public:
+    // Painted in this order (optimal routes end up on top)
+    enum Style
+    {
+        Normal,
+        Accident,
+        Closed,
+        Alternative1,     // Second, third and fourth route of a k-shortest search (later ones reuse the last)
+        Alternative2,
+        Alternative3,
+        Optimal,
+        StyleCount
+    };
+
+    // Constructor
+    EdgeBatchItem(QGraphicsItem* parent = nullptr);
+
+    // Pen of each style
+    void setStylePen(Style style, const QPen& pen);
+    QPen stylePen(Style style) const;
+
+    // Route management (add or move/restyle, remove)
+    void setRoute(const QPair<int, int>& key, const QLineF& line, Style style);
+    bool removeRoute(const QPair<int, int>& key);
+    bool containsRoute(const QPair<int, int>& key) const;
+    void clearRoutes();
+    int routeCount() const;
+    QList<QPair<int, int>> routeKeys() const;
+
+    // Route closest to a point, within 'tolerance' scene units (plus half the pen width)
+    bool routeAt(const QPointF& pos, double tolerance, QPair<int, int>& key) const;
+
+    // Distance from a point to a segment
+    static double distanceToLine(const QPointF& point, const QLineF& line);
+
+    // Statistics: memory of the arrays and duration of the last paint()
+    qint64 memoryUsage() const;
+    qint64 lastPaintNanoseconds() const;
+
+    // QGraphicsItem
+    QRectF boundingRect() const override;
+    bool contains(const QPointF& point) const override;
+    void paint(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget* widget = nullptr) override;
+
+private:
+    // Position of a route inside the arrays
+    struct Location
+    {
+        int style;
+        int position;
+    };
+
+    QVector<QLineF> lines[StyleCount];
+    QVector<QPair<int, int>> owners[StyleCount];     // Route of each line
+    QHash<QPair<int, int>, Location> locations;
+    QPen pens[StyleCount];
+
+    QRectF bounds;             // Grows with the lines; reset by clearRoutes()
+    qint64 paintNs;
+
+    void growBounds(const QLineF& line);
+    double maxPenWidth() const;
+};
+
@@ -0,0 +1,406 @@
+#include "EventJournal.h"
+#include "FileManager.h"
+#include "LineScanner.h"
+#include "Log.h"
+#include <QDir>
+#include <QFileInfo>
+
+static const char* JournalHeader = "# UrbanPath - diario de cierres y accidentes v1\n";
+
+// Record codes, in GraphEvent::Type order
+static const char* EventCodes[] = { "CE", "AE", "CR", "AR", "LC", "AC", "LA" };
+
+// Retry delays after a failed compaction
+static const int FirstCompactionRetryMs = 5000;
+static const int MaxCompactionRetryMs = 5 * 60 * 1000;
+
+// Constructor
+EventJournal::EventJournal()
+    : pendingCount(0), recordCount(0), groupSize(64), maxDelayMs(250),
+      compactionThreshold(5000), recording(true), compactionRetryMs(0)
+{
+}
+
+// Destructor
+EventJournal::~EventJournal()
+{
+    close();
+}
+
+// Open the journal for appending
+bool EventJournal::open(const QString& path)
+{
+    lastError.clear();
+    close();
+
+    // Count the records already in the file
+    recordCount = 0;
+    QFile existing(path);
+    if (existing.open(QIODevice::ReadOnly))
+    {
+        QByteArray contents = existing.readAll();
+        LineScanner scanner(contents.constData(), contents.constData() + contents.size());
+        ByteRange line;
+        while (scanner.nextLine(line))
+        {
+            if (!LineScanner::isSkippable(line))
+            {
+                recordCount++;
+            }
+        }
+        existing.close();
+    }
+
+    file.setFileName(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Append))
+    {
+        lastError = QString("No se pudo abrir el diario %1 para escritura.").arg(path);
+        LOG_ERROR << "Error:" << lastError;
+        return false;
+    }
+
+    if (file.size() == 0)
+    {
+        file.write(JournalHeader);
+        file.flush();
+    }
+
+    LOG_INFO << "[INFO] Diario de eventos abierto:" << path << "(" << recordCount << "registros pendientes de compactar)";
+    return true;
+}
+
+// Commit and close
+void EventJournal::close()
+{
+    if (file.isOpen())
+    {
+        commit();
+        file.close();
+    }
+}
+
+// Check if the journal is open
+bool EventJournal::isOpen() const
+{
+    return file.isOpen();
+}
+
+// Get the journal path
+QString EventJournal::getPath() const
+{
+    return file.fileName();
+}
+
+// Pause or resume recording
+void EventJournal::setRecording(bool enabled)
+{
+    recording = enabled;
+}
+
+// Check if events are being recorded
+bool EventJournal::isRecording() const
+{
+    return recording;
+}
+
+// Append an event
+void EventJournal::record(const GraphEvent& event)
+{
+    if (!recording || !file.isOpen())
+    {
+        return;
+    }
+
+    if (pendingCount == 0)
+    {
+        pendingSince.start();
+    }
+
+    pending.append(encode(event));
+    pendingCount++;
+
+    // Group commit: one write for many events
+    if (pendingCount >= groupSize || pendingSince.elapsed() >= maxDelayMs)
+    {
+        commit();
+    }
+}
+
+// Write the pending records
+bool EventJournal::commit()
+{
+    if (pendingCount == 0)
+    {
+        return true;
+    }
+
+    if (!file.isOpen())
+    {
+        lastError = "El diario de eventos no esta abierto.";
+        return false;
+    }
+
+    if (file.write(pending) != pending.size() || !file.flush())
+    {
+        lastError = QString("No se pudo escribir en el diario %1.").arg(file.fileName());
+        LOG_ERROR << "Error:" << lastError;
+        return false;
+    }
+
+    recordCount += pendingCount;
+    pending.clear();
+    pendingCount = 0;
+    return true;
+}
+
+// Set group commit limits
+void EventJournal::setGroupCommit(int records, int maxDelayMs)
+{
+    groupSize = qMax(1, records);
+    this->maxDelayMs = qMax(0, maxDelayMs);
+}
+
+// Set the number of records that makes compaction due
+void EventJournal::setCompactionThreshold(int records)
+{
+    compactionThreshold = qMax(1, records);
+}
+
+// Encode an event as one line
+QByteArray EventJournal::encode(const GraphEvent& event)
+{
+    QByteArray line(EventCodes[event.type]);
+    line += ' ';
+    line += QByteArray::number(event.first);
+    line += ' ';
+    line += QByteArray::number(event.second);
+    line += ' ';
+    line += QByteArray::number(event.value, 'g', 17);
+    line += '\n';
+    return line;
+}
+
+// Decode one line
+bool EventJournal::decode(const ByteRange& line, GraphEvent& event)
+{
+    ByteRange fields[4];
+    if (LineScanner::splitFields(line, ' ', fields, 4) != 4 ||
+        !LineScanner::parseInt(fields[1], event.first) ||
+        !LineScanner::parseInt(fields[2], event.second) ||
+        !LineScanner::parseDouble(fields[3], event.value) ||
+        fields[0].size() != 2)
+    {
+        return false;
+    }
+
+    for (int type = GraphEvent::StationClosed; type <= GraphEvent::AccidentsCleared; type++)
+    {
+        if (fields[0].startsWith(EventCodes[type]))
+        {
+            event.type = static_cast<GraphEvent::Type>(type);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+// Apply one event
+void EventJournal::apply(const GraphEvent& event, Graph& graph)
+{
+    switch (event.type)
+    {
+    case GraphEvent::StationClosed:
+        graph.closeStation(event.first);
+        break;
+    case GraphEvent::StationOpened:
+        graph.openStation(event.first);
+        break;
+    case GraphEvent::RouteClosed:
+        graph.closeRoute(event.first, event.second);
+        break;
+    case GraphEvent::RouteOpened:
+        graph.openRoute(event.first, event.second);
+        break;
+    case GraphEvent::ClosuresCleared:
+        graph.clearClosures();
+        break;
+    case GraphEvent::AccidentApplied:
+        graph.applyAccident(event.first, event.second, event.value);
+        break;
+    case GraphEvent::AccidentsCleared:
+        graph.clearAccidents();
+        break;
+    }
+}
+
+// Replay the journal onto the graph
+int EventJournal::replay(Graph& graph)
+{
+    lastError.clear();
+    commit();
+
+    QFile input(file.isOpen() ? file.fileName() : QString());
+    if (input.fileName().isEmpty() || !input.exists())
+    {
+        return 0;
+    }
+
+    if (!input.open(QIODevice::ReadOnly))
+    {
+        lastError = QString("No se pudo abrir el diario %1 para lectura.").arg(input.fileName());
+        LOG_ERROR << "Error:" << lastError;
+        return -1;
+    }
+
+    QByteArray contents = input.readAll();
+    input.close();
+
+    // Replayed events are already in the journal
+    bool wasRecording = recording;
+    recording = false;
+
+    LineScanner scanner(contents.constData(), contents.constData() + contents.size());
+    ByteRange line;
+    GraphEvent event;
+    int applied = 0;
+    Log::RateLimit lineWarnings;
+
+    while (scanner.nextLine(line))
+    {
+        if (LineScanner::isSkippable(line))
+        {
+            continue;
+        }
+
+        // A torn last line (crash during a write) is skipped
+        if (!decode(line, event))
+        {
+            LOG_WARNING_LIMITED(lineWarnings) << "Advertencia: Linea" << scanner.lineNumber() << "del diario invalida. Ignorando...";
+            continue;
+        }
+
+        apply(event, graph);
+        applied++;
+    }
+
+    recording = wasRecording;
+
+    if (applied > 0)
+    {
+        LOG_INFO << "[INFO] Diario reproducido:" << applied << "eventos aplicados.";
+    }
+    return applied;
+}
+
+// Check if compaction is due
+bool EventJournal::needsCompaction() const
+{
+    if (compactionFailedAt.isValid() && compactionFailedAt.elapsed() < compactionRetryMs)
+    {
+        return false;
+    }
+    return recordCount + pendingCount >= compactionThreshold;
+}
+
+// Get the delay before the next compaction attempt
+int EventJournal::getCompactionRetryMs() const
+{
+    return compactionRetryMs;
+}
+
+// Save closures and accidents, then empty the journal
+bool EventJournal::compact(FileManager& fileManager, const Graph& graph,
+                           const QString& closuresFile, const QString& accidentsFile)
+{
+    lastError.clear();
+
+    // Back off until the next attempt is due
+    compactionRetryMs = qBound(FirstCompactionRetryMs, 2 * compactionRetryMs, MaxCompactionRetryMs);
+    compactionFailedAt.start();
+
+    if (!commit())
+    {
+        return false;
+    }
+
+    QDir directory;
+    if (!directory.mkpath(QFileInfo(closuresFile).path()) || !directory.mkpath(QFileInfo(accidentsFile).path()))
+    {
+        lastError = QString("No se pudo crear el directorio de %1.").arg(closuresFile);
+        return false;
+    }
+
+    // The journal is only emptied once both files are written; if the process stops
+    // in between, replaying the journal over the new files gives the same state
+    if (!fileManager.saveClosures(closuresFile, graph) ||
+        !fileManager.saveAccidents(accidentsFile, graph))
+    {
+        lastError = fileManager.getLastError();
+        return false;
+    }
+
+    LOG_INFO << "[INFO] Diario compactado en" << closuresFile << "y" << accidentsFile << "(" << recordCount << "registros)";
+    if (!reset())
+    {
+        return false;
+    }
+
+    compactionFailedAt.invalidate();
+    compactionRetryMs = 0;
+    return true;
+}
+
+// The current state was saved: empty the journal
+bool EventJournal::truncate()
+{
+    lastError.clear();
+
+    // Anything still pending is already part of the saved state
+    pending.clear();
+    pendingCount = 0;
+
+    return reset();
+}
+
+// Empty the file and write the header
+bool EventJournal::reset()
+{
+    if (!file.isOpen())
+    {
+        recordCount = 0;
+        return true;
+    }
+
+    if (!file.resize(0))
+    {
+        lastError = QString("No se pudo vaciar el diario %1.").arg(file.fileName());
+        LOG_ERROR << "Error:" << lastError;
+        return false;
+    }
+
+    file.seek(0);
+    file.write(JournalHeader);
+    file.flush();
+    recordCount = 0;
+    return true;
+}
+
+// Get records since the last compaction
+int EventJournal::getRecordCount() const
+{
+    return recordCount;
+}
+
+// Get records waiting for a commit
+int EventJournal::getPendingCount() const
+{
+    return pendingCount;
+}
+
+// Get last error message
+QString EventJournal::getLastError() const
+{
+    return lastError;
+}
+
@@ -0,0 +1,94 @@
+#pragma once
+
+#include "Graph.h"
+#include <QString>
+#include <QFile>
+#include <QByteArray>
+#include <QElapsedTimer>
+
+using namespace std;
+
+// Forward declarations
+class FileManager;
+struct ByteRange;
+
+// Append-only journal of closure and accident events (write-ahead log).
+// Every change reported by the graph is appended as one short text line:
+//   <code> <first> <second> <value>
+// Records are grouped and written together (group commit). Compaction writes
+// the current state to cierres.txt / accidentes.txt and empties the journal;
+// after a crash, replay() applies the events that were never compacted.
+class EventJournal
+{
+private:
+    QFile file;
+    QByteArray pending;           // Records waiting for the next commit
+    int pendingCount;
+    int recordCount;              // Records in the file since the last compaction
+    QElapsedTimer pendingSince;   // Age of the oldest pending record
+
+    int groupSize;                // Commit after this many records...
+    int maxDelayMs;               // ...or when the oldest one is this old
+    int compactionThreshold;      // Records before compaction is due
+    bool recording;
+
+    // Failed compactions are retried after a growing delay instead of on every check
+    QElapsedTimer compactionFailedAt;
+    int compactionRetryMs;
+
+    QString lastError;
+
+    // Record encoding
+    static QByteArray encode(const GraphEvent& event);
+    static bool decode(const ByteRange& line, GraphEvent& event);
+
+    // Apply one event to the graph
+    static void apply(const GraphEvent& event, Graph& graph);
+
+    // Empty the file and write the header
+    bool reset();
+
+public:
+    // Constructor and Destructor (pending records are committed)
+    EventJournal();
+    ~EventJournal();
+
+    // Open (or create) the journal file for appending
+    bool open(const QString& path);
+    void close();
+    bool isOpen() const;
+    QString getPath() const;
+
+    // Recording can be paused while files are loaded or the journal is replayed
+    void setRecording(bool enabled);
+    bool isRecording() const;
+
+    // Append an event (written at the next group commit)
+    void record(const GraphEvent& event);
+
+    // Write pending records now
+    bool commit();
+
+    // Tuning
+    void setGroupCommit(int records, int maxDelayMs);
+    void setCompactionThreshold(int records);
+
+    // Replay every journaled event onto the graph; returns the events applied (-1 on error)
+    int replay(Graph& graph);
+
+    // Compaction: save closures and accidents (creating their directory), then empty the journal.
+    // After a failure needsCompaction() stays false for a while (5 s, doubling up to 5 min).
+    bool needsCompaction() const;
+    int getCompactionRetryMs() const;   // Current delay after a failure (0 if the last one worked)
+    bool compact(FileManager& fileManager, const Graph& graph,
+                 const QString& closuresFile, const QString& accidentsFile);
+    bool truncate();              // The state was saved elsewhere
+
+    // Statistics
+    int getRecordCount() const;
+    int getPendingCount() const;
+
+    // Get last error
+    QString getLastError() const;
+};
+
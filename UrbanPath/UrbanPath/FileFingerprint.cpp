@@ -0,0 +1,149 @@
+#include "FileFingerprint.h"
+#include <QFile>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QByteArray>
+#include <cstring>
+
+// Constructor
+FileFingerprint::FileFingerprint() : size(-1), modified(0)
+{
+}
+
+// Read size and modification time
+FileFingerprint FileFingerprint::stat(const QString& path)
+{
+    FileFingerprint fingerprint;
+    QFileInfo info(path);
+
+    if (info.exists())
+    {
+        fingerprint.size = info.size();
+        fingerprint.modified = info.lastModified().toMSecsSinceEpoch();
+    }
+
+    return fingerprint;
+}
+
+// Read size, modification time and the hash of every block
+FileFingerprint FileFingerprint::capture(const QString& path)
+{
+    FileFingerprint fingerprint = stat(path);
+    if (!fingerprint.isValid())
+    {
+        return fingerprint;
+    }
+
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        return FileFingerprint();
+    }
+
+    qint64 blocks = (fingerprint.size + BlockSize - 1) / BlockSize;
+    fingerprint.blockHashes.reserve(static_cast<int>(blocks));
+
+    uchar* mapped = fingerprint.size > 0 ? file.map(0, fingerprint.size) : nullptr;
+    if (mapped != nullptr)
+    {
+        fingerprint.hashContent(reinterpret_cast<const char*>(mapped), fingerprint.size);
+        file.unmap(mapped);
+    }
+    else
+    {
+        // Mapping not available: read block by block
+        while (!file.atEnd())
+        {
+            QByteArray block = file.read(BlockSize);
+            if (block.isEmpty())
+            {
+                break;
+            }
+            fingerprint.blockHashes.append(hashBytes(block.constData(), block.size()));
+        }
+    }
+
+    file.close();
+    return fingerprint;
+}
+
+// Hash the blocks of contents already in memory
+void FileFingerprint::hashContent(const char* data, qint64 length)
+{
+    blockHashes.clear();
+    blockHashes.reserve(static_cast<int>((length + BlockSize - 1) / BlockSize));
+
+    for (qint64 offset = 0; offset < length; offset += BlockSize)
+    {
+        blockHashes.append(hashBytes(data + offset, qMin(BlockSize, length - offset)));
+    }
+}
+
+// Check if the file existed when the fingerprint was taken
+bool FileFingerprint::isValid() const
+{
+    return size >= 0;
+}
+
+// Check if block hashes were computed
+bool FileFingerprint::hasContent() const
+{
+    return size == 0 || !blockHashes.isEmpty();
+}
+
+// Get file size
+qint64 FileFingerprint::getSize() const
+{
+    return size;
+}
+
+// Compare size and modification time
+bool FileFingerprint::sameMetadata(const FileFingerprint& other) const
+{
+    return isValid() && size == other.size && modified == other.modified;
+}
+
+// Count blocks with different content
+int FileFingerprint::changedBlocks(const FileFingerprint& other) const
+{
+    if (!hasContent() || !other.hasContent())
+    {
+        return -1;
+    }
+
+    int common = qMin(blockHashes.size(), other.blockHashes.size());
+    int changed = qAbs(blockHashes.size() - other.blockHashes.size());
+
+    for (int i = 0; i < common; i++)
+    {
+        if (blockHashes[i] != other.blockHashes[i])
+        {
+            changed++;
+        }
+    }
+
+    return changed;
+}
+
+// 64-bit FNV-1a
+quint64 FileFingerprint::hashBytes(const char* data, qint64 length)
+{
+    const quint64 prime = 1099511628211ULL;
+    quint64 hash = 14695981039346656037ULL;
+
+    qint64 words = length / 8;
+    for (qint64 i = 0; i < words; i++)
+    {
+        quint64 word;
+        memcpy(&word, data + i * 8, sizeof(word));
+        hash = (hash ^ word) * prime;
+    }
+
+    for (qint64 i = words * 8; i < length; i++)
+    {
+        hash = (hash ^ static_cast<unsigned char>(data[i])) * prime;
+    }
+
+    return hash;
+}
+
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <QString>
+#include <QVector>
+#include <QtGlobal>
+
+using namespace std;
+
+// Change detection for the data files.
+// Size and modification time are compared first (no read); when they differ,
+// the content hashes of fixed-size blocks tell a real edit from a file that
+// was only touched, and which parts of it changed.
+class FileFingerprint
+{
+private:
+    qint64 size;
+    qint64 modified;                 // Modification time, ms since epoch
+    QVector<quint64> blockHashes;    // Empty when only the metadata was read
+
+public:
+    static const qint64 BlockSize = 1 << 20;
+
+    // Constructor (invalid fingerprint)
+    FileFingerprint();
+
+    // Size and modification time only
+    static FileFingerprint stat(const QString& path);
+
+    // Size, modification time and block hashes
+    static FileFingerprint capture(const QString& path);
+
+    // Block hashes of contents a loader already holds in memory. Take stat() before
+    // reading them, so a write in between shows up as a change on the next check.
+    void hashContent(const char* data, qint64 length);
+
+    bool isValid() const;
+    bool hasContent() const;
+    qint64 getSize() const;
+
+    // Same size and modification time
+    bool sameMetadata(const FileFingerprint& other) const;
+
+    // Blocks that differ (blocks present in only one of them count as changed);
+    // -1 if either fingerprint has no block hashes
+    int changedBlocks(const FileFingerprint& other) const;
+
+    // FNV-1a over 64-bit words (trailing bytes one by one)
+    static quint64 hashBytes(const char* data, qint64 length);
+};
+
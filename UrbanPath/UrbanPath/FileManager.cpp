@@ -1,8 +1,18 @@
 ﻿#include "FileManager.h"
 #include "Graph.h"
 #include "StationBST.h"
+#include "LineScanner.h"
+#include "NetworkSnapshot.h"
+#include "HubLabelIndex.h"
+#include "Metrics.h"
+#include "Log.h"
+#include "Parallel.h"
 #include <QDebug>
 #include <QDateTime>
+#include <QFileInfo>
+#include <QThread>
+#include <functional>
+#include <cstring>
 
 // Check if file exists
 bool FileManager::fileExists(const QString& path) const
@@ -18,11 +28,11 @@ void FileManager::clearFile(const QString& filename)
     if (file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text))
     {
         file.close();
-        qDebug() << "Archivo" << filename << "limpiado correctamente.";
+        LOG_DEBUG << "Archivo" << filename << "limpiado correctamente.";
     }
     else
     {
-        qDebug() << "Error: No se pudo limpiar el archivo" << filename;
+        LOG_ERROR << "Error: No se pudo limpiar el archivo" << filename;
     }
 }
 
@@ -32,6 +42,18 @@ QString FileManager::getLastError() const
     return lastError;
 }
 
+// Enable or disable fast (memory-mapped) loading
+void FileManager::setFastLoading(bool enabled)
+{
+    fastLoading = enabled;
+}
+
+// Check if fast loading is enabled
+bool FileManager::isFastLoading() const
+{
+    return fastLoading;
+}
+
 // Trim whitespace from string
 QString FileManager::trim(const QString& str) const
 {
@@ -52,36 +74,109 @@ QStringList FileManager::splitLine(const QString& line, const QString& separator
     return result;
 }
 
-// Find file in multiple locations
+// Find file in multiple locations (cached)
 QString FileManager::findFile(const QString& filename) const
 {
-    // List of possible locations to search
-    QStringList searchPaths = {
-        filename,                                    // Current directory
-        QString("../") + filename,                   // Parent directory
-        QString("../../") + filename,                // Two levels up
-        QString("../../../") + filename,             // Three levels up
-        QString("../../../../") + filename,          // Four levels up
-        QString("data/") + filename,                 // data subdirectory
-        QString("../data/") + filename,              // data in parent
-        QString("../../data/") + filename            // data two levels up
-    };
-    
-    // Search in all possible paths
-    for (const QString& path : searchPaths)
-    {
-        QFile file(path);
-        if (file.exists())
-        {
-            qDebug() << "Archivo encontrado en:" << path;
+    // Already resolved (or known to be missing)
+    auto cached = resolvedFiles.constFind(filename);
+    if (cached != resolvedFiles.constEnd())
+    {
+        return cached.value();
+    }
+    
+    if (missingFiles.contains(filename))
+    {
+        return QString();
+    }
+    
+    // Absolute paths are not searched
+    if (QFileInfo(filename).isAbsolute())
+    {
+        if (QFileInfo::exists(filename))
+        {
+            resolvedFiles.insert(filename, filename);
+            return filename;
+        }
+        missingFiles.insert(filename);
+        return QString();
+    }
+    
+    // Try the root that worked last time before the others
+    QStringList roots = dataRoots;
+    if (rootResolved)
+    {
+        roots.removeOne(resolvedRoot);
+        roots.prepend(resolvedRoot);
+    }
+    
+    for (const QString& root : roots)
+    {
+        QString path = root + filename;
+        if (QFileInfo::exists(path))
+        {
+            LOG_DEBUG << "Archivo encontrado en:" << path;
+            resolvedRoot = root;
+            rootResolved = true;
+            resolvedFiles.insert(filename, path);
             return path;
         }
     }
     
-    qDebug() << "Archivo" << filename << "no encontrado en ninguna ubicacion.";
+    LOG_DEBUG << "Archivo" << filename << "no encontrado en ninguna ubicacion.";
+    missingFiles.insert(filename);
     return QString(); // Return empty string if not found
 }
 
+// Drop a cached path (the file could not be opened); the next lookup searches again
+void FileManager::forgetFile(const QString& filename) const
+{
+    resolvedFiles.remove(filename);
+    missingFiles.remove(filename);
+    rootResolved = false;
+    resolvedRoot.clear();
+}
+
+// Record the path a file was just written to
+void FileManager::rememberFile(const QString& filename, const QString& path) const
+{
+    missingFiles.remove(filename);
+    resolvedFiles.insert(filename, path);
+}
+
+// Set the search roots (a trailing '/' is added when missing)
+void FileManager::setDataRoots(const QStringList& roots)
+{
+    dataRoots.clear();
+    for (const QString& root : roots)
+    {
+        if (root.isEmpty() || root.endsWith("/") || root.endsWith("\\"))
+        {
+            dataRoots.append(root);
+        }
+        else
+        {
+            dataRoots.append(root + "/");
+        }
+    }
+    
+    clearPathCache();
+}
+
+// Get the search roots
+QStringList FileManager::getDataRoots() const
+{
+    return dataRoots;
+}
+
+// Forget every resolved path
+void FileManager::clearPathCache()
+{
+    resolvedFiles.clear();
+    missingFiles.clear();
+    rootResolved = false;
+    resolvedRoot.clear();
+}
+
 // Validate station line format
 bool FileManager::validateStationLine(const QStringList& parts) const
 {
@@ -126,7 +221,11 @@ bool FileManager::validateRouteLine(const QStringList& parts) const
 // Load stations from file
 bool FileManager::loadStations(const QString& filename, StationBST& bst, Graph& graph)
 {
+    MetricsTimer timer(Metrics::LoadStations);
     lastError.clear();
+    
+    // A new load looks again for files that were missing before
+    missingFiles.clear();
 
     // Find the file in multiple locations
     QString filePath = findFile(filename);
@@ -134,69 +233,115 @@ bool FileManager::loadStations(const QString& filename, StationBST& bst, Graph&
     if (filePath.isEmpty())
     {
         lastError = QString("El archivo %1 no existe en ninguna ubicacion conocida.").arg(filename);
-        qDebug() << "Error:" << lastError;
+        LOG_ERROR << "Error:" << lastError;
         return false;
     }
     
+    // Size and time before the read: a write during the load shows up on the next check
+    FileFingerprint fingerprint = changeTracking ? FileFingerprint::stat(filePath) : FileFingerprint();
+    
     QFile file(filePath);
     
     if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
     {
+        forgetFile(filename);
         lastError = QString("No se pudo abrir el archivo %1 para lectura.").arg(filePath);
-        qDebug() << "Error:" << lastError;
+        LOG_ERROR << "Error:" << lastError;
         return false;
     }
     
-    QTextStream in(&file);
-    int lineNumber = 0;
     int stationsLoaded = 0;
     
-    qDebug() << "\nCargando estaciones desde" << filePath << "...";
+    LOG_DEBUG << "\nCargando estaciones desde" << filePath << "...";
     
-    while (!in.atEnd())
+    // A full load replaces the tracked records
+    if (changeTracking)
     {
-        QString line = in.readLine();
-        lineNumber++;
-        
-        // Skip empty lines and comments
-        line = trim(line);
-        if (line.isEmpty() || line.startsWith("#") || line.startsWith("//"))
+        stationRecords.clear();
+    }
+    
+    // Fast path: parse the mapped file in place
+    uchar* mapped = nullptr;
+    if (fastLoading && file.size() > 0)
+    {
+        mapped = file.map(0, file.size());
+        if (mapped == nullptr)
         {
-            continue;
+            LOG_INFO << "[INFO] No se pudo mapear" << filePath << "en memoria. Se usara la lectura por lineas.";
         }
-        
-        // Parse station data: id, name, x, y
-        QStringList parts = splitLine(line, ",");
-        
-        if (!validateStationLine(parts))
+    }
+    
+    if (mapped != nullptr)
+    {
+        const char* data = reinterpret_cast<const char*>(mapped);
+        stationsLoaded = parseStationsMapped(data, data + file.size(), bst, graph);
+        if (changeTracking)
         {
-            qDebug() << "Advertencia: Linea" << lineNumber << "invalida (formato esperado: id, nombre, x, y). Ignorando...";
-            continue;
+            fingerprint.hashContent(data, file.size());
         }
+        file.unmap(mapped);
+    }
+    else
+    {
+        QTextStream in(&file);
+        int lineNumber = 0;
+        Log::RateLimit lineWarnings;
         
-        // Extract values
-        int id = parts[0].toInt();
-        QString name = parts[1];
-        double x = parts[2].toDouble();
-        double y = parts[3].toDouble();
-        
-        // Create station
-        Station station(id, name, x, y);
-        
-        // Add to BST and Graph
-        bst.insert(station);
-        graph.addStation(station);
-        
-        stationsLoaded++;
+        while (!in.atEnd())
+        {
+            QString line = in.readLine();
+            lineNumber++;
+            
+            // Skip empty lines and comments
+            line = trim(line);
+            if (line.isEmpty() || line.startsWith("#") || line.startsWith("//"))
+            {
+                continue;
+            }
+            
+            // Parse station data: id, name, x, y
+            QStringList parts = splitLine(line, ",");
+            
+            if (!validateStationLine(parts))
+            {
+                LOG_WARNING_LIMITED(lineWarnings) << "Advertencia: Linea" << lineNumber << "invalida (formato esperado: id, nombre, x, y). Ignorando...";
+                continue;
+            }
+            
+            // Extract values
+            int id = parts[0].toInt();
+            QString name = parts[1];
+            double x = parts[2].toDouble();
+            double y = parts[3].toDouble();
+            
+            // Create station
+            Station station(id, name, x, y);
+            
+            // Add to Graph (station table) and index it in the BST
+            graph.addStation(station);
+            bst.insert(id);
+            
+            if (changeTracking)
+            {
+                stationRecords.insert(id, StationRecord{ name, x, y });
+            }
+            
+            stationsLoaded++;
+        }
     }
     
     file.close();
     
-    qDebug() << "Archivo" << filePath << "cargado correctamente. (" << stationsLoaded << "estaciones)";
+    if (changeTracking)
+    {
+        rememberFingerprint(filename, fingerprint);
+    }
+    
+    LOG_INFO << "Archivo" << filePath << "cargado correctamente. (" << stationsLoaded << "estaciones)";
     
     if (stationsLoaded == 0)
     {
-        qDebug() << "Advertencia: El archivo de estaciones esta vacio.";
+        LOG_WARNING << "Advertencia: El archivo de estaciones esta vacio.";
     }
 
     return true;
@@ -205,6 +350,7 @@ bool FileManager::loadStations(const QString& filename, StationBST& bst, Graph&
 // Load routes from file
 bool FileManager::loadRoutes(const QString& filename, Graph& graph)
 {
+    MetricsTimer timer(Metrics::LoadRoutes);
     lastError.clear();
 
     // Find the file in multiple locations
@@ -213,84 +359,383 @@ bool FileManager::loadRoutes(const QString& filename, Graph& graph)
     if (filePath.isEmpty())
     {
         lastError = QString("El archivo %1 no existe en ninguna ubicacion conocida.").arg(filename);
-        qDebug() << "Error:" << lastError;
+        LOG_ERROR << "Error:" << lastError;
         return false;
     }
     
+    // Size and time before the read: a write during the load shows up on the next check
+    FileFingerprint fingerprint = changeTracking ? FileFingerprint::stat(filePath) : FileFingerprint();
+    
     QFile file(filePath);
     
     if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
     {
+        forgetFile(filename);
         lastError = QString("No se pudo abrir el archivo %1 para lectura.").arg(filePath);
-        qDebug() << "Error:" << lastError;
+        LOG_ERROR << "Error:" << lastError;
         return false;
     }
     
-    QTextStream in(&file);
-    int lineNumber = 0;
     int routesLoaded = 0;
     
-    qDebug() << "\nCargando rutas desde" << filePath << "...";
+    LOG_DEBUG << "\nCargando rutas desde" << filePath << "...";
     
-    while (!in.atEnd())
+    // A full load replaces the tracked records
+    if (changeTracking)
     {
-        QString line = in.readLine();
-        lineNumber++;
+        routeRecords.clear();
+    }
+    
+    // Fast path: parse the mapped file in place
+    uchar* mapped = nullptr;
+    if (fastLoading && file.size() > 0)
+    {
+        mapped = file.map(0, file.size());
+        if (mapped == nullptr)
+        {
+            LOG_INFO << "[INFO] No se pudo mapear" << filePath << "en memoria. Se usara la lectura por lineas.";
+        }
+    }
+    
+    if (mapped != nullptr)
+    {
+        const char* data = reinterpret_cast<const char*>(mapped);
+        routesLoaded = parseRoutesMapped(data, data + file.size(), graph);
+        if (changeTracking)
+        {
+            fingerprint.hashContent(data, file.size());
+        }
+        file.unmap(mapped);
+    }
+    else
+    {
+        QTextStream in(&file);
+        int lineNumber = 0;
+        Log::RateLimit lineWarnings;
         
+        while (!in.atEnd())
+        {
+            QString line = in.readLine();
+            lineNumber++;
+            
+            // Skip empty lines and comments
+            line = trim(line);
+            if (line.isEmpty() || line.startsWith("#") || line.startsWith("//"))
+            {
+                continue;
+            }
+            
+            // Parse route data: origin, destination, weight
+            QStringList parts = splitLine(line, ",");
+            
+            if (!validateRouteLine(parts))
+            {
+                LOG_WARNING_LIMITED(lineWarnings) << "Advertencia: Linea" << lineNumber << "invalida (formato esperado: origen, destino, peso). Ignorando...";
+                continue;
+            }
+            
+            // Extract values
+            int origin = parts[0].toInt();
+            int destination = parts[1].toInt();
+            double weight = parts[2].toDouble();
+            
+            // Check if stations exist
+            if (!graph.containsStation(origin))
+            {
+                LOG_WARNING_LIMITED(lineWarnings) << "Advertencia: Estacion origen" << origin << "no existe. Ignorando ruta...";
+                continue;
+            }
+            
+            if (!graph.containsStation(destination))
+            {
+                LOG_WARNING_LIMITED(lineWarnings) << "Advertencia: Estacion destino" << destination << "no existe. Ignorando ruta...";
+                continue;
+            }
+            
+            // Add edge to graph
+            graph.addEdge(origin, destination, weight);
+            routesLoaded++;
+            
+            if (changeTracking)
+            {
+                routeRecords.insert(QPair<int, int>(origin, destination), weight);
+            }
+        }
+    }
+    
+    file.close();
+    
+    if (changeTracking)
+    {
+        rememberFingerprint(filename, fingerprint);
+    }
+    
+    LOG_INFO << "Archivo" << filePath << "cargado correctamente. (" << routesLoaded << "rutas)";
+    
+    if (routesLoaded == 0)
+    {
+        LOG_WARNING << "Advertencia: El archivo de rutas esta vacio.";
+    }
+
+    return true;
+}
+
+// Parse stations from a mapped buffer: id, name, x, y
+int FileManager::parseStationsMapped(const char* begin, const char* end, StationBST& bst, Graph& graph)
+{
+    begin = LineScanner::skipBom(begin, end);
+    
+    // One station per line at most
+    int expected = static_cast<int>(qMin<qint64>(LineScanner::countLines(begin, end), INT_MAX / 2));
+    graph.reserve(graph.getStationTable().slotCount() + expected);
+    
+    QList<int> ids;
+    ids.reserve(expected);
+    
+    LineScanner scanner(begin, end);
+    ByteRange line;
+    ByteRange fields[4];
+    Log::RateLimit lineWarnings;
+    
+    while (scanner.nextLine(line))
+    {
         // Skip empty lines and comments
-        line = trim(line);
-        if (line.isEmpty() || line.startsWith("#") || line.startsWith("//"))
+        if (LineScanner::isSkippable(line))
         {
             continue;
         }
         
-        // Parse route data: origin, destination, weight
-        QStringList parts = splitLine(line, ",");
+        // Validate and extract in a single pass
+        int id;
+        double x, y;
+        if (LineScanner::splitFields(line, ',', fields, 4) != 4 ||
+            !LineScanner::parseInt(fields[0], id) ||
+            !LineScanner::parseDouble(fields[2], x) ||
+            !LineScanner::parseDouble(fields[3], y))
+        {
+            LOG_WARNING_LIMITED(lineWarnings) << "Advertencia: Linea" << scanner.lineNumber() << "invalida (formato esperado: id, nombre, x, y). Ignorando...";
+            continue;
+        }
         
-        if (!validateRouteLine(parts))
+        QString name = fields[1].toString();
+        graph.addStation(Station(id, name, x, y));
+        ids.append(id);
+        
+        if (changeTracking)
+        {
+            stationRecords.insert(id, StationRecord{ name, x, y });
+        }
+    }
+    
+    // Index all the new stations in the BST at once
+    bst.insertBulk(ids);
+    
+    return static_cast<int>(ids.size());
+}
+
+// Warning found while parsing a chunk of the routes file (reported after the merge)
+struct RouteWarning
+{
+    enum Kind { InvalidFormat, MissingOrigin, MissingDestination };
+    
+    Kind kind;
+    int line;        // Line number inside the chunk (1-based)
+    int stationId;   // Station that does not exist (missing origin/destination)
+};
+
+// One piece of the routes file, cut at a line boundary, with its own results
+struct RouteChunk
+{
+    const char* begin = nullptr;
+    const char* end = nullptr;
+    int lineCount = 0;
+    QVector<Edge> edges;
+    QList<RouteWarning> warnings;
+};
+
+// Station ID -> table index resolution shared (read only) by all parsing threads
+struct StationResolver
+{
+    const StationTable* table = nullptr;
+    QVector<int> denseLookup;   // Used when the IDs are compact
+    int minId = 0;
+    bool dense = false;
+    
+    int resolve(int id) const
+    {
+        if (dense)
+        {
+            qint64 offset = static_cast<qint64>(id) - minId;
+            return (offset >= 0 && offset < denseLookup.size()) ? denseLookup[offset] : StationTable::InvalidIndex;
+        }
+        return table->indexOf(id);
+    }
+};
+
+// Parse one chunk of routes: origin, destination, weight
+static void parseRouteChunk(RouteChunk& chunk, const StationResolver& resolver)
+{
+    chunk.edges.reserve(static_cast<int>(qMin<qint64>(LineScanner::countLines(chunk.begin, chunk.end), INT_MAX / 2)));
+    
+    LineScanner scanner(chunk.begin, chunk.end);
+    ByteRange line;
+    ByteRange fields[3];
+    
+    while (scanner.nextLine(line))
+    {
+        // Skip empty lines and comments
+        if (LineScanner::isSkippable(line))
         {
-            qDebug() << "Advertencia: Linea" << lineNumber << "invalida (formato esperado: origen, destino, peso). Ignorando...";
             continue;
         }
         
-        // Extract values
-        int origin = parts[0].toInt();
-        int destination = parts[1].toInt();
-        double weight = parts[2].toDouble();
+        int origin, destination;
+        double weight;
+        if (LineScanner::splitFields(line, ',', fields, 3) != 3 ||
+            !LineScanner::parseInt(fields[0], origin) ||
+            !LineScanner::parseInt(fields[1], destination) ||
+            !LineScanner::parseDouble(fields[2], weight))
+        {
+            chunk.warnings.append({ RouteWarning::InvalidFormat, scanner.lineNumber(), 0 });
+            continue;
+        }
         
         // Check if stations exist
-        if (!graph.containsStation(origin))
+        int originIndex = resolver.resolve(origin);
+        if (originIndex == StationTable::InvalidIndex)
         {
-            qDebug() << "Advertencia: Estacion origen" << origin << "no existe. Ignorando ruta...";
+            chunk.warnings.append({ RouteWarning::MissingOrigin, scanner.lineNumber(), origin });
             continue;
         }
         
-        if (!graph.containsStation(destination))
+        int destIndex = resolver.resolve(destination);
+        if (destIndex == StationTable::InvalidIndex)
         {
-            qDebug() << "Advertencia: Estacion destino" << destination << "no existe. Ignorando ruta...";
+            chunk.warnings.append({ RouteWarning::MissingDestination, scanner.lineNumber(), destination });
             continue;
         }
         
-        // Add edge to graph
-        graph.addEdge(origin, destination, weight);
-        routesLoaded++;
+        chunk.edges.append(Edge(originIndex, destIndex, weight));
     }
     
-    file.close();
+    chunk.lineCount = scanner.lineNumber();
+}
+
+// Set the number of threads used to parse large route files (0 = one per core)
+void FileManager::setParseThreads(int threads)
+{
+    parseThreads = qMax(0, threads);
+}
+
+// Get the configured number of parsing threads
+int FileManager::getParseThreads() const
+{
+    return parseThreads;
+}
+
+// Parse routes from a mapped buffer
+// Large files are cut into chunks at line boundaries and parsed in parallel;
+// the results are merged in file order, so edges and warnings come out exactly
+// as with a single thread
+int FileManager::parseRoutesMapped(const char* begin, const char* end, Graph& graph)
+{
+    begin = LineScanner::skipBom(begin, end);
+    
+    // Resolve station IDs with a flat array when the IDs are compact, otherwise with the table hash
+    StationResolver resolver;
+    resolver.table = &graph.getStationTable();
+    resolver.dense = resolver.table->makeDenseLookup(resolver.denseLookup, resolver.minId);
+    
+    // Small files are not worth the threads
+    const qint64 minChunkBytes = 4 * 1024 * 1024;
+    qint64 totalBytes = end - begin;
+    int threads = (parseThreads > 0) ? parseThreads : QThread::idealThreadCount();
+    threads = static_cast<int>(qBound<qint64>(1, totalBytes / minChunkBytes, qMax(1, threads)));
+    
+    // Cut the buffer into chunks that end right after a newline
+    QVector<RouteChunk> chunks(threads);
+    const char* chunkStart = begin;
+    for (int i = 0; i < threads; i++)
+    {
+        const char* chunkEnd = end;
+        if (i < threads - 1)
+        {
+            chunkEnd = chunkStart + (end - chunkStart) / (threads - i);
+            const char* newline = static_cast<const char*>(memchr(chunkEnd, '\n', end - chunkEnd));
+            chunkEnd = (newline != nullptr) ? newline + 1 : end;
+        }
+        
+        chunks[i].begin = chunkStart;
+        chunks[i].end = chunkEnd;
+        chunkStart = chunkEnd;
+    }
     
-    qDebug() << "Archivo" << filePath << "cargado correctamente. (" << routesLoaded << "rutas)";
+    // Parse, one chunk per task (the calling thread takes part)
+    Parallel::runWithWorker(threads, threads, [&chunks, &resolver](int i, int) {
+        if (chunks[i].begin < chunks[i].end)
+        {
+            parseRouteChunk(chunks[i], resolver);
+        }
+    });
     
-    if (routesLoaded == 0)
+    // Merge in file order, turning chunk line numbers into file line numbers
+    int totalEdges = 0;
+    for (const RouteChunk& chunk : chunks)
     {
-        qDebug() << "Advertencia: El archivo de rutas esta vacio.";
+        totalEdges += chunk.edges.size();
     }
-
-    return true;
+    
+    QVector<Edge> edges;
+    edges.reserve(totalEdges);
+    int firstLine = 0;
+    Log::RateLimit lineWarnings;
+    
+    for (const RouteChunk& chunk : chunks)
+    {
+        for (const RouteWarning& warning : chunk.warnings)
+        {
+            int lineNumber = firstLine + warning.line;
+            switch (warning.kind)
+            {
+            case RouteWarning::InvalidFormat:
+                LOG_WARNING_LIMITED(lineWarnings) << "Advertencia: Linea" << lineNumber << "invalida (formato esperado: origen, destino, peso). Ignorando...";
+                break;
+            case RouteWarning::MissingOrigin:
+                LOG_WARNING_LIMITED(lineWarnings) << "Advertencia: Linea" << lineNumber << "- Estacion origen" << warning.stationId << "no existe. Ignorando ruta...";
+                break;
+            case RouteWarning::MissingDestination:
+                LOG_WARNING_LIMITED(lineWarnings) << "Advertencia: Linea" << lineNumber << "- Estacion destino" << warning.stationId << "no existe. Ignorando ruta...";
+                break;
+            }
+        }
+        
+        edges.append(chunk.edges);
+        firstLine += chunk.lineCount;
+    }
+    
+    if (threads > 1)
+    {
+        LOG_INFO << "[INFO] Rutas analizadas en" << threads << "hilos.";
+    }
+    
+    // Remember the routes by station ID for delta reloads
+    if (changeTracking)
+    {
+        routeRecords.reserve(routeRecords.size() + edges.size());
+        for (const Edge& edge : edges)
+        {
+            routeRecords.insert(QPair<int, int>(resolver.table->idAt(edge.from), resolver.table->idAt(edge.to)), edge.weight);
+        }
+    }
+    
+    // Insert all the routes at once
+    return graph.addEdgesBulk(edges);
 }
 
 // Load closures from file
 bool FileManager::loadClosures(const QString& filename, Graph& graph)
 {
+    MetricsTimer timer(Metrics::LoadClosures);
     lastError.clear();
 
     // Find the file in multiple locations
@@ -298,7 +743,7 @@ bool FileManager::loadClosures(const QString& filename, Graph& graph)
     
     if (filePath.isEmpty())
     {
-        qDebug() << "Advertencia: El archivo" << filename << "no existe. No se aplicaran cierres.";
+        LOG_WARNING << "Advertencia: El archivo" << filename << "no existe. No se aplicaran cierres.";
         return false;
     }
     
@@ -306,8 +751,9 @@ bool FileManager::loadClosures(const QString& filename, Graph& graph)
     
     if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
     {
+        forgetFile(filename);
         lastError = QString("No se pudo abrir el archivo %1 para lectura.").arg(filePath);
-        qDebug() << "Error:" << lastError;
+        LOG_ERROR << "Error:" << lastError;
         return false;
     }
     
@@ -315,10 +761,11 @@ bool FileManager::loadClosures(const QString& filename, Graph& graph)
     int lineNumber = 0;
     int closuresApplied = 0;
     
-    qDebug() << "\nCargando cierres desde" << filePath << "...";
+    LOG_DEBUG << "\nCargando cierres desde" << filePath << "...";
     
     // Clear previous closures before loading new ones
     graph.clearClosures();
+    Log::RateLimit lineWarnings;
     
     while (!in.atEnd())
     {
@@ -343,12 +790,12 @@ bool FileManager::loadClosures(const QString& filename, Graph& graph)
             if (graph.containsStation(stationId))
             {
                 graph.closeStation(stationId);
-                qDebug() << "  Estacion" << stationId << "bloqueada (cerrada).";
+                LOG_DEBUG << "  Estacion" << stationId << "bloqueada (cerrada).";
                 closuresApplied++;
             }
             else
             {
-                qDebug() << "Advertencia: Estacion" << stationId << "no existe. Ignorando cierre...";
+                LOG_WARNING_LIMITED(lineWarnings) << "Advertencia: Estacion" << stationId << "no existe. Ignorando cierre...";
             }
         }
         else if (parts.size() >= 3 && parts[0].toUpper() == "RUTA")
@@ -360,23 +807,23 @@ bool FileManager::loadClosures(const QString& filename, Graph& graph)
             if (graph.containsStation(origin) && graph.containsStation(destination))
             {
                 graph.closeRoute(origin, destination);
-                qDebug() << "  Ruta" << origin << "<->" << destination << "bloqueada (cerrada).";
+                LOG_DEBUG << "  Ruta" << origin << "<->" << destination << "bloqueada (cerrada).";
                 closuresApplied++;
             }
             else
             {
-                qDebug() << "Advertencia: Ruta" << origin << "->" << destination << "(estaciones no existen). Ignorando cierre...";
+                LOG_WARNING_LIMITED(lineWarnings) << "Advertencia: Ruta" << origin << "->" << destination << "(estaciones no existen). Ignorando cierre...";
             }
         }
         else
         {
-            qDebug() << "Advertencia: Linea" << lineNumber << "invalida. Formato esperado: ESTACION,id o RUTA,origen,destino";
+            LOG_WARNING_LIMITED(lineWarnings) << "Advertencia: Linea" << lineNumber << "invalida. Formato esperado: ESTACION,id o RUTA,origen,destino";
         }
     }
     
     file.close();
     
-    qDebug() << "Archivo" << filePath << "procesado. (" << closuresApplied << "cierres aplicados)";
+    LOG_INFO << "Archivo" << filePath << "procesado. (" << closuresApplied << "cierres aplicados)";
     return closuresApplied > 0;
 }
 
@@ -385,12 +832,21 @@ bool FileManager::saveStations(const QString& filename, const StationBST& bst)
 {
     lastError.clear();
 
+    const StationTable* table = bst.getStationTable();
+    
+    if (!table)
+    {
+        lastError = "El arbol de estaciones no tiene tabla de estaciones asociada.";
+        LOG_ERROR << "Error:" << lastError;
+        return false;
+    }
+
     QFile file(filename);
     
     if (!file.open(QIODevice::WriteOnly | QIODevice::Text))
     {
         lastError = QString("No se pudo abrir el archivo %1 para escritura.").arg(filename);
-        qDebug() << "Error:" << lastError;
+        LOG_ERROR << "Error:" << lastError;
         return false;
     }
     
@@ -402,19 +858,20 @@ bool FileManager::saveStations(const QString& filename, const StationBST& bst)
     out << "# Generado: " << QDateTime::currentDateTime().toString("yyyy-MM-dd HH:mm:ss") << "\n\n";
     
     // Get stations in order (InOrder traversal)
-    QList<Station> stations = bst.inOrder();
+    QList<int> stations = bst.inOrder();
     
-    for (const Station& station : stations)
+    for (int index : stations)
     {
-        out << station.getId() << ", "
-            << station.getName() << ", "
-            << station.getX() << ", "
-            << station.getY() << "\n";
+        out << table->idAt(index) << ", "
+            << table->nameViewAt(index).toString() << ", "
+            << table->xAt(index) << ", "
+            << table->yAt(index) << "\n";
     }
     
     file.close();
     
-    qDebug() << "Estaciones guardadas en" << filename << "(" << stations.size() << "estaciones)";
+    LOG_INFO << "Estaciones guardadas en" << filename << "(" << stations.size() << "estaciones)";
+    rememberFile(filename, filename);
     return true;
 }
 
@@ -428,7 +885,7 @@ bool FileManager::saveRoutes(const QString& filename, const Graph& graph)
     if (!file.open(QIODevice::WriteOnly | QIODevice::Text))
     {
         lastError = QString("No se pudo abrir el archivo %1 para escritura.").arg(filename);
-        qDebug() << "Error:" << lastError;
+        LOG_ERROR << "Error:" << lastError;
         return false;
     }
     
@@ -440,18 +897,18 @@ bool FileManager::saveRoutes(const QString& filename, const Graph& graph)
     out << "# Generado: " << QDateTime::currentDateTime().toString("yyyy-MM-dd HH:mm:ss") << "\n\n";
     
     // Get all stations
-    QList<Station> stations = graph.getAllStations();
+    const StationTable& table = graph.getStationTable();
     int routeCount = 0;
     
     // Iterate through all stations and their neighbors
-    for (const Station& station : stations)
+    for (int index : table.indices())
     {
-        int stationId = station.getId();
-        QList<QPair<int, double>> neighbors = graph.getNeighbors(stationId);
+        int stationId = table.idAt(index);
+        const QList<QPair<int, double>>& neighbors = graph.neighborsAt(index);
         
         for (const auto& neighbor : neighbors)
         {
-            int neighborId = neighbor.first;
+            int neighborId = table.idAt(neighbor.first);
             double weight = neighbor.second;
             
             // For undirected graphs, only write each edge once (origin < destination)
@@ -467,7 +924,8 @@ bool FileManager::saveRoutes(const QString& filename, const Graph& graph)
     
     file.close();
     
-    qDebug() << "Rutas guardadas en" << filename << "(" << routeCount << "rutas)";
+    LOG_INFO << "Rutas guardadas en" << filename << "(" << routeCount << "rutas)";
+    rememberFile(filename, filename);
     return true;
 }
 
@@ -481,7 +939,7 @@ bool FileManager::saveClosures(const QString& filename, const Graph& graph)
     if (!file.open(QIODevice::WriteOnly | QIODevice::Text))
     {
         lastError = QString("No se pudo abrir el archivo %1 para escritura.").arg(filename);
-        qDebug() << "Error:" << lastError;
+        LOG_ERROR << "Error:" << lastError;
         return false;
     }
     
@@ -527,7 +985,8 @@ bool FileManager::saveClosures(const QString& filename, const Graph& graph)
     
     file.close();
     
-    qDebug() << "Cierres guardados en" << filename << "(" << closureCount << "cierres)";
+    LOG_INFO << "Cierres guardados en" << filename << "(" << closureCount << "cierres)";
+    rememberFile(filename, filename);
     return true;
 }
 
@@ -541,7 +1000,7 @@ bool FileManager::exportReport(const QString& filename, const QString& content)
     if (!file.open(QIODevice::WriteOnly | QIODevice::Text))
     {
         lastError = QString("No se pudo crear el archivo de reporte %1.").arg(filename);
-        qDebug() << "Error:" << lastError;
+        LOG_ERROR << "Error:" << lastError;
         return false;
     }
     
@@ -565,7 +1024,8 @@ bool FileManager::exportReport(const QString& filename, const QString& content)
     
     file.close();
     
-    qDebug() << "Reporte exportado exitosamente a:" << filename;
+    LOG_INFO << "Reporte exportado exitosamente a:" << filename;
+    rememberFile(filename, filename);
     return true;
 }
 
@@ -580,17 +1040,21 @@ bool FileManager::loadAccidents(Graph& graph, const QString& filename)
     if (filePath.isEmpty())
     {
         // File not found, but this is not necessarily an error
-        qDebug() << "[INFO] No se encontro archivo de accidentes:" << filename;
+        LOG_INFO << "[INFO] No se encontro archivo de accidentes:" << filename;
         return false;
     }
     
-    qDebug() << "[INFO] Cargando accidentes desde:" << filePath;
+    LOG_INFO << "[INFO] Cargando accidentes desde:" << filePath;
     
     // Delegate to Graph's loadAccidents method
     bool result = graph.loadAccidents(filePath);
     
     if (!result)
     {
+        if (!QFileInfo::exists(filePath))
+        {
+            forgetFile(filename);
+        }
         lastError = QString("No se pudieron cargar accidentes desde %1").arg(filename);
     }
     
@@ -607,7 +1071,7 @@ bool FileManager::saveAccidents(const QString& filename, const Graph& graph)
     if (!file.open(QIODevice::WriteOnly | QIODevice::Text))
     {
         lastError = QString("No se pudo abrir el archivo %1 para escritura.").arg(filename);
-        qDebug() << "Error:" << lastError;
+        LOG_ERROR << "Error:" << lastError;
         return false;
     }
     
@@ -633,7 +1097,8 @@ bool FileManager::saveAccidents(const QString& filename, const Graph& graph)
     {
         out << "# No hay accidentes activos\n";
         file.close();
-        qDebug() << "Archivo de accidentes guardado (sin accidentes activos):" << filename;
+        LOG_INFO << "Archivo de accidentes guardado (sin accidentes activos):" << filename;
+        rememberFile(filename, filename);
         return true;
     }
     
@@ -657,20 +1122,601 @@ bool FileManager::saveAccidents(const QString& filename, const Graph& graph)
         
         processedRoutes.insert(route);
         
-        // Calculate increment percentage from current and original weights
-        double currentWeight = graph.getEdgeWeight(origin, dest);
-        // Note: We can't retrieve the exact percentage used, so we calculate it
-        // This is a limitation - in a future version, we could store the percentage
-        // For now, we'll note this route has an accident but use a placeholder
+        // Increment percentage stored by the graph when the accident was applied
+        double increment = graph.getAccidentIncrement(origin, dest);
         
-        out << origin << "," << dest << ",30\n"; // Default 30% - user should adjust
+        out << origin << "," << dest << "," << QString::number(increment, 'g', 10) << "\n";
         accidentCount++;
     }
     
     file.close();
     
-    qDebug() << "Accidentes guardados en" << filename << "(" << accidentCount << "accidentes)";
-    qDebug() << "NOTA: Los porcentajes se guardaron como 30% por defecto. Ajuste manualmente si es necesario.";
+    LOG_INFO << "Accidentes guardados en" << filename << "(" << accidentCount << "accidentes)";
+    
+    rememberFile(filename, filename);
+    return true;
+}
+
+// Save a binary snapshot of the network
+bool FileManager::saveSnapshot(const QString& filename, const Graph& graph)
+{
+    lastError.clear();
+    
+    NetworkSnapshot snapshot;
+    if (!snapshot.save(filename, graph))
+    {
+        lastError = snapshot.getLastError();
+        return false;
+    }
+    
+    rememberFile(filename, filename);
+    return true;
+}
+
+// Load a binary snapshot (replaces the current graph and BST contents)
+bool FileManager::loadSnapshot(const QString& filename, StationBST& bst, Graph& graph)
+{
+    MetricsTimer timer(Metrics::LoadSnapshot);
+    lastError.clear();
+    
+    QString filePath = findFile(filename);
+    
+    if (filePath.isEmpty())
+    {
+        lastError = QString("El archivo %1 no existe en ninguna ubicacion conocida.").arg(filename);
+        LOG_ERROR << "Error:" << lastError;
+        return false;
+    }
+    
+    NetworkSnapshot snapshot;
+    if (!snapshot.load(filePath, graph, bst))
+    {
+        forgetFile(filename);
+        lastError = snapshot.getLastError();
+        return false;
+    }
+    
+    // Records of an earlier load no longer describe the network; the next delta reload
+    // diffs the text files against the snapshot network instead (see reloadChanged)
+    fingerprints.clear();
+    stationRecords.clear();
+    routeRecords.clear();
+    
+    return true;
+}
+
+// Check if a snapshot exists and is not older than any of its text sources
+bool FileManager::isSnapshotCurrent(const QString& snapshotFile, const QStringList& sourceFiles) const
+{
+    QString snapshotPath = findFile(snapshotFile);
+    if (snapshotPath.isEmpty())
+    {
+        return false;
+    }
+    
+    QDateTime snapshotTime = QFileInfo(snapshotPath).lastModified();
+    
+    for (const QString& source : sourceFiles)
+    {
+        QString sourcePath = findFile(source);
+        if (!sourcePath.isEmpty() && QFileInfo(sourcePath).lastModified() > snapshotTime)
+        {
+            LOG_INFO << "[INFO] La instantanea" << snapshotPath << "es anterior a" << sourcePath;
+            return false;
+        }
+    }
+    
+    return true;
+}
+
+// Snapshot path in the same directory as the stations file
+QString FileManager::snapshotPathFor(const QString& stationsFile) const
+{
+    return siblingPath(stationsFile, "red.upsnap");
+}
+
+// Save the hub labels of the current network
+bool FileManager::saveHubLabels(const QString& filename, const HubLabelIndex& index)
+{
+    lastError.clear();
+    
+    if (!index.save(filename))
+    {
+        lastError = index.getLastError();
+        return false;
+    }
+    
+    rememberFile(filename, filename);
+    return true;
+}
+
+// Load hub labels (rejected if they were built for another network)
+bool FileManager::loadHubLabels(const QString& filename, const Graph& graph, HubLabelIndex& index)
+{
+    lastError.clear();
+    
+    QString filePath = findFile(filename);
+    
+    if (filePath.isEmpty())
+    {
+        lastError = QString("El archivo %1 no existe en ninguna ubicacion conocida.").arg(filename);
+        LOG_ERROR << "Error:" << lastError;
+        return false;
+    }
+    
+    if (!index.load(filePath, graph))
+    {
+        forgetFile(filename);
+        lastError = index.getLastError();
+        return false;
+    }
+    
+    return true;
+}
+
+// Hub label path in the same directory as the stations file
+QString FileManager::hubLabelsPathFor(const QString& stationsFile) const
+{
+    return siblingPath(stationsFile, "red.uphubs");
+}
+
+// Path of another file in the same directory as a data file
+QString FileManager::siblingPath(const QString& dataFile, const QString& name) const
+{
+    QString dataPath = findFile(dataFile);
+    if (dataPath.isEmpty())
+    {
+        dataPath = dataFile;
+    }
+    
+    return QFileInfo(dataPath).path() + "/" + name;
+}
+
+// Enable or disable change tracking for delta reloads
+void FileManager::setChangeTracking(bool enabled)
+{
+    changeTracking = enabled;
+    
+    if (!enabled)
+    {
+        fingerprints.clear();
+        stationRecords.clear();
+        routeRecords.clear();
+    }
+}
+
+// Check if change tracking is enabled
+bool FileManager::isChangeTracking() const
+{
+    return changeTracking;
+}
+
+// Store the fingerprint taken while a file was loaded (without block hashes the next
+// metadata change is treated as a content change)
+void FileManager::rememberFingerprint(const QString& filename, const FileFingerprint& fingerprint)
+{
+    fingerprints.insert(filename, fingerprint);
+}
+
+// Check if a tracked file was written since it was last loaded (size and time only, no read)
+bool FileManager::detectTouch(const QString& filename, bool& touched)
+{
+    touched = false;
+    
+    QString filePath = findFile(filename);
+    
+    if (filePath.isEmpty())
+    {
+        lastError = QString("El archivo %1 no existe en ninguna ubicacion conocida.").arg(filename);
+        LOG_ERROR << "Error:" << lastError;
+        return false;
+    }
+    
+    touched = !fingerprints.value(filename).sameMetadata(FileFingerprint::stat(filePath));
+    return true;
+}
+
+// Compare the fingerprint taken while a touched file was read again with the one of the last load
+void FileManager::compareContent(const QString& filename, const FileFingerprint& current, bool& changed, int& changedBlocks)
+{
+    auto previous = fingerprints.constFind(filename);
+    if (previous == fingerprints.constEnd())
+    {
+        changed = true;
+        changedBlocks = -1;
+        return;
+    }
+    
+    changedBlocks = current.changedBlocks(previous.value());
+    changed = changedBlocks != 0 || current.getSize() != previous.value().getSize();
+    
+    // Only touched: keep the new time so the next check is cheap again
+    if (!changed)
+    {
+        fingerprints.insert(filename, current);
+    }
+}
+
+// Station records of the network in memory (first delta reload after a snapshot load)
+void FileManager::seedStationRecords(const Graph& graph)
+{
+    const StationTable& table = graph.getStationTable();
+    
+    stationRecords.clear();
+    stationRecords.reserve(table.size());
+    for (int index : table.indices())
+    {
+        stationRecords.insert(table.idAt(index), StationRecord{ table.nameAt(index), table.xAt(index), table.yAt(index) });
+    }
+}
+
+// Route records of the network in memory, keyed the way the routes file lists them.
+// Undirected routes are kept once, and accidents are left out of the weights.
+void FileManager::seedRouteRecords(const Graph& graph, const QHash<QPair<int, int>, double>& fileRoutes)
+{
+    const StationTable& table = graph.getStationTable();
+    QHash<QPair<int, int>, double> originalWeights = graph.getOriginalWeights();
+    bool undirected = !graph.isDirected();
+    
+    routeRecords.clear();
+    routeRecords.reserve(fileRoutes.size());
+    
+    for (int fromIndex : table.indices())
+    {
+        int from = table.idAt(fromIndex);
+        
+        for (const auto& neighbor : graph.neighborsAt(fromIndex))
+        {
+            int to = table.idAt(neighbor.first);
+            QPair<int, int> key(from, to);
+            QPair<int, int> reverseKey(to, from);
+            
+            if (undirected)
+            {
+                // Already seen from the other end
+                if (routeRecords.contains(key) || routeRecords.contains(reverseKey))
+                {
+                    continue;
+                }
+                if (!fileRoutes.contains(key) && fileRoutes.contains(reverseKey))
+                {
+                    key = reverseKey;
+                }
+            }
+            
+            double weight = originalWeights.value(key, originalWeights.value(QPair<int, int>(key.second, key.first), neighbor.second));
+            routeRecords.insert(key, weight);
+        }
+    }
+}
+
+// Read all station records of a file (nothing is applied)
+bool FileManager::readStationRecords(const QString& filename, QHash<int, StationRecord>& records,
+                                     FileFingerprint& fingerprint)
+{
+    QString filePath = findFile(filename);
+    fingerprint = FileFingerprint::stat(filePath);
+    QFile file(filePath);
+    
+    if (filePath.isEmpty() || !file.open(QIODevice::ReadOnly))
+    {
+        forgetFile(filename);
+        lastError = QString("No se pudo abrir el archivo %1 para lectura.").arg(filename);
+        LOG_ERROR << "Error:" << lastError;
+        return false;
+    }
+    
+    // Map the file, or read it whole if mapping is not available
+    QByteArray contents;
+    uchar* mapped = file.size() > 0 ? file.map(0, file.size()) : nullptr;
+    if (mapped == nullptr)
+    {
+        contents = file.readAll();
+    }
+    
+    const char* begin = mapped ? reinterpret_cast<const char*>(mapped) : contents.constData();
+    const char* end = begin + (mapped ? file.size() : contents.size());
+    fingerprint.hashContent(begin, end - begin);
+    begin = LineScanner::skipBom(begin, end);
+    
+    LineScanner scanner(begin, end);
+    ByteRange line;
+    ByteRange fields[4];
+    Log::RateLimit lineWarnings;
+    
+    while (scanner.nextLine(line))
+    {
+        if (LineScanner::isSkippable(line))
+        {
+            continue;
+        }
+        
+        int id;
+        double x, y;
+        if (LineScanner::splitFields(line, ',', fields, 4) != 4 ||
+            !LineScanner::parseInt(fields[0], id) ||
+            !LineScanner::parseDouble(fields[2], x) ||
+            !LineScanner::parseDouble(fields[3], y))
+        {
+            LOG_WARNING_LIMITED(lineWarnings) << "Advertencia: Linea" << scanner.lineNumber() << "invalida (formato esperado: id, nombre, x, y). Ignorando...";
+            continue;
+        }
+        
+        records.insert(id, StationRecord{ fields[1].toString(), x, y });
+    }
+    
+    if (mapped != nullptr)
+    {
+        file.unmap(mapped);
+    }
+    file.close();
+    
+    return true;
+}
+
+// Read all route records of a file (nothing is applied)
+bool FileManager::readRouteRecords(const QString& filename, QHash<QPair<int, int>, double>& records,
+                                   FileFingerprint& fingerprint)
+{
+    QString filePath = findFile(filename);
+    fingerprint = FileFingerprint::stat(filePath);
+    QFile file(filePath);
+    
+    if (filePath.isEmpty() || !file.open(QIODevice::ReadOnly))
+    {
+        forgetFile(filename);
+        lastError = QString("No se pudo abrir el archivo %1 para lectura.").arg(filename);
+        LOG_ERROR << "Error:" << lastError;
+        return false;
+    }
+    
+    // Map the file, or read it whole if mapping is not available
+    QByteArray contents;
+    uchar* mapped = file.size() > 0 ? file.map(0, file.size()) : nullptr;
+    if (mapped == nullptr)
+    {
+        contents = file.readAll();
+    }
+    
+    const char* begin = mapped ? reinterpret_cast<const char*>(mapped) : contents.constData();
+    const char* end = begin + (mapped ? file.size() : contents.size());
+    fingerprint.hashContent(begin, end - begin);
+    begin = LineScanner::skipBom(begin, end);
+    
+    records.reserve(static_cast<int>(qMin<qint64>(LineScanner::countLines(begin, end), INT_MAX / 2)));
+    
+    LineScanner scanner(begin, end);
+    ByteRange line;
+    ByteRange fields[3];
+    Log::RateLimit lineWarnings;
+    
+    while (scanner.nextLine(line))
+    {
+        if (LineScanner::isSkippable(line))
+        {
+            continue;
+        }
+        
+        int origin, destination;
+        double weight;
+        if (LineScanner::splitFields(line, ',', fields, 3) != 3 ||
+            !LineScanner::parseInt(fields[0], origin) ||
+            !LineScanner::parseInt(fields[1], destination) ||
+            !LineScanner::parseDouble(fields[2], weight))
+        {
+            LOG_WARNING_LIMITED(lineWarnings) << "Advertencia: Linea" << scanner.lineNumber() << "invalida (formato esperado: origen, destino, peso). Ignorando...";
+            continue;
+        }
+        
+        records.insert(QPair<int, int>(origin, destination), weight);
+    }
+    
+    if (mapped != nullptr)
+    {
+        file.unmap(mapped);
+    }
+    file.close();
+    
+    return true;
+}
+
+// Apply only what changed in the station and route files since the last load
+bool FileManager::reloadChanged(const QString& stationsFile, const QString& routesFile,
+                                StationBST& bst, Graph& graph, DeltaSummary& summary)
+{
+    lastError.clear();
+    summary = DeltaSummary();
+    
+    if (!changeTracking)
+    {
+        lastError = "El seguimiento de cambios esta desactivado.";
+        LOG_ERROR << "Error:" << lastError;
+        return false;
+    }
+    
+    // No fingerprints after a snapshot load: the files are diffed against the network in memory
+    bool seeding = !fingerprints.contains(stationsFile) || !fingerprints.contains(routesFile);
+    if (seeding && graph.isEmpty())
+    {
+        lastError = "No hay una carga completa previa con seguimiento de cambios.";
+        LOG_ERROR << "Error:" << lastError;
+        return false;
+    }
+    
+    // Detect writes (no read when size and time are unchanged)
+    bool stationsTouched = seeding;
+    bool routesTouched = seeding;
+    if (!seeding && (!detectTouch(stationsFile, stationsTouched) || !detectTouch(routesFile, routesTouched)))
+    {
+        return false;
+    }
+    
+    if (!stationsTouched && !routesTouched)
+    {
+        LOG_INFO << "[INFO] Sin cambios en" << stationsFile << "ni en" << routesFile;
+        return true;
+    }
+    
+    if (seeding)
+    {
+        seedStationRecords(graph);
+    }
+    
+    // Read the new records before touching the graph (the fingerprints are taken in the same pass)
+    QHash<int, StationRecord> newStations;
+    FileFingerprint stationsFingerprint;
+    if (stationsTouched && !readStationRecords(stationsFile, newStations, stationsFingerprint))
+    {
+        return false;
+    }
+    
+    // New stations may enable routes skipped before, so the routes are needed for them too
+    bool stationsAppear = false;
+    for (auto it = newStations.constBegin(); it != newStations.constEnd() && !stationsAppear; ++it)
+    {
+        stationsAppear = !stationRecords.contains(it.key());
+    }
+    
+    QHash<QPair<int, int>, double> newRoutes;
+    FileFingerprint routesFingerprint;
+    if ((routesTouched || stationsAppear) && !readRouteRecords(routesFile, newRoutes, routesFingerprint))
+    {
+        return false;
+    }
+    
+    if (seeding)
+    {
+        seedRouteRecords(graph, newRoutes);
+    }
+    
+    int stationBlocks = 0;
+    int routeBlocks = 0;
+    if (stationsTouched)
+    {
+        compareContent(stationsFile, stationsFingerprint, summary.stationsFileChanged, stationBlocks);
+    }
+    if (routesTouched)
+    {
+        compareContent(routesFile, routesFingerprint, summary.routesFileChanged, routeBlocks);
+    }
+    summary.changedBlocks = qMax(0, stationBlocks) + qMax(0, routeBlocks);
+    
+    if (!summary.stationsFileChanged && !summary.routesFileChanged)
+    {
+        LOG_INFO << "[INFO] Sin cambios en" << stationsFile << "ni en" << routesFile;
+        return true;
+    }
+    
+    // Stations added or updated
+    QSet<int> removedStations;
+    if (summary.stationsFileChanged)
+    {
+        for (auto it = newStations.constBegin(); it != newStations.constEnd(); ++it)
+        {
+            const StationRecord& record = it.value();
+            auto previous = stationRecords.constFind(it.key());
+            
+            if (previous == stationRecords.constEnd())
+            {
+                graph.addStation(Station(it.key(), record.name, record.x, record.y));
+                bst.insert(it.key());
+                summary.stationsAdded++;
+            }
+            else if (!(previous.value() == record))
+            {
+                graph.updateStation(Station(it.key(), record.name, record.x, record.y));
+                summary.stationsUpdated++;
+            }
+        }
+        
+        for (auto it = stationRecords.constBegin(); it != stationRecords.constEnd(); ++it)
+        {
+            if (!newStations.contains(it.key()))
+            {
+                removedStations.insert(it.key());
+            }
+        }
+    }
+    
+    // Routes: diff when the file changed, or when new stations may enable routes skipped before
+    if (summary.routesFileChanged || summary.stationsAdded > 0)
+    {
+        QHash<QPair<int, int>, double> appliedRoutes;
+        appliedRoutes.reserve(newRoutes.size());
+        
+        for (auto it = newRoutes.constBegin(); it != newRoutes.constEnd(); ++it)
+        {
+            int origin = it.key().first;
+            int destination = it.key().second;
+            
+            // Routes of stations that are about to be removed go with them
+            if (removedStations.contains(origin) || removedStations.contains(destination) ||
+                !graph.containsStation(origin) || !graph.containsStation(destination))
+            {
+                continue;
+            }
+            
+            auto previous = routeRecords.constFind(it.key());
+            if (previous == routeRecords.constEnd())
+            {
+                graph.addEdge(origin, destination, it.value());
+                summary.routesAdded++;
+            }
+            else if (previous.value() != it.value())
+            {
+                graph.setEdgeWeight(origin, destination, it.value());
+                summary.routesReweighted++;
+            }
+            appliedRoutes.insert(it.key(), it.value());
+        }
+        
+        for (auto it = routeRecords.constBegin(); it != routeRecords.constEnd(); ++it)
+        {
+            if (!appliedRoutes.contains(it.key()))
+            {
+                graph.removeEdge(it.key().first, it.key().second);
+                summary.routesRemoved++;
+            }
+        }
+        
+        routeRecords = appliedRoutes;
+        rememberFingerprint(routesFile, routesFingerprint);
+    }
+    
+    // Stations removed last (their remaining routes are removed with them)
+    for (int id : removedStations)
+    {
+        bst.remove(id);
+        graph.removeStation(id);
+        summary.stationsRemoved++;
+    }
+    
+    if (summary.stationsFileChanged)
+    {
+        stationRecords = newStations;
+        rememberFingerprint(stationsFile, stationsFingerprint);
+        
+        // Routes of removed stations are no longer applied
+        if (!removedStations.isEmpty())
+        {
+            for (auto it = routeRecords.begin(); it != routeRecords.end();)
+            {
+                if (removedStations.contains(it.key().first) || removedStations.contains(it.key().second))
+                {
+                    it = routeRecords.erase(it);
+                }
+                else
+                {
+                    ++it;
+                }
+            }
+        }
+    }
+    
+    LOG_INFO << "[INFO] Recarga incremental:" << summary.stationsAdded << "estaciones nuevas,"
+             << summary.stationsUpdated << "actualizadas," << summary.stationsRemoved << "eliminadas;"
+             << summary.routesAdded << "rutas nuevas," << summary.routesReweighted << "con peso nuevo,"
+             << summary.routesRemoved << "eliminadas.";
     
     return true;
 }
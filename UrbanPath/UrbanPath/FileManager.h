@@ -1,7 +1,11 @@
 #pragma once
 
 #include "Station.h"
+#include "FileFingerprint.h"
 #include <QString>
+#include <QStringList>
+#include <QHash>
+#include <QSet>
 #include <QFile>
 #include <QTextStream>
 
@@ -10,6 +14,40 @@ using namespace std;
 // Forward declarations to avoid circular dependencies
 class Graph;
 class StationBST;
+class HubLabelIndex;
+
+// Station as read from estaciones.txt (kept to diff reloads)
+struct StationRecord
+{
+    QString name;
+    double x;
+    double y;
+    
+    bool operator==(const StationRecord& other) const
+    {
+        return name == other.name && x == other.x && y == other.y;
+    }
+};
+
+// What a delta reload changed
+struct DeltaSummary
+{
+    bool stationsFileChanged = false;
+    bool routesFileChanged = false;
+    int changedBlocks = 0;          // Changed file blocks (both files)
+    int stationsAdded = 0;
+    int stationsUpdated = 0;
+    int stationsRemoved = 0;
+    int routesAdded = 0;
+    int routesReweighted = 0;
+    int routesRemoved = 0;
+    
+    bool hasChanges() const
+    {
+        return stationsAdded + stationsUpdated + stationsRemoved +
+               routesAdded + routesReweighted + routesRemoved > 0;
+    }
+};
 
 class FileManager
 {
@@ -30,6 +68,41 @@ public:
     bool saveAccidents(const QString& filename, const Graph& graph);
     bool exportReport(const QString& filename, const QString& content);
     
+    // Binary snapshot of the whole network (stations, routes, closures, accidents)
+    bool saveSnapshot(const QString& filename, const Graph& graph);
+    bool loadSnapshot(const QString& filename, StationBST& bst, Graph& graph);
+    bool isSnapshotCurrent(const QString& snapshotFile, const QStringList& sourceFiles) const;
+    QString snapshotPathFor(const QString& stationsFile) const;   // Next to the stations file
+    QString siblingPath(const QString& dataFile, const QString& name) const;
+    
+    // Hub labels for distance queries (only valid for the network they were built on)
+    bool saveHubLabels(const QString& filename, const HubLabelIndex& index);
+    bool loadHubLabels(const QString& filename, const Graph& graph, HubLabelIndex& index);
+    QString hubLabelsPathFor(const QString& stationsFile) const;  // Next to the stations file
+    
+    // Fast loading: memory-map the data files and parse them in place (on by default)
+    void setFastLoading(bool enabled);
+    bool isFastLoading() const;
+    
+    // Threads used to parse large route files in fast mode (0 = one per core)
+    void setParseThreads(int threads);
+    int getParseThreads() const;
+    
+    // Data file locations: relative names are searched under these roots, in order.
+    // The first root that holds a file is tried first for the next ones, and resolved
+    // paths are cached until a file fails to open or the roots change.
+    void setDataRoots(const QStringList& roots);
+    QStringList getDataRoots() const;
+    void clearPathCache();
+    
+    // Change tracking: full loads remember file fingerprints and records so that
+    // reloadChanged() can apply only the differences (closures and accidents are kept).
+    // After a snapshot load the first reload diffs the files against the network in memory.
+    void setChangeTracking(bool enabled);
+    bool isChangeTracking() const;
+    bool reloadChanged(const QString& stationsFile, const QString& routesFile,
+                       StationBST& bst, Graph& graph, DeltaSummary& summary);
+    
     // Utility methods
     bool fileExists(const QString& path) const;
     void clearFile(const QString& filename);
@@ -37,6 +110,8 @@ public:
     
 private:
     QString lastError;
+    bool fastLoading = true;
+    int parseThreads = 0;
     
     // Helper methods for parsing
     QString trim(const QString& str) const;
@@ -44,7 +119,37 @@ private:
     bool validateStationLine(const QStringList& parts) const;
     bool validateRouteLine(const QStringList& parts) const;
     
+    // Fast loading over a mapped buffer (return the number of stations/routes loaded)
+    int parseStationsMapped(const char* begin, const char* end, StationBST& bst, Graph& graph);
+    int parseRoutesMapped(const char* begin, const char* end, Graph& graph);
+    
     // Find file in multiple locations
     QString findFile(const QString& filename) const;
+    
+    // Path cache maintenance
+    void forgetFile(const QString& filename) const;                         // After a failed open
+    void rememberFile(const QString& filename, const QString& path) const;  // After a successful write
+    
+    // Delta reload helpers
+    void rememberFingerprint(const QString& filename, const FileFingerprint& fingerprint);
+    bool detectTouch(const QString& filename, bool& touched);
+    void compareContent(const QString& filename, const FileFingerprint& current, bool& changed, int& changedBlocks);
+    void seedStationRecords(const Graph& graph);
+    void seedRouteRecords(const Graph& graph, const QHash<QPair<int, int>, double>& fileRoutes);
+    bool readStationRecords(const QString& filename, QHash<int, StationRecord>& records, FileFingerprint& fingerprint);
+    bool readRouteRecords(const QString& filename, QHash<QPair<int, int>, double>& records, FileFingerprint& fingerprint);
+    
+    // Change tracking state (records of the last full or delta load)
+    bool changeTracking = false;
+    QHash<QString, FileFingerprint> fingerprints;        // Requested name -> fingerprint
+    QHash<int, StationRecord> stationRecords;           // Station ID -> record
+    QHash<QPair<int, int>, double> routeRecords;        // (origin, destination) -> weight, applied routes only
+    
+    // Search roots and resolution cache
+    QStringList dataRoots = { "", "../", "../../", "../../../", "../../../../", "data/", "../data/", "../../data/" };
+    mutable QString resolvedRoot;                  // Root where the last file was found
+    mutable bool rootResolved = false;
+    mutable QHash<QString, QString> resolvedFiles; // Requested name -> path
+    mutable QSet<QString> missingFiles;            // Names not found under any root
 };
 
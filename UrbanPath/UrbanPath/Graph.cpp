@@ -1,14 +1,26 @@
 ﻿#include "Graph.h"
+#include "JobToken.h"
+#include "Log.h"
 #include <algorithm>
 #include <limits>
+#include <queue>
+#include <vector>
+#include <functional>
+#include <utility>
 #include <QFile>
 #include <QTextStream>
 #include <QIODevice>
 
 const double INF = std::numeric_limits<double>::infinity();
 
+// Loop iterations between two checks of a job token (cheap loops)
+const int TokenCheckInterval = 1024;
+
+// Network changes kept for the shortest-path caches (older ones are dropped in one go)
+const int MaxLoggedChanges = 4096;
+
 // Constructor
-Graph::Graph(bool isDirected) : directed(isDirected)
+Graph::Graph(bool isDirected) : directed(isDirected), version(0), changeLogStart(0)
 {
 }
 
@@ -17,154 +29,331 @@ void Graph::addStation(const Station& station)
 {
     int id = station.getId();
     
-    if (stations.contains(id))
+    if (stationTable.contains(id))
     {
-        qDebug() << "Advertencia: La estacion con ID" << id << "ya existe. Se actualizara.";
+        static Log::RateLimit duplicateWarnings;
+        LOG_WARNING_LIMITED(duplicateWarnings) << "Advertencia: La estacion con ID" << id << "ya existe. Se actualizara.";
     }
     
-    stations[id] = station;
+    int index = stationTable.add(station);
     
-    // Initialize adjacency list if not exists
-    if (!adjList.contains(id))
+    // Initialize adjacency list and closure bit for new slots (reused slots were emptied by removeStation)
+    if (index >= adjList.size())
     {
-        adjList[id] = QList<QPair<int, double>>();
+        adjList.resize(index + 1);
+        closedStations.resize(index + 1);
     }
 }
 
+// Reserve room for a bulk load of stations
+void Graph::reserve(int stations, int nameChars)
+{
+    stationTable.reserve(stations, nameChars);
+    adjList.reserve(stations);
+}
+
 // Remove a station from the graph
 void Graph::removeStation(int id)
 {
-    if (!stations.contains(id))
+    int index = stationTable.indexOf(id);
+    
+    if (index == StationTable::InvalidIndex)
     {
-        qDebug() << "Error: La estacion con ID" << id << "no existe.";
+        LOG_ERROR << "Error: La estacion con ID" << id << "no existe.";
         return;
     }
     
-    // Remove station
-    stations.remove(id);
-    
     // Remove all edges connected to this station
-    adjList.remove(id);
+    QList<QPair<int, double>> outgoing = adjList[index];
+    adjList[index].clear();
     
     // Eliminar aristas pointing to this station
-    for (auto& neighbors : adjList)
+    if (directed)
+    {
+        // Any station may point here
+        for (auto& neighbors : adjList)
+        {
+            for (int i = 0; i < neighbors.size(); i++)
+            {
+                if (neighbors[i].first == index)
+                {
+                    neighbors.removeAt(i);
+                    i--;
+                }
+            }
+        }
+    }
+    else
     {
-        for (int i = 0; i < neighbors.size(); i++)
+        // Only the neighbors hold reverse edges
+        for (const auto& neighbor : outgoing)
         {
-            if (neighbors[i].first == id)
+            QList<QPair<int, double>>& neighbors = adjList[neighbor.first];
+            for (int i = 0; i < neighbors.size(); i++)
             {
-                neighbors.removeAt(i);
-                i--;
+                if (neighbors[i].first == index)
+                {
+                    neighbors.removeAt(i);
+                    i--;
+                }
             }
         }
     }
+    
+    // Remove station (its slot stays reserved)
+    closedStations.clearBit(index);
+    stationTable.remove(id);
+    recordChange(NetworkChange::Reset);
+}
+
+// Update name and position of an existing station
+bool Graph::updateStation(const Station& station)
+{
+    if (!stationTable.contains(station.getId()))
+    {
+        return false;
+    }
+    
+    stationTable.add(station);
+    return true;
 }
 
 // Check if station exists
 bool Graph::containsStation(int id) const
 {
-    return stations.contains(id);
+    return stationTable.contains(id);
 }
 
 // Get station by ID
-Station* Graph::getStation(int id)
+Station Graph::getStation(int id) const
 {
-    if (stations.contains(id))
+    int index = stationTable.indexOf(id);
+    if (index != StationTable::InvalidIndex)
     {
-        return &stations[id];
+        return stationTable.stationAt(index);
     }
-    return nullptr;
+    return Station();
 }
 
 // Get all stations
 QList<Station> Graph::getAllStations() const
 {
-    return stations.values();
+    QList<Station> result;
+    result.reserve(stationTable.size());
+    
+    for (int index : stationTable.indices())
+    {
+        result.append(stationTable.stationAt(index));
+    }
+    
+    return result;
 }
 
 // Get station count
 int Graph::getStationCount() const
 {
-    return stations.size();
+    return stationTable.size();
+}
+
+// Get the station table
+const StationTable& Graph::getStationTable() const
+{
+    return stationTable;
+}
+
+// Get the index of a station ID
+int Graph::indexOf(int id) const
+{
+    return stationTable.indexOf(id);
+}
+
+// Check if the graph is directed
+bool Graph::isDirected() const
+{
+    return directed;
+}
+
+// Replace the whole network with ready-made columns and adjacency lists
+void Graph::assignNetwork(StationTable table, QVector<QList<QPair<int, double>>> adjacency)
+{
+    stationTable = std::move(table);
+    adjList = std::move(adjacency);
+    adjList.resize(stationTable.slotCount());
+    
+    closedStations = QBitArray(stationTable.slotCount());
+    closedRoutes.clear();
+    closedRouteKeys.clear();
+    affectedRoutes.clear();
+    originalWeights.clear();
+    accidentIncrements.clear();
+    recordChange(NetworkChange::Reset);
 }
 
 // Add an edge between two stations
 void Graph::addEdge(int origin, int destination, double weight)
 {
-    if (!stations.contains(origin))
+    int originIndex = stationTable.indexOf(origin);
+    int destIndex = stationTable.indexOf(destination);
+    
+    if (originIndex == StationTable::InvalidIndex)
     {
-        qDebug() << "Error: Estacion origen" << origin << "no existe.";
+        LOG_ERROR << "Error: Estacion origen" << origin << "no existe.";
         return;
     }
     
-    if (!stations.contains(destination))
+    if (destIndex == StationTable::InvalidIndex)
     {
-        qDebug() << "Error: Estacion destino" << destination << "no existe.";
+        LOG_ERROR << "Error: Estacion destino" << destination << "no existe.";
         return;
     }
     
     if (weight < 0)
     {
-        qDebug() << "Advertencia: Peso negativo detectado. Se usara valor absoluto.";
+        LOG_WARNING << "Advertencia: Peso negativo detectado. Se usara valor absoluto.";
         weight = qAbs(weight);
     }
     
     // Agregar arista from origin to destination
-    adjList[origin].append(QPair<int, double>(destination, weight));
+    adjList[originIndex].append(QPair<int, double>(destIndex, weight));
     
     // If undirected, add reverse edge
     if (!directed)
     {
-        adjList[destination].append(QPair<int, double>(origin, weight));
+        adjList[destIndex].append(QPair<int, double>(originIndex, weight));
     }
+    
+    recordChange(NetworkChange::EdgeChanged, originIndex, destIndex, weight, INF);
+}
+
+// Add many edges at once (from/to are station indices)
+// Each adjacency list is sized once, so large route files don't keep reallocating
+int Graph::addEdgesBulk(const QVector<Edge>& edges)
+{
+    int slotTotal = adjList.size();
+    QVector<int> degree(slotTotal, 0);
+    int added = 0;
+    int negativeWeights = 0;
+    
+    // First pass: count the new entries of each list
+    for (const Edge& edge : edges)
+    {
+        if (edge.from < 0 || edge.from >= slotTotal || edge.to < 0 || edge.to >= slotTotal)
+        {
+            continue;
+        }
+        
+        degree[edge.from]++;
+        if (!directed)
+        {
+            degree[edge.to]++;
+        }
+    }
+    
+    for (int i = 0; i < slotTotal; i++)
+    {
+        if (degree[i] > 0)
+        {
+            adjList[i].reserve(adjList[i].size() + degree[i]);
+        }
+    }
+    
+    // Second pass: append
+    for (const Edge& edge : edges)
+    {
+        if (edge.from < 0 || edge.from >= slotTotal || edge.to < 0 || edge.to >= slotTotal)
+        {
+            continue;
+        }
+        
+        double weight = edge.weight;
+        if (weight < 0)
+        {
+            negativeWeights++;
+            weight = qAbs(weight);
+        }
+        
+        adjList[edge.from].append(QPair<int, double>(edge.to, weight));
+        if (!directed)
+        {
+            adjList[edge.to].append(QPair<int, double>(edge.from, weight));
+        }
+        added++;
+    }
+    
+    if (negativeWeights > 0)
+    {
+        LOG_WARNING << "Advertencia:" << negativeWeights << "rutas con peso negativo. Se usara valor absoluto.";
+    }
+    
+    if (added > 0)
+    {
+        recordChange(NetworkChange::Reset);
+    }
+    
+    return added;
 }
 
 // Remove an edge
 void Graph::removeEdge(int origin, int destination)
 {
-    if (!adjList.contains(origin))
+    int originIndex = stationTable.indexOf(origin);
+    int destIndex = stationTable.indexOf(destination);
+    
+    if (originIndex == StationTable::InvalidIndex || destIndex == StationTable::InvalidIndex)
     {
         return;
     }
     
     // Eliminar arista from origin to destination
-    QList<QPair<int, double>>& neighbors = adjList[origin];
+    bool removed = false;
+    QList<QPair<int, double>>& neighbors = adjList[originIndex];
     for (int i = 0; i < neighbors.size(); i++)
     {
-        if (neighbors[i].first == destination)
+        if (neighbors[i].first == destIndex)
         {
             neighbors.removeAt(i);
+            removed = true;
             break;
         }
     }
     
     // If undirected, remove reverse edge
-    if (!directed && adjList.contains(destination))
+    if (!directed)
     {
-        QList<QPair<int, double>>& reverseNeighbors = adjList[destination];
+        QList<QPair<int, double>>& reverseNeighbors = adjList[destIndex];
         for (int i = 0; i < reverseNeighbors.size(); i++)
         {
-            if (reverseNeighbors[i].first == origin)
+            if (reverseNeighbors[i].first == originIndex)
             {
                 reverseNeighbors.removeAt(i);
+                removed = true;
                 break;
             }
         }
     }
+    
+    // Nothing erased: the network (and its version) stays the same
+    if (removed)
+    {
+        recordChange(NetworkChange::EdgeRemoved, originIndex, destIndex, INF);
+    }
 }
 
 // Check if edge exists
 bool Graph::hasEdge(int origin, int destination) const
 {
-    if (!adjList.contains(origin))
+    int originIndex = stationTable.indexOf(origin);
+    int destIndex = stationTable.indexOf(destination);
+    
+    if (originIndex == StationTable::InvalidIndex || destIndex == StationTable::InvalidIndex)
     {
         return false;
     }
     
-    const QList<QPair<int, double>>& neighbors = adjList[origin];
+    const QList<QPair<int, double>>& neighbors = adjList[originIndex];
     for (const auto& neighbor : neighbors)
     {
-        if (neighbor.first == destination)
+        if (neighbor.first == destIndex)
         {
             return true;
         }
@@ -176,15 +365,18 @@ bool Graph::hasEdge(int origin, int destination) const
 // Get edge weight
 double Graph::getEdgeWeight(int origin, int destination) const
 {
-    if (!adjList.contains(origin))
+    int originIndex = stationTable.indexOf(origin);
+    int destIndex = stationTable.indexOf(destination);
+    
+    if (originIndex == StationTable::InvalidIndex || destIndex == StationTable::InvalidIndex)
     {
         return INF;
     }
     
-    const QList<QPair<int, double>>& neighbors = adjList[origin];
+    const QList<QPair<int, double>>& neighbors = adjList[originIndex];
     for (const auto& neighbor : neighbors)
     {
-        if (neighbor.first == destination)
+        if (neighbor.first == destIndex)
         {
             return neighbor.second;
         }
@@ -193,77 +385,187 @@ double Graph::getEdgeWeight(int origin, int destination) const
     return INF;
 }
 
+// Update the weight of the first edge fromIndex -> toIndex
+bool Graph::setWeightAt(int fromIndex, int toIndex, double weight)
+{
+    QList<QPair<int, double>>& neighbors = adjList[fromIndex];
+    for (int i = 0; i < neighbors.size(); i++)
+    {
+        if (neighbors[i].first == toIndex)
+        {
+            double previous = neighbors[i].second;
+            neighbors[i].second = weight;
+            recordChange(NetworkChange::EdgeChanged, fromIndex, toIndex, weight, previous);
+            return true;
+        }
+    }
+    return false;
+}
+
+// Change the weight of an existing route
+// If the route has an accident, the new value becomes its original weight and the
+// current weight keeps the same increment
+bool Graph::setEdgeWeight(int origin, int destination, double weight)
+{
+    int originIndex = stationTable.indexOf(origin);
+    int destIndex = stationTable.indexOf(destination);
+    
+    if (originIndex == StationTable::InvalidIndex || destIndex == StationTable::InvalidIndex)
+    {
+        return false;
+    }
+    
+    if (weight < 0)
+    {
+        LOG_WARNING << "Advertencia: Peso negativo detectado. Se usara valor absoluto.";
+        weight = qAbs(weight);
+    }
+    
+    double currentWeight = weight;
+    QPair<int, int> routeKey(origin, destination);
+    QPair<int, int> reverseKey(destination, origin);
+    
+    if (affectedRoutes.contains(routeKey) || affectedRoutes.contains(reverseKey))
+    {
+        double originalWeight = originalWeights.value(routeKey, originalWeights.value(reverseKey, 0.0));
+        if (originalWeight > 0)
+        {
+            currentWeight = weight * (getEdgeWeight(origin, destination) / originalWeight);
+        }
+        
+        if (originalWeights.contains(routeKey))
+        {
+            originalWeights[routeKey] = weight;
+        }
+        if (originalWeights.contains(reverseKey))
+        {
+            originalWeights[reverseKey] = weight;
+        }
+    }
+    
+    if (!setWeightAt(originIndex, destIndex, currentWeight))
+    {
+        return false;
+    }
+    
+    if (!directed)
+    {
+        setWeightAt(destIndex, originIndex, currentWeight);
+    }
+    
+    return true;
+}
+
 // Clear all data
 void Graph::clear()
 {
-    stations.clear();
+    stationTable.clear();
     adjList.clear();
+    
+    // Closures refer to station slots, so they go with them
+    closedStations.clear();
+    closedRoutes.clear();
+    closedRouteKeys.clear();
+    recordChange(NetworkChange::Reset);
 }
 
 // Check if graph is empty
 bool Graph::isEmpty() const
 {
-    return stations.isEmpty();
+    return stationTable.isEmpty();
 }
 
 // Get neighbors of a station
 QList<QPair<int, double>> Graph::getNeighbors(int stationId) const
 {
-    if (adjList.contains(stationId))
+    QList<QPair<int, double>> result;
+    int index = stationTable.indexOf(stationId);
+    
+    if (index != StationTable::InvalidIndex)
     {
-        return adjList[stationId];
+        const QList<QPair<int, double>>& neighbors = adjList[index];
+        result.reserve(neighbors.size());
+        for (const auto& neighbor : neighbors)
+        {
+            result.append(QPair<int, double>(stationTable.idAt(neighbor.first), neighbor.second));
+        }
     }
-    return QList<QPair<int, double>>();
+    
+    return result;
+}
+
+// Get neighbors of a station index
+const QList<QPair<int, double>>& Graph::neighborsAt(int index) const
+{
+    static const QList<QPair<int, double>> empty;
+    
+    if (index < 0 || index >= adjList.size())
+    {
+        return empty;
+    }
+    return adjList[index];
 }
 
 // BFS traversal
-QList<int> Graph::bfs(int startId)
+QList<int> Graph::bfs(int startId, JobToken* token) const
 {
+    MetricsTimer timer(Metrics::Bfs);
     QList<int> result;
+    int startIndex = stationTable.indexOf(startId);
     
-    if (!stations.contains(startId))
+    if (startIndex == StationTable::InvalidIndex)
     {
-        qDebug() << "Error: Estacion inicial" << startId << "no existe.";
+        LOG_ERROR << "Error: Estacion inicial" << startId << "no existe.";
         return result;
     }
     
-    QSet<int> visited;
+    QVector<bool> visited(adjList.size(), false);
     QQueue<int> queue;
     
-    queue.enqueue(startId);
-    visited.insert(startId);
+    queue.enqueue(startIndex);
+    visited[startIndex] = true;
+    int steps = 0;
+    MetricsTally tally(Metrics::Bfs);
+    bool routeClosures = !closedRouteKeys.isEmpty();
     
     while (!queue.isEmpty())
     {
         int current = queue.dequeue();
         
+        // Stop if the job was cancelled
+        if (token && ++steps % TokenCheckInterval == 0 && !token->progress(result.size(), stationTable.size()))
+        {
+            return result;
+        }
+        
         // Skip closed stations
-        if (isStationClosed(current))
+        if (isIndexClosed(current))
         {
             continue;
         }
         
-        result.append(current);
+        result.append(stationTable.idAt(current));
+        tally.count(Metrics::NodesSettled);
         
         // Visit all neighbors
-        if (adjList.contains(current))
+        const QList<QPair<int, double>>& neighbors = adjList[current];
+        for (const auto& neighbor : neighbors)
         {
-            const QList<QPair<int, double>>& neighbors = adjList[current];
-            for (const auto& neighbor : neighbors)
+            int neighborIndex = neighbor.first;
+            tally.count(Metrics::EdgesScanned);
+            tally.count(Metrics::ClosureChecks, routeClosures);
+            
+            // Skip closed routes and stations
+            if (isRouteClosedAt(current, neighborIndex) || isIndexClosed(neighborIndex))
             {
-                int neighborId = neighbor.first;
-                
-                // Skip closed routes and stations
-                if (isRouteClosed(current, neighborId) || isStationClosed(neighborId))
-                {
-                    continue;
-                }
-                
-                if (!visited.contains(neighborId))
-                {
-                    visited.insert(neighborId);
-                    queue.enqueue(neighborId);
-                }
+                continue;
+            }
+            
+            if (!visited[neighborIndex])
+            {
+                visited[neighborIndex] = true;
+                queue.enqueue(neighborIndex);
+                tally.count(Metrics::EdgesRelaxed);
             }
         }
     }
@@ -272,253 +574,491 @@ QList<int> Graph::bfs(int startId)
 }
 
 // DFS traversal
-QList<int> Graph::dfs(int startId)
+QList<int> Graph::dfs(int startId, JobToken* token) const
 {
+    MetricsTimer timer(Metrics::Dfs);
     QList<int> result;
+    int startIndex = stationTable.indexOf(startId);
     
-    if (!stations.contains(startId))
+    if (startIndex == StationTable::InvalidIndex)
     {
-        qDebug() << "Error: Estacion inicial" << startId << "no existe.";
+        LOG_ERROR << "Error: Estacion inicial" << startId << "no existe.";
         return result;
     }
     
-    QSet<int> visited;
-    dfsHelper(startId, visited, result);
+    QVector<bool> visited(adjList.size(), false);
+    MetricsTally tally(Metrics::Dfs);
+    dfsHelper(startIndex, visited, result, token, tally);
     
     return result;
 }
 
-// DFS helper (recursive)
-void Graph::dfsHelper(int nodeId, QSet<int>& visited, QList<int>& result)
+// DFS helper: explicit stack of (station, next neighbor) so deep networks cannot overflow
+// a worker thread's stack; stations are visited in the same order as the recursive walk
+void Graph::dfsHelper(int nodeIndex, QVector<bool>& visited, QList<int>& result, JobToken* token,
+                      MetricsTally& tally) const
 {
     // Skip closed stations
-    if (isStationClosed(nodeId))
+    if (isIndexClosed(nodeIndex))
     {
         return;
     }
     
-    visited.insert(nodeId);
-    result.append(nodeId);
+    bool routeClosures = !closedRouteKeys.isEmpty();
+    QVector<QPair<int, int>> stack;
+    
+    // Visit a station and push it; false if the job was cancelled
+    auto enter = [&](int index) {
+        if (token && (result.size() + 1) % TokenCheckInterval == 0 && !token->progress(result.size(), stationTable.size()))
+        {
+            return false;
+        }
+        
+        visited[index] = true;
+        result.append(stationTable.idAt(index));
+        tally.count(Metrics::NodesSettled);
+        stack.append(QPair<int, int>(index, 0));
+        return true;
+    };
+    
+    if (!enter(nodeIndex))
+    {
+        return;
+    }
     
-    if (adjList.contains(nodeId))
+    while (!stack.isEmpty())
+    {
+        QPair<int, int>& top = stack.last();
+        const QList<QPair<int, double>>& neighbors = adjList[top.first];
+        
+        if (top.second == neighbors.size())
+        {
+            stack.removeLast();
+            continue;
+        }
+        
+        int current = top.first;
+        int neighborIndex = neighbors[top.second++].first;
+        tally.count(Metrics::EdgesScanned);
+        tally.count(Metrics::ClosureChecks, routeClosures);
+        
+        // Skip closed routes and stations
+        if (isRouteClosedAt(current, neighborIndex) || isIndexClosed(neighborIndex))
+        {
+            continue;
+        }
+        
+        if (!visited[neighborIndex])
+        {
+            tally.count(Metrics::EdgesRelaxed);
+            if (!enter(neighborIndex))
+            {
+                return;
+            }
+        }
+    }
+}
+
+// Dijkstra over station indices using a binary heap (lazy deletion of stale entries)
+void Graph::dijkstraIndexed(int startIndex, QVector<double>& dist, QVector<int>& pred, JobToken* token) const
+{
+    typedef std::pair<double, int> HeapItem;
+    
+    int n = adjList.size();
+    dist.fill(INF, n);
+    pred.fill(-1, n);
+    QVector<bool> visited(n, false);
+    
+    std::priority_queue<HeapItem, std::vector<HeapItem>, std::greater<HeapItem>> heap;
+    dist[startIndex] = 0.0;
+    heap.push(HeapItem(0.0, startIndex));
+    int settled = 0;
+    MetricsTally tally(Metrics::Dijkstra);
+    tally.count(Metrics::HeapOperations);
+    bool routeClosures = !closedRouteKeys.isEmpty();
+    
+    while (!heap.empty())
     {
-        const QList<QPair<int, double>>& neighbors = adjList[nodeId];
+        int minNode = heap.top().second;
+        heap.pop();
+        tally.count(Metrics::HeapOperations);
+        
+        if (visited[minNode])
+        {
+            continue;  // Already settled with a shorter distance
+        }
+        visited[minNode] = true;
+        
+        // Stop if the job was cancelled
+        if (token && ++settled % TokenCheckInterval == 0 && !token->progress(settled, stationTable.size()))
+        {
+            return;
+        }
+        
+        // Skip closed stations
+        if (isIndexClosed(minNode))
+        {
+            continue;
+        }
+        tally.count(Metrics::NodesSettled);
+        
+        // Update distances to neighbors
+        const QList<QPair<int, double>>& neighbors = adjList[minNode];
         for (const auto& neighbor : neighbors)
         {
-            int neighborId = neighbor.first;
+            int neighborIndex = neighbor.first;
+            tally.count(Metrics::EdgesScanned);
+            tally.count(Metrics::ClosureChecks, routeClosures);
             
             // Skip closed routes and stations
-            if (isRouteClosed(nodeId, neighborId) || isStationClosed(neighborId))
+            if (isRouteClosedAt(minNode, neighborIndex) || isIndexClosed(neighborIndex))
             {
                 continue;
             }
             
-            if (!visited.contains(neighborId))
+            double newDist = dist[minNode] + neighbor.second;
+            
+            if (newDist < dist[neighborIndex])
             {
-                dfsHelper(neighborId, visited, result);
+                dist[neighborIndex] = newDist;
+                pred[neighborIndex] = minNode;
+                heap.push(HeapItem(newDist, neighborIndex));
+                tally.count(Metrics::EdgesRelaxed);
+                tally.count(Metrics::HeapOperations);
             }
         }
     }
 }
 
 // Dijkstra's shortest path algorithm
-QHash<int, double> Graph::dijkstra(int startId)
+QHash<int, double> Graph::dijkstra(int startId, JobToken* token) const
 {
+    MetricsTimer timer(Metrics::Dijkstra);
     QHash<int, double> distances;
+    int startIndex = stationTable.indexOf(startId);
     
-    if (!stations.contains(startId))
+    if (startIndex == StationTable::InvalidIndex)
     {
-        qDebug() << "Error: Estacion inicial" << startId << "no existe.";
+        LOG_ERROR << "Error: Estacion inicial" << startId << "no existe.";
         return distances;
     }
     
-    // Initialize distances
-    for (int id : stations.keys())
+    QVector<double> dist;
+    QVector<int> pred;
+    dijkstraIndexed(startIndex, dist, pred, token);
+    
+    distances.reserve(stationTable.size());
+    for (int index : stationTable.indices())
     {
-        distances[id] = INF;
+        distances[stationTable.idAt(index)] = dist[index];
     }
-    distances[startId] = 0.0;
     
-    QSet<int> visited;
+    return distances;
+}
+
+// Dijkstra with path reconstruction
+QPair<QHash<int, double>, QHash<int, int>> Graph::dijkstraWithPath(int startId, JobToken* token) const
+{
+    MetricsTimer timer(Metrics::Dijkstra);
+    QHash<int, double> distances;
+    QHash<int, int> predecessors;  // To reconstruct path
+    int startIndex = stationTable.indexOf(startId);
+    
+    if (startIndex == StationTable::InvalidIndex)
+    {
+        LOG_ERROR << "Error: Estacion inicial" << startId << "no existe.";
+        return QPair<QHash<int, double>, QHash<int, int>>(distances, predecessors);
+    }
+    
+    QVector<double> dist;
+    QVector<int> pred;
+    dijkstraIndexed(startIndex, dist, pred, token);
     
-    while (visited.size() < stations.size())
+    // Translate indices back to station IDs (-1 = no predecessor)
+    distances.reserve(stationTable.size());
+    predecessors.reserve(stationTable.size());
+    for (int index : stationTable.indices())
     {
-        // Find unvisited node with minimum distance
-        int minNode = -1;
-        double minDist = INF;
+        int id = stationTable.idAt(index);
+        distances[id] = dist[index];
+        predecessors[id] = (pred[index] >= 0) ? stationTable.idAt(pred[index]) : -1;
+    }
+    
+    return QPair<QHash<int, double>, QHash<int, int>>(distances, predecessors);
+}
+
+// Dijkstra returning the tree by station index (no hash tables to build)
+bool Graph::shortestPathTree(int startId, QVector<double>& dist, QVector<int>& pred, JobToken* token) const
+{
+    MetricsTimer timer(Metrics::Dijkstra);
+    int startIndex = stationTable.indexOf(startId);
+    
+    if (startIndex == StationTable::InvalidIndex)
+    {
+        LOG_ERROR << "Error: Estacion inicial" << startId << "no existe.";
+        return false;
+    }
+    
+    dijkstraIndexed(startIndex, dist, pred, token);
+    return true;
+}
+
+// Dijkstra between two station indices, avoiding extra stations and first hops
+void Graph::shortestPathAvoiding(int startIndex, int targetIndex, const QBitArray& blockedStations,
+                                 const QVector<int>& blockedFirstHops, QList<int>& route, double& distance,
+                                 JobToken* token) const
+{
+    typedef std::pair<double, int> HeapItem;
+    
+    route.clear();
+    distance = INF;
+    int n = adjList.size();
+    
+    // The extra stations ride on the closure bitmap: one word-wise OR per search
+    QBitArray blocked = closedStations;
+    blocked.resize(n);
+    if (!blockedStations.isEmpty())
+    {
+        QBitArray extra = blockedStations;
+        extra.resize(n);
+        blocked |= extra;
+    }
+    
+    if (startIndex < 0 || startIndex >= n || targetIndex < 0 || targetIndex >= n ||
+        blocked.testBit(startIndex) || blocked.testBit(targetIndex))
+    {
+        return;
+    }
+    
+    QVector<double> dist(n, INF);
+    QVector<int> pred(n, -1);
+    QVector<bool> visited(n, false);
+    
+    std::priority_queue<HeapItem, std::vector<HeapItem>, std::greater<HeapItem>> heap;
+    dist[startIndex] = 0.0;
+    heap.push(HeapItem(0.0, startIndex));
+    int settled = 0;
+    MetricsTally tally(Metrics::KShortestPaths);
+    tally.count(Metrics::HeapOperations);
+    bool routeClosures = !closedRouteKeys.isEmpty();
+    
+    while (!heap.empty())
+    {
+        int minNode = heap.top().second;
+        heap.pop();
+        tally.count(Metrics::HeapOperations);
         
-        for (int id : stations.keys())
+        if (visited[minNode])
         {
-            if (!visited.contains(id) && distances[id] < minDist)
-            {
-                minDist = distances[id];
-                minNode = id;
-            }
+            continue;  // Already settled with a shorter distance
         }
+        visited[minNode] = true;
+        tally.count(Metrics::NodesSettled);
         
-        if (minNode == -1)
+        // Stop if the job was cancelled, or once the target is settled
+        if (token && ++settled % TokenCheckInterval == 0 && !token->progress(settled, stationTable.size()))
         {
-            break;  // No more reachable nodes
+            return;
         }
-        
-        visited.insert(minNode);
-        
-        // Skip closed stations
-        if (isStationClosed(minNode))
+        if (minNode == targetIndex)
         {
-            continue;
+            break;
         }
         
-        // Update distances to neighbors
-        if (adjList.contains(minNode))
+        const QList<QPair<int, double>>& neighbors = adjList[minNode];
+        for (const auto& neighbor : neighbors)
         {
-            const QList<QPair<int, double>>& neighbors = adjList[minNode];
-            for (const auto& neighbor : neighbors)
+            int neighborIndex = neighbor.first;
+            tally.count(Metrics::EdgesScanned);
+            tally.count(Metrics::ClosureChecks, routeClosures);
+            
+            // Skip blocked stations, closed routes and the first hops already taken
+            if (blocked.testBit(neighborIndex) || isRouteClosedAt(minNode, neighborIndex) ||
+                (minNode == startIndex && blockedFirstHops.contains(neighborIndex)))
             {
-                int neighborId = neighbor.first;
-                double edgeWeight = neighbor.second;
-                
-                // Skip closed routes and stations
-                if (isRouteClosed(minNode, neighborId) || isStationClosed(neighborId))
-                {
-                    continue;
-                }
-                
-                double newDist = distances[minNode] + edgeWeight;
-                
-                if (newDist < distances[neighborId])
-                {
-                    distances[neighborId] = newDist;
-                }
+                continue;
+            }
+            
+            double newDist = dist[minNode] + neighbor.second;
+            
+            if (newDist < dist[neighborIndex])
+            {
+                dist[neighborIndex] = newDist;
+                pred[neighborIndex] = minNode;
+                heap.push(HeapItem(newDist, neighborIndex));
+                tally.count(Metrics::EdgesRelaxed);
+                tally.count(Metrics::HeapOperations);
             }
         }
     }
     
-    return distances;
+    if (dist[targetIndex] >= INF)
+    {
+        return;
+    }
+    
+    distance = dist[targetIndex];
+    for (int index = targetIndex; index != -1; index = pred[index])
+    {
+        route.prepend(index);
+    }
 }
 
-// Dijkstra with path reconstruction
-QPair<QHash<int, double>, QHash<int, int>> Graph::dijkstraWithPath(int startId)
+// Dijkstra bounded by a cost budget
+void Graph::reachableWithin(int startIndex, double budget, QVector<QPair<int, double>>& reached,
+                            JobToken* token) const
 {
-    QHash<int, double> distances;
-    QHash<int, int> predecessors;  // To reconstruct path
+    typedef std::pair<double, int> HeapItem;
     
-    if (!stations.contains(startId))
+    reached.clear();
+    if (startIndex < 0 || startIndex >= adjList.size() || !stationTable.isValidIndex(startIndex) ||
+        isIndexClosed(startIndex) || budget < 0.0)
     {
-        qDebug() << "Error: Estacion inicial" << startId << "no existe.";
-        return QPair<QHash<int, double>, QHash<int, int>>(distances, predecessors);
+        return;
     }
     
-    // Initialize distances and predecessors
-    for (int id : stations.keys())
-    {
-        distances[id] = INF;
-        predecessors[id] = -1;  // No predecessor
-    }
-    distances[startId] = 0.0;
+    QHash<int, double> dist;
+    QSet<int> settled;
     
-    QSet<int> visited;
+    std::priority_queue<HeapItem, std::vector<HeapItem>, std::greater<HeapItem>> heap;
+    dist.insert(startIndex, 0.0);
+    heap.push(HeapItem(0.0, startIndex));
+    MetricsTally tally(Metrics::Isochrone);
+    tally.count(Metrics::HeapOperations);
+    bool routeClosures = !closedRouteKeys.isEmpty();
     
-    while (visited.size() < stations.size())
+    while (!heap.empty())
     {
-        // Find unvisited node with minimum distance
-        int minNode = -1;
-        double minDist = INF;
+        HeapItem top = heap.top();
+        heap.pop();
+        tally.count(Metrics::HeapOperations);
         
-        for (int id : stations.keys())
+        int minNode = top.second;
+        if (settled.contains(minNode))
         {
-            if (!visited.contains(id) && distances[id] < minDist)
-            {
-                minDist = distances[id];
-                minNode = id;
-            }
+            continue;  // Already settled with a shorter distance
         }
+        settled.insert(minNode);
+        reached.append(QPair<int, double>(minNode, top.first));
+        tally.count(Metrics::NodesSettled);
         
-        if (minNode == -1)
+        // Stop if the job was cancelled (no progress: several depots can share the token)
+        if (token && reached.size() % TokenCheckInterval == 0 && token->isCancelled())
         {
-            break;  // No more reachable nodes
-        }
-        
-        visited.insert(minNode);
-        
-        // Skip closed stations
-        if (isStationClosed(minNode))
-        {
-            continue;
+            return;
         }
         
-        // Update distances to neighbors
-        if (adjList.contains(minNode))
+        const QList<QPair<int, double>>& neighbors = adjList[minNode];
+        for (const auto& neighbor : neighbors)
         {
-            const QList<QPair<int, double>>& neighbors = adjList[minNode];
-            for (const auto& neighbor : neighbors)
+            int neighborIndex = neighbor.first;
+            tally.count(Metrics::EdgesScanned);
+            tally.count(Metrics::ClosureChecks, routeClosures);
+            
+            // Skip closed routes and stations
+            if (isRouteClosedAt(minNode, neighborIndex) || isIndexClosed(neighborIndex))
             {
-                int neighborId = neighbor.first;
-                double edgeWeight = neighbor.second;
-                
-                // Skip closed routes and stations
-                if (isRouteClosed(minNode, neighborId) || isStationClosed(neighborId))
-                {
-                    continue;
-                }
-                
-                double newDist = distances[minNode] + edgeWeight;
-                
-                if (newDist < distances[neighborId])
-                {
-                    distances[neighborId] = newDist;
-                    predecessors[neighborId] = minNode;  // Store predecessor
-                }
+                continue;
+            }
+            
+            // Nothing past the budget enters the queue
+            double newDist = top.first + neighbor.second;
+            if (newDist > budget)
+            {
+                continue;
+            }
+            
+            auto known = dist.find(neighborIndex);
+            if (known == dist.end() || newDist < known.value())
+            {
+                dist.insert(neighborIndex, newDist);
+                heap.push(HeapItem(newDist, neighborIndex));
+                tally.count(Metrics::EdgesRelaxed);
+                tally.count(Metrics::HeapOperations);
             }
         }
     }
-    
-    return QPair<QHash<int, double>, QHash<int, int>>(distances, predecessors);
 }
 
 // Floyd-Warshall all-pairs shortest path
-QHash<QPair<int, int>, double> Graph::floydWarshall()
+QHash<QPair<int, int>, double> Graph::floydWarshall(JobToken* token) const
 {
+    MetricsTimer timer(Metrics::FloydWarshall);
+    MetricsTally tally(Metrics::FloydWarshall);
     QHash<QPair<int, int>, double> dist;
-    QList<int> nodeIds = stations.keys();
+    QList<int> nodeIndices = stationTable.indices();
+    int n = nodeIndices.size();
+    
+    // Dense matrix over live stations (row = position in nodeIndices)
+    QVector<int> position(adjList.size(), -1);
+    for (int i = 0; i < n; i++)
+    {
+        position[nodeIndices[i]] = i;
+    }
     
     // Initialize distances
-    for (int i : nodeIds)
+    QVector<double> matrix(n * n, INF);
+    for (int i = 0; i < n; i++)
     {
-        for (int j : nodeIds)
+        matrix[i * n + i] = 0.0;
+        
+        for (const auto& neighbor : adjList[nodeIndices[i]])
         {
-            if (i == j)
-            {
-                dist[QPair<int, int>(i, j)] = 0.0;
-            }
-            else if (hasEdge(i, j))
-            {
-                dist[QPair<int, int>(i, j)] = getEdgeWeight(i, j);
-            }
-            else
+            int j = position[neighbor.first];
+            
+            // Keep the first edge found, like getEdgeWeight()
+            if (j >= 0 && j != i && matrix[i * n + j] == INF)
             {
-                dist[QPair<int, int>(i, j)] = INF;
+                matrix[i * n + j] = neighbor.second;
             }
         }
     }
     
-    // Floyd-Warshall algorithm
-    for (int k : nodeIds)
+    // Floyd-Warshall algorithm (progress and cancellation once per pivot)
+    for (int k = 0; k < n; k++)
     {
-        for (int i : nodeIds)
+        if (token && !token->progress(k, n))
         {
-            for (int j : nodeIds)
+            return dist;
+        }
+        tally.count(Metrics::NodesSettled);
+        
+        for (int i = 0; i < n; i++)
+        {
+            double ik = matrix[i * n + k];
+            if (ik == INF)
             {
-                QPair<int, int> ij(i, j);
-                QPair<int, int> ik(i, k);
-                QPair<int, int> kj(k, j);
-                
-                double throughK = dist[ik] + dist[kj];
-                if (throughK < dist[ij])
+                continue;
+            }
+            tally.count(Metrics::EdgesScanned, n);
+            
+            int relaxed = 0;
+            for (int j = 0; j < n; j++)
+            {
+                double throughK = ik + matrix[k * n + j];
+                if (throughK < matrix[i * n + j])
                 {
-                    dist[ij] = throughK;
+                    matrix[i * n + j] = throughK;
+                    relaxed++;
                 }
             }
+            tally.count(Metrics::EdgesRelaxed, relaxed);
+        }
+    }
+    
+    // Translate back to station IDs
+    dist.reserve(n * n);
+    for (int i = 0; i < n; i++)
+    {
+        if (token && token->isCancelled())
+        {
+            return QHash<QPair<int, int>, double>();
+        }
+        
+        int fromId = stationTable.idAt(nodeIndices[i]);
+        for (int j = 0; j < n; j++)
+        {
+            dist[QPair<int, int>(fromId, stationTable.idAt(nodeIndices[j]))] = matrix[i * n + j];
         }
     }
     
@@ -531,14 +1071,14 @@ QList<Edge> Graph::getAllEdges() const
     QList<Edge> edges;
     QSet<QPair<int, int>> addedEdges;
     
-    for (auto it = adjList.begin(); it != adjList.end(); ++it)
+    for (int fromIndex : stationTable.indices())
     {
-        int from = it.key();
-        const QList<QPair<int, double>>& neighbors = it.value();
+        int from = stationTable.idAt(fromIndex);
+        const QList<QPair<int, double>>& neighbors = adjList[fromIndex];
         
         for (const auto& neighbor : neighbors)
         {
-            int to = neighbor.first;
+            int to = stationTable.idAt(neighbor.first);
             double weight = neighbor.second;
             
             // For undirected graphs, avoid duplicate edges
@@ -560,58 +1100,67 @@ QList<Edge> Graph::getAllEdges() const
 }
 
 // Prim's MST algorithm
-QList<QPair<int, int>> Graph::primMST()
+QList<QPair<int, int>> Graph::primMST(JobToken* token) const
 {
+    MetricsTimer timer(Metrics::PrimMST);
     QList<QPair<int, int>> mstEdges;
     
-    if (stations.isEmpty())
+    if (stationTable.isEmpty())
     {
-        qDebug() << "Error: El grafo esta vacio.";
+        LOG_ERROR << "Error: El grafo esta vacio.";
         return mstEdges;
     }
     
-    QSet<int> inMST;
-    QList<int> nodeIds = stations.keys();
+    QVector<bool> inMST(adjList.size(), false);
+    QList<int> mstNodes;
     
     // Start with first node
-    int startNode = nodeIds.first();
-    inMST.insert(startNode);
+    int startNode = stationTable.indices().first();
+    inMST[startNode] = true;
+    mstNodes.append(startNode);
+    MetricsTally tally(Metrics::PrimMST);
+    bool routeClosures = !closedRouteKeys.isEmpty();
     
-    while (inMST.size() < stations.size())
+    while (mstNodes.size() < stationTable.size())
     {
+        // Each round scans the whole tree: check the token every round
+        if (token && !token->progress(mstNodes.size(), stationTable.size()))
+        {
+            return mstEdges;
+        }
+        
         double minWeight = INF;
         int minFrom = -1;
         int minTo = -1;
         
         // Find minimum edge connecting MST to non-MST node
-        for (int node : inMST)
+        for (int node : mstNodes)
         {
             // Skip closed stations
-            if (isStationClosed(node))
+            if (isIndexClosed(node))
             {
                 continue;
             }
             
-            if (adjList.contains(node))
+            const QList<QPair<int, double>>& neighbors = adjList[node];
+            for (const auto& neighbor : neighbors)
             {
-                const QList<QPair<int, double>>& neighbors = adjList[node];
-                for (const auto& neighbor : neighbors)
+                int neighborIndex = neighbor.first;
+                double weight = neighbor.second;
+                tally.count(Metrics::EdgesScanned);
+                tally.count(Metrics::ClosureChecks, routeClosures);
+                
+                // Skip closed routes and stations
+                if (isRouteClosedAt(node, neighborIndex) || isIndexClosed(neighborIndex))
                 {
-                    int neighborId = neighbor.first;
-                    double weight = neighbor.second;
-                    
-                    // Skip closed routes and stations
-                    if (isRouteClosed(node, neighborId) || isStationClosed(neighborId))
-                    {
-                        continue;
-                    }
-                    
-                    if (!inMST.contains(neighborId) && weight < minWeight)
-                    {
-                        minWeight = weight;
-                        minFrom = node;
-                        minTo = neighborId;
-                    }
+                    continue;
+                }
+                
+                if (!inMST[neighborIndex] && weight < minWeight)
+                {
+                    minWeight = weight;
+                    minFrom = node;
+                    minTo = neighborIndex;
                 }
             }
         }
@@ -621,60 +1170,76 @@ QList<QPair<int, int>> Graph::primMST()
             break;  // No more reachable nodes (disconnected graph)
         }
         
-        mstEdges.append(QPair<int, int>(minFrom, minTo));
-        inMST.insert(minTo);
+        mstEdges.append(QPair<int, int>(stationTable.idAt(minFrom), stationTable.idAt(minTo)));
+        inMST[minTo] = true;
+        mstNodes.append(minTo);
+        tally.count(Metrics::NodesSettled);
+        tally.count(Metrics::EdgesRelaxed);
     }
     
     return mstEdges;
 }
 
 // Kruskal's MST algorithm using DisjointSet
-QList<QPair<int, int>> Graph::kruskalMST()
+QList<QPair<int, int>> Graph::kruskalMST(JobToken* token) const
 {
+    MetricsTimer timer(Metrics::KruskalMST);
     QList<QPair<int, int>> mstEdges;
     
-    if (stations.isEmpty())
+    if (stationTable.isEmpty())
     {
-        qDebug() << "Error: El grafo esta vacio.";
+        LOG_ERROR << "Error: El grafo esta vacio.";
         return mstEdges;
     }
     
-    // Get all edges and sort by weight
-    QList<Edge> edges = getAllEdges();
-    std::sort(edges.begin(), edges.end());
-    
-    // Create disjoint set
-    int maxId = 0;
-    for (int id : stations.keys())
+    // Collect edges by station index (each undirected edge once) and sort by weight
+    QList<Edge> edges;
+    for (int fromIndex : stationTable.indices())
     {
-        if (id > maxId)
+        for (const auto& neighbor : adjList[fromIndex])
         {
-            maxId = id;
+            if (directed || fromIndex < neighbor.first)
+            {
+                edges.append(Edge(fromIndex, neighbor.first, neighbor.second));
+            }
         }
     }
+    std::stable_sort(edges.begin(), edges.end());
     
-    DisjointSet ds(maxId);
+    // Create disjoint set (elements are index + 1)
+    DisjointSet ds(adjList.size());
     
     // Process edges in order of increasing weight
+    int processed = 0;
+    MetricsTally tally(Metrics::KruskalMST);
+    bool routeClosures = !closedRouteKeys.isEmpty();
     for (const Edge& edge : edges)
     {
+        if (token && ++processed % TokenCheckInterval == 0 && !token->progress(processed, edges.size()))
+        {
+            return mstEdges;
+        }
+        
         int u = edge.from;
         int v = edge.to;
+        tally.count(Metrics::EdgesScanned);
+        tally.count(Metrics::ClosureChecks, routeClosures);
         
         // Skip closed routes and stations
-        if (isRouteClosed(u, v) || isStationClosed(u) || isStationClosed(v))
+        if (isRouteClosedAt(u, v) || isIndexClosed(u) || isIndexClosed(v))
         {
             continue;
         }
         
         // If adding this edge doesn't create a cycle
-        if (!ds.connected(u, v))
+        if (!ds.connected(u + 1, v + 1))
         {
-            mstEdges.append(QPair<int, int>(u, v));
-            ds.unionSets(u, v);
+            mstEdges.append(QPair<int, int>(stationTable.idAt(u), stationTable.idAt(v)));
+            ds.unionSets(u + 1, v + 1);
+            tally.count(Metrics::EdgesRelaxed);
             
             // MST complete when we have n-1 edges
-            if (mstEdges.size() == stations.size() - 1)
+            if (mstEdges.size() == stationTable.size() - 1)
             {
                 break;
             }
@@ -689,13 +1254,13 @@ void Graph::printGraph() const
 {
     qDebug() << "\n=== ESTRUCTURA DEL GRAFO ===";
     qDebug() << "Tipo:" << (directed ? "Dirigido" : "No dirigido");
-    qDebug() << "Estaciones:" << stations.size();
+    qDebug() << "Estaciones:" << stationTable.size();
     qDebug() << "Rutas:" << getAllEdges().size();
     
     qDebug() << "\nEstaciones registradas:";
-    for (const Station& station : stations.values())
+    for (int index : stationTable.indices())
     {
-        qDebug() << "  " << station.toString();
+        qDebug() << "  " << stationTable.stationAt(index).toString();
     }
 }
 
@@ -704,10 +1269,10 @@ void Graph::printAdjacencyList() const
 {
     qDebug() << "\n=== LISTA DE ADYACENCIA ===";
     
-    for (auto it = adjList.begin(); it != adjList.end(); ++it)
+    for (int index : stationTable.indices())
     {
-        int stationId = it.key();
-        const QList<QPair<int, double>>& neighbors = it.value();
+        int stationId = stationTable.idAt(index);
+        const QList<QPair<int, double>>& neighbors = adjList[index];
         
         QString line = QString("Estacion %1: ").arg(stationId);
         
@@ -720,9 +1285,9 @@ void Graph::printAdjacencyList() const
             for (int i = 0; i < neighbors.size(); i++)
             {
                 line += QString("-> %1 (peso: %2)")
-                    .arg(neighbors[i].first)
+                    .arg(stationTable.idAt(neighbors[i].first))
                     .arg(neighbors[i].second, 0, 'f', 1);
-                
+                    
                 if (i < neighbors.size() - 1)
                 {
                     line += " ";
@@ -736,51 +1301,67 @@ void Graph::printAdjacencyList() const
 
 // ========== CLOSURE MANAGEMENT ==========
 
+// Check if a station index is closed
+bool Graph::isIndexClosed(int index) const
+{
+    return index < closedStations.size() && closedStations.testBit(index);
+}
+
+// Check if the route between two station indices is closed
+bool Graph::isRouteClosedAt(int fromIndex, int toIndex) const
+{
+    if (closedRouteKeys.isEmpty())
+    {
+        return false;
+    }
+    return closedRouteKeys.contains(makeRouteKey(stationTable.idAt(fromIndex), stationTable.idAt(toIndex)));
+}
+
+// Route key with the smaller ID first (closures apply in both directions)
+QPair<int, int> Graph::makeRouteKey(int a, int b) const
+{
+    return (a < b) ? QPair<int, int>(a, b) : QPair<int, int>(b, a);
+}
+
 // Check if a station is closed
 bool Graph::isStationClosed(int id) const
 {
-    return closedStations.contains(id);
+    int index = stationTable.indexOf(id);
+    return index != StationTable::InvalidIndex && isIndexClosed(index);
 }
 
 // Check if a route is closed (checks both directions for undirected graphs)
 bool Graph::isRouteClosed(int a, int b) const
 {
-    QPair<int, int> route1(a, b);
-    QPair<int, int> route2(b, a);
-    
-    for (const auto& route : closedRoutes)
-    {
-        if (route == route1 || route == route2)
-        {
-            return true;
-        }
-    }
-    
-    return false;
+    return closedRouteKeys.contains(makeRouteKey(a, b));
 }
 
 // Close a station (block it)
 void Graph::closeStation(int id)
 {
-    if (!stations.contains(id))
+    int index = stationTable.indexOf(id);
+    
+    if (index == StationTable::InvalidIndex)
     {
-        qDebug() << "Advertencia: No se puede cerrar estacion" << id << "(no existe).";
+        LOG_WARNING << "Advertencia: No se puede cerrar estacion" << id << "(no existe).";
         return;
     }
     
-    if (!closedStations.contains(id))
+    if (!closedStations.testBit(index))
     {
-        closedStations.insert(id);
-        qDebug() << "Estacion" << id << "cerrada (bloqueada).";
+        closedStations.setBit(index);
+        recordChange(NetworkChange::StationClosed, index);
+        LOG_DEBUG << "Estacion" << id << "cerrada (bloqueada).";
+        notifyChange(GraphEvent::StationClosed, id);
     }
 }
 
 // Close a route (block it)
 void Graph::closeRoute(int a, int b)
 {
-    if (!stations.contains(a) || !stations.contains(b))
+    if (!stationTable.contains(a) || !stationTable.contains(b))
     {
-        qDebug() << "Advertencia: No se puede cerrar ruta" << a << "->" << b << "(estaciones no existen).";
+        LOG_WARNING << "Advertencia: No se puede cerrar ruta" << a << "->" << b << "(estaciones no existen).";
         return;
     }
     
@@ -789,23 +1370,43 @@ void Graph::closeRoute(int a, int b)
     if (!isRouteClosed(a, b))
     {
         closedRoutes.append(route);
-        qDebug() << "Ruta" << a << "<->" << b << "cerrada (bloqueada).";
+        closedRouteKeys.insert(makeRouteKey(a, b));
+        recordChange(NetworkChange::RouteClosed, stationTable.indexOf(a), stationTable.indexOf(b), INF);
+        if (directed)
+        {
+            recordChange(NetworkChange::RouteClosed, stationTable.indexOf(b), stationTable.indexOf(a), INF);
+        }
+        LOG_DEBUG << "Ruta" << a << "<->" << b << "cerrada (bloqueada).";
+        notifyChange(GraphEvent::RouteClosed, a, b);
     }
 }
 
 // Open a station (unblock it)
 void Graph::openStation(int id)
 {
-    if (closedStations.contains(id))
+    if (isStationClosed(id))
     {
-        closedStations.remove(id);
-        qDebug() << "Estacion" << id << "abierta (desbloqueada).";
+        int index = stationTable.indexOf(id);
+        closedStations.clearBit(index);
+        recordChange(NetworkChange::StationOpened, index);
+        LOG_DEBUG << "Estacion" << id << "abierta (desbloqueada).";
+        notifyChange(GraphEvent::StationOpened, id);
     }
 }
 
 // Open a route (unblock it)
 void Graph::openRoute(int a, int b)
 {
+    if (!closedRouteKeys.remove(makeRouteKey(a, b)))
+    {
+        return;
+    }
+    recordChange(NetworkChange::RouteOpened, stationTable.indexOf(a), stationTable.indexOf(b), getEdgeWeight(a, b));
+    if (directed)
+    {
+        recordChange(NetworkChange::RouteOpened, stationTable.indexOf(b), stationTable.indexOf(a), getEdgeWeight(b, a));
+    }
+    
     QPair<int, int> route1(a, b);
     QPair<int, int> route2(b, a);
     
@@ -814,7 +1415,8 @@ void Graph::openRoute(int a, int b)
         if (closedRoutes[i] == route1 || closedRoutes[i] == route2)
         {
             closedRoutes.removeAt(i);
-            qDebug() << "Ruta" << a << "<->" << b << "abierta (desbloqueada).";
+            LOG_DEBUG << "Ruta" << a << "<->" << b << "abierta (desbloqueada).";
+            notifyChange(GraphEvent::RouteOpened, a, b);
             return;
         }
     }
@@ -823,15 +1425,28 @@ void Graph::openRoute(int a, int b)
 // Clear all closures
 void Graph::clearClosures()
 {
-    closedStations.clear();
+    closedStations.fill(false);
     closedRoutes.clear();
-    qDebug() << "Todos los cierres han sido eliminados.";
+    closedRouteKeys.clear();
+    recordChange(NetworkChange::Reset);
+    LOG_INFO << "Todos los cierres han sido eliminados.";
+    notifyChange(GraphEvent::ClosuresCleared);
 }
 
 // Get list of closed stations
 QSet<int> Graph::getClosedStations() const
 {
-    return closedStations;
+    QSet<int> result;
+    
+    for (int index = 0; index < closedStations.size(); index++)
+    {
+        if (closedStations.testBit(index) && stationTable.isValidIndex(index))
+        {
+            result.insert(stationTable.idAt(index));
+        }
+    }
+    
+    return result;
 }
 
 // Get list of closed routes
@@ -845,18 +1460,22 @@ QList<QPair<int, int>> Graph::getClosedRoutes() const
 // Apply an accident to a route (increase its weight)
 bool Graph::applyAccident(int originId, int destId, double increment)
 {
+    static Log::RateLimit accidentWarnings;   // Files with many bad accident lines
+    int originIndex = stationTable.indexOf(originId);
+    int destIndex = stationTable.indexOf(destId);
+    
     // Validate stations exist
-    if (!stations.contains(originId) || !stations.contains(destId))
+    if (originIndex == StationTable::InvalidIndex || destIndex == StationTable::InvalidIndex)
     {
-        qDebug() << "Error: No se puede aplicar accidente. Estaciones" << originId 
-                 << "o" << destId << "no existen.";
+        LOG_ERROR_LIMITED(accidentWarnings) << "Error: No se puede aplicar accidente. Estaciones" << originId
+                                            << "o" << destId << "no existen.";
         return false;
     }
     
     // Check if route exists
     if (!hasEdge(originId, destId))
     {
-        qDebug() << "Error: No existe ruta entre" << originId << "y" << destId;
+        LOG_ERROR_LIMITED(accidentWarnings) << "Error: No existe ruta entre" << originId << "y" << destId;
         return false;
     }
     
@@ -867,8 +1486,8 @@ bool Graph::applyAccident(int originId, int destId, double increment)
     // Check if accident already applied to avoid double increment
     if (affectedRoutes.contains(routeKey1) || affectedRoutes.contains(routeKey2))
     {
-        qDebug() << "Advertencia: Ruta" << originId << "<->" << destId 
-                 << "ya tiene un accidente aplicado. Se omite.";
+        LOG_WARNING_LIMITED(accidentWarnings) << "Advertencia: Ruta" << originId << "<->" << destId
+                                              << "ya tiene un accidente aplicado. Se omite.";
         return false;
     }
     
@@ -889,45 +1508,30 @@ bool Graph::applyAccident(int originId, int destId, double increment)
     double newWeight = currentWeight + (currentWeight * (increment / 100.0));
     
     // Update weight in adjacency list (origin -> dest)
-    if (adjList.contains(originId))
-    {
-        QList<QPair<int, double>>& neighbors = adjList[originId];
-        for (int i = 0; i < neighbors.size(); i++)
-        {
-            if (neighbors[i].first == destId)
-            {
-                neighbors[i].second = newWeight;
-                break;
-            }
-        }
-    }
+    setWeightAt(originIndex, destIndex, newWeight);
     
     // Update weight in reverse direction if undirected graph
-    if (!directed && adjList.contains(destId))
+    if (!directed)
     {
-        QList<QPair<int, double>>& neighbors = adjList[destId];
-        for (int i = 0; i < neighbors.size(); i++)
-        {
-            if (neighbors[i].first == originId)
-            {
-                neighbors[i].second = newWeight;
-                break;
-            }
-        }
+        setWeightAt(destIndex, originIndex, newWeight);
     }
     
     // Mark route as affected
     affectedRoutes.insert(routeKey1);
+    accidentIncrements[routeKey1] = increment;
     if (!directed)
     {
         affectedRoutes.insert(routeKey2);
+        accidentIncrements[routeKey2] = increment;
     }
     
-    qDebug() << "[OK] Accidente aplicado: Ruta (" << originId << "->" << destId 
-             << ") aumento de" << QString::number(currentWeight, 'f', 1) 
-             << "a" << QString::number(newWeight, 'f', 1) 
-             << "(+" << QString::number(increment, 'f', 0) << "%)";
+    LOG_DEBUG << "[OK] Accidente aplicado: Ruta (" << originId << "->" << destId
+              << ") aumento de" << QString::number(currentWeight, 'f', 1)
+              << "a" << QString::number(newWeight, 'f', 1)
+              << "(+" << QString::number(increment, 'f', 0) << "%)";
     
+    notifyChange(GraphEvent::AccidentApplied, originId, destId, increment);
+             
     return true;
 }
 
@@ -938,13 +1542,13 @@ bool Graph::loadAccidents(const QString& filename)
     
     if (!file.exists())
     {
-        qDebug() << "[INFO] Archivo de accidentes no encontrado:" << filename;
+        LOG_INFO << "[INFO] Archivo de accidentes no encontrado:" << filename;
         return false;
     }
     
     if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
     {
-        qDebug() << "Error: No se pudo abrir archivo de accidentes:" << filename;
+        LOG_ERROR << "Error: No se pudo abrir archivo de accidentes:" << filename;
         return false;
     }
     
@@ -952,7 +1556,8 @@ bool Graph::loadAccidents(const QString& filename)
     int lineNumber = 0;
     int accidentsApplied = 0;
     
-    qDebug() << "[INFO] Aplicando accidentes desde" << filename;
+    LOG_INFO << "[INFO] Aplicando accidentes desde" << filename;
+    Log::RateLimit lineWarnings;
     
     while (!in.atEnd())
     {
@@ -970,8 +1575,8 @@ bool Graph::loadAccidents(const QString& filename)
         
         if (parts.size() != 3)
         {
-            qDebug() << "Advertencia: Linea" << lineNumber 
-                     << "tiene formato invalido (esperado: origen,destino,incremento):" << line;
+            LOG_WARNING_LIMITED(lineWarnings) << "Advertencia: Linea" << lineNumber 
+                                              << "tiene formato invalido (esperado: origen,destino,incremento):" << line;
             continue;
         }
         
@@ -982,8 +1587,8 @@ bool Graph::loadAccidents(const QString& filename)
         
         if (!ok1 || !ok2 || !ok3)
         {
-            qDebug() << "Advertencia: Linea" << lineNumber 
-                     << "contiene valores no numericos:" << line;
+            LOG_WARNING_LIMITED(lineWarnings) << "Advertencia: Linea" << lineNumber 
+                                              << "contiene valores no numericos:" << line;
             continue;
         }
         
@@ -996,7 +1601,7 @@ bool Graph::loadAccidents(const QString& filename)
     
     file.close();
     
-    qDebug() << "[INFO] Total de accidentes aplicados:" << accidentsApplied;
+    LOG_INFO << "[INFO] Total de accidentes aplicados:" << accidentsApplied;
     
     return accidentsApplied > 0;
 }
@@ -1006,7 +1611,7 @@ void Graph::clearAccidents()
 {
     if (affectedRoutes.isEmpty())
     {
-        qDebug() << "[INFO] No hay accidentes activos para limpiar.";
+        LOG_INFO << "[INFO] No hay accidentes activos para limpiar.";
         return;
     }
     
@@ -1017,23 +1622,15 @@ void Graph::clearAccidents()
     {
         if (originalWeights.contains(routeKey))
         {
-            int origin = routeKey.first;
-            int dest = routeKey.second;
+            int originIndex = stationTable.indexOf(routeKey.first);
+            int destIndex = stationTable.indexOf(routeKey.second);
             double originalWeight = originalWeights[routeKey];
             
             // Restore weight in adjacency list
-            if (adjList.contains(origin))
+            if (originIndex != StationTable::InvalidIndex && destIndex != StationTable::InvalidIndex &&
+                setWeightAt(originIndex, destIndex, originalWeight))
             {
-                QList<QPair<int, double>>& neighbors = adjList[origin];
-                for (int i = 0; i < neighbors.size(); i++)
-                {
-                    if (neighbors[i].first == dest)
-                    {
-                        neighbors[i].second = originalWeight;
-                        restoredCount++;
-                        break;
-                    }
-                }
+                restoredCount++;
             }
         }
     }
@@ -1041,8 +1638,10 @@ void Graph::clearAccidents()
     // Clear tracking data
     affectedRoutes.clear();
     originalWeights.clear();
+    accidentIncrements.clear();
     
-    qDebug() << "[INFO] Accidentes limpiados. Rutas restauradas:" << restoredCount;
+    LOG_INFO << "[INFO] Accidentes limpiados. Rutas restauradas:" << restoredCount;
+    notifyChange(GraphEvent::AccidentsCleared);
 }
 
 // Restore original weights without clearing tracking (for re-application)
@@ -1050,7 +1649,7 @@ bool Graph::restoreOriginalWeights()
 {
     if (originalWeights.isEmpty())
     {
-        qDebug() << "[INFO] No hay pesos originales guardados.";
+        LOG_INFO << "[INFO] No hay pesos originales guardados.";
         return false;
     }
     
@@ -1059,25 +1658,17 @@ bool Graph::restoreOriginalWeights()
         QPair<int, int> routeKey = it.key();
         double originalWeight = it.value();
         
-        int origin = routeKey.first;
-        int dest = routeKey.second;
+        int originIndex = stationTable.indexOf(routeKey.first);
+        int destIndex = stationTable.indexOf(routeKey.second);
         
         // Restore weight in adjacency list
-        if (adjList.contains(origin))
+        if (originIndex != StationTable::InvalidIndex && destIndex != StationTable::InvalidIndex)
         {
-            QList<QPair<int, double>>& neighbors = adjList[origin];
-            for (int i = 0; i < neighbors.size(); i++)
-            {
-                if (neighbors[i].first == dest)
-                {
-                    neighbors[i].second = originalWeight;
-                    break;
-                }
-            }
+            setWeightAt(originIndex, destIndex, originalWeight);
         }
     }
     
-    qDebug() << "[INFO] Pesos originales restaurados.";
+    LOG_INFO << "[INFO] Pesos originales restaurados.";
     return true;
 }
 
@@ -1087,4 +1678,76 @@ QSet<QPair<int, int>> Graph::getAffectedRoutes() const
     return affectedRoutes;
 }
 
+// Get the weights routes had before their accidents
+QHash<QPair<int, int>, double> Graph::getOriginalWeights() const
+{
+    return originalWeights;
+}
 
+// Restore the accident state of a route (its current weight already includes the increment)
+void Graph::restoreAccident(int originId, int destId, double originalWeight)
+{
+    QPair<int, int> routeKey(originId, destId);
+    affectedRoutes.insert(routeKey);
+    originalWeights[routeKey] = originalWeight;
+    
+    double currentWeight = getEdgeWeight(originId, destId);
+    accidentIncrements[routeKey] = (originalWeight > 0 && currentWeight != INF)
+        ? (currentWeight / originalWeight - 1.0) * 100.0
+        : 0.0;
+}
+
+// Get the increment (%) of the accident on a route
+double Graph::getAccidentIncrement(int originId, int destId) const
+{
+    return accidentIncrements.value(QPair<int, int>(originId, destId), 0.0);
+}
+
+// Set the listener for closure and accident changes
+void Graph::setChangeListener(function<void(const GraphEvent&)> listener)
+{
+    changeListener = listener;
+}
+
+// Report a change to the listener, if any
+void Graph::notifyChange(GraphEvent::Type type, int first, int second, double value) const
+{
+    if (changeListener)
+    {
+        GraphEvent event = { type, first, second, value };
+        changeListener(event);
+    }
+}
+
+// Get the network version
+quint64 Graph::getVersion() const
+{
+    return version;
+}
+
+// Get the changes made after a version
+bool Graph::getChangesSince(quint64 sinceVersion, QVector<NetworkChange>& changes) const
+{
+    changes.clear();
+    
+    if (sinceVersion < changeLogStart || sinceVersion > version)
+    {
+        return false;
+    }
+    
+    changes = changeLog.mid(static_cast<int>(sinceVersion - changeLogStart));
+    return true;
+}
+
+// Bump the version and remember what changed
+void Graph::recordChange(NetworkChange::Kind kind, int from, int to, double weight, double previous)
+{
+    if (changeLog.size() >= MaxLoggedChanges)
+    {
+        changeLog.clear();
+        changeLogStart = version;
+    }
+    
+    changeLog.append(NetworkChange{ kind, from, to, weight, previous });
+    version++;
+}
@@ -1,16 +1,24 @@
 #pragma once
 
 #include "Station.h"
+#include "StationTable.h"
 #include "DisjointSet.h"
+#include "Metrics.h"
 #include <QList>
+#include <QVector>
 #include <QPair>
 #include <QHash>
 #include <QSet>
+#include <QBitArray>
 #include <QQueue>
 #include <QDebug>
+#include <functional>
 
 using namespace std;
 
+// Forward declarations
+class JobToken;
+
 // Edge structure for MST algorithms
 struct Edge
 {
@@ -27,26 +35,87 @@ struct Edge
     }
 };
 
+// Change to closures or accidents, reported to the change listener (event journal)
+struct GraphEvent
+{
+    enum Type
+    {
+        StationClosed,
+        StationOpened,
+        RouteClosed,
+        RouteOpened,
+        ClosuresCleared,
+        AccidentApplied,
+        AccidentsCleared
+    };
+    
+    Type type;
+    int first;       // Station ID, or route origin
+    int second;      // Route destination (routes and accidents)
+    double value;    // Accident increment in percent
+};
+
+// Change that can alter shortest paths, one per network version (see Graph::getChangesSince)
+struct NetworkChange
+{
+    enum Kind
+    {
+        EdgeChanged,     // Route added or re-weighted (accidents, restored weights)
+        EdgeRemoved,     // Route taken out of the network
+        RouteClosed,     // Closure: the weight stays, searches skip the route
+        RouteOpened,
+        StationClosed,
+        StationOpened,
+        Reset            // Too broad to describe (bulk loads, removed stations, cleared closures)
+    };
+    
+    Kind kind;
+    int from;          // Station indices (routes), or the station (StationClosed/Opened)
+    int to;
+    double weight;     // Weight searches see now (infinity if removed or closed)
+    double previous;   // Weight before an EdgeChanged (infinity for a new route)
+};
+
 class Graph
 {
 private:
-    QHash<int, QList<QPair<int, double>>> adjList;  // Adjacency list (destination, weight)
-    QHash<int, Station> stations;                    // Registered stations
+    StationTable stationTable;                       // Registered stations (columns by dense index)
+    QVector<QList<QPair<int, double>>> adjList;      // Adjacency list by station index (destination index, weight)
     bool directed;                                   // Directed or undirected graph
     
     // Closures (blocked stations and routes)
-    QSet<int> closedStations;                        // Blocked stations
-    QList<QPair<int, int>> closedRoutes;            // Blocked routes
+    QBitArray closedStations;                        // Blocked stations, one bit per station index
+    QList<QPair<int, int>> closedRoutes;            // Blocked routes (in the order they were closed)
+    QSet<QPair<int, int>> closedRouteKeys;           // Same routes with the smaller ID first, for fast lookups
     
     // Accidents (increased weights on routes)
     QSet<QPair<int, int>> affectedRoutes;            // Routes with accidents applied
     QHash<QPair<int, int>, double> originalWeights;  // Original weights before accidents
+    QHash<QPair<int, int>, double> accidentIncrements; // Increment (%) of each affected route
+    
+    // Notified after every closure/accident change
+    function<void(const GraphEvent&)> changeListener;
+    void notifyChange(GraphEvent::Type type, int first = 0, int second = 0, double value = 0.0) const;
     
-    // Helper methods for DFS
-    void dfsHelper(int nodeId, QSet<int>& visited, QList<int>& result);
+    // Network version and the changes that made the last versions (shortest-path caches)
+    quint64 version;
+    quint64 changeLogStart;                          // Version before changeLog[0]
+    QVector<NetworkChange> changeLog;
+    void recordChange(NetworkChange::Kind kind, int from = -1, int to = -1, double weight = 0.0, double previous = 0.0);
+    
+    // Helper methods for DFS (station indices)
+    void dfsHelper(int nodeIndex, QVector<bool>& visited, QList<int>& result, JobToken* token,
+                   MetricsTally& tally) const;
     
     // Helper to get all edges
     QList<Edge> getAllEdges() const;
+    
+    // Index based helpers
+    QPair<int, int> makeRouteKey(int a, int b) const;
+    bool setWeightAt(int fromIndex, int toIndex, double weight);
+    
+    // Binary heap Dijkstra over station indices
+    void dijkstraIndexed(int startIndex, QVector<double>& dist, QVector<int>& pred, JobToken* token = nullptr) const;
 
 public:
     // Constructor
@@ -54,42 +123,81 @@ public:
     
     // Station management
     void addStation(const Station& station);
+    void reserve(int stations, int nameChars = 0);   // Pre-size the table before a bulk load
     void removeStation(int id);
+    bool updateStation(const Station& station);     // Name/position of an existing station (no warning)
     bool containsStation(int id) const;
-    Station* getStation(int id);
+    Station getStation(int id) const;            // Station() (ID -1) if it does not exist
     QList<Station> getAllStations() const;
     int getStationCount() const;
     
+    // Direct access to the station table (index based)
+    const StationTable& getStationTable() const;
+    int indexOf(int id) const;
+    bool isDirected() const;
+    
+    // Replace stations and adjacency in one step (binary snapshots); closures and accidents are cleared
+    void assignNetwork(StationTable table, QVector<QList<QPair<int, double>>> adjacency);
+    
     // Edge management
     void addEdge(int origin, int destination, double weight);
+    int addEdgesBulk(const QVector<Edge>& edges);    // Edges between station indices (bulk load)
     void removeEdge(int origin, int destination);
     bool hasEdge(int origin, int destination) const;
     double getEdgeWeight(int origin, int destination) const;
+    bool setEdgeWeight(int origin, int destination, double weight);   // Keeps accident increments
     
     // Graph operations
     void clear();
     bool isEmpty() const;
     
-    // Traversal algorithms
-    QList<int> bfs(int startId);
-    QList<int> dfs(int startId);
+    // Traversal algorithms (const: safe to run from several threads while the graph is not modified)
+    // The optional token is polled in the main loop: a cancelled run returns a partial result.
+    QList<int> bfs(int startId, JobToken* token = nullptr) const;
+    QList<int> dfs(int startId, JobToken* token = nullptr) const;
     
     // Shortest path algorithms
-    QHash<int, double> dijkstra(int startId);
-    QPair<QHash<int, double>, QHash<int, int>> dijkstraWithPath(int startId);
-    QHash<QPair<int, int>, double> floydWarshall();
+    QHash<int, double> dijkstra(int startId, JobToken* token = nullptr) const;
+    QPair<QHash<int, double>, QHash<int, int>> dijkstraWithPath(int startId, JobToken* token = nullptr) const;
+    QHash<QPair<int, int>, double> floydWarshall(JobToken* token = nullptr) const;
+    
+    // Shortest path tree by station index (distance infinity and predecessor -1 where unreachable);
+    // false if the station does not exist
+    bool shortestPathTree(int startId, QVector<double>& dist, QVector<int>& pred, JobToken* token = nullptr) const;
+    
+    // Point-to-point Dijkstra by station index for alternative routes (spur searches). On top of
+    // the closures it skips the stations set in 'blockedStations' and the routes from the start
+    // to 'blockedFirstHops'; it stops when the target is settled. Route in station indices
+    // (empty and distance infinity if there is none).
+    void shortestPathAvoiding(int startIndex, int targetIndex, const QBitArray& blockedStations,
+                              const QVector<int>& blockedFirstHops, QList<int>& route, double& distance,
+                              JobToken* token = nullptr) const;
+    
+    // Dijkstra by station index that never goes past 'budget': the stations reachable within it,
+    // nearest first (index, distance). Distances are kept in a hash, so the cost follows the
+    // size of the area, not the size of the network (isochrones for many depots). The token is
+    // only checked for cancellation, so it can be shared by searches on several threads.
+    void reachableWithin(int startIndex, double budget, QVector<QPair<int, double>>& reached,
+                         JobToken* token = nullptr) const;
     
     // Minimum spanning tree algorithms
-    QList<QPair<int, int>> primMST();
-    QList<QPair<int, int>> kruskalMST();
+    QList<QPair<int, int>> primMST(JobToken* token = nullptr) const;
+    QList<QPair<int, int>> kruskalMST(JobToken* token = nullptr) const;
     
     // Utility methods
     void printGraph() const;
     void printAdjacencyList() const;
     
-    // Get neighbors of a station
+    // Get neighbors of a station (IDs)
     QList<QPair<int, double>> getNeighbors(int stationId) const;
     
+    // Get neighbors of a station index (indices, no copies)
+    const QList<QPair<int, double>>& neighborsAt(int index) const;
+    
+    // Closure checks by station index (searches outside Graph)
+    bool isIndexClosed(int index) const;
+    bool isRouteClosedAt(int fromIndex, int toIndex) const;
+    
     // Closure management (blocking stations and routes)
     bool isStationClosed(int id) const;
     bool isRouteClosed(int a, int b) const;
@@ -107,5 +215,20 @@ public:
     void clearAccidents();
     bool restoreOriginalWeights();
     QSet<QPair<int, int>> getAffectedRoutes() const;
+    QHash<QPair<int, int>, double> getOriginalWeights() const;
+    double getAccidentIncrement(int originId, int destId) const;   // 0 if the route has no accident
+    
+    // Mark a route as affected without touching its current weight (restoring a saved state)
+    void restoreAccident(int originId, int destId, double originalWeight);
+    
+    // Listener for closure and accident changes (nullptr to remove)
+    void setChangeListener(function<void(const GraphEvent&)> listener);
+    
+    // Network version: bumped by every change that can alter a shortest path
+    // (routes, weights, closures, accidents, removed stations)
+    quint64 getVersion() const;
+    
+    // Changes made after 'version', oldest first; false if some are no longer kept
+    bool getChangesSince(quint64 sinceVersion, QVector<NetworkChange>& changes) const;
 };
 
@@ -1,11 +1,26 @@
 ﻿#include "GraphVisualizer.h"
 #include <QDebug>
+#include <QElapsedTimer>
 #include <QFont>
+#include <QImage>
+#include <QPainter>
+#include <QStyleOptionGraphicsItem>
+#include <QTimer>
+#include <QScrollBar>
+#include <QWheelEvent>
 #include <algorithm>
+#include <cmath>
+
+// Route line comparison: private data of one QGraphicsLineItem (approximate) and paint runs
+static const qint64 LineItemPrivateBytes = 256;
+static const int EdgePaintRuns = 3;
 
 // Constructor
 GraphVisualizer::GraphVisualizer(QGraphicsScene* scene, QGraphicsView* view, Graph* graph)
-    : QObject(nullptr), scene(scene), view(view), graph(graph), backgroundItem(nullptr)
+    : QObject(nullptr), scene(scene), view(view), graph(graph), edgeBatch(nullptr), batchedEdges(true),
+      backgroundItem(nullptr), updateDepth(0),
+      graphDrawn(false), gridDirty(true), culling(false), cullingThreshold(2000), detailLevel(Full),
+      namePixels(6.0), weightPixels(10.0), clusterPixels(1.5), regionDirty(true), viewTimer(nullptr), panning(false)
 {
     // Initialize default visual settings - will be recalculated when map loads
     nodeRadius = 30.0;  // Default, will adjust to map size
@@ -25,6 +40,20 @@ GraphVisualizer::GraphVisualizer(QGraphicsScene* scene, QGraphicsView* view, Gra
         view->setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);  // No horizontal scrollbar
         view->setVerticalScrollBarPolicy(Qt::ScrollBarAlwaysOff);    // No vertical scrollbar
         view->setResizeAnchor(QGraphicsView::AnchorViewCenter);
+        
+        // Level of detail and culling follow zoom and scrolling (coalesced)
+        viewTimer = new QTimer(this);
+        viewTimer->setSingleShot(true);
+        viewTimer->setInterval(30);
+        connect(viewTimer, &QTimer::timeout, this, [this]() {
+            updateVisibleItems();
+        });
+        connect(view->horizontalScrollBar(), &QScrollBar::valueChanged, this, [this]() {
+            scheduleViewUpdate();
+        });
+        connect(view->verticalScrollBar(), &QScrollBar::valueChanged, this, [this]() {
+            scheduleViewUpdate();
+        });
     }
     
     qDebug() << "GraphVisualizer inicializado correctamente.";
@@ -38,6 +67,8 @@ GraphVisualizer::~GraphVisualizer()
     nodeItems.clear();
     edgeItems.clear();
     weightLabels.clear();
+    nameLabels.clear();
+    edgeBatch = nullptr;
 }
 
 // Set click callback function
@@ -64,6 +95,47 @@ void GraphVisualizer::installClickEvent()
 // Event filter to capture mouse clicks on the map
 bool GraphVisualizer::eventFilter(QObject* obj, QEvent* event)
 {
+    if (view && obj == view->viewport())
+    {
+        // Mouse wheel: zoom around the cursor
+        if (event->type() == QEvent::Wheel)
+        {
+            QWheelEvent* wheelEvent = static_cast<QWheelEvent*>(event);
+            view->setTransformationAnchor(QGraphicsView::AnchorUnderMouse);
+            zoom(std::pow(1.0015, wheelEvent->angleDelta().y()));
+            view->setTransformationAnchor(QGraphicsView::AnchorViewCenter);
+            return true;
+        }
+        
+        // Middle button drag: pan
+        if (event->type() == QEvent::MouseButtonPress &&
+            static_cast<QMouseEvent*>(event)->button() == Qt::MiddleButton)
+        {
+            panning = true;
+            panStart = static_cast<QMouseEvent*>(event)->pos();
+            return true;
+        }
+        if (event->type() == QEvent::MouseMove && panning)
+        {
+            QPoint pos = static_cast<QMouseEvent*>(event)->pos();
+            QPoint delta = pos - panStart;
+            panStart = pos;
+            view->horizontalScrollBar()->setValue(view->horizontalScrollBar()->value() - delta.x());
+            view->verticalScrollBar()->setValue(view->verticalScrollBar()->value() - delta.y());
+            return true;
+        }
+        if (event->type() == QEvent::MouseButtonRelease && panning)
+        {
+            panning = false;
+            return true;
+        }
+        
+        if (event->type() == QEvent::Resize)
+        {
+            scheduleViewUpdate();
+        }
+    }
+    
     if (event->type() == QEvent::MouseButtonPress && obj == view->viewport())
     {
         QMouseEvent* mouseEvent = static_cast<QMouseEvent*>(event);
@@ -143,6 +215,7 @@ void GraphVisualizer::loadBackground(const QString& imagePath)
     nodeRadius = mapSize * 0.02;  // 2% of smaller dimension
     normalEdgeWidth = mapSize * 0.005;  // 0.5% of smaller dimension
     optimalEdgeWidth = mapSize * 0.008;  // 0.8% of smaller dimension
+    updateEdgePens();
     
     qDebug() << "Tamanos ajustados proporcionalmente:";
     qDebug() << "  - Radio nodos:" << nodeRadius;
@@ -169,7 +242,19 @@ void GraphVisualizer::clearScene()
     // Clear all stored items
     nodeItems.clear();
     edgeItems.clear();
+    edgeBatch = nullptr;  // Deleted by scene->clear()
     weightLabels.clear();
+    nameLabels.clear();
+    highlightedStations.clear();
+    optimalEdges.clear();
+    alternativeEdges.clear();
+    coverageItems.clear();
+    dirtyStations.clear();
+    dirtyRoutes.clear();
+    clusterItems.clear();
+    graphDrawn = false;
+    drawnRegion = QRectF();
+    regionDirty = true;
     
     // Clear scene (keeps background if setZValue was used correctly)
     QPixmap savedBackground;
@@ -212,8 +297,9 @@ void GraphVisualizer::drawGraph()
     
     qDebug() << "\nDibujando grafo...";
     
-    // Get all stations
-    QList<Station> stations = graph->getAllStations();
+    // Get all stations (indices into the station table)
+    const StationTable& table = graph->getStationTable();
+    QList<int> stations = table.indices();
     
     if (stations.isEmpty())
     {
@@ -221,18 +307,36 @@ void GraphVisualizer::drawGraph()
         return;
     }
     
+    graphDrawn = true;
+    culling = stations.size() > cullingThreshold;
+    detailLevel = detailForScale(view ? view->transform().m11() : 1.0);
+    
+    // Large networks: only the stations near the viewport get items
+    if (culling)
+    {
+        gridDirty = true;
+        fitInView();
+        updateVisibleItems();
+        
+        qDebug() << "Grafo dibujado (solo la zona visible):";
+        qDebug() << "  - Estaciones:" << nodeItems.size() << "de" << stations.size();
+        qDebug() << "  - Rutas:" << routeLineCount();
+        qDebug() << "  - Grupos:" << clusterItems.size();
+        return;
+    }
+    
     // First, draw all edges (behind nodes)
     int edgeCount = 0;
     QSet<QPair<int, int>> drawnEdges;
     
-    for (const Station& station : stations)
+    for (int index : stations)
     {
-        int stationId = station.getId();
-        QList<QPair<int, double>> neighbors = graph->getNeighbors(stationId);
+        int stationId = table.idAt(index);
+        const QList<QPair<int, double>>& neighbors = graph->neighborsAt(index);
         
         for (const auto& neighbor : neighbors)
         {
-            int neighborId = neighbor.first;
+            int neighborId = table.idAt(neighbor.first);
             double weight = neighbor.second;
             
             // For undirected graphs, avoid drawing same edge twice
@@ -240,7 +344,7 @@ void GraphVisualizer::drawGraph()
             
             if (!drawnEdges.contains(edgeKey))
             {
-                drawEdge(stationId, neighborId, weight);
+                drawEdge(index, neighbor.first, weight);
                 drawnEdges.insert(edgeKey);
                 edgeCount++;
             }
@@ -248,34 +352,40 @@ void GraphVisualizer::drawGraph()
     }
     
     // Then, draw all nodes (on top of edges)
-    for (const Station& station : stations)
+    for (int index : stations)
     {
-        drawStationNode(station);
+        drawStationNode(index);
     }
     
     qDebug() << "Grafo dibujado:";
     qDebug() << "  - Estaciones:" << stations.size();
     qDebug() << "  - Rutas:" << edgeCount;
+    if (edgeBatch)
+    {
+        qDebug() << "  - Memoria de rutas (lote):" << edgeBatch->memoryUsage() / 1024 << "KB";
+    }
     
     // Auto-fit to show entire map without scrollbars
     fitInView();
+    detailLevel = detailForScale(view ? view->transform().m11() : 1.0);
+    applyLabelVisibility();
 }
 
-// Draw a single station node
-void GraphVisualizer::drawStationNode(const Station& station)
+// Draw a single station node (by station table index)
+void GraphVisualizer::drawStationNode(int index)
 {
     if (!scene)
     {
         return;
     }
     
-    double x = station.getX();
-    double y = station.getY();
-    int id = station.getId();
+    const StationTable& table = graph->getStationTable();
+    double x = table.xAt(index);
+    double y = table.yAt(index);
+    int id = table.idAt(index);
     
-    // Check if station is closed
-    bool isClosed = graph->isStationClosed(id);
-    QColor nodeColor = isClosed ? QColor(128, 128, 128) : normalNodeColor;  // Gray if closed
+    // Gray if closed, highlight color if on the optimal route
+    QColor nodeColor = stationColor(id);
     
     // Calculate proportional border width
     double borderWidth = nodeRadius * 0.1;  // 10% of node radius
@@ -298,7 +408,7 @@ void GraphVisualizer::drawStationNode(const Station& station)
     nodeItems[id] = node;
     
     // Create label with station name and ID
-    QString label = QString("%1\n%2").arg(id).arg(station.getName());
+    QString label = QString("%1\n%2").arg(id).arg(table.nameViewAt(index));
     QGraphicsTextItem* text = scene->addText(label);
     
     // Calculate proportional font size based on node radius
@@ -315,62 +425,48 @@ void GraphVisualizer::drawStationNode(const Station& station)
     double textOffset = nodeRadius * 0.15;
     text->setPos(x + nodeRadius + textOffset, y - nodeRadius);
     text->setZValue(3);  // Above everything
+    text->setVisible(detailLevel >= Names);
+    
+    // Store label reference
+    nameLabels[id] = text;
 }
 
-// Draw an edge between two stations
-void GraphVisualizer::drawEdge(int fromId, int toId, double weight)
+// Draw an edge between two stations (by station table index)
+void GraphVisualizer::drawEdge(int fromIndex, int toIndex, double weight)
 {
-    // Check if route is closed (highest priority - red)
-    bool isClosed = graph->isRouteClosed(fromId, toId);
-    
-    // Check if route has an accident (medium priority - orange)
-    QSet<QPair<int, int>> affectedRoutes = graph->getAffectedRoutes();
-    bool hasAccident = affectedRoutes.contains(QPair<int, int>(fromId, toId)) || 
-                       affectedRoutes.contains(QPair<int, int>(toId, fromId));
-    
-    // Determine color: Red if closed, Orange if accident, Green otherwise
-    QColor edgeColor = normalEdgeColor;  // Default: Neon green
-    if (isClosed)
-    {
-        edgeColor = QColor(255, 0, 0);  // Red for closed routes
-    }
-    else if (hasAccident)
-    {
-        edgeColor = QColor(255, 140, 0);  // Orange for accidents
-    }
+    const StationTable& table = graph->getStationTable();
+    int fromId = table.idAt(fromIndex);
+    int toId = table.idAt(toIndex);
     
-    QPen pen(edgeColor, normalEdgeWidth);
-    drawEdgeWithStyle(fromId, toId, weight, pen);
+    // Red if closed, orange if accident, green otherwise
+    drawEdgeWithStyle(fromIndex, toIndex, weight, routeStyle(fromId, toId));
 }
 
-// Draw edge with custom style
-void GraphVisualizer::drawEdgeWithStyle(int fromId, int toId, double weight, const QPen& pen)
+// Draw edge with custom style (by station table index)
+void GraphVisualizer::drawEdgeWithStyle(int fromIndex, int toIndex, double weight, EdgeBatchItem::Style style)
 {
     if (!scene || !graph)
     {
         return;
     }
     
-    Station* fromStation = graph->getStation(fromId);
-    Station* toStation = graph->getStation(toId);
+    const StationTable& table = graph->getStationTable();
     
-    if (!fromStation || !toStation)
+    if (!table.isValidIndex(fromIndex) || !table.isValidIndex(toIndex))
     {
         return;
     }
     
-    double x1 = fromStation->getX();
-    double y1 = fromStation->getY();
-    double x2 = toStation->getX();
-    double y2 = toStation->getY();
-    
-    // Create line
-    QGraphicsLineItem* line = scene->addLine(x1, y1, x2, y2, pen);
-    line->setZValue(1);  // Below nodes, above background
+    int fromId = table.idAt(fromIndex);
+    int toId = table.idAt(toIndex);
+    double x1 = table.xAt(fromIndex);
+    double y1 = table.yAt(fromIndex);
+    double x2 = table.xAt(toIndex);
+    double y2 = table.yAt(toIndex);
     
-    // Store edge reference
+    // Create line (in the batch item, or one item per route)
     QPair<int, int> edgeKey = makeEdgeKey(fromId, toId);
-    edgeItems[edgeKey] = line;
+    setRouteLine(edgeKey, QLineF(x1, y1, x2, y2), style);
     
     // Create weight label
     QString weightText = QString::number(weight, 'f', 1);
@@ -391,90 +487,1067 @@ void GraphVisualizer::drawEdgeWithStyle(int fromId, int toId, double weight, con
     double midY = (y1 + y2) / 2.0;
     label->setPos(midX, midY);
     label->setZValue(2);
+    label->setVisible(detailLevel == Full);
     
     // Store label reference
     weightLabels[edgeKey] = label;
 }
 
-// Highlight optimal route
-void GraphVisualizer::drawOptimalRoute(const QList<int>& route)
+// Update the items of one station
+void GraphVisualizer::updateStation(int stationId)
 {
-    if (route.size() < 2)
+    dirtyStations.insert(stationId);
+    markIncidentRoutes(stationId);
+    
+    if (updateDepth == 0)
     {
-        qDebug() << "Advertencia: La ruta debe tener al menos 2 estaciones.";
-        return;
+        flushUpdates();
     }
+}
+
+// Update the items of one route
+void GraphVisualizer::updateRoute(int from, int to)
+{
+    dirtyRoutes.insert(makeEdgeKey(from, to));
     
-    qDebug() << "\nResaltando ruta optima...";
+    if (updateDepth == 0)
+    {
+        flushUpdates();
+    }
+}
+
+// Bring every item in line with the graph without rebuilding the scene
+void GraphVisualizer::refresh()
+{
+    if (!graph)
+    {
+        return;
+    }
     
-    QPen optimalPen(optimalEdgeColor, optimalEdgeWidth);
+    beginUpdate();
     
-    // Highlight edges in the route
-    for (int i = 0; i < route.size() - 1; i++)
+    const StationTable& table = graph->getStationTable();
+    for (int index : table.indices())
     {
-        int from = route[i];
-        int to = route[i + 1];
+        int stationId = table.idAt(index);
+        dirtyStations.insert(stationId);
         
-        // Remove old edge if exists
-        QPair<int, int> edgeKey = makeEdgeKey(from, to);
-        if (edgeItems.contains(edgeKey))
+        for (const auto& neighbor : graph->neighborsAt(index))
         {
-            scene->removeItem(edgeItems[edgeKey]);
-            delete edgeItems[edgeKey];
+            dirtyRoutes.insert(makeEdgeKey(stationId, table.idAt(neighbor.first)));
         }
+    }
+    
+    // Items whose station or route is gone
+    for (auto it = nodeItems.constBegin(); it != nodeItems.constEnd(); ++it)
+    {
+        dirtyStations.insert(it.key());
+    }
+    for (const QPair<int, int>& edgeKey : routeLineKeys())
+    {
+        dirtyRoutes.insert(edgeKey);
+    }
+    
+    endUpdate();
+}
+
+// Start a batch of updates
+void GraphVisualizer::beginUpdate()
+{
+    if (updateDepth++ == 0 && view)
+    {
+        view->setUpdatesEnabled(false);
+    }
+}
+
+// Apply the batched updates (outermost call only)
+void GraphVisualizer::endUpdate()
+{
+    if (updateDepth == 0)
+    {
+        return;
+    }
+    
+    if (--updateDepth == 0)
+    {
+        flushUpdates();
         
-        // Redraw with optimal style
-        Station* fromStation = graph->getStation(from);
-        Station* toStation = graph->getStation(to);
-        
-        if (fromStation && toStation)
+        if (view)
         {
-            double x1 = fromStation->getX();
-            double y1 = fromStation->getY();
-            double x2 = toStation->getX();
-            double y2 = toStation->getY();
-            
-            QGraphicsLineItem* line = scene->addLine(x1, y1, x2, y2, optimalPen);
-            line->setZValue(1);
-            edgeItems[edgeKey] = line;
+            view->setUpdatesEnabled(true);  // One repaint for the whole batch
         }
-        
-        // Highlight nodes in route
-        highlightStation(from);
+    }
+}
+
+// Apply pending station and route updates
+void GraphVisualizer::flushUpdates()
+{
+    if (!scene || !graph)
+    {
+        return;
     }
     
-    // Highlight last node
-    if (!route.isEmpty())
+    // Nothing on screen yet: draw everything once
+    if (!isGraphDrawn())
     {
-        highlightStation(route.last());
+        dirtyStations.clear();
+        dirtyRoutes.clear();
+        drawGraph();
+        return;
     }
     
-    qDebug() << "Ruta optima resaltada:" << route;
+    // Stations first (a removed station marks its routes), then routes
+    QSet<int> stations;
+    stations.swap(dirtyStations);
+    for (int stationId : stations)
+    {
+        applyStation(stationId);
+    }
+    
+    QSet<QPair<int, int>> routes;
+    routes.swap(dirtyRoutes);
+    for (const QPair<int, int>& edgeKey : routes)
+    {
+        applyRoute(edgeKey);
+    }
 }
 
-// Clear optimal route highlighting
-void GraphVisualizer::clearOptimalRoute()
+// Add, restyle or remove the node and label of a station
+void GraphVisualizer::applyStation(int stationId)
 {
-    // Redraw the entire graph to reset highlighting
-    drawGraph();
+    const StationTable& table = graph->getStationTable();
+    int index = table.indexOf(stationId);
+    
+    if (index == StationTable::InvalidIndex)
+    {
+        removeStationItems(stationId);
+        highlightedStations.remove(stationId);
+        gridDirty = true;
+        return;
+    }
+    
+    // With culling the station may have moved in or out of view: the grid is rebuilt later
+    if (culling)
+    {
+        gridDirty = true;
+        scheduleViewUpdate();
+    }
+    
+    if (!nodeItems.contains(stationId))
+    {
+        if (isInDrawnRegion(index))
+        {
+            drawStationNode(index);
+        }
+        return;
+    }
+    
+    double x = table.xAt(index);
+    double y = table.yAt(index);
+    
+    // Node: position and color (setBrush/setRect are no-ops when nothing changed)
+    QGraphicsEllipseItem* node = nodeItems[stationId];
+    node->setRect(x - nodeRadius, y - nodeRadius, nodeRadius * 2, nodeRadius * 2);
+    node->setBrush(QBrush(stationColor(stationId)));
+    
+    // Label: name and position
+    if (nameLabels.contains(stationId))
+    {
+        QGraphicsTextItem* text = nameLabels[stationId];
+        QString label = QString("%1\n%2").arg(stationId).arg(table.nameViewAt(index));
+        if (text->toPlainText() != label)
+        {
+            text->setPlainText(label);
+        }
+        
+        double textOffset = nodeRadius * 0.15;
+        text->setPos(x + nodeRadius + textOffset, y - nodeRadius);
+    }
 }
 
-// Highlight a specific station
-void GraphVisualizer::highlightStation(int stationId)
+// Add, restyle or remove the line and weight label of a route
+void GraphVisualizer::applyRoute(const QPair<int, int>& edgeKey)
 {
-    if (nodeItems.contains(stationId))
+    const StationTable& table = graph->getStationTable();
+    int fromIndex = table.indexOf(edgeKey.first);
+    int toIndex = table.indexOf(edgeKey.second);
+    
+    // The route may be stored in either direction
+    bool forward = graph->hasEdge(edgeKey.first, edgeKey.second);
+    bool backward = !forward && graph->hasEdge(edgeKey.second, edgeKey.first);
+    
+    if (fromIndex == StationTable::InvalidIndex || toIndex == StationTable::InvalidIndex || (!forward && !backward))
     {
-        nodeItems[stationId]->setBrush(QBrush(highlightNodeColor));
+        removeRouteItems(edgeKey);
+        optimalEdges.remove(edgeKey);
+        alternativeEdges.remove(edgeKey);
+        return;
+    }
+    
+    double weight = forward ? graph->getEdgeWeight(edgeKey.first, edgeKey.second)
+                            : graph->getEdgeWeight(edgeKey.second, edgeKey.first);
+    
+    if (!hasRouteLine(edgeKey))
+    {
+        if (isInDrawnRegion(fromIndex) || isInDrawnRegion(toIndex))
+        {
+            drawEdge(fromIndex, toIndex, weight);
+        }
+        return;
+    }
+    
+    double x1 = table.xAt(fromIndex);
+    double y1 = table.yAt(fromIndex);
+    double x2 = table.xAt(toIndex);
+    double y2 = table.yAt(toIndex);
+    
+    setRouteLine(edgeKey, QLineF(x1, y1, x2, y2), routeStyle(edgeKey.first, edgeKey.second));
+    
+    if (weightLabels.contains(edgeKey))
+    {
+        QGraphicsTextItem* label = weightLabels[edgeKey];
+        QString weightText = QString::number(weight, 'f', 1);
+        if (label->toPlainText() != weightText)
+        {
+            label->setPlainText(weightText);
+        }
+        label->setPos((x1 + x2) / 2.0, (y1 + y2) / 2.0);
     }
 }
 
-// Unhighlight a specific station
-void GraphVisualizer::unhighlightStation(int stationId)
+// Remove the node and label of a station
+void GraphVisualizer::removeStationItems(int stationId)
 {
     if (nodeItems.contains(stationId))
     {
-        nodeItems[stationId]->setBrush(QBrush(normalNodeColor));
+        QGraphicsEllipseItem* node = nodeItems.take(stationId);
+        scene->removeItem(node);
+        delete node;
+    }
+    
+    if (nameLabels.contains(stationId))
+    {
+        QGraphicsTextItem* text = nameLabels.take(stationId);
+        scene->removeItem(text);
+        delete text;
+    }
+}
+
+// Remove the line and weight label of a route
+void GraphVisualizer::removeRouteItems(const QPair<int, int>& edgeKey)
+{
+    removeRouteLine(edgeKey);
+    
+    if (weightLabels.contains(edgeKey))
+    {
+        QGraphicsTextItem* label = weightLabels.take(edgeKey);
+        scene->removeItem(label);
+        delete label;
+    }
+}
+
+// Mark the drawn routes of a station (they follow its position or disappear with it)
+void GraphVisualizer::markIncidentRoutes(int stationId)
+{
+    for (const QPair<int, int>& edgeKey : routeLineKeys())
+    {
+        if (edgeKey.first == stationId || edgeKey.second == stationId)
+        {
+            dirtyRoutes.insert(edgeKey);
+        }
+    }
+}
+
+// Fill color of a station: highlighted, closed (gray) or normal
+QColor GraphVisualizer::stationColor(int stationId) const
+{
+    if (highlightedStations.contains(stationId))
+    {
+        return highlightNodeColor;
+    }
+    if (graph && graph->isStationClosed(stationId))
+    {
+        return QColor(128, 128, 128);
+    }
+    return normalNodeColor;
+}
+
+// Style of a route: optimal, closed (red), accident (orange) or normal
+EdgeBatchItem::Style GraphVisualizer::routeStyle(int fromId, int toId) const
+{
+    if (optimalEdges.contains(makeEdgeKey(fromId, toId)))
+    {
+        return EdgeBatchItem::Optimal;
+    }
+    
+    // Alternative routes, one style per rank
+    auto alternative = alternativeEdges.constFind(makeEdgeKey(fromId, toId));
+    if (alternative != alternativeEdges.constEnd())
+    {
+        int rank = qMin(alternative.value(), static_cast<int>(EdgeBatchItem::Alternative3 - EdgeBatchItem::Alternative1 + 1));
+        return static_cast<EdgeBatchItem::Style>(EdgeBatchItem::Alternative1 + rank - 1);
+    }
+    
+    // Check if route is closed (highest priority - red)
+    if (graph->isRouteClosed(fromId, toId))
+    {
+        return EdgeBatchItem::Closed;
+    }
+    
+    // Check if route has an accident (medium priority - orange)
+    QSet<QPair<int, int>> affectedRoutes = graph->getAffectedRoutes();  // Implicitly shared, no copy
+    if (affectedRoutes.contains(QPair<int, int>(fromId, toId)) || 
+        affectedRoutes.contains(QPair<int, int>(toId, fromId)))
+    {
+        return EdgeBatchItem::Accident;
+    }
+    
+    return EdgeBatchItem::Normal;
+}
+
+// Check if a route has a line in the scene
+bool GraphVisualizer::hasRouteLine(const QPair<int, int>& edgeKey) const
+{
+    if (batchedEdges)
+    {
+        return edgeBatch && edgeBatch->containsRoute(edgeKey);
     }
+    return edgeItems.contains(edgeKey);
+}
+
+// Keys of the routes with a line in the scene
+QList<QPair<int, int>> GraphVisualizer::routeLineKeys() const
+{
+    if (batchedEdges)
+    {
+        return edgeBatch ? edgeBatch->routeKeys() : QList<QPair<int, int>>();
+    }
+    return edgeItems.keys();
+}
+
+// Number of route lines in the scene
+int GraphVisualizer::routeLineCount() const
+{
+    if (batchedEdges)
+    {
+        return edgeBatch ? edgeBatch->routeCount() : 0;
+    }
+    return edgeItems.size();
+}
+
+// Add or update the line of a route
+void GraphVisualizer::setRouteLine(const QPair<int, int>& edgeKey, const QLineF& line, EdgeBatchItem::Style style)
+{
+    if (batchedEdges)
+    {
+        if (!edgeBatch)
+        {
+            edgeBatch = new EdgeBatchItem();
+            edgeBatch->setZValue(1);  // Below nodes, above background
+            scene->addItem(edgeBatch);
+            updateEdgePens();
+        }
+        edgeBatch->setRoute(edgeKey, line, style);
+        return;
+    }
+    
+    if (edgeItems.contains(edgeKey))
+    {
+        QGraphicsLineItem* item = edgeItems[edgeKey];
+        item->setLine(line);
+        item->setPen(stylePen(style));
+        return;
+    }
+    
+    QGraphicsLineItem* item = scene->addLine(line, stylePen(style));
+    item->setZValue(1);  // Below nodes, above background
+    edgeItems[edgeKey] = item;
+}
+
+// Remove the line of a route
+void GraphVisualizer::removeRouteLine(const QPair<int, int>& edgeKey)
+{
+    if (batchedEdges)
+    {
+        if (edgeBatch)
+        {
+            edgeBatch->removeRoute(edgeKey);
+        }
+        return;
+    }
+    
+    if (edgeItems.contains(edgeKey))
+    {
+        QGraphicsLineItem* line = edgeItems.take(edgeKey);
+        scene->removeItem(line);
+        delete line;
+    }
+}
+
+// Give the batch item the current colors and widths
+void GraphVisualizer::updateEdgePens()
+{
+    if (!edgeBatch)
+    {
+        return;
+    }
+    
+    for (int style = 0; style < EdgeBatchItem::StyleCount; style++)
+    {
+        edgeBatch->setStylePen(static_cast<EdgeBatchItem::Style>(style), stylePen(static_cast<EdgeBatchItem::Style>(style)));
+    }
+}
+
+// Pen of a route style
+QPen GraphVisualizer::stylePen(EdgeBatchItem::Style style) const
+{
+    switch (style)
+    {
+    case EdgeBatchItem::Optimal:
+        return QPen(optimalEdgeColor, optimalEdgeWidth);
+    case EdgeBatchItem::Closed:
+        return QPen(QColor(255, 0, 0), normalEdgeWidth);      // Red for closed routes
+    case EdgeBatchItem::Accident:
+        return QPen(QColor(255, 140, 0), normalEdgeWidth);    // Orange for accidents
+    case EdgeBatchItem::Alternative1:
+        return QPen(QColor(255, 0, 255), optimalEdgeWidth * 0.8, Qt::DashLine);      // Magenta, dashed
+    case EdgeBatchItem::Alternative2:
+        return QPen(QColor(255, 255, 0), optimalEdgeWidth * 0.8, Qt::DashDotLine);   // Yellow, dash-dot
+    case EdgeBatchItem::Alternative3:
+        return QPen(QColor(30, 144, 255), optimalEdgeWidth * 0.8, Qt::DotLine);      // Blue, dotted
+    default:
+        return QPen(normalEdgeColor, normalEdgeWidth);        // Neon green
+    }
+}
+
+// Highlight optimal route
+void GraphVisualizer::drawOptimalRoute(const QList<int>& route)
+{
+    if (route.size() < 2)
+    {
+        qDebug() << "Advertencia: La ruta debe tener al menos 2 estaciones.";
+        return;
+    }
+    
+    qDebug() << "\nResaltando ruta optima...";
+    
+    // Restyle the route's lines in place
+    for (int i = 0; i < route.size() - 1; i++)
+    {
+        int from = route[i];
+        int to = route[i + 1];
+        
+        QPair<int, int> edgeKey = makeEdgeKey(from, to);
+        optimalEdges.insert(edgeKey);
+        applyRoute(edgeKey);
+        
+        // Highlight nodes in route
+        highlightStation(from);
+    }
+    
+    // Highlight last node
+    if (!route.isEmpty())
+    {
+        highlightStation(route.last());
+    }
+    
+    qDebug() << "Ruta optima resaltada:" << route;
+}
+
+// Highlight several routes: the first as the optimal one, the others in their own styles
+void GraphVisualizer::drawAlternativeRoutes(const QList<QList<int>>& routes)
+{
+    if (routes.isEmpty())
+    {
+        return;
+    }
+    
+    // A route shared by several alternatives keeps the style of the best one
+    for (int rank = routes.size() - 1; rank >= 1; rank--)
+    {
+        const QList<int>& route = routes[rank];
+        for (int i = 0; i < route.size() - 1; i++)
+        {
+            QPair<int, int> edgeKey = makeEdgeKey(route[i], route[i + 1]);
+            alternativeEdges.insert(edgeKey, rank);
+            applyRoute(edgeKey);
+        }
+    }
+    
+    drawOptimalRoute(routes.first());
+    qDebug() << "Rutas alternativas resaltadas:" << routes.size() - 1;
+}
+
+// Clear optimal route highlighting
+void GraphVisualizer::clearOptimalRoute()
+{
+    // Restyle only the items of the previous routes
+    QSet<int> stations;
+    stations.swap(highlightedStations);
+    QSet<QPair<int, int>> routes;
+    routes.swap(optimalEdges);
+    QHash<QPair<int, int>, int> alternatives;
+    alternatives.swap(alternativeEdges);
+    
+    for (int stationId : stations)
+    {
+        applyStation(stationId);
+    }
+    for (const QPair<int, int>& edgeKey : routes)
+    {
+        applyRoute(edgeKey);
+    }
+    for (auto it = alternatives.constBegin(); it != alternatives.constEnd(); ++it)
+    {
+        applyRoute(it.key());
+    }
+    
+    clearCoverageAreas();
+}
+
+// Shade the area each depot reaches
+void GraphVisualizer::drawCoverageAreas(const QList<Isochrone::Area>& areas)
+{
+    clearCoverageAreas();
+    
+    if (!scene || !graph)
+    {
+        return;
+    }
+    
+    const QList<QColor> colors = {
+        QColor(0, 191, 255, 70),     // Sky blue
+        QColor(255, 105, 180, 70),   // Pink
+        QColor(255, 215, 0, 70),     // Gold
+        QColor(138, 43, 226, 70),    // Violet
+        QColor(255, 140, 0, 70)      // Orange
+    };
+    
+    for (int i = 0; i < areas.size(); i++)
+    {
+        const Isochrone::Area& area = areas[i];
+        if (area.stations.isEmpty())
+        {
+            continue;
+        }
+        
+        // Covered routes (whole, or up to where the budget runs out) as one path;
+        // the depot alone is a dot in case it has no usable routes
+        QPainterPath path;
+        QPointF depot = getStationPosition(area.depotId);
+        path.moveTo(depot);
+        path.lineTo(depot);
+        for (const Isochrone::CoveredRoute& route : area.routes)
+        {
+            QPointF from = getStationPosition(route.from);
+            QPointF to = getStationPosition(route.to);
+            path.moveTo(from);
+            path.lineTo(from + (to - from) * qMin(1.0, route.fraction));
+        }
+        
+        // One wide translucent stroke: the path is filled once, so its own overlaps do not darken
+        QPen pen(colors[i % colors.size()], nodeRadius * 4.0, Qt::SolidLine, Qt::RoundCap);
+        QGraphicsPathItem* item = scene->addPath(path, pen);
+        item->setZValue(0.5);  // Above the background, below routes and nodes
+        coverageItems.append(item);
+    }
+    
+    qDebug() << "Areas de cobertura dibujadas:" << coverageItems.size();
+}
+
+// Remove the shaded coverage areas
+void GraphVisualizer::clearCoverageAreas()
+{
+    for (QGraphicsPathItem* item : coverageItems)
+    {
+        scene->removeItem(item);
+        delete item;
+    }
+    coverageItems.clear();
+}
+
+// Highlight a specific station
+void GraphVisualizer::highlightStation(int stationId)
+{
+    highlightedStations.insert(stationId);
+    if (nodeItems.contains(stationId))
+    {
+        nodeItems[stationId]->setBrush(QBrush(highlightNodeColor));
+    }
+}
+
+// Unhighlight a specific station
+void GraphVisualizer::unhighlightStation(int stationId)
+{
+    highlightedStations.remove(stationId);
+    if (nodeItems.contains(stationId))
+    {
+        nodeItems[stationId]->setBrush(QBrush(stationColor(stationId)));
+    }
+}
+
+// Set the station count above which culling is used
+void GraphVisualizer::setCullingThreshold(int stations)
+{
+    cullingThreshold = stations;
+}
+
+// Set level of detail thresholds (node radius on screen, in pixels)
+void GraphVisualizer::setDetailThresholds(double namePixels, double weightPixels, double clusterPixels)
+{
+    this->namePixels = namePixels;
+    this->weightPixels = weightPixels;
+    this->clusterPixels = clusterPixels;
+    regionDirty = true;
+    scheduleViewUpdate();
+}
+
+// Get current level of detail
+GraphVisualizer::DetailLevel GraphVisualizer::getDetailLevel() const
+{
+    return detailLevel;
+}
+
+// Scale the view
+void GraphVisualizer::zoom(double factor)
+{
+    if (!view || factor <= 0.0)
+    {
+        return;
+    }
+    
+    // Keep the scale within sane limits
+    double scale = view->transform().m11() * factor;
+    if (scale < 1e-4 || scale > 1e3)
+    {
+        return;
+    }
+    
+    view->scale(factor, factor);
+    scheduleViewUpdate();
+}
+
+// Update the visible items once the view stops changing
+void GraphVisualizer::scheduleViewUpdate()
+{
+    if (viewTimer)
+    {
+        viewTimer->start();
+    }
+}
+
+// Level of detail for a view scale
+GraphVisualizer::DetailLevel GraphVisualizer::detailForScale(double scale) const
+{
+    double pixels = nodeRadius * scale;
+    
+    if (pixels >= weightPixels)
+    {
+        return Full;
+    }
+    if (pixels >= namePixels)
+    {
+        return Names;
+    }
+    if (culling && pixels < clusterPixels)
+    {
+        return Clusters;
+    }
+    return Nodes;
+}
+
+// Scene area shown by the view
+QRectF GraphVisualizer::visibleSceneRect() const
+{
+    if (!view || !view->viewport())
+    {
+        return scene ? scene->sceneRect() : QRectF();
+    }
+    return view->mapToScene(view->viewport()->rect()).boundingRect();
+}
+
+// Check if a station lies in the area covered by the items
+bool GraphVisualizer::isInDrawnRegion(int index) const
+{
+    if (!culling)
+    {
+        return true;
+    }
+    
+    const StationTable& table = graph->getStationTable();
+    return detailLevel != Clusters && drawnRegion.contains(QPointF(table.xAt(index), table.yAt(index)));
+}
+
+// Bring the items in line with the view (level of detail and culling)
+void GraphVisualizer::updateVisibleItems()
+{
+    if (!scene || !graph || !graphDrawn)
+    {
+        return;
+    }
+    
+    DetailLevel level = detailForScale(view ? view->transform().m11() : 1.0);
+    
+    // Small networks keep every item; only the text follows the zoom
+    if (!culling)
+    {
+        if (level != detailLevel)
+        {
+            detailLevel = level;
+            applyLabelVisibility();
+        }
+        return;
+    }
+    
+    if (gridDirty)
+    {
+        grid.build(graph->getStationTable());
+        gridDirty = false;
+        regionDirty = true;
+    }
+    
+    // Items cover the visible area plus half a screen on each side, so short pans need no work
+    QRectF visible = visibleSceneRect();
+    if (level == detailLevel && !regionDirty && drawnRegion.contains(visible))
+    {
+        return;
+    }
+    
+    QRectF region = visible.adjusted(-visible.width() / 2, -visible.height() / 2,
+                                     visible.width() / 2, visible.height() / 2);
+    
+    // One repaint for the whole change (a batch already holds the updates)
+    bool holdUpdates = view && updateDepth == 0;
+    if (holdUpdates)
+    {
+        view->setUpdatesEnabled(false);
+    }
+    
+    bool textChanged = level != detailLevel;
+    if (level == Clusters)
+    {
+        removeAllItems();
+        removeClusters();
+        detailLevel = level;
+        drawClusters(region);
+    }
+    else
+    {
+        removeClusters();
+        detailLevel = level;
+        drawRegion(region);
+        if (textChanged)
+        {
+            applyLabelVisibility();
+        }
+    }
+    
+    drawnRegion = region;
+    regionDirty = false;
+    
+    if (holdUpdates)
+    {
+        view->setUpdatesEnabled(true);
+    }
+}
+
+// Create the items of the stations in a region and drop the ones outside it
+void GraphVisualizer::drawRegion(const QRectF& region)
+{
+    const StationTable& table = graph->getStationTable();
+    
+    // Stations that left the region (their routes go with them unless the other end stays)
+    QList<int> stationsOut;
+    for (auto it = nodeItems.constBegin(); it != nodeItems.constEnd(); ++it)
+    {
+        int index = table.indexOf(it.key());
+        if (index == StationTable::InvalidIndex || !region.contains(QPointF(table.xAt(index), table.yAt(index))))
+        {
+            stationsOut.append(it.key());
+        }
+    }
+    for (int stationId : stationsOut)
+    {
+        removeStationItems(stationId);
+    }
+    
+    QList<QPair<int, int>> routesOut;
+    for (const QPair<int, int>& edgeKey : routeLineKeys())
+    {
+        if (!nodeItems.contains(edgeKey.first) && !nodeItems.contains(edgeKey.second))
+        {
+            routesOut.append(edgeKey);
+        }
+    }
+    for (const QPair<int, int>& edgeKey : routesOut)
+    {
+        removeRouteItems(edgeKey);
+    }
+    
+    // Stations in the region and the routes leaving them (directed routes are found from their origin)
+    for (int index : grid.query(region))
+    {
+        double x = table.xAt(index);
+        double y = table.yAt(index);
+        if (!region.contains(QPointF(x, y)))
+        {
+            continue;
+        }
+        
+        int stationId = table.idAt(index);
+        for (const auto& neighbor : graph->neighborsAt(index))
+        {
+            if (!hasRouteLine(makeEdgeKey(stationId, table.idAt(neighbor.first))))
+            {
+                drawEdge(index, neighbor.first, neighbor.second);
+            }
+        }
+        
+        if (!nodeItems.contains(stationId))
+        {
+            drawStationNode(index);
+        }
+    }
+}
+
+// Draw one circle per block of grid cells, sized by its station count
+void GraphVisualizer::drawClusters(const QRectF& region)
+{
+    int firstColumn, firstRow, lastColumn, lastRow;
+    if (!grid.cellRange(region, firstColumn, firstRow, lastColumn, lastRow))
+    {
+        return;
+    }
+    
+    // Blocks about 32 pixels wide on screen
+    double scale = view ? view->transform().m11() : 1.0;
+    int block = std::max(1, static_cast<int>(std::ceil(32.0 / (grid.getCellSize() * scale))));
+    firstColumn -= firstColumn % block;
+    firstRow -= firstRow % block;
+    
+    double maxRadius = block * grid.getCellSize() / 2.0;
+    double borderWidth = std::max(1.0, 1.5 / scale);
+    
+    for (int row = firstRow; row <= lastRow; row += block)
+    {
+        for (int column = firstColumn; column <= lastColumn; column += block)
+        {
+            int count = 0;
+            QPointF sum;
+            for (int r = row; r < std::min(row + block, grid.getRows()); r++)
+            {
+                for (int c = column; c < std::min(column + block, grid.getColumns()); c++)
+                {
+                    count += grid.countAt(c, r);
+                    sum += grid.sumAt(c, r);
+                }
+            }
+            
+            if (count == 0)
+            {
+                continue;
+            }
+            
+            // 3 pixels for a lone station, growing with the logarithm of the count
+            QPointF center = sum / static_cast<double>(count);
+            double radius = std::min((3.0 + 2.0 * std::log2(static_cast<double>(count))) / scale, maxRadius);
+            
+            QGraphicsEllipseItem* cluster = scene->addEllipse(
+                center.x() - radius, center.y() - radius, radius * 2, radius * 2,
+                QPen(Qt::black, borderWidth), QBrush(normalNodeColor));
+            cluster->setZValue(2);
+            cluster->setToolTip(QString("%1 estaciones").arg(count));
+            clusterItems.append(cluster);
+        }
+    }
+}
+
+// Remove the cluster circles
+void GraphVisualizer::removeClusters()
+{
+    for (QGraphicsItem* item : clusterItems)
+    {
+        scene->removeItem(item);
+        delete item;
+    }
+    clusterItems.clear();
+}
+
+// Remove every station and route item (background and clusters stay)
+void GraphVisualizer::removeAllItems()
+{
+    QList<QPair<int, int>> routes = routeLineKeys();
+    for (const QPair<int, int>& edgeKey : routes)
+    {
+        removeRouteItems(edgeKey);
+    }
+    
+    QList<int> stations = nodeItems.keys();
+    for (int stationId : stations)
+    {
+        removeStationItems(stationId);
+    }
+}
+
+// Show or hide names and weights for the current level of detail
+void GraphVisualizer::applyLabelVisibility()
+{
+    bool showNames = detailLevel >= Names;
+    bool showWeights = detailLevel == Full;
+    
+    for (QGraphicsTextItem* text : nameLabels)
+    {
+        text->setVisible(showNames);
+    }
+    for (QGraphicsTextItem* label : weightLabels)
+    {
+        label->setVisible(showWeights);
+    }
+}
+
+// Choose between the batch item and one item per route (for comparisons); redraws if needed
+void GraphVisualizer::setBatchedEdges(bool batched)
+{
+    if (batchedEdges == batched)
+    {
+        return;
+    }
+    
+    batchedEdges = batched;
+    if (graphDrawn)
+    {
+        drawGraph();
+    }
+}
+
+// Check if routes are painted by the batch item
+bool GraphVisualizer::isBatchedEdges() const
+{
+    return batchedEdges;
+}
+
+// Find the route under a scene point
+bool GraphVisualizer::routeAt(double x, double y, int& from, int& to) const
+{
+    QPointF pos(x, y);
+    QPair<int, int> edgeKey;
+    bool found = false;
+    
+    // A few pixels of slack on screen, whatever the zoom
+    double tolerance = 3.0 / (view ? view->transform().m11() : 1.0);
+    
+    if (batchedEdges)
+    {
+        found = edgeBatch && edgeBatch->routeAt(pos, tolerance, edgeKey);
+    }
+    else
+    {
+        double best = -1.0;
+        for (auto it = edgeItems.constBegin(); it != edgeItems.constEnd(); ++it)
+        {
+            double distance = EdgeBatchItem::distanceToLine(pos, it.value()->line());
+            if (distance <= tolerance + it.value()->pen().widthF() / 2.0 && (best < 0.0 || distance < best))
+            {
+                best = distance;
+                edgeKey = it.key();
+                found = true;
+            }
+        }
+    }
+    
+    if (found)
+    {
+        from = edgeKey.first;
+        to = edgeKey.second;
+    }
+    return found;
+}
+
+// Approximate memory of the route lines. A line item is counted as the object, its private
+// data (pen, line, transform, flags, scene index entry; about LineItemPrivateBytes) and its map node.
+qint64 GraphVisualizer::getEdgeMemoryUsage() const
+{
+    if (batchedEdges)
+    {
+        return edgeBatch ? edgeBatch->memoryUsage() : 0;
+    }
+    
+    qint64 perItem = sizeof(QGraphicsLineItem) + LineItemPrivateBytes + sizeof(QPair<int, int>) + 3 * sizeof(void*);
+    return edgeItems.size() * perItem;
+}
+
+// Paint the route lines into an image of the viewport size, as the view would (fastest of a few runs)
+qint64 GraphVisualizer::measureEdgePaintNanoseconds() const
+{
+    if (!view || (batchedEdges ? edgeBatch == nullptr : edgeItems.isEmpty()))
+    {
+        return 0;
+    }
+    
+    QImage image(qMax(1, view->viewport()->width()), qMax(1, view->viewport()->height()),
+                 QImage::Format_ARGB32_Premultiplied);
+    image.fill(0);
+    QPainter painter(&image);
+    painter.setRenderHint(QPainter::Antialiasing);
+    painter.setTransform(view->viewportTransform());
+    
+    QStyleOptionGraphicsItem option;
+    QElapsedTimer timer;
+    qint64 best = -1;
+    
+    for (int run = 0; run < EdgePaintRuns; run++)
+    {
+        timer.start();
+        if (batchedEdges)
+        {
+            option.exposedRect = edgeBatch->boundingRect();
+            edgeBatch->paint(&painter, &option);
+        }
+        else
+        {
+            for (QGraphicsLineItem* item : edgeItems)
+            {
+                option.exposedRect = item->boundingRect();
+                item->paint(&painter, &option);
+            }
+        }
+        qint64 elapsed = timer.nsecsElapsed();
+        best = (best < 0) ? elapsed : qMin(best, elapsed);
+    }
+    
+    painter.end();
+    return best;
+}
+
+// Draw the graph with each kind of route line and measure both; the current mode is restored
+bool GraphVisualizer::compareEdgeModes(EdgeModeComparison& result)
+{
+    result = EdgeModeComparison();
+    if (!graphDrawn)
+    {
+        return false;
+    }
+    
+    bool wasBatched = batchedEdges;
+    for (bool batched : { wasBatched, !wasBatched })
+    {
+        setBatchedEdges(batched);
+        
+        if (batched)
+        {
+            result.routes = edgeBatch ? edgeBatch->routeCount() : 0;
+            result.batchBytes = getEdgeMemoryUsage();
+            result.batchPaintNs = measureEdgePaintNanoseconds();
+        }
+        else
+        {
+            result.itemBytes = getEdgeMemoryUsage();
+            result.itemPaintNs = measureEdgePaintNanoseconds();
+        }
+    }
+    setBatchedEdges(wasBatched);
+    
+    return true;
 }
 
 // Get station position
@@ -482,10 +1555,11 @@ QPointF GraphVisualizer::getStationPosition(int stationId) const
 {
     if (graph)
     {
-        Station* station = graph->getStation(stationId);
-        if (station)
+        const StationTable& table = graph->getStationTable();
+        int index = table.indexOf(stationId);
+        if (index != StationTable::InvalidIndex)
         {
-            return QPointF(station->getX(), station->getY());
+            return QPointF(table.xAt(index), table.yAt(index));
         }
     }
     return QPointF(0, 0);
@@ -512,6 +1586,7 @@ void GraphVisualizer::fitInView()
         // Just fit without scaling down - keep native resolution
         view->fitInView(scene->sceneRect(), Qt::KeepAspectRatio);
         // Removed scale to keep 100% zoom (native resolution)
+        scheduleViewUpdate();
     }
 }
 
@@ -527,8 +1602,8 @@ void GraphVisualizer::resetZoom()
 // Check if graph is currently drawn
 bool GraphVisualizer::isGraphDrawn() const
 {
-    // Graph is considered drawn if there are node items visible
-    return !nodeItems.isEmpty();
+    // Set by drawGraph(); with culling there may be no node items in view
+    return graphDrawn;
 }
 
 // Validate whether a point lies within the current map bounds
@@ -574,12 +1649,14 @@ void GraphVisualizer::setEdgeColor(const QColor& normal, const QColor& optimal)
 {
     normalEdgeColor = normal;
     optimalEdgeColor = optimal;
+    updateEdgePens();
 }
 
 void GraphVisualizer::setEdgeWidth(double normal, double optimal)
 {
     normalEdgeWidth = normal;
     optimalEdgeWidth = optimal;
+    updateEdgePens();
 }
 
 
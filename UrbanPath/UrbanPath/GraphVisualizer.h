@@ -1,17 +1,22 @@
 #pragma once
 
 #include "Graph.h"
+#include "Isochrone.h"
 #include "Station.h"
+#include "StationGrid.h"
+#include "EdgeBatchItem.h"
 #include <QGraphicsScene>
 #include <QGraphicsView>
 #include <QGraphicsEllipseItem>
 #include <QGraphicsLineItem>
 #include <QGraphicsTextItem>
 #include <QGraphicsPixmapItem>
+#include <QGraphicsPathItem>
 #include <QPixmap>
 #include <QPen>
 #include <QBrush>
 #include <QMap>
+#include <QSet>
 #include <QList>
 #include <QObject>
 #include <QEvent>
@@ -20,8 +25,30 @@
 
 using namespace std;
 
+class QTimer;
+
+// Cost of the route lines in both drawing modes (GraphVisualizer::compareEdgeModes)
+struct EdgeModeComparison
+{
+    int routes = 0;
+    qint64 batchBytes = 0;       // Batch item arrays
+    qint64 itemBytes = 0;        // One QGraphicsLineItem per route (approximate footprint)
+    qint64 batchPaintNs = 0;     // One offscreen paint of every line
+    qint64 itemPaintNs = 0;
+};
+
 class GraphVisualizer : public QObject
 {
+public:
+    // Level of detail, chosen from the on-screen node radius
+    enum DetailLevel
+    {
+        Clusters,   // Nearby stations merged into one circle per block of grid cells (culling only)
+        Nodes,      // Stations and routes, no text
+        Names,      // Plus station names
+        Full        // Plus route weights
+    };
+    
 private:
     QGraphicsScene* scene;
     QGraphicsView* view;
@@ -29,10 +56,43 @@ private:
     
     // Store visual elements for updates
     QMap<int, QGraphicsEllipseItem*> nodeItems;
-    QMap<QPair<int, int>, QGraphicsLineItem*> edgeItems;
+    QMap<QPair<int, int>, QGraphicsLineItem*> edgeItems;   // Only when batchedEdges is off
+    EdgeBatchItem* edgeBatch;                                // Every route line, one item
+    bool batchedEdges;
     QMap<QPair<int, int>, QGraphicsTextItem*> weightLabels;
+    QMap<int, QGraphicsTextItem*> nameLabels;
     QGraphicsPixmapItem* backgroundItem;
     
+    // Highlighting state (kept so items can be restyled in place)
+    QSet<int> highlightedStations;
+    QSet<QPair<int, int>> optimalEdges;
+    QHash<QPair<int, int>, int> alternativeEdges;   // Rank of the best alternative using a route (1 = second route)
+    QList<QGraphicsPathItem*> coverageItems;         // Shaded isochrone areas, one per depot
+    
+    // Incremental updates waiting for endUpdate()
+    QSet<int> dirtyStations;
+    QSet<QPair<int, int>> dirtyRoutes;
+    int updateDepth;
+    bool graphDrawn;
+    
+    // Level of detail and viewport culling. Above 'cullingThreshold' stations only the
+    // stations near the viewport get items (found through a grid over their coordinates);
+    // the items are rebuilt when the view is zoomed, panned or resized.
+    StationGrid grid;
+    bool gridDirty;                  // Stations moved or were added since build()
+    bool culling;
+    int cullingThreshold;
+    DetailLevel detailLevel;
+    double namePixels;               // Minimum node radius on screen for station names
+    double weightPixels;             // ...for route weights
+    double clusterPixels;            // Below this, stations are clustered
+    QRectF drawnRegion;              // Scene area covered by the items (culling)
+    bool regionDirty;                // Items must be rebuilt on the next view update
+    QList<QGraphicsItem*> clusterItems;
+    QTimer* viewTimer;               // Coalesces view changes into one update
+    bool panning;
+    QPoint panStart;
+    
     // Visual settings
     double nodeRadius;
     QColor normalNodeColor;
@@ -57,14 +117,45 @@ public:
     void drawGraph();
     void clearScene();
     
+    // Incremental updates: add, remove or restyle only the items of one station or route.
+    // A station or route that no longer exists in the graph loses its items.
+    // If nothing is drawn yet, the whole graph is drawn instead.
+    void updateStation(int stationId);    // Node, label and its routes
+    void updateRoute(int from, int to);   // Line and weight label
+    void refresh();                       // Every station and route, reusing the items
+    
+    // Batched updates: changes between beginUpdate() and endUpdate() are applied once,
+    // with one repaint (calls can nest)
+    void beginUpdate();
+    void endUpdate();
+    
     // Route highlighting
     void drawOptimalRoute(const QList<int>& route);
-    void clearOptimalRoute();
+    void drawAlternativeRoutes(const QList<QList<int>>& routes);   // Shortest first, one style per rank
+    void clearOptimalRoute();                                       // Alternatives and coverage too
+    
+    // Coverage areas: the routes each depot reaches within its budget, shaded in one
+    // translucent color per depot (replaces the previous areas)
+    void drawCoverageAreas(const QList<Isochrone::Area>& areas);
+    void clearCoverageAreas();
     
     // Individual drawing methods
     void highlightStation(int stationId);
     void unhighlightStation(int stationId);
     
+    // Level of detail: thresholds are node radii in screen pixels
+    void setCullingThreshold(int stations);
+    void setDetailThresholds(double namePixels, double weightPixels, double clusterPixels);
+    DetailLevel getDetailLevel() const;
+    
+    // Route lines: one batch item (default) or one QGraphicsLineItem per route.
+    // compareEdgeModes() draws the graph both ways, measures each and restores the mode.
+    void setBatchedEdges(bool batched);
+    bool isBatchedEdges() const;
+    qint64 getEdgeMemoryUsage() const;             // Current mode, approximate
+    qint64 measureEdgePaintNanoseconds() const;    // Current mode, offscreen at the view size
+    bool compareEdgeModes(EdgeModeComparison& result);   // false if the graph is not drawn
+    
     // Visual settings
     void setNodeRadius(double radius);
     void setNodeColor(const QColor& normal, const QColor& highlight);
@@ -75,6 +166,8 @@ public:
     void fitInView();
     void resetZoom();
     bool isGraphDrawn() const;  // Check if graph is currently drawn
+    bool routeAt(double x, double y, int& from, int& to) const;   // Route under a scene point
+    void zoom(double factor);   // Scale the view (mouse wheel does the same)
     bool isPointWithinMap(double x, double y) const;
     
     // Map click callback setup
@@ -86,10 +179,43 @@ protected:
     bool eventFilter(QObject* obj, QEvent* event) override;
 
 private:
-    // Helper methods for drawing
-    void drawStationNode(const Station& station);
-    void drawEdge(int fromId, int toId, double weight);
-    void drawEdgeWithStyle(int fromId, int toId, double weight, const QPen& pen);
+    // Helper methods for drawing (station table indices)
+    void drawStationNode(int index);
+    void drawEdge(int fromIndex, int toIndex, double weight);
+    void drawEdgeWithStyle(int fromIndex, int toIndex, double weight, EdgeBatchItem::Style style);
+    
+    // Route lines (batch item or per-route items)
+    bool hasRouteLine(const QPair<int, int>& edgeKey) const;
+    QList<QPair<int, int>> routeLineKeys() const;
+    int routeLineCount() const;
+    void setRouteLine(const QPair<int, int>& edgeKey, const QLineF& line, EdgeBatchItem::Style style);
+    void removeRouteLine(const QPair<int, int>& edgeKey);
+    void updateEdgePens();
+    QPen stylePen(EdgeBatchItem::Style style) const;
+    
+    // Incremental update helpers
+    void flushUpdates();
+    void applyStation(int stationId);
+    void applyRoute(const QPair<int, int>& edgeKey);
+    void removeStationItems(int stationId);
+    void removeRouteItems(const QPair<int, int>& edgeKey);
+    void markIncidentRoutes(int stationId);
+    
+    // Level of detail and culling helpers
+    void scheduleViewUpdate();
+    void updateVisibleItems();
+    DetailLevel detailForScale(double scale) const;
+    QRectF visibleSceneRect() const;
+    bool isInDrawnRegion(int index) const;
+    void drawRegion(const QRectF& region);
+    void drawClusters(const QRectF& region);
+    void removeClusters();
+    void removeAllItems();
+    void applyLabelVisibility();
+    
+    // Current style of a station or route
+    QColor stationColor(int stationId) const;
+    EdgeBatchItem::Style routeStyle(int fromId, int toId) const;
     
     // Coordinate conversion
     QPointF getStationPosition(int stationId) const;
@@ -0,0 +1,799 @@
+#include "HubLabelIndex.h"
+#include "FileFingerprint.h"
+#include "Log.h"
+#include "Metrics.h"
+#include "Parallel.h"
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QSaveFile>
+#include <QThread>
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <vector>
+
+namespace
+{
+
+const double INF = std::numeric_limits<double>::infinity();
+
+// Hubs searched one at a time before the batches start (they prune the most)
+const int SequentialHubs = 256;
+
+// Batch size: one hub per this many hubs already done, up to MaxBatchHubs
+const int BatchDivisor = 16;
+const int MaxBatchHubs = 256;
+
+typedef std::pair<double, int> HeapItem;
+typedef std::priority_queue<HeapItem, std::vector<HeapItem>, std::greater<HeapItem>> MinHeap;
+
+// File header (native byte order, checked with byteOrder)
+struct HubLabelHeader
+{
+    char magic[8];                 // "UPHUBS" + two zero bytes
+    quint32 version;
+    quint32 byteOrder;             // 0x01020304 as written by the saving machine
+    quint32 flags;                 // Bit 0: directed graph
+    quint32 slotCount;             // Station slots (includes removed ones)
+    quint32 entryCount;            // Label entries, both sides, without sentinels
+    quint32 hubBytes;              // Bytes of the varint section
+    quint64 rawSize;               // Payload size before compression
+    quint64 networkHash;           // Network the labels were built for
+    quint64 payloadSize;           // Bytes after the header (compressed)
+    quint64 payloadChecksum;
+};
+
+static_assert(sizeof(HubLabelHeader) == 64, "Hub label header must be 64 bytes");
+
+const char HubLabelMagic[8] = { 'U', 'P', 'H', 'U', 'B', 'S', 0, 0 };
+const quint32 HubLabelByteOrder = 0x01020304;
+
+// Adjacency of the current network in compressed rows (closed stations and routes left out)
+struct Adjacency
+{
+    QVector<int> first;       // Row start per station slot (one extra entry at the end)
+    QVector<int> target;
+    QVector<double> weight;
+};
+
+// Label entry while the labels grow
+struct LabelEntry
+{
+    int hub;                  // Hub rank (station index in search results)
+    double dist;
+};
+
+typedef QVector<QVector<LabelEntry>> LabelRows;
+
+// Work space of one thread: distances from the root, the root's own label by rank
+struct SearchSpace
+{
+    QVector<double> dist;
+    QVector<double> rootLabel;
+    QVector<int> touched;
+};
+
+// Forward adjacency (and the reverse one for directed graphs) of the current network
+void buildAdjacency(const Graph& graph, Adjacency& forward, Adjacency& backward)
+{
+    const StationTable& table = graph.getStationTable();
+    int slotTotal = table.slotCount();
+
+    forward.first.fill(0, slotTotal + 1);
+    for (int index : table.indices())
+    {
+        if (graph.isIndexClosed(index))
+        {
+            continue;
+        }
+        for (const auto& neighbor : graph.neighborsAt(index))
+        {
+            if (!graph.isIndexClosed(neighbor.first) && !graph.isRouteClosedAt(index, neighbor.first))
+            {
+                forward.first[index + 1]++;
+            }
+        }
+    }
+    for (int i = 0; i < slotTotal; i++)
+    {
+        forward.first[i + 1] += forward.first[i];
+    }
+
+    forward.target.resize(forward.first[slotTotal]);
+    forward.weight.resize(forward.first[slotTotal]);
+    for (int index : table.indices())
+    {
+        int position = forward.first[index];
+        if (position == forward.first[index + 1])
+        {
+            continue;
+        }
+        for (const auto& neighbor : graph.neighborsAt(index))
+        {
+            if (!graph.isIndexClosed(neighbor.first) && !graph.isRouteClosedAt(index, neighbor.first))
+            {
+                forward.target[position] = neighbor.first;
+                forward.weight[position] = neighbor.second;
+                position++;
+            }
+        }
+    }
+
+    if (!graph.isDirected())
+    {
+        return;
+    }
+
+    // Reverse: count, prefix sums, fill
+    backward.first.fill(0, slotTotal + 1);
+    for (int target : forward.target)
+    {
+        backward.first[target + 1]++;
+    }
+    for (int i = 0; i < slotTotal; i++)
+    {
+        backward.first[i + 1] += backward.first[i];
+    }
+
+    backward.target.resize(forward.target.size());
+    backward.weight.resize(forward.weight.size());
+    QVector<int> next = backward.first;
+    for (int from = 0; from < slotTotal; from++)
+    {
+        for (int e = forward.first[from]; e < forward.first[from + 1]; e++)
+        {
+            int position = next[forward.target[e]]++;
+            backward.target[position] = from;
+            backward.weight[position] = forward.weight[e];
+        }
+    }
+}
+
+// Hash of the station IDs and the usable routes (a saved index only fits the same network)
+quint64 hashNetwork(const Graph& graph, const Adjacency& forward)
+{
+    const QVector<int>& ids = graph.getStationTable().idColumn();
+    quint64 hash = FileFingerprint::hashBytes(reinterpret_cast<const char*>(ids.constData()), ids.size() * sizeof(int));
+    hash = (hash ^ FileFingerprint::hashBytes(reinterpret_cast<const char*>(forward.first.constData()),
+                                              forward.first.size() * sizeof(int))) * 0x100000001B3ULL;
+    hash = (hash ^ FileFingerprint::hashBytes(reinterpret_cast<const char*>(forward.target.constData()),
+                                              forward.target.size() * sizeof(int))) * 0x100000001B3ULL;
+    hash = (hash ^ FileFingerprint::hashBytes(reinterpret_cast<const char*>(forward.weight.constData()),
+                                              forward.weight.size() * sizeof(double))) * 0x100000001B3ULL;
+    return hash;
+}
+
+// Pruned Dijkstra from a hub. 'rootRow' is the hub's label on the side the prune test
+// reads, 'rows' the labels the search grows. A station is pruned when the labels built
+// so far already give its distance; the others are returned in 'found' (index, distance).
+void prunedSearch(const Adjacency& adjacency, int root, const QVector<LabelEntry>& rootRow, const LabelRows& rows,
+                  SearchSpace& space, QVector<LabelEntry>& found)
+{
+    MetricsTally tally(Metrics::HubLabelBuild);
+    found.clear();
+
+    for (const LabelEntry& entry : rootRow)
+    {
+        space.rootLabel[entry.hub] = entry.dist;
+    }
+
+    MinHeap heap;
+    space.dist[root] = 0.0;
+    space.touched.append(root);
+    heap.push(HeapItem(0.0, root));
+    tally.count(Metrics::HeapOperations);
+
+    while (!heap.empty())
+    {
+        HeapItem top = heap.top();
+        heap.pop();
+        tally.count(Metrics::HeapOperations);
+
+        int node = top.second;
+        if (top.first > space.dist[node])
+        {
+            continue;  // Stale entry
+        }
+
+        // Prune: a hub seen by both ends already gives this distance
+        bool covered = false;
+        for (const LabelEntry& entry : rows[node])
+        {
+            if (space.rootLabel[entry.hub] + entry.dist <= top.first)
+            {
+                covered = true;
+                break;
+            }
+        }
+        if (covered)
+        {
+            continue;
+        }
+
+        tally.count(Metrics::NodesSettled);
+        found.append(LabelEntry{ node, top.first });
+
+        for (int e = adjacency.first[node]; e < adjacency.first[node + 1]; e++)
+        {
+            int target = adjacency.target[e];
+            double newDist = top.first + adjacency.weight[e];
+            tally.count(Metrics::EdgesScanned);
+
+            if (newDist < space.dist[target])
+            {
+                if (space.dist[target] == INF)
+                {
+                    space.touched.append(target);
+                }
+                space.dist[target] = newDist;
+                heap.push(HeapItem(newDist, target));
+                tally.count(Metrics::EdgesRelaxed);
+                tally.count(Metrics::HeapOperations);
+            }
+        }
+    }
+
+    // Leave the work space clean for the next hub
+    for (int node : space.touched)
+    {
+        space.dist[node] = INF;
+    }
+    space.touched.clear();
+    for (const LabelEntry& entry : rootRow)
+    {
+        space.rootLabel[entry.hub] = INF;
+    }
+}
+
+// Varint: 7 bits per byte, lowest first, high bit set on every byte but the last
+void appendVarint(QByteArray& out, quint32 value)
+{
+    while (value >= 0x80)
+    {
+        out.append(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    out.append(static_cast<char>(value));
+}
+
+bool readVarint(const uchar*& cursor, const uchar* end, quint32& value)
+{
+    value = 0;
+    for (int shift = 0; shift < 35 && cursor < end; shift += 7)
+    {
+        uchar byte = *cursor++;
+        value |= static_cast<quint32>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+}
+
+// Constructor
+HubLabelIndex::HubLabelIndex()
+    : slotCount(0), stationCount(0), directed(false), built(false), builtVersion(0), networkHash(0), buildMs(0),
+      threads(0)
+{
+}
+
+// Compute the labels of every station
+bool HubLabelIndex::build(const Graph& graph)
+{
+    MetricsTimer timer(Metrics::HubLabelBuild);
+    QElapsedTimer elapsed;
+    elapsed.start();
+
+    clear();
+    directed = graph.isDirected();
+    builtVersion = graph.getVersion();
+
+    QList<int> live = graph.getStationTable().indices();
+    if (live.isEmpty())
+    {
+        return false;
+    }
+
+    Adjacency forward;
+    Adjacency backward;
+    buildAdjacency(graph, forward, backward);
+    slotCount = forward.first.size() - 1;
+    stationCount = live.size();
+    networkHash = hashNetwork(graph, forward);
+
+    // Most connected stations first: they lie on the most shortest paths
+    QVector<int> degree(slotCount, 0);
+    for (int index : live)
+    {
+        degree[index] = forward.first[index + 1] - forward.first[index];
+        if (directed)
+        {
+            degree[index] += backward.first[index + 1] - backward.first[index];
+        }
+    }
+    QVector<int> order(live.begin(), live.end());
+    std::stable_sort(order.begin(), order.end(), [&degree](int a, int b) { return degree[a] > degree[b]; });
+
+    // Rows under construction; undirected graphs grow a single side
+    LabelRows outRows(slotCount);
+    LabelRows inRows(directed ? slotCount : 0);
+    LabelRows& targetRows = directed ? inRows : outRows;
+
+    int workers = (threads > 0) ? threads : QThread::idealThreadCount();
+    int searchesPerHub = directed ? 2 : 1;
+    QVector<SearchSpace> spaces(workers);
+    for (SearchSpace& space : spaces)
+    {
+        space.dist.fill(INF, slotCount);
+        space.rootLabel.fill(INF, stationCount);
+    }
+
+    int done = 0;
+    while (done < order.size())
+    {
+        int batch = 1;
+        if (workers > 1 && done >= SequentialHubs)
+        {
+            batch = qBound(workers, done / BatchDivisor, MaxBatchHubs);
+        }
+        batch = qMin(batch, static_cast<int>(order.size()) - done);
+
+        // Searches of the batch read the labels of the earlier batches only
+        QVector<QVector<LabelEntry>> found(batch * searchesPerHub);
+        Parallel::runWithWorker(found.size(), workers, [&](int task, int worker) {
+            int root = order[done + task / searchesPerHub];
+            if (task % searchesPerHub == 0)
+            {
+                // d(hub, v) for the labels that end at v
+                prunedSearch(forward, root, outRows[root], targetRows, spaces[worker], found[task]);
+            }
+            else
+            {
+                // d(v, hub) for the labels that start at v
+                prunedSearch(backward, root, inRows[root], outRows, spaces[worker], found[task]);
+            }
+        });
+
+        // Hubs join the rows in rank order, so every row stays sorted
+        for (int task = 0; task < found.size(); task++)
+        {
+            int rank = done + task / searchesPerHub;
+            LabelRows& rows = (task % searchesPerHub == 0) ? targetRows : outRows;
+            for (const LabelEntry& entry : found[task])
+            {
+                rows[entry.hub].append(LabelEntry{ rank, entry.dist });
+            }
+        }
+        done += batch;
+    }
+
+    // Flatten into compressed rows closed by a sentinel
+    auto flatten = [this](LabelRows& rows, Labels& labels) {
+        labels.first.fill(0, slotCount + 1);
+        for (int i = 0; i < slotCount; i++)
+        {
+            labels.first[i + 1] = labels.first[i] + rows[i].size() + 1;
+        }
+        labels.hub.resize(labels.first[slotCount]);
+        labels.dist.resize(labels.first[slotCount]);
+        for (int i = 0; i < slotCount; i++)
+        {
+            int position = labels.first[i];
+            for (const LabelEntry& entry : rows[i])
+            {
+                labels.hub[position] = entry.hub;
+                labels.dist[position] = entry.dist;
+                position++;
+            }
+            labels.hub[position] = Sentinel;
+            labels.dist[position] = INF;
+            rows[i] = QVector<LabelEntry>();
+        }
+    };
+    flatten(outRows, outLabels);
+    if (directed)
+    {
+        flatten(inRows, inLabels);
+    }
+
+    built = true;
+    buildMs = elapsed.elapsed();
+
+    LOG_INFO << "Etiquetas de hubs:" << getEntryCount() << "entradas (" << static_cast<double>(getEntryCount()) / stationCount
+             << "por estacion)," << getLabelBytes() / 1024 << "KB, construidas en" << buildMs << "ms.";
+    return true;
+}
+
+// Set the number of threads
+void HubLabelIndex::setThreads(int threads)
+{
+    this->threads = qMax(0, threads);
+}
+
+// Get the number of threads
+int HubLabelIndex::getThreads() const
+{
+    return threads;
+}
+
+// Check if the labels describe the current network
+bool HubLabelIndex::isCurrent(const Graph& graph) const
+{
+    return built && builtVersion == graph.getVersion();
+}
+
+// Distance between two stations
+bool HubLabelIndex::distance(const Graph& graph, int originId, int destId, double& result) const
+{
+    MetricsTimer timer(Metrics::HubLabelQuery);
+    result = INF;
+
+    int source = graph.indexOf(originId);
+    int target = graph.indexOf(destId);
+    if (source == StationTable::InvalidIndex || target == StationTable::InvalidIndex)
+    {
+        return false;
+    }
+
+    if (source == target)
+    {
+        result = 0.0;
+    }
+    else if (built && source < slotCount && target < slotCount)
+    {
+        result = distanceAt(source, target);
+    }
+    return true;
+}
+
+// Merge of two labels sorted by hub rank
+double HubLabelIndex::distanceAt(int fromIndex, int toIndex) const
+{
+    const Labels& in = targetLabels();
+    const int* a = outLabels.hub.constData() + outLabels.first[fromIndex];
+    const double* da = outLabels.dist.constData() + outLabels.first[fromIndex];
+    const int* b = in.hub.constData() + in.first[toIndex];
+    const double* db = in.dist.constData() + in.first[toIndex];
+
+    // Both rows end with the same sentinel hub, so the loop stops there
+    double best = INF;
+    while (true)
+    {
+        if (*a < *b)
+        {
+            a++;
+            da++;
+        }
+        else if (*a > *b)
+        {
+            b++;
+            db++;
+        }
+        else
+        {
+            if (*a == Sentinel)
+            {
+                break;
+            }
+            best = qMin(best, *da + *db);
+            a++;
+            da++;
+            b++;
+            db++;
+        }
+    }
+    return best;
+}
+
+// Write the labels to a file
+bool HubLabelIndex::save(const QString& filename) const
+{
+    lastError.clear();
+
+    if (!built)
+    {
+        lastError = "No hay etiquetas de hubs construidas.";
+        LOG_ERROR << "Error:" << lastError;
+        return false;
+    }
+
+    // Varint section: per side and station, the row length and the hub rank deltas
+    QList<const Labels*> sides = { &outLabels };
+    if (directed)
+    {
+        sides.append(&inLabels);
+    }
+
+    QByteArray raw;
+    raw.reserve(getEntryCount() * 2 + slotCount * sides.size());
+    quint32 entries = 0;
+    for (const Labels* labels : sides)
+    {
+        for (int i = 0; i < slotCount; i++)
+        {
+            int first = labels->first[i];
+            int length = labels->first[i + 1] - first - 1;
+            appendVarint(raw, static_cast<quint32>(length));
+
+            int previous = 0;
+            for (int e = first; e < first + length; e++)
+            {
+                appendVarint(raw, static_cast<quint32>(labels->hub[e] - previous));
+                previous = labels->hub[e];
+            }
+            entries += length;
+        }
+    }
+    quint32 hubBytes = static_cast<quint32>(raw.size());
+
+    // Distance section, 8-byte aligned, in the same order
+    raw.append((8 - raw.size() % 8) % 8, '\0');
+    for (const Labels* labels : sides)
+    {
+        for (int i = 0; i < slotCount; i++)
+        {
+            int first = labels->first[i];
+            int length = labels->first[i + 1] - first - 1;
+            raw.append(reinterpret_cast<const char*>(labels->dist.constData() + first), length * sizeof(double));
+        }
+    }
+
+    QByteArray payload = qCompress(raw);
+
+    HubLabelHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, HubLabelMagic, sizeof(header.magic));
+    header.version = FormatVersion;
+    header.byteOrder = HubLabelByteOrder;
+    header.flags = directed ? 1u : 0u;
+    header.slotCount = static_cast<quint32>(slotCount);
+    header.entryCount = entries;
+    header.hubBytes = hubBytes;
+    header.rawSize = static_cast<quint64>(raw.size());
+    header.networkHash = networkHash;
+    header.payloadSize = static_cast<quint64>(payload.size());
+    header.payloadChecksum = FileFingerprint::hashBytes(payload.constData(), payload.size());
+
+    // Write atomically so a failed save never leaves broken labels behind
+    QSaveFile file(filename);
+
+    if (!file.open(QIODevice::WriteOnly))
+    {
+        lastError = QString("No se pudo abrir el archivo %1 para escritura.").arg(filename);
+        LOG_ERROR << "Error:" << lastError;
+        return false;
+    }
+
+    if (file.write(reinterpret_cast<const char*>(&header), sizeof(header)) != sizeof(header) ||
+        file.write(payload) != payload.size() ||
+        !file.commit())
+    {
+        lastError = QString("No se pudieron escribir las etiquetas %1.").arg(filename);
+        LOG_ERROR << "Error:" << lastError;
+        return false;
+    }
+
+    LOG_INFO << "Etiquetas de hubs guardadas en" << filename << "(" << entries << "entradas,"
+             << (sizeof(header) + payload.size()) << "bytes)";
+    return true;
+}
+
+// Read labels written for this network
+bool HubLabelIndex::load(const QString& filename, const Graph& graph)
+{
+    lastError.clear();
+
+    QFile file(filename);
+
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        lastError = QString("No se pudo abrir el archivo %1 para lectura.").arg(filename);
+        LOG_ERROR << "Error:" << lastError;
+        return false;
+    }
+
+    QByteArray data = file.readAll();
+    HubLabelHeader header;
+    memset(&header, 0, sizeof(header));
+    if (data.size() >= static_cast<qsizetype>(sizeof(header)))
+    {
+        memcpy(&header, data.constData(), sizeof(header));
+    }
+
+    Adjacency forward;
+    Adjacency backward;
+    buildAdjacency(graph, forward, backward);
+
+    // Validate header
+    if (data.size() < static_cast<qsizetype>(sizeof(header)))
+    {
+        lastError = QString("Las etiquetas %1 estan incompletas.").arg(filename);
+    }
+    else if (memcmp(header.magic, HubLabelMagic, sizeof(header.magic)) != 0)
+    {
+        lastError = QString("%1 no es un archivo de etiquetas de UrbanPath.").arg(filename);
+    }
+    else if (header.byteOrder != HubLabelByteOrder)
+    {
+        lastError = QString("Las etiquetas %1 fueron creadas en una arquitectura incompatible.").arg(filename);
+    }
+    else if (header.version != FormatVersion)
+    {
+        lastError = QString("Version de etiquetas no soportada: %1 (se esperaba %2).").arg(header.version).arg(FormatVersion);
+    }
+    else if (static_cast<qint64>(header.payloadSize) != data.size() - static_cast<qint64>(sizeof(header)))
+    {
+        lastError = QString("Las etiquetas %1 tienen un tamano inconsistente.").arg(filename);
+    }
+    else if (FileFingerprint::hashBytes(data.constData() + sizeof(header), header.payloadSize) != header.payloadChecksum)
+    {
+        lastError = QString("Las etiquetas %1 estan danadas (checksum invalido).").arg(filename);
+    }
+    else if (((header.flags & 1u) != 0) != graph.isDirected() ||
+             static_cast<int>(header.slotCount) != forward.first.size() - 1 ||
+             header.networkHash != hashNetwork(graph, forward))
+    {
+        lastError = QString("Las etiquetas %1 no corresponden a la red actual.").arg(filename);
+    }
+
+    QByteArray raw;
+    if (lastError.isEmpty())
+    {
+        raw = qUncompress(reinterpret_cast<const uchar*>(data.constData() + sizeof(header)),
+                          static_cast<qsizetype>(header.payloadSize));
+        data.clear();
+
+        quint64 distanceOffset = (static_cast<quint64>(header.hubBytes) + 7) & ~static_cast<quint64>(7);
+        if (static_cast<quint64>(raw.size()) != header.rawSize ||
+            distanceOffset + static_cast<quint64>(header.entryCount) * sizeof(double) != header.rawSize)
+        {
+            lastError = QString("Las etiquetas %1 estan danadas (tamano descomprimido invalido).").arg(filename);
+        }
+    }
+
+    if (!lastError.isEmpty())
+    {
+        LOG_ERROR << "Error:" << lastError;
+        return false;
+    }
+
+    clear();
+    directed = graph.isDirected();
+    slotCount = static_cast<int>(header.slotCount);
+
+    // Decode the rows; every read is checked against the section bounds
+    const uchar* cursor = reinterpret_cast<const uchar*>(raw.constData());
+    const uchar* hubEnd = cursor + header.hubBytes;
+    const char* distances = raw.constData() + ((header.hubBytes + 7) & ~7u);
+    quint32 remaining = header.entryCount;
+    bool consistent = true;
+
+    auto decode = [&](Labels& labels) {
+        labels.first.fill(0, slotCount + 1);
+        labels.hub.clear();
+        labels.dist.clear();
+        for (int i = 0; i < slotCount && consistent; i++)
+        {
+            quint32 length = 0;
+            if (!readVarint(cursor, hubEnd, length) || length > remaining)
+            {
+                consistent = false;
+                break;
+            }
+
+            quint32 rank = 0;
+            for (quint32 e = 0; e < length; e++)
+            {
+                quint32 delta = 0;
+                if (!readVarint(cursor, hubEnd, delta) || (e > 0 && delta == 0) ||
+                    static_cast<quint64>(rank) + delta >= static_cast<quint64>(slotCount))
+                {
+                    consistent = false;
+                    break;
+                }
+                rank += delta;
+                labels.hub.append(static_cast<int>(rank));
+                double dist;
+                memcpy(&dist, distances, sizeof(double));
+                distances += sizeof(double);
+                labels.dist.append(dist);
+            }
+            remaining -= length;
+
+            labels.hub.append(Sentinel);
+            labels.dist.append(INF);
+            labels.first[i + 1] = labels.hub.size();
+        }
+    };
+
+    decode(outLabels);
+    if (directed)
+    {
+        decode(inLabels);
+    }
+
+    if (!consistent || remaining != 0 || cursor != hubEnd)
+    {
+        clear();
+        lastError = QString("Las etiquetas %1 estan danadas (filas inconsistentes).").arg(filename);
+        LOG_ERROR << "Error:" << lastError;
+        return false;
+    }
+
+    stationCount = graph.getStationTable().indices().size();
+    networkHash = header.networkHash;
+    builtVersion = graph.getVersion();
+    built = true;
+
+    LOG_INFO << "Etiquetas de hubs" << filename << "cargadas. (" << header.entryCount << "entradas)";
+    return true;
+}
+
+// Check if the labels exist
+bool HubLabelIndex::isBuilt() const
+{
+    return built;
+}
+
+// Get the number of label entries
+qint64 HubLabelIndex::getEntryCount() const
+{
+    // Every row holds one sentinel
+    qint64 count = outLabels.hub.size() - qMax(0, static_cast<int>(outLabels.first.size()) - 1);
+    if (directed)
+    {
+        count += inLabels.hub.size() - qMax(0, static_cast<int>(inLabels.first.size()) - 1);
+    }
+    return count;
+}
+
+// Get the memory used by the labels
+qint64 HubLabelIndex::getLabelBytes() const
+{
+    return (outLabels.first.size() + inLabels.first.size()) * sizeof(int)
+           + (outLabels.hub.size() + inLabels.hub.size()) * (sizeof(int) + sizeof(double));
+}
+
+// Get the construction time
+qint64 HubLabelIndex::getBuildMs() const
+{
+    return buildMs;
+}
+
+// Get the number of stations with labels
+int HubLabelIndex::getStationCount() const
+{
+    return stationCount;
+}
+
+// Drop the labels
+void HubLabelIndex::clear()
+{
+    outLabels = Labels();
+    inLabels = Labels();
+    slotCount = 0;
+    stationCount = 0;
+    built = false;
+    builtVersion = 0;
+    networkHash = 0;
+    buildMs = 0;
+}
+
+// Get last error message
+QString HubLabelIndex::getLastError() const
+{
+    return lastError;
+}
+
+// Labels read at the target of a query
+const HubLabelIndex::Labels& HubLabelIndex::targetLabels() const
+{
+    return directed ? inLabels : outLabels;
+}
+
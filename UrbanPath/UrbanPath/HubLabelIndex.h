@@ -0,0 +1,95 @@
+#pragma once
+
+#include "Graph.h"
+#include <QString>
+#include <QVector>
+#include <QtGlobal>
+
+using namespace std;
+
+// Hub labels (pruned landmark labeling) for distance-only queries.
+// Every station keeps a label: a list of (hub, distance) pairs such that for any two
+// stations s and t some hub on a shortest s-t path appears in the out-label of s and
+// in the in-label of t. A query is then a merge of two arrays sorted by hub rank:
+//   d(s, t) = min over common hubs h of  dOut(s, h) + dIn(h, t)
+// Undirected graphs use one label per station for both sides.
+//
+// The labels are built with one pruned Dijkstra per station, most connected stations
+// first: a search stops at every station whose distance the labels built so far already
+// give. Hubs are processed in batches on several threads; hubs of the same batch do not
+// prune each other, which only adds a few entries.
+//
+// The labels describe the network as it was built (closures and accidents included), so
+// any change to the graph makes them stale (isCurrent() compares the network version).
+// save()/load() keep them on disk next to the data files: hub ranks delta-encoded as
+// varints and the distances, compressed with zlib and checked against the network.
+class HubLabelIndex
+{
+public:
+    static const quint32 FormatVersion = 1;
+
+    // Constructor
+    HubLabelIndex();
+
+    // Compute the labels of every station; false for an empty network
+    bool build(const Graph& graph);
+
+    // Threads for the construction (0 = one per core)
+    void setThreads(int threads);
+    int getThreads() const;
+
+    // Check if the labels were built (or loaded) for the current network
+    bool isCurrent(const Graph& graph) const;
+
+    // Distance between two stations (infinity if unreachable); false if a station does not exist.
+    // The index must be current for the graph.
+    bool distance(const Graph& graph, int originId, int destId, double& result) const;
+
+    // Distance between two station indices, without checks (the hot path of batch queries)
+    double distanceAt(int fromIndex, int toIndex) const;
+
+    // Write the labels; false if the file cannot be written
+    bool save(const QString& filename) const;
+
+    // Read labels written for this same network; false if the file is damaged or belongs to another network
+    bool load(const QString& filename, const Graph& graph);
+
+    // Index information
+    bool isBuilt() const;
+    qint64 getEntryCount() const;      // Label entries of all stations (both sides)
+    qint64 getLabelBytes() const;      // Memory used by the labels
+    qint64 getBuildMs() const;
+    int getStationCount() const;
+
+    void clear();
+
+    // Get last error (save and load)
+    QString getLastError() const;
+
+private:
+    // Labels of one side in compressed rows. Every row is sorted by hub rank and ends
+    // with a sentinel entry (hub Sentinel, distance infinity), so the merge needs no bounds checks.
+    struct Labels
+    {
+        QVector<int> first;        // Row start per station slot (one extra entry at the end)
+        QVector<int> hub;          // Hub ranks
+        QVector<double> dist;
+    };
+
+    static const int Sentinel = 0x7FFFFFFF;
+
+    Labels outLabels;              // Distance from the station to its hubs (both sides if undirected)
+    Labels inLabels;               // Distance from the hubs to the station (directed graphs only)
+    int slotCount;
+    int stationCount;
+    bool directed;
+    bool built;
+    quint64 builtVersion;
+    quint64 networkHash;           // Hash of the network the labels describe
+    qint64 buildMs;
+    int threads;
+    mutable QString lastError;
+
+    const Labels& targetLabels() const;
+};
+
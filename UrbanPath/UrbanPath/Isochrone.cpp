@@ -0,0 +1,131 @@
+#include "Isochrone.h"
+#include "JobToken.h"
+#include "Log.h"
+#include "Metrics.h"
+#include "Parallel.h"
+#include <QHash>
+#include <QThread>
+#include <atomic>
+#include <thread>
+
+// Constructor
+Isochrone::Isochrone() : threads(0)
+{
+}
+
+// Set the number of threads
+void Isochrone::setThreads(int threads)
+{
+    this->threads = qMax(0, threads);
+}
+
+// Get the number of threads
+int Isochrone::getThreads() const
+{
+    return threads;
+}
+
+// Area of one depot
+bool Isochrone::compute(const Graph& graph, int depotId, double budget, Area& area, JobToken* token) const
+{
+    MetricsTimer timer(Metrics::Isochrone);
+    area = Area();
+    area.depotId = depotId;
+    area.budget = budget;
+
+    int depot = graph.indexOf(depotId);
+    if (depot == StationTable::InvalidIndex)
+    {
+        LOG_ERROR << "Error: Estacion" << depotId << "no existe.";
+        return false;
+    }
+
+    QVector<QPair<int, double>> reached;
+    graph.reachableWithin(depot, budget, reached, token);
+    if (token && token->isCancelled())
+    {
+        return true;  // Cut short: leave the area empty
+    }
+    collectRoutes(graph, reached, budget, area);
+    return true;
+}
+
+// Areas of several depots in parallel
+QList<Isochrone::Area> Isochrone::computeMany(const Graph& graph, const QList<int>& depotIds, double budget,
+                                              JobToken* token) const
+{
+    QVector<Area> areas(depotIds.size());
+    int workers = (threads > 0) ? threads : QThread::idealThreadCount();
+    atomic<int> done(0);
+
+    // The calling thread reports progress; the others only check for cancellation
+    std::thread::id caller = std::this_thread::get_id();
+    Parallel::run(depotIds.size(), workers, [&](int i) {
+        if (token && token->isCancelled())
+        {
+            return;
+        }
+        compute(graph, depotIds[i], budget, areas[i], token);
+
+        int finished = ++done;
+        if (token && std::this_thread::get_id() == caller)
+        {
+            token->progress(finished, depotIds.size());
+        }
+    });
+
+    return QList<Area>(areas.begin(), areas.end());
+}
+
+// Stations and covered routes of an area
+void Isochrone::collectRoutes(const Graph& graph, const QVector<QPair<int, double>>& reached, double budget, Area& area)
+{
+    const StationTable& table = graph.getStationTable();
+    bool undirected = !graph.isDirected();
+
+    QHash<int, double> cost;
+    cost.reserve(reached.size());
+    for (const auto& station : reached)
+    {
+        cost.insert(station.first, station.second);
+        area.stations.append(QPair<int, double>(table.idAt(station.first), station.second));
+    }
+
+    for (const auto& station : reached)
+    {
+        int from = station.first;
+        double fromCost = station.second;
+
+        for (const auto& neighbor : graph.neighborsAt(from))
+        {
+            int to = neighbor.first;
+            double weight = neighbor.second;
+            if (graph.isRouteClosedAt(from, to) || graph.isIndexClosed(to))
+            {
+                continue;
+            }
+
+            auto known = cost.constFind(to);
+            bool toReached = known != cost.constEnd();
+
+            // Whole route: from this end, or from the other one in undirected graphs
+            bool whole = fromCost + weight <= budget || (undirected && toReached && known.value() + weight <= budget);
+            if (whole)
+            {
+                // Both ends are inside; undirected routes appear in both lists: keep one
+                if (!undirected || from < to)
+                {
+                    area.routes.append(CoveredRoute{ table.idAt(from), table.idAt(to), 1.0 });
+                }
+                continue;
+            }
+
+            // Part of the route, up to where the budget runs out
+            if (weight > 0.0 && fromCost < budget)
+            {
+                area.routes.append(CoveredRoute{ table.idAt(from), table.idAt(to), (budget - fromCost) / weight });
+            }
+        }
+    }
+}
+
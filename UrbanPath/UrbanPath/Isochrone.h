@@ -0,0 +1,59 @@
+#pragma once
+
+#include "Graph.h"
+#include <QList>
+#include <QPair>
+#include <QtGlobal>
+
+using namespace std;
+
+// Forward declaration
+class JobToken;
+
+// Coverage areas (isochrones): everything reachable from a depot within a cost budget.
+// Each area is one Graph::reachableWithin() search, which never queues a station past
+// the budget, plus one pass over the routes of the reached stations to find the routes
+// the budget covers whole or only in part. computeMany() runs one search per depot on
+// several threads. Closed stations and routes are left out, as in every search.
+class Isochrone
+{
+public:
+    // Route inside the budget: whole (fraction 1), or the part reachable from 'from'
+    struct CoveredRoute
+    {
+        int from;          // Station IDs
+        int to;
+        double fraction;   // Share of the route covered, starting at 'from' (0 < fraction <= 1)
+    };
+
+    // Area of one depot
+    struct Area
+    {
+        int depotId = -1;
+        double budget = 0.0;
+        QList<QPair<int, double>> stations;   // (station ID, cost), nearest first
+        QList<CoveredRoute> routes;
+    };
+
+    // Constructor
+    Isochrone();
+
+    // Threads for computeMany() (0 = one per core)
+    void setThreads(int threads);
+    int getThreads() const;
+
+    // Area of one depot; false if the station does not exist (empty if the token is cancelled)
+    bool compute(const Graph& graph, int depotId, double budget, Area& area, JobToken* token = nullptr) const;
+
+    // Areas of several depots, in the same order (depots that do not exist give empty areas).
+    // A cancelled token stops the searches under way and leaves the unfinished areas empty.
+    QList<Area> computeMany(const Graph& graph, const QList<int>& depotIds, double budget,
+                            JobToken* token = nullptr) const;
+
+private:
+    int threads;
+
+    // Build the area from the reached stations
+    static void collectRoutes(const Graph& graph, const QVector<QPair<int, double>>& reached, double budget, Area& area);
+};
+
@@ -0,0 +1,48 @@
+#include "JobToken.h"
+
+// Constructor
+JobToken::JobToken() : cancelled(false), percent(0)
+{
+}
+
+// Request cancellation
+void JobToken::cancel()
+{
+    cancelled.store(true, memory_order_relaxed);
+}
+
+// Check if cancellation was requested
+bool JobToken::isCancelled() const
+{
+    return cancelled.load(memory_order_relaxed);
+}
+
+// Report progress
+bool JobToken::progress(qint64 done, qint64 total)
+{
+    if (total > 0)
+    {
+        int value = static_cast<int>(qBound<qint64>(0, done * 100 / total, 100));
+
+        // The listener only hears about whole-percent steps
+        if (percent.exchange(value, memory_order_relaxed) != value && progressListener)
+        {
+            progressListener(value);
+        }
+    }
+
+    return !isCancelled();
+}
+
+// Get last reported progress
+int JobToken::getPercent() const
+{
+    return percent.load(memory_order_relaxed);
+}
+
+// Set progress listener
+void JobToken::setProgressListener(function<void(int)> listener)
+{
+    progressListener = listener;
+}
+
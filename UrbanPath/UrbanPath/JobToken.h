@@ -0,0 +1,36 @@
+#pragma once
+
+#include <QtGlobal>
+#include <atomic>
+#include <functional>
+
+using namespace std;
+
+// Cancellation flag and progress of one background job.
+// The algorithm polls the token inside its main loop (see Graph); the owner
+// cancels it from any thread. progress() returns false once the job was
+// cancelled, so a loop can report and check in one call:
+//   if (token && !token->progress(k, n)) return partial;
+class JobToken
+{
+private:
+    atomic<bool> cancelled;
+    atomic<int> percent;                  // Last reported progress (0-100)
+    function<void(int)> progressListener; // Called when the percent changes
+
+public:
+    // Constructor
+    JobToken();
+
+    // Request cancellation (any thread)
+    void cancel();
+    bool isCancelled() const;
+
+    // Report 'done' of 'total' steps; false if the job was cancelled
+    bool progress(qint64 done, qint64 total);
+    int getPercent() const;
+
+    // Listener for percent changes (runs on the job's thread; set before the job starts)
+    void setProgressListener(function<void(int)> listener);
+};
+
@@ -0,0 +1,221 @@
+#include "KShortestPaths.h"
+#include "JobToken.h"
+#include "Log.h"
+#include "Metrics.h"
+#include "Parallel.h"
+#include <QBitArray>
+#include <QSet>
+#include <QThread>
+#include <algorithm>
+#include <limits>
+
+namespace
+{
+
+const double INF = std::numeric_limits<double>::infinity();
+
+}
+
+// Constructor
+KShortestPaths::KShortestPaths() : threads(0)
+{
+}
+
+// Set the number of threads
+void KShortestPaths::setThreads(int threads)
+{
+    this->threads = qMax(0, threads);
+}
+
+// Get the number of threads
+int KShortestPaths::getThreads() const
+{
+    return threads;
+}
+
+// Yen's algorithm
+bool KShortestPaths::find(const Graph& graph, int originId, int destId, int k, QList<Path>& paths,
+                          JobToken* token) const
+{
+    MetricsTimer timer(Metrics::KShortestPaths);
+    paths.clear();
+
+    int source = graph.indexOf(originId);
+    int target = graph.indexOf(destId);
+    if (source == StationTable::InvalidIndex || target == StationTable::InvalidIndex)
+    {
+        LOG_ERROR << "Error: Estacion" << (source == StationTable::InvalidIndex ? originId : destId) << "no existe.";
+        return false;
+    }
+
+    if (k <= 0)
+    {
+        return true;
+    }
+    if (source == target)
+    {
+        Path path;
+        path.stations.append(originId);
+        paths.append(path);
+        return true;
+    }
+
+    // Shortest route first
+    Candidate first;
+    double distance = 0.0;
+    graph.shortestPathAvoiding(source, target, QBitArray(), QVector<int>(), first.nodes, distance, token);
+    if (first.nodes.isEmpty())
+    {
+        return true;
+    }
+    first.costs = costsOf(graph, first.nodes);
+
+    QList<Candidate> accepted;
+    accepted.append(first);
+    QList<Candidate> candidates;          // Sorted by distance, then by stations
+    QSet<QList<int>> seen;                // Routes accepted or queued once
+    seen.insert(first.nodes);
+
+    int workers = (threads > 0) ? threads : QThread::idealThreadCount();
+    auto shorter = [](const Candidate& a, const Candidate& b) {
+        if (a.costs.last() != b.costs.last())
+        {
+            return a.costs.last() < b.costs.last();
+        }
+        return a.nodes.size() < b.nodes.size();
+    };
+
+    while (accepted.size() < k)
+    {
+        // Progress and cancellation are handled here; the spur searches run without the token
+        if (token && !token->progress(accepted.size(), k))
+        {
+            break;
+        }
+
+        const Candidate& parent = accepted.last();
+        int spurCount = parent.nodes.size() - 1 - parent.deviation;
+        QVector<Candidate> spurs(qMax(0, spurCount));
+        QVector<bool> found(spurs.size(), false);
+
+        Parallel::run(spurs.size(), workers, [&](int task) {
+            found[task] = spur(graph, parent, parent.deviation + task, target, accepted, spurs[task]);
+        });
+
+        for (int i = 0; i < spurs.size(); i++)
+        {
+            if (!found[i] || seen.contains(spurs[i].nodes))
+            {
+                continue;
+            }
+            seen.insert(spurs[i].nodes);
+            candidates.insert(std::upper_bound(candidates.begin(), candidates.end(), spurs[i], shorter) - candidates.begin(),
+                              spurs[i]);
+        }
+
+        // Only the best k - accepted candidates can still be returned
+        while (candidates.size() > k - accepted.size())
+        {
+            candidates.removeLast();
+        }
+
+        if (candidates.isEmpty())
+        {
+            break;
+        }
+        accepted.append(candidates.takeFirst());
+    }
+
+    // Station IDs
+    const StationTable& table = graph.getStationTable();
+    for (const Candidate& candidate : accepted)
+    {
+        Path path;
+        for (int index : candidate.nodes)
+        {
+            path.stations.append(table.idAt(index));
+        }
+        path.distance = candidate.costs.last();
+        paths.append(path);
+    }
+    return true;
+}
+
+// Spur route from one station of a parent route
+bool KShortestPaths::spur(const Graph& graph, const Candidate& parent, int cut, int targetIndex,
+                          const QList<Candidate>& accepted, Candidate& result)
+{
+    // The root part (before the cut) may not be visited again
+    QBitArray blocked(graph.getStationTable().slotCount());
+    for (int i = 0; i < cut; i++)
+    {
+        blocked.setBit(parent.nodes[i]);
+    }
+
+    // Next stations of the accepted routes that share the whole root with the parent
+    QVector<int> blockedHops;
+    for (const Candidate& route : accepted)
+    {
+        if (route.nodes.size() <= cut + 1)
+        {
+            continue;
+        }
+
+        bool sameRoot = true;
+        for (int i = cut; i >= 0 && sameRoot; i--)
+        {
+            sameRoot = route.nodes[i] == parent.nodes[i];
+        }
+        if (sameRoot && !blockedHops.contains(route.nodes[cut + 1]))
+        {
+            blockedHops.append(route.nodes[cut + 1]);
+        }
+    }
+
+    QList<int> spurRoute;
+    double spurDistance = INF;
+    graph.shortestPathAvoiding(parent.nodes[cut], targetIndex, blocked, blockedHops, spurRoute, spurDistance);
+    if (spurRoute.isEmpty())
+    {
+        return false;
+    }
+
+    // Root + spur, with the distances carried over from the parent
+    result.nodes = parent.nodes.mid(0, cut) + spurRoute;
+    result.costs = parent.costs.mid(0, cut);
+    double rootDistance = parent.costs[cut];
+    for (double cost : costsOf(graph, spurRoute))
+    {
+        result.costs.append(rootDistance + cost);
+    }
+    result.deviation = cut;
+    return true;
+}
+
+// Distance from the first station to every station of a route
+QVector<double> KShortestPaths::costsOf(const Graph& graph, const QList<int>& nodes)
+{
+    QVector<double> costs;
+    costs.reserve(nodes.size());
+    double total = 0.0;
+
+    for (int i = 0; i < nodes.size(); i++)
+    {
+        if (i > 0)
+        {
+            // Lightest of the parallel routes (the one the search took)
+            double weight = INF;
+            for (const auto& neighbor : graph.neighborsAt(nodes[i - 1]))
+            {
+                if (neighbor.first == nodes[i])
+                {
+                    weight = qMin(weight, neighbor.second);
+                }
+            }
+            total += weight;
+        }
+        costs.append(total);
+    }
+    return costs;
+}
+
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "Graph.h"
+#include <QList>
+#include <QVector>
+#include <QtGlobal>
+
+using namespace std;
+
+// Forward declaration
+class JobToken;
+
+// Alternative routes between two stations: Yen's k shortest loopless paths.
+// Each accepted route is cut at every station after the point where it left its
+// parent route (Lawler's rule: earlier cuts only find routes already listed); from
+// each cut a spur search looks for a way to the destination that avoids the stations
+// of the root part and the next stations already taken by accepted routes with the
+// same root. The spur searches run on Graph::shortestPathAvoiding(), which ORs the
+// root into the closed-station bitmap, and the searches of one route run in parallel.
+// Only the best k - accepted candidates are kept. Closures are respected; routes
+// are returned shortest first.
+class KShortestPaths
+{
+public:
+    static const int DefaultPaths = 3;
+
+    // One route in station IDs, origin first
+    struct Path
+    {
+        QList<int> stations;
+        double distance = 0.0;
+    };
+
+    // Constructor
+    KShortestPaths();
+
+    // Threads for the spur searches (0 = one per core)
+    void setThreads(int threads);
+    int getThreads() const;
+
+    // Up to k loopless routes from origin to destination (fewer if the network has no more);
+    // false if a station does not exist. A cancelled token returns the routes found so far.
+    bool find(const Graph& graph, int originId, int destId, int k, QList<Path>& paths,
+              JobToken* token = nullptr) const;
+
+private:
+    // Route by station index with the distance from the origin to each of its stations
+    struct Candidate
+    {
+        QList<int> nodes;
+        QVector<double> costs;     // costs[i]: distance from the origin to nodes[i]
+        int deviation = 0;         // First station where it leaves its parent route
+    };
+
+    int threads;
+
+    // Spur route from the station at 'cut' of 'parent'; false if there is none
+    static bool spur(const Graph& graph, const Candidate& parent, int cut, int targetIndex,
+                     const QList<Candidate>& accepted, Candidate& result);
+
+    // Distance from the first station to every station of a route
+    static QVector<double> costsOf(const Graph& graph, const QList<int>& nodes);
+};
+
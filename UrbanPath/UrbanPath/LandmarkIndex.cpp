@@ -0,0 +1,891 @@
+#include "LandmarkIndex.h"
+#include "JobToken.h"
+#include "Log.h"
+#include "Metrics.h"
+#include "Parallel.h"
+#include <QElapsedTimer>
+#include <QThread>
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <random>
+#include <vector>
+
+namespace
+{
+
+const double INF = std::numeric_limits<double>::infinity();
+
+// Loop iterations between two checks of a job token
+const int TokenCheckInterval = 1024;
+
+// Rounds of "avoid" that may pick nothing new before falling back to "farthest"
+const int MaxEmptyRounds = 3;
+
+typedef std::pair<double, int> HeapItem;
+typedef std::priority_queue<HeapItem, std::vector<HeapItem>, std::greater<HeapItem>> MinHeap;
+
+// Adjacency of the base network in compressed rows (no closures, pre-accident weights)
+struct Adjacency
+{
+    QVector<int> first;       // Row start per station slot (one extra entry at the end)
+    QVector<int> target;
+    QVector<double> weight;
+};
+
+// Forward adjacency (and the reverse one for directed graphs) of the base network.
+// Routes whose weight comes from an accident get their original weight back; they are
+// returned in 'baseWeights' (station indices).
+void buildAdjacency(const Graph& graph, Adjacency& forward, Adjacency& backward,
+                    QHash<QPair<int, int>, double>& baseWeights)
+{
+    const StationTable& table = graph.getStationTable();
+    int slotTotal = table.slotCount();
+    QHash<QPair<int, int>, double> original = graph.getOriginalWeights();
+
+    forward.first.fill(0, slotTotal + 1);
+    for (int index : table.indices())
+    {
+        forward.first[index + 1] = graph.neighborsAt(index).size();
+    }
+    for (int i = 0; i < slotTotal; i++)
+    {
+        forward.first[i + 1] += forward.first[i];
+    }
+
+    forward.target.resize(forward.first[slotTotal]);
+    forward.weight.resize(forward.first[slotTotal]);
+    for (int index : table.indices())
+    {
+        int position = forward.first[index];
+        for (const auto& neighbor : graph.neighborsAt(index))
+        {
+            double weight = neighbor.second;
+            if (!original.isEmpty())
+            {
+                QPair<int, int> key(table.idAt(index), table.idAt(neighbor.first));
+                auto found = original.constFind(key);
+                if (found != original.constEnd() && found.value() < weight)
+                {
+                    weight = found.value();
+                    baseWeights[QPair<int, int>(index, neighbor.first)] = weight;
+                }
+            }
+            forward.target[position] = neighbor.first;
+            forward.weight[position] = weight;
+            position++;
+        }
+    }
+
+    if (!graph.isDirected())
+    {
+        return;
+    }
+
+    // Reverse: count, prefix sums, fill
+    backward.first.fill(0, slotTotal + 1);
+    for (int target : forward.target)
+    {
+        backward.first[target + 1]++;
+    }
+    for (int i = 0; i < slotTotal; i++)
+    {
+        backward.first[i + 1] += backward.first[i];
+    }
+
+    backward.target.resize(forward.target.size());
+    backward.weight.resize(forward.weight.size());
+    QVector<int> next = backward.first;
+    for (int from = 0; from < slotTotal; from++)
+    {
+        for (int e = forward.first[from]; e < forward.first[from + 1]; e++)
+        {
+            int position = next[forward.target[e]]++;
+            backward.target[position] = from;
+            backward.weight[position] = forward.weight[e];
+        }
+    }
+}
+
+// Dijkstra over an adjacency; predecessors and settle order only when asked for
+void search(const Adjacency& adjacency, int source, QVector<double>& dist, QVector<int>* pred, QVector<int>* order)
+{
+    MetricsTally tally(Metrics::LandmarkBuild);
+    int n = adjacency.first.size() - 1;
+    dist.fill(INF, n);
+    if (pred)
+    {
+        pred->fill(-1, n);
+    }
+    if (order)
+    {
+        order->clear();
+    }
+
+    MinHeap heap;
+    dist[source] = 0.0;
+    heap.push(HeapItem(0.0, source));
+    tally.count(Metrics::HeapOperations);
+
+    while (!heap.empty())
+    {
+        HeapItem top = heap.top();
+        heap.pop();
+        tally.count(Metrics::HeapOperations);
+
+        int node = top.second;
+        if (top.first > dist[node])
+        {
+            continue;  // Stale entry
+        }
+        tally.count(Metrics::NodesSettled);
+        if (order)
+        {
+            order->append(node);
+        }
+
+        for (int e = adjacency.first[node]; e < adjacency.first[node + 1]; e++)
+        {
+            int target = adjacency.target[e];
+            double newDist = top.first + adjacency.weight[e];
+            tally.count(Metrics::EdgesScanned);
+
+            if (newDist < dist[target])
+            {
+                dist[target] = newDist;
+                if (pred)
+                {
+                    (*pred)[target] = node;
+                }
+                heap.push(HeapItem(newDist, target));
+                tally.count(Metrics::EdgesRelaxed);
+                tally.count(Metrics::HeapOperations);
+            }
+        }
+    }
+}
+
+// Station not chosen yet that is farthest from the nearest landmark (unreached ones first)
+int pickFarthest(const QList<int>& live, const QVector<double>& nearest, const QVector<bool>& isLandmark)
+{
+    int best = -1;
+    double bestDist = -1.0;
+    for (int index : live)
+    {
+        if (!isLandmark[index] && nearest[index] > bestDist)
+        {
+            best = index;
+            bestDist = nearest[index];
+        }
+    }
+    return best;
+}
+
+// "Avoid" (Goldberg and Werneck): grow the shortest-path tree of a root, weigh every
+// station by how much the current bounds underestimate its distance, and walk down to
+// the leaf of the heaviest subtree that holds no landmark. -1 if there is none.
+int pickAvoid(const Adjacency& forward, int root, const QVector<QVector<double>>& forwardTables,
+              const QVector<QVector<double>>& backwardTables, const QVector<bool>& isLandmark)
+{
+    QVector<double> dist;
+    QVector<int> pred;
+    QVector<int> order;
+    search(forward, root, dist, &pred, &order);
+
+    int n = dist.size();
+    QVector<double> size(n, 0.0);
+    QVector<bool> covered(n, false);     // Subtree holds a landmark
+    QVector<int> firstChild(n, -1);
+    QVector<int> nextSibling(n, -1);
+
+    // Children settle after their parent: walk the settle order backwards
+    for (int i = order.size() - 1; i >= 0; i--)
+    {
+        int node = order[i];
+
+        double bound = 0.0;
+        for (int l = 0; l < forwardTables.size(); l++)
+        {
+            const QVector<double>& to = forwardTables[l];
+            const QVector<double>& from = backwardTables[l];
+            if (to[node] < INF && to[root] < INF)
+            {
+                bound = qMax(bound, to[node] - to[root]);
+            }
+            if (from[root] < INF && from[node] < INF)
+            {
+                bound = qMax(bound, from[root] - from[node]);
+            }
+        }
+
+        size[node] += dist[node] - bound;
+        if (isLandmark[node])
+        {
+            covered[node] = true;
+        }
+        if (covered[node])
+        {
+            size[node] = 0.0;
+        }
+
+        int parent = pred[node];
+        if (parent >= 0)
+        {
+            size[parent] += size[node];
+            covered[parent] = covered[parent] || covered[node];
+            nextSibling[node] = firstChild[parent];
+            firstChild[parent] = node;
+        }
+    }
+
+    // Follow the heaviest child down to a leaf
+    int node = root;
+    while (true)
+    {
+        int best = -1;
+        for (int child = firstChild[node]; child != -1; child = nextSibling[child])
+        {
+            if (size[child] > 0.0 && (best == -1 || size[child] > size[best]))
+            {
+                best = child;
+            }
+        }
+        if (best == -1)
+        {
+            break;
+        }
+        node = best;
+    }
+
+    return (node == root || isLandmark[node]) ? -1 : node;
+}
+
+}
+
+// Constructor
+LandmarkIndex::LandmarkIndex()
+    : stride(0), slotCount(0), scale(1.0), directed(false), built(false), builtVersion(0), buildMs(0),
+      threads(0), selection(Avoid), precision(Bits16), requestedLandmarks(DefaultLandmarks)
+{
+}
+
+// Pick the landmarks and compute their tables
+bool LandmarkIndex::build(const Graph& graph, int landmarkCount, Selection selection, Precision precision)
+{
+    MetricsTimer timer(Metrics::LandmarkBuild);
+    QElapsedTimer elapsed;
+    elapsed.start();
+
+    clear();
+    this->selection = selection;
+    this->precision = precision;
+    requestedLandmarks = landmarkCount;
+    directed = graph.isDirected();
+    builtVersion = graph.getVersion();
+
+    QList<int> live = graph.getStationTable().indices();
+    int count = qMin(landmarkCount, static_cast<int>(live.size()));
+    if (count <= 0)
+    {
+        return false;
+    }
+
+    Adjacency forward;
+    Adjacency backward;
+    buildAdjacency(graph, forward, backward, baseWeights);
+    slotCount = forward.first.size() - 1;
+    const Adjacency& reverse = directed ? backward : forward;
+
+    int workers = (threads > 0) ? threads : QThread::idealThreadCount();
+    mt19937 rng(0x414C54);   // Fixed seed: the same network always gets the same landmarks
+
+    QVector<QVector<double>> forwardTables;
+    QVector<QVector<double>> backwardTables;   // Same as forwardTables in undirected graphs
+    QVector<bool> isLandmark(slotCount, false);
+    QVector<double> nearest;                   // Distance from the nearest landmark
+    int pending = -1;
+    int emptyRounds = 0;
+
+    // "Farthest" starts with the station farthest from a random one
+    if (selection == Farthest)
+    {
+        QVector<double> dist;
+        search(forward, live[rng() % live.size()], dist, nullptr, nullptr);
+        double farthest = -1.0;
+        for (int index : live)
+        {
+            if (dist[index] < INF && dist[index] > farthest)
+            {
+                farthest = dist[index];
+                pending = index;
+            }
+        }
+    }
+
+    while (landmarks.size() < count)
+    {
+        QVector<int> batch;
+
+        if (selection == Avoid && emptyRounds < MaxEmptyRounds)
+        {
+            // One root per thread; the trees grow in parallel
+            int roots = qMin(workers, count - static_cast<int>(landmarks.size()));
+            QVector<int> rootList(roots);
+            for (int& root : rootList)
+            {
+                root = live[rng() % live.size()];
+            }
+
+            QVector<int> picked(roots, -1);
+            Parallel::run(roots, workers, [&](int i) {
+                picked[i] = pickAvoid(forward, rootList[i], forwardTables, backwardTables, isLandmark);
+            });
+
+            for (int index : picked)
+            {
+                if (index >= 0 && !isLandmark[index] && !batch.contains(index))
+                {
+                    batch.append(index);
+                }
+            }
+            if (batch.isEmpty())
+            {
+                emptyRounds++;
+                continue;
+            }
+        }
+        else
+        {
+            int index = (pending >= 0) ? pending : (nearest.isEmpty() ? live.first() : pickFarthest(live, nearest, isLandmark));
+            pending = -1;
+            if (index < 0 || isLandmark[index])
+            {
+                break;
+            }
+            batch.append(index);
+        }
+
+        // Tables of the new landmarks, one search per landmark and direction, in parallel
+        int perLandmark = directed ? 2 : 1;
+        QVector<QVector<double>> tables(batch.size() * perLandmark);
+        Parallel::run(tables.size(), workers, [&](int task) {
+            bool towards = (task % perLandmark) == 1;
+            search(towards ? reverse : forward, batch[task / perLandmark], tables[task], nullptr, nullptr);
+        });
+
+        for (int i = 0; i < batch.size(); i++)
+        {
+            const QVector<double>& table = tables[i * perLandmark];
+            landmarks.append(batch[i]);
+            landmarkIds.append(graph.getStationTable().idAt(batch[i]));
+            isLandmark[batch[i]] = true;
+            forwardTables.append(table);
+            backwardTables.append(tables[i * perLandmark + perLandmark - 1]);
+
+            if (nearest.isEmpty())
+            {
+                nearest = table;
+            }
+            else
+            {
+                for (int v = 0; v < slotCount; v++)
+                {
+                    nearest[v] = qMin(nearest[v], table[v]);
+                }
+            }
+        }
+    }
+
+    quantize(forwardTables, backwardTables);
+    built = true;
+    buildMs = elapsed.elapsed();
+
+    LOG_INFO << "Indice ALT:" << landmarks.size() << "puntos de referencia," << getTableBytes() / 1024
+             << "KB, construido en" << buildMs << "ms.";
+    return true;
+}
+
+// Set the number of threads
+void LandmarkIndex::setThreads(int threads)
+{
+    this->threads = qMax(0, threads);
+}
+
+// Get the number of threads
+int LandmarkIndex::getThreads() const
+{
+    return threads;
+}
+
+// Check if the tables still hold for the graph
+bool LandmarkIndex::isCurrent(const Graph& graph) const
+{
+    QHash<QPair<int, int>, double> safeWeights;
+    return scanChanges(graph, safeWeights);
+}
+
+// Rebuild if needed
+bool LandmarkIndex::update(const Graph& graph)
+{
+    QHash<QPair<int, int>, double> safeWeights;
+    if (scanChanges(graph, safeWeights))
+    {
+        // Remember what the changes taught, so the next scan starts from here
+        baseWeights = safeWeights;
+        builtVersion = graph.getVersion();
+        return true;
+    }
+    return build(graph, requestedLandmarks, selection, precision);
+}
+
+// A* with the landmark bounds
+bool LandmarkIndex::findPath(const Graph& graph, int originId, int destId, QList<int>& route, double& distance,
+                             JobToken* token) const
+{
+    MetricsTimer timer(Metrics::LandmarkQuery);
+    MetricsTally tally(Metrics::LandmarkQuery);
+    route.clear();
+    distance = INF;
+
+    int source = graph.indexOf(originId);
+    int target = graph.indexOf(destId);
+    if (source == StationTable::InvalidIndex || target == StationTable::InvalidIndex)
+    {
+        return false;
+    }
+
+    if (source == target)
+    {
+        route.append(originId);
+        distance = 0.0;
+        return true;
+    }
+    if (graph.isIndexClosed(source) || graph.isIndexClosed(target))
+    {
+        return true;
+    }
+
+    // Landmarks that give the best bound at the origin
+    QVector<QPair<double, ActiveColumn>> candidates;
+    for (int l = 0; l < landmarks.size(); l++)
+    {
+        for (int direction = 0; direction < 2; direction++)
+        {
+            ActiveColumn active;
+            active.backward = (direction == 1);
+            active.column = columnOf(l, active.backward);
+            active.targetCode = codeAt(target, active.column);
+
+            double bound = columnBound(source, active);
+            if (bound >= INF)
+            {
+                return true;   // The target cannot be reached from the origin
+            }
+            candidates.append(QPair<double, ActiveColumn>(bound, active));
+        }
+    }
+    std::sort(candidates.begin(), candidates.end(),
+              [](const QPair<double, ActiveColumn>& a, const QPair<double, ActiveColumn>& b) { return a.first > b.first; });
+
+    QVector<ActiveColumn> active;
+    for (int i = 0; i < candidates.size() && i < ActiveLandmarks; i++)
+    {
+        active.append(candidates[i].second);
+    }
+
+    auto potential = [this, &active](int slot) {
+        double bound = 0.0;
+        for (const ActiveColumn& column : active)
+        {
+            bound = qMax(bound, columnBound(slot, column));
+        }
+        return bound;
+    };
+
+    // A* (a station may be settled again: quantized bounds are admissible, not always consistent)
+    int n = graph.getStationTable().slotCount();
+    QVector<double> dist(n, INF);
+    QVector<int> pred(n, -1);
+    QVector<double> heuristic(n, -1.0);   // Bound to the target, computed on first reach
+
+    MinHeap heap;
+    dist[source] = 0.0;
+    heuristic[source] = potential(source);
+    heap.push(HeapItem(heuristic[source], source));
+    tally.count(Metrics::HeapOperations);
+    int settled = 0;
+    bool routeClosures = !graph.getClosedRoutes().isEmpty();
+
+    while (!heap.empty())
+    {
+        HeapItem top = heap.top();
+        heap.pop();
+        tally.count(Metrics::HeapOperations);
+
+        int node = top.second;
+        if (top.first > dist[node] + heuristic[node])
+        {
+            continue;  // Stale entry
+        }
+        if (node == target)
+        {
+            break;
+        }
+
+        // Stop if the job was cancelled
+        if (token && ++settled % TokenCheckInterval == 0 && !token->progress(settled, n))
+        {
+            return true;
+        }
+        tally.count(Metrics::NodesSettled);
+
+        for (const auto& neighbor : graph.neighborsAt(node))
+        {
+            int next = neighbor.first;
+            tally.count(Metrics::EdgesScanned);
+            tally.count(Metrics::ClosureChecks, routeClosures);
+
+            if (graph.isRouteClosedAt(node, next) || graph.isIndexClosed(next))
+            {
+                continue;
+            }
+
+            double newDist = dist[node] + neighbor.second;
+            if (newDist < dist[next])
+            {
+                if (heuristic[next] < 0.0)
+                {
+                    heuristic[next] = potential(next);
+                }
+                if (heuristic[next] >= INF)
+                {
+                    continue;  // No way to the target from there
+                }
+
+                dist[next] = newDist;
+                pred[next] = node;
+                heap.push(HeapItem(newDist + heuristic[next], next));
+                tally.count(Metrics::EdgesRelaxed);
+                tally.count(Metrics::HeapOperations);
+            }
+        }
+    }
+
+    if (dist[target] >= INF)
+    {
+        return true;
+    }
+
+    distance = dist[target];
+    const StationTable& table = graph.getStationTable();
+    for (int node = target; node != -1; node = pred[node])
+    {
+        route.prepend(table.idAt(node));
+    }
+    return true;
+}
+
+// Lower bound between two station indices
+double LandmarkIndex::lowerBound(int fromIndex, int toIndex) const
+{
+    double bound = 0.0;
+    for (int l = 0; l < landmarks.size(); l++)
+    {
+        for (int direction = 0; direction < 2; direction++)
+        {
+            ActiveColumn active;
+            active.backward = (direction == 1);
+            active.column = columnOf(l, active.backward);
+            active.targetCode = codeAt(toIndex, active.column);
+            bound = qMax(bound, columnBound(fromIndex, active));
+        }
+    }
+    return bound;
+}
+
+// Check if the index was built
+bool LandmarkIndex::isBuilt() const
+{
+    return built;
+}
+
+// Get the number of landmarks
+int LandmarkIndex::getLandmarkCount() const
+{
+    return landmarks.size();
+}
+
+// Get the landmark station IDs
+QList<int> LandmarkIndex::getLandmarks() const
+{
+    return landmarkIds;
+}
+
+// Get the selection method
+LandmarkIndex::Selection LandmarkIndex::getSelection() const
+{
+    return selection;
+}
+
+// Get the stored precision
+LandmarkIndex::Precision LandmarkIndex::getPrecision() const
+{
+    return precision;
+}
+
+// Get the size of the distance tables
+qint64 LandmarkIndex::getTableBytes() const
+{
+    return codes16.size() * static_cast<qint64>(sizeof(quint16)) + codes32.size() * static_cast<qint64>(sizeof(quint32));
+}
+
+// Get the last build time
+qint64 LandmarkIndex::getBuildMs() const
+{
+    return buildMs;
+}
+
+// Drop the tables
+void LandmarkIndex::clear()
+{
+    landmarks.clear();
+    landmarkIds.clear();
+    codes16.clear();
+    codes32.clear();
+    baseWeights.clear();
+    stride = 0;
+    slotCount = 0;
+    scale = 1.0;
+    built = false;
+    buildMs = 0;
+}
+
+// Get selection name
+QString LandmarkIndex::selectionName(Selection selection)
+{
+    return (selection == Farthest) ? "lejano" : "evitar";
+}
+
+// Parse selection name
+bool LandmarkIndex::parseSelection(const QString& name, Selection& selection)
+{
+    QString key = name.trimmed().toLower();
+    if (key == "lejano" || key == "farthest")
+    {
+        selection = Farthest;
+        return true;
+    }
+    if (key == "evitar" || key == "avoid")
+    {
+        selection = Avoid;
+        return true;
+    }
+    return false;
+}
+
+// Stored code of a slot and column
+quint32 LandmarkIndex::codeAt(int slot, int column) const
+{
+    if (slot < 0 || slot >= slotCount)
+    {
+        return Unreached;
+    }
+
+    int position = slot * stride + column;
+    if (precision == Bits16)
+    {
+        quint16 code = codes16[position];
+        return (code == 0xFFFF) ? Unreached : code;
+    }
+    return codes32[position];
+}
+
+// Column of a landmark (directed graphs keep the distances to the landmark after the ones from it)
+int LandmarkIndex::columnOf(int landmark, bool backward) const
+{
+    return (directed && backward) ? landmarks.size() + landmark : landmark;
+}
+
+// Bound from one column. Codes are rounded down, so one unit is given up to stay below
+// the real difference.
+double LandmarkIndex::columnBound(int slot, const ActiveColumn& active) const
+{
+    quint32 code = codeAt(slot, active.column);
+    qint64 difference;
+
+    if (!active.backward)
+    {
+        // d(L, t) - d(L, v): L reaches v but not t, so v does not reach t
+        if (active.targetCode == Unreached)
+        {
+            return (code == Unreached) ? 0.0 : INF;
+        }
+        if (code == Unreached)
+        {
+            return 0.0;
+        }
+        difference = static_cast<qint64>(active.targetCode) - code;
+    }
+    else
+    {
+        // d(v, L) - d(t, L): t reaches L but v does not, so v does not reach t
+        if (active.targetCode == Unreached)
+        {
+            return 0.0;
+        }
+        if (code == Unreached)
+        {
+            return INF;
+        }
+        difference = static_cast<qint64>(code) - active.targetCode;
+    }
+
+    return (difference > 1) ? (difference - 1) * scale : 0.0;
+}
+
+// Check the triangle inequality of a route against every column
+bool LandmarkIndex::keepsBounds(int fromIndex, int toIndex, double weight) const
+{
+    for (int l = 0; l < landmarks.size(); l++)
+    {
+        // d(L, to) <= d(L, from) + weight
+        int column = columnOf(l, false);
+        quint32 from = codeAt(fromIndex, column);
+        quint32 to = codeAt(toIndex, column);
+        if (from != Unreached && (to == Unreached || (static_cast<qint64>(to) - from + 1) * scale > weight))
+        {
+            return false;
+        }
+
+        // d(from, L) <= weight + d(to, L)
+        column = columnOf(l, true);
+        from = codeAt(fromIndex, column);
+        to = codeAt(toIndex, column);
+        if (to != Unreached && (from == Unreached || (static_cast<qint64>(from) - to + 1) * scale > weight))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Walk the changes made since the build. A route may get heavier (accidents), or lighter
+// down to a weight it already had (restored accidents); any other cheaper route must pass
+// the triangle inequality. 'safeWeights' collects the lightest weight known to be fine.
+bool LandmarkIndex::scanChanges(const Graph& graph, QHash<QPair<int, int>, double>& safeWeights) const
+{
+    if (!built)
+    {
+        return false;
+    }
+
+    safeWeights = baseWeights;
+    if (graph.getVersion() == builtVersion)
+    {
+        return true;
+    }
+
+    QVector<NetworkChange> changes;
+    if (!graph.getChangesSince(builtVersion, changes))
+    {
+        return false;
+    }
+
+    for (const NetworkChange& change : changes)
+    {
+        switch (change.kind)
+        {
+        case NetworkChange::EdgeChanged:
+        {
+            QPair<int, int> key(change.from, change.to);
+            double safe = qMin(change.previous, safeWeights.value(key, INF));
+            if (change.weight < safe && !keepsBounds(change.from, change.to, change.weight))
+            {
+                return false;
+            }
+            safeWeights[key] = qMin(safe, change.weight);
+            break;
+        }
+
+        case NetworkChange::EdgeRemoved:
+            return false;   // The bounds still hold but get loose: rebuild
+
+        case NetworkChange::RouteClosed:
+        case NetworkChange::RouteOpened:
+        case NetworkChange::StationClosed:
+        case NetworkChange::StationOpened:
+            break;          // The tables ignore closures
+
+        case NetworkChange::Reset:
+            return false;
+        }
+    }
+    return true;
+}
+
+// Store the tables quantized (rounded down; the largest distance gets the largest code)
+void LandmarkIndex::quantize(const QVector<QVector<double>>& forward, const QVector<QVector<double>>& backward)
+{
+    QVector<const QVector<double>*> columns;
+    for (const QVector<double>& table : forward)
+    {
+        columns.append(&table);
+    }
+    if (directed)
+    {
+        for (const QVector<double>& table : backward)
+        {
+            columns.append(&table);
+        }
+    }
+    stride = columns.size();
+
+    double maxDist = 0.0;
+    for (const QVector<double>* table : columns)
+    {
+        for (double d : *table)
+        {
+            if (d < INF)
+            {
+                maxDist = qMax(maxDist, d);
+            }
+        }
+    }
+
+    quint32 maxCode = (precision == Bits16) ? 0xFFFE : 0xFFFFFFFE;
+    scale = (maxDist > 0.0) ? maxDist / maxCode : 1.0;
+
+    if (precision == Bits16)
+    {
+        codes16.resize(slotCount * stride);
+    }
+    else
+    {
+        codes32.resize(slotCount * stride);
+    }
+
+    for (int slot = 0; slot < slotCount; slot++)
+    {
+        for (int column = 0; column < stride; column++)
+        {
+            double d = (*columns[column])[slot];
+            quint32 code = Unreached;
+            if (d < INF)
+            {
+                code = static_cast<quint32>(qMin<double>(maxCode, std::floor(d / scale)));
+            }
+
+            if (precision == Bits16)
+            {
+                codes16[slot * stride + column] = (code == Unreached) ? 0xFFFF : static_cast<quint16>(code);
+            }
+            else
+            {
+                codes32[slot * stride + column] = code;
+            }
+        }
+    }
+}
+
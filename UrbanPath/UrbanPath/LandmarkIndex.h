@@ -0,0 +1,137 @@
+#pragma once
+
+#include "Graph.h"
+#include <QList>
+#include <QVector>
+#include <QHash>
+#include <QPair>
+#include <QString>
+#include <QtGlobal>
+
+using namespace std;
+
+// Forward declaration
+class JobToken;
+
+// ALT preprocessing (A*, landmarks, triangle inequality) for point-to-point queries.
+// A few stations are picked as landmarks and the distance from each landmark to every
+// station (and back, in directed graphs) is stored. For any station v and target t,
+//   d(v, t) >= d(L, t) - d(L, v)   and   d(v, t) >= d(v, L) - d(t, L)
+// so the largest of those differences is a lower bound that steers A* towards the
+// target, whatever the weights mean (travel times do not follow the coordinates).
+//
+// The tables are built on the network without closures and with the weights from
+// before any accident, so closures and accidents only make routes longer and the
+// bounds stay valid. isCurrent() reads Graph::getChangesSince() to find the changes
+// that could break them (cheaper routes, removed routes, reset networks); update()
+// then rebuilds the tables, so a network edited between queries is rebuilt lazily.
+//
+// Distances are stored quantized to 16 or 32 bits per entry, rounded down, one row
+// of landmark columns per station so a query reads one cache line per station.
+class LandmarkIndex
+{
+public:
+    // How the landmarks are picked
+    enum Selection
+    {
+        Farthest,   // Each new landmark as far as possible from the chosen ones
+        Avoid       // Goldberg-Werneck "avoid": covers the regions the bounds serve worst
+    };
+
+    // Bits per stored distance
+    enum Precision
+    {
+        Bits16,
+        Bits32
+    };
+
+    static const int DefaultLandmarks = 16;
+    static const int ActiveLandmarks = 4;      // Landmarks used by one query (the best for its pair)
+
+    // Constructor
+    LandmarkIndex();
+
+    // Pick the landmarks and compute their tables; false for an empty network
+    bool build(const Graph& graph, int landmarkCount = DefaultLandmarks,
+               Selection selection = Avoid, Precision precision = Bits16);
+
+    // Threads for the landmark searches (0 = one per core)
+    void setThreads(int threads);
+    int getThreads() const;
+
+    // Check if the tables still give valid (and reasonably tight) bounds for the graph
+    bool isCurrent(const Graph& graph) const;
+
+    // Rebuild with the same settings if the tables are no longer current; false if the build fails
+    bool update(const Graph& graph);
+
+    // A* from origin to destination, skipping closed stations and routes. The index must
+    // be current for the graph. Route in station IDs (empty and distance infinity if there
+    // is no route). False if a station does not exist.
+    bool findPath(const Graph& graph, int originId, int destId, QList<int>& route, double& distance,
+                  JobToken* token = nullptr) const;
+
+    // Lower bound of the distance between two station indices (0 if unknown, infinity if unreachable)
+    double lowerBound(int fromIndex, int toIndex) const;
+
+    // Index information
+    bool isBuilt() const;
+    int getLandmarkCount() const;
+    QList<int> getLandmarks() const;           // Station IDs
+    Selection getSelection() const;
+    Precision getPrecision() const;
+    qint64 getTableBytes() const;
+    qint64 getBuildMs() const;
+
+    void clear();
+
+    // Names used by the command line tools ("lejano", "evitar")
+    static QString selectionName(Selection selection);
+    static bool parseSelection(const QString& name, Selection& selection);
+
+private:
+    // Station without a path to or from a landmark
+    static const quint32 Unreached = 0xFFFFFFFF;
+
+    // One landmark column used by a query: target code and direction of the bound
+    struct ActiveColumn
+    {
+        int column;
+        quint32 targetCode;
+        bool backward;        // d(v, L) - d(t, L) instead of d(L, t) - d(L, v)
+    };
+
+    QVector<int> landmarks;                    // Station indices
+    QList<int> landmarkIds;
+    QVector<quint16> codes16;                  // Rows of 'stride' codes, one row per station slot
+    QVector<quint32> codes32;
+    QHash<QPair<int, int>, double> baseWeights;  // Lightest weight known to keep the bounds (routes by index)
+    int stride;                                // Columns per row (landmarks, twice for directed graphs)
+    int slotCount;
+    double scale;                              // Distance of one code unit
+    bool directed;
+    bool built;
+    quint64 builtVersion;
+    qint64 buildMs;
+    int threads;
+    Selection selection;
+    Precision precision;
+    int requestedLandmarks;
+
+    // Stored code of a station slot and column (Unreached if out of range)
+    quint32 codeAt(int slot, int column) const;
+    int columnOf(int landmark, bool backward) const;
+
+    // Bound from one column, Unreached-aware; infinity if v cannot reach t
+    double columnBound(int slot, const ActiveColumn& active) const;
+
+    // Check if a route weight keeps every bound valid (triangle inequality per column)
+    bool keepsBounds(int fromIndex, int toIndex, double weight) const;
+
+    // Check the graph's changes since the build; fills the safe weight of the routes they touch
+    bool scanChanges(const Graph& graph, QHash<QPair<int, int>, double>& safeWeights) const;
+
+    // Store the double tables quantized
+    void quantize(const QVector<QVector<double>>& forward, const QVector<QVector<double>>& backward);
+};
+
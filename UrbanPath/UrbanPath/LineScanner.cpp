@@ -0,0 +1,170 @@
+#include "LineScanner.h"
+#include <charconv>
+#include <cstring>
+#include <algorithm>
+
+// Whitespace accepted around lines and fields
+static inline bool isBlank(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+}
+
+// Check if the range starts with the given text
+bool ByteRange::startsWith(const char* prefix) const
+{
+    size_t length = strlen(prefix);
+    return static_cast<size_t>(end - begin) >= length && memcmp(begin, prefix, length) == 0;
+}
+
+// Range without leading and trailing whitespace
+ByteRange ByteRange::trimmed() const
+{
+    const char* b = begin;
+    const char* e = end;
+
+    while (b < e && isBlank(*b))
+    {
+        b++;
+    }
+    while (e > b && isBlank(*(e - 1)))
+    {
+        e--;
+    }
+
+    return ByteRange(b, e);
+}
+
+// Decode the range as UTF-8
+QString ByteRange::toString() const
+{
+    return QString::fromUtf8(begin, size());
+}
+
+// Constructor
+LineScanner::LineScanner(const char* begin, const char* end, int firstLineNumber)
+    : current(begin), end(end), currentLine(firstLineNumber - 1)
+{
+}
+
+// Get the next line
+bool LineScanner::nextLine(ByteRange& line)
+{
+    if (current >= end)
+    {
+        return false;
+    }
+
+    const char* lineEnd = static_cast<const char*>(memchr(current, '\n', end - current));
+    if (lineEnd == nullptr)
+    {
+        lineEnd = end;
+    }
+
+    line = ByteRange(current, lineEnd).trimmed();
+    current = (lineEnd < end) ? lineEnd + 1 : end;
+    currentLine++;
+
+    return true;
+}
+
+// Number of the line last returned
+int LineScanner::lineNumber() const
+{
+    return currentLine;
+}
+
+// Current position in the buffer
+const char* LineScanner::position() const
+{
+    return current;
+}
+
+// Empty lines and comments are skipped by the loaders
+bool LineScanner::isSkippable(const ByteRange& line)
+{
+    return line.isEmpty() || line.startsWith("#") || line.startsWith("//");
+}
+
+// Split a line into trimmed fields
+int LineScanner::splitFields(const ByteRange& line, char separator, ByteRange* fields, int maxFields)
+{
+    int count = 0;
+    const char* fieldStart = line.begin;
+
+    while (true)
+    {
+        const char* fieldEnd = static_cast<const char*>(memchr(fieldStart, separator, line.end - fieldStart));
+        if (fieldEnd == nullptr)
+        {
+            fieldEnd = line.end;
+        }
+
+        if (count < maxFields)
+        {
+            fields[count] = ByteRange(fieldStart, fieldEnd).trimmed();
+        }
+        count++;
+
+        if (fieldEnd == line.end)
+        {
+            break;
+        }
+        fieldStart = fieldEnd + 1;
+    }
+
+    return count;
+}
+
+// Parse a whole field as an int
+bool LineScanner::parseInt(const ByteRange& field, int& value)
+{
+    const char* b = field.begin;
+    if (b < field.end && *b == '+')
+    {
+        b++;
+    }
+    if (b == field.end)
+    {
+        return false;
+    }
+
+    auto result = std::from_chars(b, field.end, value);
+    return result.ec == std::errc() && result.ptr == field.end;
+}
+
+// Parse a whole field as a double
+bool LineScanner::parseDouble(const ByteRange& field, double& value)
+{
+    const char* b = field.begin;
+    if (b < field.end && *b == '+')
+    {
+        b++;
+    }
+    if (b == field.end)
+    {
+        return false;
+    }
+
+    auto result = std::from_chars(b, field.end, value);
+    return result.ec == std::errc() && result.ptr == field.end;
+}
+
+// Skip a UTF-8 BOM
+const char* LineScanner::skipBom(const char* begin, const char* end)
+{
+    if (end - begin >= 3 &&
+        static_cast<unsigned char>(begin[0]) == 0xEF &&
+        static_cast<unsigned char>(begin[1]) == 0xBB &&
+        static_cast<unsigned char>(begin[2]) == 0xBF)
+    {
+        return begin + 3;
+    }
+    return begin;
+}
+
+// Count line terminators
+qint64 LineScanner::countLines(const char* begin, const char* end)
+{
+    return static_cast<qint64>(std::count(begin, end, '\n')) + 1;
+}
+
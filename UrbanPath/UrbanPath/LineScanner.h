@@ -0,0 +1,59 @@
+#pragma once
+
+#include <QString>
+
+using namespace std;
+
+// Byte range inside a loaded or memory-mapped buffer (no copies)
+struct ByteRange
+{
+    const char* begin;
+    const char* end;
+
+    ByteRange() : begin(nullptr), end(nullptr) {}
+    ByteRange(const char* b, const char* e) : begin(b), end(e) {}
+
+    int size() const { return static_cast<int>(end - begin); }
+    bool isEmpty() const { return begin == end; }
+    bool startsWith(const char* prefix) const;
+    ByteRange trimmed() const;
+    QString toString() const;   // UTF-8 decode
+};
+
+// Line tokenizer for the comma separated data files.
+// Works directly over the bytes of a buffer: lines, fields and numbers are
+// byte ranges, so nothing is copied until a field is turned into a value.
+class LineScanner
+{
+private:
+    const char* current;
+    const char* end;
+    int currentLine;     // Number of the line last returned by nextLine()
+
+public:
+    // Constructor (firstLineNumber lets a chunk keep the numbering of the whole file)
+    LineScanner(const char* begin, const char* end, int firstLineNumber = 1);
+
+    // Next line without its terminator, trimmed; false at the end of the buffer
+    bool nextLine(ByteRange& line);
+    int lineNumber() const;
+    const char* position() const;
+
+    // Empty lines and comments (# or //)
+    static bool isSkippable(const ByteRange& line);
+
+    // Split a line into trimmed fields; returns the real number of fields
+    // (only the first maxFields are stored)
+    static int splitFields(const ByteRange& line, char separator, ByteRange* fields, int maxFields);
+
+    // Number parsing with from_chars (optional leading '+', no locale)
+    static bool parseInt(const ByteRange& field, int& value);
+    static bool parseDouble(const ByteRange& field, double& value);
+
+    // Skip a UTF-8 byte order mark at the start of a buffer
+    static const char* skipBom(const char* begin, const char* end);
+
+    // Count line terminators (to pre-size containers)
+    static qint64 countLines(const char* begin, const char* end);
+};
+
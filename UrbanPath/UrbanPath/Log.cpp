@@ -0,0 +1,259 @@
+#include "Log.h"
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+atomic<int> Log::minimumLevel(Log::Debug);
+
+namespace
+{
+
+struct Entry
+{
+    Log::Level level;
+    QString message;
+};
+
+// Pass a message on to Qt's message handler
+void output(Log::Level level, const QString& message)
+{
+    QMessageLogger logger;
+    switch (level)
+    {
+    case Log::Debug:
+        logger.debug().noquote() << message;
+        break;
+    case Log::Info:
+        logger.info().noquote() << message;
+        break;
+    case Log::Warning:
+        logger.warning().noquote() << message;
+        break;
+    case Log::Error:
+        logger.critical().noquote() << message;
+        break;
+    }
+}
+
+// Set once the writer is gone (static destruction): later messages are written directly
+atomic<bool> sinkClosed(false);
+
+// Writer thread, started with the first queued message
+class Sink
+{
+public:
+    // Above this many queued messages, Debug and Info messages are dropped (and counted)
+    static const int MaxQueued = 65536;
+
+    ~Sink()
+    {
+        {
+            lock_guard<mutex> lock(queueMutex);
+            stopping = true;
+        }
+        wakeWriter.notify_one();
+        if (writer.joinable())
+        {
+            writer.join();
+        }
+        sinkClosed = true;
+    }
+
+    void write(Log::Level level, const QString& message)
+    {
+        unique_lock<mutex> lock(queueMutex);
+        if (!asynchronous || stopping)
+        {
+            lock.unlock();
+            output(level, message);
+            return;
+        }
+
+        if (queue.size() >= MaxQueued && level < Log::Warning)
+        {
+            dropped++;
+            return;
+        }
+
+        queue.push_back(Entry{ level, message });
+        if (!writer.joinable())
+        {
+            writer = thread(&Sink::run, this);
+        }
+        lock.unlock();
+        wakeWriter.notify_one();
+    }
+
+    void setAsynchronous(bool enabled)
+    {
+        lock_guard<mutex> lock(queueMutex);
+        asynchronous = enabled;
+    }
+
+    bool isAsynchronous()
+    {
+        lock_guard<mutex> lock(queueMutex);
+        return asynchronous;
+    }
+
+    void flush()
+    {
+        unique_lock<mutex> lock(queueMutex);
+        drained.wait(lock, [this]() { return queue.empty() && !writing; });
+    }
+
+private:
+    mutex queueMutex;
+    condition_variable wakeWriter;
+    condition_variable drained;
+    deque<Entry> queue;
+    thread writer;
+    bool asynchronous = true;
+    bool stopping = false;
+    bool writing = false;
+    qint64 dropped = 0;
+
+    void run()
+    {
+        unique_lock<mutex> lock(queueMutex);
+        while (true)
+        {
+            wakeWriter.wait(lock, [this]() { return !queue.empty() || stopping; });
+            if (queue.empty())
+            {
+                return;  // Stopping and nothing left
+            }
+
+            // Take the whole queue and write it without holding the lock
+            deque<Entry> batch;
+            batch.swap(queue);
+            qint64 droppedNow = dropped;
+            dropped = 0;
+            writing = true;
+            lock.unlock();
+
+            if (droppedNow > 0)
+            {
+                output(Log::Warning, QString("Advertencia: %1 mensajes de registro descartados (cola llena).").arg(droppedNow));
+            }
+            for (const Entry& entry : batch)
+            {
+                output(entry.level, entry.message);
+            }
+
+            lock.lock();
+            writing = false;
+            if (queue.empty())
+            {
+                drained.notify_all();
+            }
+        }
+    }
+};
+
+Sink& sink()
+{
+    static Sink instance;
+    return instance;
+}
+
+qint64 nowMs()
+{
+    return chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+}
+
+// Set the runtime level
+void Log::setLevel(Level level)
+{
+    minimumLevel = level;
+}
+
+// Get the runtime level
+Log::Level Log::getLevel()
+{
+    return static_cast<Level>(minimumLevel.load());
+}
+
+// Write a message
+void Log::write(Level level, const QString& message)
+{
+    // QDebug leaves a space after the last argument
+    QString text = message.endsWith(' ') ? message.left(message.length() - 1) : message;
+
+    if (sinkClosed)
+    {
+        output(level, text);
+        return;
+    }
+    sink().write(level, text);
+}
+
+// Turn the writer thread on or off
+void Log::setAsynchronous(bool enabled)
+{
+    if (!enabled)
+    {
+        flush();
+    }
+    sink().setAsynchronous(enabled);
+}
+
+// Check if messages go through the writer thread
+bool Log::isAsynchronous()
+{
+    return sink().isAsynchronous();
+}
+
+// Wait for the queued messages
+void Log::flush()
+{
+    if (!sinkClosed)
+    {
+        sink().flush();
+    }
+}
+
+// Rate limit constructor
+Log::RateLimit::RateLimit(int burst, int intervalMs)
+    : burst(qMax(1, burst)), intervalMs(qMax(1, intervalMs)), windowStart(nowMs()), windowCount(0), suppressed(0)
+{
+}
+
+// Report the messages that were left out
+Log::RateLimit::~RateLimit()
+{
+    qint64 count = suppressed;
+    if (count > 0 && isEnabled(Warning))
+    {
+        write(Warning, QString("Advertencia: %1 advertencias similares no se mostraron.").arg(count));
+    }
+}
+
+// Check if one more message fits in the current interval
+bool Log::RateLimit::allow()
+{
+    qint64 now = nowMs();
+    qint64 start = windowStart.load(memory_order_relaxed);
+    if (now - start >= intervalMs && windowStart.compare_exchange_strong(start, now))
+    {
+        windowCount = 0;
+    }
+
+    if (windowCount.fetch_add(1, memory_order_relaxed) < burst)
+    {
+        return true;
+    }
+    suppressed.fetch_add(1, memory_order_relaxed);
+    return false;
+}
+
+// Get how many messages were left out
+qint64 Log::RateLimit::getSuppressed() const
+{
+    return suppressed;
+}
+
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <QString>
+#include <QDebug>
+#include <QtGlobal>
+#include <atomic>
+
+using namespace std;
+
+// Minimum level compiled in (0 = Debug, 1 = Info, 2 = Warning, 3 = Error).
+// Release builds (QT_NO_DEBUG) drop the Debug messages: their arguments are not
+// even evaluated, the whole statement is dead code.
+#ifndef URBANPATH_LOG_MIN_LEVEL
+#ifdef QT_NO_DEBUG
+#define URBANPATH_LOG_MIN_LEVEL 1
+#else
+#define URBANPATH_LOG_MIN_LEVEL 0
+#endif
+#endif
+
+// Leveled logging for the core (network, files), used like qDebug():
+//
+//   LOG_DEBUG << "Estacion" << id << "cerrada (bloqueada).";
+//   LOG_WARNING_LIMITED(lineWarnings) << "Advertencia: Linea" << lineNumber << "invalida.";
+//
+// A message below the compiled or the runtime level costs one comparison.
+// The others are formatted on the calling thread and handed to a writer thread
+// that passes them on to Qt's message handler (qDebug, qInfo, qWarning, qCritical),
+// so slow consoles no longer hold up loads and algorithms.
+class Log
+{
+public:
+    enum Level
+    {
+        Debug,
+        Info,
+        Warning,
+        Error
+    };
+
+    // Runtime minimum level (Debug by default; levels not compiled in stay off)
+    static void setLevel(Level level);
+    static Level getLevel();
+    static bool isEnabled(Level level)
+    {
+        return level >= URBANPATH_LOG_MIN_LEVEL && level >= minimumLevel.load(memory_order_relaxed);
+    }
+
+    // Queue a message (or write it right away when the writer thread is off)
+    static void write(Level level, const QString& message);
+
+    // Writer thread on (default) or off; off writes on the calling thread
+    static void setAsynchronous(bool enabled);
+    static bool isAsynchronous();
+
+    // Wait until every queued message has been written
+    static void flush();
+
+    // One message, written when the statement ends
+    class Line
+    {
+    public:
+        explicit Line(Level level) : level(level), debug(&message) {}
+        ~Line() { write(level, message); }
+
+        QDebug& stream() { return debug; }
+
+        Line(const Line&) = delete;
+        Line& operator=(const Line&) = delete;
+
+    private:
+        Level level;
+        QString message;
+        QDebug debug;
+    };
+
+    // Lets through 'burst' messages per interval and counts the rest.
+    // One per repeated warning (e.g. per file being loaded); safe to share between threads.
+    // The destructor reports how many messages were left out.
+    class RateLimit
+    {
+    public:
+        explicit RateLimit(int burst = 10, int intervalMs = 1000);
+        ~RateLimit();
+
+        bool allow();
+        qint64 getSuppressed() const;
+
+        RateLimit(const RateLimit&) = delete;
+        RateLimit& operator=(const RateLimit&) = delete;
+
+    private:
+        int burst;
+        qint64 intervalMs;
+        atomic<qint64> windowStart;
+        atomic<int> windowCount;
+        atomic<qint64> suppressed;
+    };
+
+private:
+    static atomic<int> minimumLevel;
+};
+
+#define URBANPATH_LOG_IF(level, condition) \
+    if ((level) < URBANPATH_LOG_MIN_LEVEL || !Log::isEnabled(level) || !(condition)) {} \
+    else Log::Line(level).stream()
+
+#define LOG_DEBUG URBANPATH_LOG_IF(Log::Debug, true)
+#define LOG_INFO URBANPATH_LOG_IF(Log::Info, true)
+#define LOG_WARNING URBANPATH_LOG_IF(Log::Warning, true)
+#define LOG_ERROR URBANPATH_LOG_IF(Log::Error, true)
+#define LOG_WARNING_LIMITED(limit) URBANPATH_LOG_IF(Log::Warning, (limit).allow())
+#define LOG_ERROR_LIMITED(limit) URBANPATH_LOG_IF(Log::Error, (limit).allow())
+
@@ -1,4 +1,5 @@
 ﻿#include "MainWindow.h"
+#include "Metrics.h"
 #include <QDateTime>
 #include <QDesktopServices>
 #include <QUrl>
@@ -6,15 +7,20 @@
 #include <QSet>
 #include <QStringList>
 #include <QDir>
+#include <QFileInfo>
 #include <QPushButton>
 #include <QDialog>
 #include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QFontDatabase>
 #include <QTextEdit>
 #include <QFrame>
+#include <QTimer>
+#include <QProgressBar>
 #include <algorithm>
 
 MainWindow::MainWindow(QWidget *parent)
-    : QMainWindow(parent), dataLoaded(false)
+    : QMainWindow(parent), bst(&graph.getStationTable()), dataLoaded(false), latestJobId(-1)
 {
     ui.setupUi(this);
     
@@ -39,14 +45,15 @@ MainWindow::MainWindow(QWidget *parent)
         
         // Crear estacion en coordenadas clickeadas
         Station station(newId, name, x, y);
-        bst.insert(station);
         graph.addStation(station);
+        bst.insert(newId);
         
-        // Redibujar el grafo para mostrar nueva estacion
-        visualizer->drawGraph();
+        // Dibujar solo la nueva estacion
+        visualizer->updateStation(newId);
         
-        // Actualizar combo boxes
-        updateComboBoxes();
+        // Actualizar combo boxes e indice de nombres solo con la nueva estacion
+        addStationToCombos(newId);
+        nameIndex.insert(newId, name);
         
         // Registrar la accion
         QString log = QString("<span style='color:green'>[%1] Estacion agregada con clic: [%2] %3 (X:%4, Y:%5)</span>")
@@ -68,6 +75,9 @@ MainWindow::MainWindow(QWidget *parent)
     // Configurar conexiones
     setupConnections();
     
+    // Autocompletado por nombre en los combos de estaciones
+    setupStationCompleters();
+    
     // Mensajes iniciales
     logBST("=== Sistema UrbanPath Iniciado ===", "#00BFFF");
     logBST("Listo para gestionar estaciones.", "white");
@@ -80,6 +90,49 @@ MainWindow::MainWindow(QWidget *parent)
     // Intentar cargar imagen de fondo
     loadBackgroundImage();
     
+    // Recordar lo cargado para poder recargar solo los cambios
+    fileManager.setChangeTracking(true);
+    
+    // Diario de eventos: cada cierre o accidente se anota en cuanto ocurre
+    graph.setChangeListener([this](const GraphEvent& event) {
+        journal.record(event);
+    });
+    
+    // Confirmar el diario periodicamente y compactarlo cuando crece demasiado
+    journalTimer = new QTimer(this);
+    connect(journalTimer, &QTimer::timeout, this, [this]() {
+        journal.commit();
+        if (journal.needsCompaction() &&
+            !journal.compact(fileManager, graph, journalClosuresFile, journalAccidentsFile))
+        {
+            logGraph(QString("Advertencia: %1 Se reintentara en %2 s.")
+                .arg(journal.getLastError()).arg(journal.getCompactionRetryMs() / 1000), "orange");
+        }
+    });
+    journalTimer->start(1000);
+    
+    // Algoritmos del grafo en segundo plano, con progreso y cancelacion en la barra de estado
+    algorithmWorker = new AlgorithmWorker(this);
+    jobProgressBar = new QProgressBar(this);
+    jobProgressBar->setRange(0, 100);
+    jobProgressBar->setMaximumWidth(220);
+    jobProgressBar->hide();
+    cancelJobsButton = new QPushButton("Cancelar", this);
+    cancelJobsButton->hide();
+    statusBar()->addPermanentWidget(jobProgressBar);
+    statusBar()->addPermanentWidget(cancelJobsButton);
+    
+    // Metricas de los algoritmos (llamadas, tiempos y contadores)
+    metricsButton = new QPushButton("Metricas", this);
+    metricsButton->setToolTip("Llamadas, tiempos y contadores de los algoritmos");
+    statusBar()->addPermanentWidget(metricsButton);
+    
+    connect(algorithmWorker, &AlgorithmWorker::jobStarted, this, &MainWindow::onJobStarted);
+    connect(algorithmWorker, &AlgorithmWorker::jobProgress, this, &MainWindow::onJobProgress);
+    connect(algorithmWorker, &AlgorithmWorker::jobFinished, this, &MainWindow::onJobFinished);
+    connect(cancelJobsButton, &QPushButton::clicked, this, &MainWindow::onCancelJobsClicked);
+    connect(metricsButton, &QPushButton::clicked, this, &MainWindow::onMetricsClicked);
+    
     // Cargar datos iniciales si los archivos existen
     if (fileManager.fileExists("estaciones.txt"))
     {
@@ -89,6 +142,12 @@ MainWindow::MainWindow(QWidget *parent)
 
 MainWindow::~MainWindow()
 {
+    // Las tareas usan copias del grafo, pero sus resultados apuntan a esta ventana
+    algorithmWorker->cancelAll();
+    algorithmWorker->waitForDone();
+    
+    journal.commit();
+    graph.setChangeListener(nullptr);
     delete visualizer;
     delete scene;
 }
@@ -328,28 +387,186 @@ void MainWindow::loadBackgroundImage()
     logGraph("Advertencia: No se encontro imagen de fondo.", "orange");
 }
 
-// Actualizar combo boxes con IDs de estaciones
+namespace
+{
+
+// Estaciones que se cargan directamente en cada combo; el resto llega por el autocompletado
+const int ComboStationLimit = 100;
+
+// Texto de una estacion en los combos
+QString comboText(const StationTable& table, int index)
+{
+    return QString("%1 - %2").arg(table.idAt(index)).arg(table.nameViewAt(index));
+}
+
+}
+
+// Combos de estaciones
+QList<QComboBox*> MainWindow::stationCombos() const
+{
+    return {
+        ui.comboOrigin, ui.comboDestination, ui.comboClosureStation,
+        ui.comboClosureOrigin, ui.comboClosureDest,
+        ui.comboAccidentOrigin, ui.comboAccidentDest
+    };
+}
+
+// Actualizar combo boxes: solo las primeras estaciones (y la seleccionada), no toda la red
 void MainWindow::updateComboBoxes()
 {
-    ui.comboOrigin->clear();
-    ui.comboDestination->clear();
-    ui.comboClosureStation->clear();
-    ui.comboClosureOrigin->clear();
-    ui.comboClosureDest->clear();
-    ui.comboAccidentOrigin->clear();
-    ui.comboAccidentDest->clear();
-    
-    QList<Station> stations = graph.getAllStations();
-    for (const Station& station : stations)
-    {
-        QString text = QString("%1 - %2").arg(station.getId()).arg(station.getName());
-        ui.comboOrigin->addItem(text, station.getId());
-        ui.comboDestination->addItem(text, station.getId());
-        ui.comboClosureStation->addItem(text, station.getId());
-        ui.comboClosureOrigin->addItem(text, station.getId());
-        ui.comboClosureDest->addItem(text, station.getId());
-        ui.comboAccidentOrigin->addItem(text, station.getId());
-        ui.comboAccidentDest->addItem(text, station.getId());
+    const StationTable& table = graph.getStationTable();
+    
+    QList<int> first;
+    for (int index = 0; index < table.slotCount() && first.size() < ComboStationLimit; index++)
+    {
+        if (table.isValidIndex(index))
+        {
+            first.append(index);
+        }
+    }
+    
+    for (QComboBox* combo : stationCombos())
+    {
+        // Conservar la estacion elegida si sigue existiendo
+        int selected = combo->currentData().toInt();
+        int selectedIndex = (combo->count() > 0) ? table.indexOf(selected) : StationTable::InvalidIndex;
+        
+        combo->clear();
+        for (int index : first)
+        {
+            combo->addItem(comboText(table, index), table.idAt(index));
+        }
+        
+        if (selectedIndex != StationTable::InvalidIndex)
+        {
+            selectComboStation(combo, selected);
+        }
+    }
+}
+
+// Agregar una estacion nueva a los combos que aun tienen espacio
+void MainWindow::addStationToCombos(int id)
+{
+    const StationTable& table = graph.getStationTable();
+    int index = table.indexOf(id);
+    if (index == StationTable::InvalidIndex)
+    {
+        return;
+    }
+    
+    for (QComboBox* combo : stationCombos())
+    {
+        int existing = combo->findData(id);
+        if (existing >= 0)
+        {
+            combo->setItemText(existing, comboText(table, index));
+        }
+        else if (combo->count() < ComboStationLimit)
+        {
+            combo->addItem(comboText(table, index), id);
+        }
+    }
+}
+
+// Quitar una estacion eliminada de los combos
+void MainWindow::removeStationFromCombos(int id)
+{
+    for (QComboBox* combo : stationCombos())
+    {
+        int existing = combo->findData(id);
+        if (existing >= 0)
+        {
+            combo->removeItem(existing);
+        }
+    }
+}
+
+// Seleccionar una estacion en un combo, agregandola si no estaba cargada
+void MainWindow::selectComboStation(QComboBox* combo, int id)
+{
+    int existing = combo->findData(id);
+    if (existing < 0)
+    {
+        const StationTable& table = graph.getStationTable();
+        int index = table.indexOf(id);
+        if (index == StationTable::InvalidIndex)
+        {
+            return;
+        }
+        
+        // La elegida va al principio; el combo no pasa del limite
+        combo->insertItem(0, comboText(table, index), id);
+        if (combo->count() > ComboStationLimit + 1)
+        {
+            combo->removeItem(combo->count() - 1);
+        }
+        existing = 0;
+    }
+    combo->setCurrentIndex(existing);
+}
+
+// Configurar autocompletado por nombre en los combos de estaciones
+void MainWindow::setupStationCompleters()
+{
+    for (QComboBox* combo : stationCombos())
+    {
+        combo->setEditable(true);
+        combo->setInsertPolicy(QComboBox::NoInsert);
+        
+        // El modelo solo contiene las sugerencias actuales, no todas las estaciones
+        QStringListModel* model = new QStringListModel(this);
+        QCompleter* completer = new QCompleter(model, this);
+        completer->setCompletionMode(QCompleter::UnfilteredPopupCompletion);
+        completer->setMaxVisibleItems(10);
+        combo->setCompleter(completer);
+        
+        connect(combo->lineEdit(), &QLineEdit::textEdited, this, [this, combo, model](const QString& text) {
+            updateStationSuggestions(combo, model, text);
+        });
+        
+        // Seleccionar la estacion elegida ("id - nombre"), aunque no estuviera en el combo
+        connect(completer, QOverload<const QString&>::of(&QCompleter::activated), this, [this, combo](const QString& text) {
+            selectComboStation(combo, text.section(" - ", 0, 0).toInt());
+        });
+    }
+}
+
+// Actualizar sugerencias de un combo segun el texto escrito
+void MainWindow::updateStationSuggestions(QComboBox* combo, QStringListModel* model, const QString& text)
+{
+    QStringList suggestions;
+    QList<int> ids;
+    
+    // Un numero se interpreta primero como ID de estacion
+    bool isNumber = false;
+    int typedId = text.trimmed().toInt(&isNumber);
+    if (isNumber && graph.containsStation(typedId))
+    {
+        ids.append(typedId);
+    }
+    
+    for (int id : nameIndex.autocomplete(text, 10))
+    {
+        if (!ids.contains(id))
+        {
+            ids.append(id);
+        }
+    }
+    
+    const StationTable& table = graph.getStationTable();
+    for (int id : ids)
+    {
+        int index = table.indexOf(id);
+        if (index != StationTable::InvalidIndex)
+        {
+            suggestions << QString("%1 - %2").arg(id).arg(table.nameViewAt(index));
+        }
+    }
+    
+    model->setStringList(suggestions);
+    if (!suggestions.isEmpty())
+    {
+        combo->completer()->complete();
     }
 }
 
@@ -419,8 +636,8 @@ void MainWindow::onAddStationClicked()
     }
     
     Station station(id, name, x, y);
-    bst.insert(station);
     graph.addStation(station);
+    bst.insert(id);
     
     logBST(QString("Estacion agregada: [%1] %2 (X:%3, Y:%4)")
         .arg(id).arg(name).arg(x).arg(y), "green");
@@ -428,7 +645,8 @@ void MainWindow::onAddStationClicked()
     // Marcar datos como cargados al agregar estaciones manualmente
     dataLoaded = true;
     
-    updateComboBoxes();
+    addStationToCombos(id);
+    nameIndex.insert(id, name);
     onClearStationClicked();
     statusBar()->showMessage(QString("Estacion %1 agregada correctamente").arg(id), 3000);
 }
@@ -448,7 +666,8 @@ void MainWindow::onRemoveStationClicked()
     {
         graph.removeStation(id);
         logBST(QString("Estacion %1 eliminada correctamente.").arg(id), "#FF6B6B");
-        updateComboBoxes();
+        removeStationFromCombos(id);
+        nameIndex.remove(id);
         onClearStationClicked();
         statusBar()->showMessage(QString("Estacion %1 eliminada").arg(id), 3000);
     }
@@ -463,23 +682,51 @@ void MainWindow::onRemoveStationClicked()
 void MainWindow::onSearchStationClicked()
 {
     int id = ui.txtStationID->text().toInt();
+    QString nameQuery = ui.txtStationName->text().trimmed();
+    
+    // Sin ID valido, buscar por nombre (prefijo y luego con tolerancia a errores)
+    if (id <= 0 && !nameQuery.isEmpty())
+    {
+        QList<int> matches = nameIndex.autocomplete(nameQuery, 1);
+        if (matches.isEmpty())
+        {
+            QList<QPair<int, int>> fuzzy = nameIndex.fuzzySearch(nameQuery, 2, 1);
+            if (!fuzzy.isEmpty())
+            {
+                matches.append(fuzzy.first().first);
+            }
+        }
+        
+        if (matches.isEmpty())
+        {
+            logBST(QString("Estacion con nombre '%1' no encontrada.").arg(nameQuery), "orange");
+            showInfoMessage("Busqueda", QString("No se encontro una estacion con nombre '%1'").arg(nameQuery));
+            return;
+        }
+        
+        id = matches.first();
+        ui.txtStationID->setText(QString::number(id));
+    }
     
     if (id <= 0)
     {
-        showErrorMessage("Error", "Por favor ingrese un ID valido.");
+        showErrorMessage("Error", "Por favor ingrese un ID o nombre valido.");
         return;
     }
     
-    Station* station = bst.search(id);
+    int index = bst.search(id);
     
-    if (station)
+    if (index != StationTable::InvalidIndex)
     {
-        ui.txtStationName->setText(station->getName());
-        ui.txtStationX->setText(QString::number(station->getX()));
-        ui.txtStationY->setText(QString::number(station->getY()));
+        const StationTable& table = graph.getStationTable();
+        QString name = table.nameAt(index);
+        
+        ui.txtStationName->setText(name);
+        ui.txtStationX->setText(QString::number(table.xAt(index)));
+        ui.txtStationY->setText(QString::number(table.yAt(index)));
         
         logBST(QString("Estacion encontrada: [%1] %2")
-            .arg(station->getId()).arg(station->getName()), "blue");
+            .arg(id).arg(name), "blue");
         
         statusBar()->showMessage(QString("Estacion %1 encontrada").arg(id), 3000);
     }
@@ -503,13 +750,14 @@ void MainWindow::onClearStationClicked()
 // Slot: Recorrido En Orden
 void MainWindow::onInOrderClicked()
 {
-    QList<Station> stations = bst.inOrder();
+    QList<int> stations = bst.inOrder();
+    const StationTable& table = graph.getStationTable();
     
     logBST("=== Recorrido In-Order (Ascendente) ===", "#00BFFF");
     for (int i = 0; i < stations.size(); i++)
     {
-        const Station& s = stations[i];
-        logBST(QString("%1. [%2] %3").arg(i+1).arg(s.getId()).arg(s.getName()), "white");
+        int index = stations[i];
+        logBST(QString("%1. [%2] %3").arg(i+1).arg(table.idAt(index)).arg(table.nameViewAt(index)), "white");
     }
     logBST(QString("Total: %1 estaciones").arg(stations.size()), "green");
 }
@@ -517,13 +765,14 @@ void MainWindow::onInOrderClicked()
 // Slot: Recorrido Pre Orden
 void MainWindow::onPreOrderClicked()
 {
-    QList<Station> stations = bst.preOrder();
+    QList<int> stations = bst.preOrder();
+    const StationTable& table = graph.getStationTable();
     
     logBST("=== Recorrido Pre-Order ===", "#00BFFF");
     for (int i = 0; i < stations.size(); i++)
     {
-        const Station& s = stations[i];
-        logBST(QString("%1. [%2] %3").arg(i+1).arg(s.getId()).arg(s.getName()), "white");
+        int index = stations[i];
+        logBST(QString("%1. [%2] %3").arg(i+1).arg(table.idAt(index)).arg(table.nameViewAt(index)), "white");
     }
     logBST(QString("Total: %1 estaciones").arg(stations.size()), "green");
 }
@@ -531,13 +780,14 @@ void MainWindow::onPreOrderClicked()
 // Slot: Recorrido Post Orden
 void MainWindow::onPostOrderClicked()
 {
-    QList<Station> stations = bst.postOrder();
+    QList<int> stations = bst.postOrder();
+    const StationTable& table = graph.getStationTable();
     
     logBST("=== Recorrido Post-Order ===", "#00BFFF");
     for (int i = 0; i < stations.size(); i++)
     {
-        const Station& s = stations[i];
-        logBST(QString("%1. [%2] %3").arg(i+1).arg(s.getId()).arg(s.getName()), "white");
+        int index = stations[i];
+        logBST(QString("%1. [%2] %3").arg(i+1).arg(table.idAt(index)).arg(table.nameViewAt(index)), "white");
     }
     logBST(QString("Total: %1 estaciones").arg(stations.size()), "green");
 }
@@ -588,7 +838,7 @@ void MainWindow::onAddRouteClicked()
     
     if (visualizer)
     {
-        visualizer->drawGraph();
+        visualizer->updateRoute(origin, dest);
     }
     
     statusBar()->showMessage(QString("Ruta %1-%2 agregada").arg(origin).arg(dest), 3000);
@@ -612,7 +862,7 @@ void MainWindow::onRemoveRouteClicked()
     
     if (visualizer)
     {
-        visualizer->drawGraph();
+        visualizer->updateRoute(origin, dest);
     }
     
     statusBar()->showMessage(QString("Ruta %1-%2 eliminada").arg(origin).arg(dest), 3000);
@@ -646,38 +896,55 @@ void MainWindow::onShortestPathClicked()
         return;
     }
     
-    // Redibujar grafo para limpiar resaltado de ruta optima previa
-    visualizer->drawGraph();
+    // Limpiar resaltado de ruta optima previa
+    visualizer->clearOptimalRoute();
     
     logGraph(QString("Calculando ruta mas corta de %1 a %2...").arg(origin).arg(dest), "#00BFFF");
     
-    // Obtener distancias y predecesores
-    QPair<QHash<int, double>, QHash<int, int>> result = graph.dijkstraWithPath(origin);
-    QHash<int, double> distances = result.first;
-    QHash<int, int> predecessors = result.second;
-    
-    if (distances[dest] >= std::numeric_limits<double>::infinity())
+    // Rutas ya consultadas (o del mismo origen) salen de la cache
+    QList<int> cachedRoute;
+    double cachedDistance = 0.0;
+    if (pathCache.lookup(graph, origin, dest, cachedRoute, cachedDistance))
     {
-        logGraph("No existe ruta entre las estaciones seleccionadas.", "#FF6B6B");
-        showInfoMessage("Sin Ruta", "No hay conexion entre las estaciones seleccionadas.");
+        logGraph("Ruta obtenida de la cache (la red no cambio en ese tramo).", "#00BFFF");
+        showShortestPath(cachedRoute, cachedDistance);
         return;
     }
     
-    // Reconstruir el camino completo
-    QList<int> route;
-    int current = dest;
+    // Arbol de caminos desde el origen en segundo plano (sirve para cualquier destino)
+    struct DijkstraResult
+    {
+        ShortestPathCache::Tree tree;
+        QList<int> route;
+        double distance = 0.0;
+    };
     
-    while (current != -1)
+    algorithmWorker->start("Dijkstra", graph,
+        [origin, dest](const Graph& snapshot, JobToken& token) {
+            DijkstraResult result;
+            if (ShortestPathCache::computeTree(snapshot, origin, result.tree, &token))
+            {
+                result.route = ShortestPathCache::routeOf(snapshot, result.tree, dest, result.distance);
+            }
+            return result;
+        },
+        [this, origin](const DijkstraResult& result) {
+            if (!result.tree.dist.isEmpty())
+            {
+                pathCache.insertTree(origin, result.tree);
+            }
+            showShortestPath(result.route, result.distance);
+        });
+}
+
+// Mostrar la ruta mas corta (dibujo, registro, reporte y ventana)
+void MainWindow::showShortestPath(const QList<int>& route, double distance)
+{
+    if (route.isEmpty())
     {
-        route.prepend(current);  // Agregar al inicio de la lista
-        current = predecessors[current];
-        
-        // Romper si hemos alcanzado el origen o si no hay predecesor
-        if (current == origin)
-        {
-            route.prepend(origin);
-            break;
-        }
+        logGraph("No existe ruta entre las estaciones seleccionadas.", "#FF6B6B");
+        showInfoMessage("Sin Ruta", "No hay conexion entre las estaciones seleccionadas.");
+        return;
     }
     
     // Dibujar la ruta optima
@@ -695,48 +962,108 @@ void MainWindow::onShortestPathClicked()
     }
     
     logGraph(pathStr, "green");
-    logGraph(QString("Distancia total: %1").arg(distances[dest], 0, 'f', 1), "green");
+    logGraph(QString("Distancia total: %1").arg(distance, 0, 'f', 1), "green");
     
     reportGenerator.generateRouteReport("data/reportes/reporte_ruta_corta.txt", route, graph);
-    statusBar()->showMessage(QString("Distancia: %1 | %2 estaciones").arg(distances[dest], 0, 'f', 1).arg(route.size()), 5000);
+    statusBar()->showMessage(QString("Distancia: %1 | %2 estaciones").arg(distance, 0, 'f', 1).arg(route.size()), 5000);
     
     // Mostrar resultados en ventana popup
     QString resultMsg = QString("Ruta mas corta encontrada (Dijkstra)\n\n%1\n\nDistancia total: %2\nEstaciones: %3")
         .arg(pathStr)
-        .arg(distances[dest], 0, 'f', 1)
+        .arg(distance, 0, 'f', 1)
         .arg(route.size());
     showInfoMessage("Resultado - Dijkstra", resultMsg);
 }
 
-// Slot: Floyd-Warshall
-void MainWindow::onFloydClicked()
+// Slot: Rutas alternativas (k rutas mas cortas sin ciclos, algoritmo de Yen)
+void MainWindow::onAlternativeRoutesClicked()
 {
-    if (ui.comboOrigin->count() == 0)
+    if (ui.comboOrigin->count() == 0 || ui.comboDestination->count() == 0)
     {
         showErrorMessage("Error", "Deben de haber estaciones y rutas primero.");
         return;
     }
     
-    logGraph("Ejecutando algoritmo de Floyd-Warshall...", "#00BFFF");
+    if (!visualizer->isGraphDrawn())
+    {
+        showErrorMessage("Error", 
+            "Debe dibujar el grafo primero.\n\n"
+            "Haga clic en el boton 'Dibujar Grafo' antes de calcular rutas.");
+        logGraph("Error: Intento de calcular rutas alternativas sin grafo dibujado.", "#FF6B6B");
+        return;
+    }
+    
+    int origin = ui.comboOrigin->currentData().toInt();
+    int dest = ui.comboDestination->currentData().toInt();
+    
+    if (origin == dest)
+    {
+        showInfoMessage("Informacion", "Origen y destino son la misma estacion.");
+        return;
+    }
     
-    QHash<QPair<int, int>, double> allPaths = graph.floydWarshall();
+    bool ok = false;
+    int k = QInputDialog::getInt(this, "Rutas alternativas", "Numero de rutas a mostrar:",
+                                 KShortestPaths::DefaultPaths, 2, 8, 1, &ok);
+    if (!ok)
+    {
+        return;
+    }
     
-    logGraph(QString("Floyd-Warshall completado. %1 pares de distancias calculadas.")
-        .arg(allPaths.size()), "green");
+    // Limpiar resaltado de rutas previas
+    visualizer->clearOptimalRoute();
     
-    statusBar()->showMessage("Floyd-Warshall ejecutado correctamente", 3000);
+    logGraph(QString("Calculando %1 rutas de %2 a %3...").arg(k).arg(origin).arg(dest), "#00BFFF");
     
-    // Mostrar resultados en ventana popup
-    QString resultMsg = QString("Algoritmo de Floyd-Warshall completado exitosamente.\n\n"
-                                "Pares de distancias calculadas: %1\n\n"
-                                "Este algoritmo calcula las distancias mas cortas\n"
-                                "entre todos los pares de estaciones.")
-        .arg(allPaths.size());
-    showInfoMessage("Resultado - Floyd-Warshall", resultMsg);
+    algorithmWorker->start("Rutas alternativas", graph,
+        [origin, dest, k](const Graph& snapshot, JobToken& token) {
+            QList<KShortestPaths::Path> paths;
+            KShortestPaths().find(snapshot, origin, dest, k, paths, &token);
+            return paths;
+        },
+        [this, k](const QList<KShortestPaths::Path>& paths) {
+            if (paths.isEmpty())
+            {
+                logGraph("No existe ruta entre las estaciones seleccionadas.", "#FF6B6B");
+                showInfoMessage("Sin Ruta", "No hay conexion entre las estaciones seleccionadas.");
+                return;
+            }
+            
+            // Registrar cada ruta con el color con el que se dibuja
+            const QStringList colors = { "#00FFFF", "#FF00FF", "#FFFF00", "#1E90FF" };
+            QList<QList<int>> routes;
+            QString summary;
+            for (int i = 0; i < paths.size(); i++)
+            {
+                QStringList ids;
+                for (int id : paths[i].stations)
+                {
+                    ids << QString::number(id);
+                }
+                
+                QString line = QString("Ruta %1: %2 (distancia %3)")
+                    .arg(i + 1).arg(ids.join(" -> ")).arg(paths[i].distance, 0, 'f', 1);
+                logGraph(line, colors[qMin(i, static_cast<int>(colors.size()) - 1)]);
+                summary += line + "\n";
+                routes.append(paths[i].stations);
+            }
+            
+            if (paths.size() < k)
+            {
+                logGraph(QString("Solo existen %1 rutas sin ciclos entre las estaciones.").arg(paths.size()), "orange");
+            }
+            
+            visualizer->drawAlternativeRoutes(routes);
+            statusBar()->showMessage(QString("%1 rutas | Mejor distancia: %2")
+                .arg(paths.size()).arg(paths.first().distance, 0, 'f', 1), 5000);
+            
+            showInfoMessage("Resultado - Rutas alternativas", summary +
+                "\nColores: cian = mas corta, magenta = segunda, amarillo = tercera, azul = cuarta y siguientes.");
+        });
 }
 
-// Slot: MST de Prim
-void MainWindow::onPrimMSTClicked()
+// Slot: Cobertura (estaciones alcanzables desde uno o varios depositos dentro de un costo)
+void MainWindow::onCoverageClicked()
 {
     if (ui.comboOrigin->count() == 0)
     {
@@ -744,42 +1071,94 @@ void MainWindow::onPrimMSTClicked()
         return;
     }
     
-    logGraph("Calculando MST con algoritmo de Prim...", "#00BFFF");
+    if (!visualizer->isGraphDrawn())
+    {
+        showErrorMessage("Error", 
+            "Debe dibujar el grafo primero.\n\n"
+            "Haga clic en el boton 'Dibujar Grafo' antes de calcular la cobertura.");
+        logGraph("Error: Intento de calcular cobertura sin grafo dibujado.", "#FF6B6B");
+        return;
+    }
+    
+    // Depositos: por defecto la estacion de origen seleccionada
+    bool ok = false;
+    QString text = QInputDialog::getText(this, "Cobertura", "IDs de los depositos (separados por comas):",
+                                         QLineEdit::Normal, ui.comboOrigin->currentData().toString(), &ok);
+    if (!ok)
+    {
+        return;
+    }
     
-    QList<QPair<int, int>> mst = graph.primMST();
+    QList<int> depots;
+    for (const QString& part : text.split(',', Qt::SkipEmptyParts))
+    {
+        bool valid = false;
+        int id = part.trimmed().toInt(&valid);
+        if (!valid || !graph.containsStation(id))
+        {
+            showErrorMessage("Error", QString("'%1' no es una estacion existente.").arg(part.trimmed()));
+            return;
+        }
+        if (!depots.contains(id))
+        {
+            depots.append(id);
+        }
+    }
     
-    if (mst.isEmpty())
+    if (depots.isEmpty())
     {
-        logGraph("Error: No se pudo calcular el MST.", "#FF6B6B");
+        showErrorMessage("Error", "Debe indicar al menos un deposito.");
         return;
     }
     
-    double totalWeight = 0.0;
-    QString edgesStr = "Aristas del MST:\n\n";
-    logGraph("Aristas del MST (Prim):", "#00BFFF");
-    for (const auto& edge : mst)
+    double budget = QInputDialog::getDouble(this, "Cobertura", "Costo maximo desde cada deposito:",
+                                            10.0, 0.0, 1e9, 1, &ok);
+    if (!ok)
     {
-        double weight = graph.getEdgeWeight(edge.first, edge.second);
-        totalWeight += weight;
-        logGraph(QString("  %1 <-> %2: %3")
-            .arg(edge.first).arg(edge.second).arg(weight, 0, 'f', 1), "black");
-        edgesStr += QString("  %1  <->  %2: %3\n")
-            .arg(edge.first).arg(edge.second).arg(weight, 0, 'f', 1);
+        return;
     }
     
-    logGraph(QString("Peso total del MST: %1").arg(totalWeight, 0, 'f', 1), "green");
-    statusBar()->showMessage(QString("MST (Prim) - Peso: %1").arg(totalWeight, 0, 'f', 1), 5000);
+    logGraph(QString("Calculando cobertura de %1 depositos con costo maximo %2...")
+             .arg(depots.size()).arg(budget, 0, 'f', 1), "#00BFFF");
     
-    // Mostrar resultados en ventana popup
-    QString resultMsg = QString("arbol de Expansion Minima (Prim)\n\n%1\nPeso total: %2\nAristas: %3")
-        .arg(edgesStr)
-        .arg(totalWeight, 0, 'f', 1)
-        .arg(mst.size());
-    showInfoMessage("Resultado - MST (Prim)", resultMsg);
+    algorithmWorker->start("Cobertura", graph,
+        [depots, budget](const Graph& snapshot, JobToken& token) {
+            return Isochrone().computeMany(snapshot, depots, budget, &token);
+        },
+        [this, budget](const QList<Isochrone::Area>& areas) {
+            visualizer->drawCoverageAreas(areas);
+            
+            // Resumen por deposito y estaciones cubiertas por al menos uno
+            QSet<int> covered;
+            QString summary;
+            for (const Isochrone::Area& area : areas)
+            {
+                int partial = 0;
+                for (const Isochrone::CoveredRoute& route : area.routes)
+                {
+                    partial += route.fraction < 1.0 ? 1 : 0;
+                }
+                for (const auto& station : area.stations)
+                {
+                    covered.insert(station.first);
+                }
+                
+                QString line = QString("Deposito %1: %2 estaciones, %3 rutas completas, %4 parciales")
+                    .arg(area.depotId).arg(area.stations.size()).arg(area.routes.size() - partial).arg(partial);
+                logGraph(line, "green");
+                summary += line + "\n";
+            }
+            
+            QString total = QString("Estaciones cubiertas: %1 de %2 (costo maximo %3)")
+                .arg(covered.size()).arg(graph.getStationCount()).arg(budget, 0, 'f', 1);
+            logGraph(total, "green");
+            statusBar()->showMessage(total, 5000);
+            showInfoMessage("Resultado - Cobertura", summary + "\n" + total);
+        });
 }
 
-// Slot: MST de Kruskal
-void MainWindow::onKruskalMSTClicked()
+// Slot: Floyd-Warshall
+void MainWindow::onFloydClicked()
 {
     if (ui.comboOrigin->count() == 0)
     {
@@ -787,40 +1166,145 @@ void MainWindow::onKruskalMSTClicked()
         return;
     }
     
-    logGraph("Calculando MST con algoritmo de Kruskal...", "#00BFFF");
-    
-    QList<QPair<int, int>> mst = graph.kruskalMST();
+    logGraph("Ejecutando algoritmo de Floyd-Warshall...", "#00BFFF");
     
-    if (mst.isEmpty())
+    algorithmWorker->start("Floyd-Warshall", graph,
+        [](const Graph& snapshot, JobToken& token) {
+            return snapshot.floydWarshall(&token).size();
+        },
+        [this](qsizetype pairCount) {
+            logGraph(QString("Floyd-Warshall completado. %1 pares de distancias calculadas.")
+                .arg(pairCount), "green");
+            
+            statusBar()->showMessage("Floyd-Warshall ejecutado correctamente", 3000);
+            
+            // Mostrar resultados en ventana popup
+            QString resultMsg = QString("Algoritmo de Floyd-Warshall completado exitosamente.\n\n"
+                                        "Pares de distancias calculadas: %1\n\n"
+                                        "Este algoritmo calcula las distancias mas cortas\n"
+                                        "entre todos los pares de estaciones.")
+                .arg(pairCount);
+            showInfoMessage("Resultado - Floyd-Warshall", resultMsg);
+        });
+}
+
+// Mostrar las aristas de un MST calculado en segundo plano
+static QString formatMSTEdges(const QList<Edge>& mst, double& totalWeight)
+{
+    totalWeight = 0.0;
+    QString edgesStr = "Aristas del MST:\n\n";
+    for (const Edge& edge : mst)
     {
-        logGraph("Error: No se pudo calcular el MST.", "#FF6B6B");
-        return;
+        totalWeight += edge.weight;
+        edgesStr += QString("  %1  <->  %2: %3\n")
+            .arg(edge.from).arg(edge.to).arg(edge.weight, 0, 'f', 1);
     }
-    
-    double totalWeight = 0.0;
-    QString edgesStr = "Aristas del MST:\n\n";
-    logGraph("Aristas del MST (Kruskal):", "#00BFFF");
+    return edgesStr;
+}
+
+// Pesos de las aristas de un MST (sobre la copia del grafo)
+static QList<Edge> mstWithWeights(const Graph& snapshot, const QList<QPair<int, int>>& mst)
+{
+    QList<Edge> edges;
+    edges.reserve(mst.size());
     for (const auto& edge : mst)
     {
-        double weight = graph.getEdgeWeight(edge.first, edge.second);
-        totalWeight += weight;
-        logGraph(QString("  %1 <-> %2: %3")
-            .arg(edge.first).arg(edge.second).arg(weight, 0, 'f', 1), "black");
-        edgesStr += QString("  %1  <->  %2: %3\n")
-            .arg(edge.first).arg(edge.second).arg(weight, 0, 'f', 1);
+        edges.append(Edge(edge.first, edge.second, snapshot.getEdgeWeight(edge.first, edge.second)));
+    }
+    return edges;
+}
+
+// Slot: MST de Prim
+void MainWindow::onPrimMSTClicked()
+{
+    if (ui.comboOrigin->count() == 0)
+    {
+        showErrorMessage("Error", "Deben de haber estaciones y rutas primero.");
+        return;
     }
     
-    logGraph(QString("Peso total del MST: %1").arg(totalWeight, 0, 'f', 1), "green");
+    logGraph("Calculando MST con algoritmo de Prim...", "#00BFFF");
     
-    reportGenerator.generateMSTReport("reporte_mst.txt", graph);
-    statusBar()->showMessage(QString("MST (Kruskal) - Peso: %1").arg(totalWeight, 0, 'f', 1), 5000);
+    algorithmWorker->start("Prim", graph,
+        [](const Graph& snapshot, JobToken& token) {
+            return mstWithWeights(snapshot, snapshot.primMST(&token));
+        },
+        [this](const QList<Edge>& mst) {
+            if (mst.isEmpty())
+            {
+                logGraph("Error: No se pudo calcular el MST.", "#FF6B6B");
+                return;
+            }
+            
+            double totalWeight = 0.0;
+            QString edgesStr = formatMSTEdges(mst, totalWeight);
+            logGraph("Aristas del MST (Prim):", "#00BFFF");
+            for (const Edge& edge : mst)
+            {
+                logGraph(QString("  %1 <-> %2: %3")
+                    .arg(edge.from).arg(edge.to).arg(edge.weight, 0, 'f', 1), "black");
+            }
+            
+            logGraph(QString("Peso total del MST: %1").arg(totalWeight, 0, 'f', 1), "green");
+            statusBar()->showMessage(QString("MST (Prim) - Peso: %1").arg(totalWeight, 0, 'f', 1), 5000);
+            
+            // Mostrar resultados en ventana popup
+            QString resultMsg = QString("arbol de Expansion Minima (Prim)\n\n%1\nPeso total: %2\nAristas: %3")
+                .arg(edgesStr)
+                .arg(totalWeight, 0, 'f', 1)
+                .arg(mst.size());
+            showInfoMessage("Resultado - MST (Prim)", resultMsg);
+        });
+}
+
+// Slot: MST de Kruskal
+void MainWindow::onKruskalMSTClicked()
+{
+    if (ui.comboOrigin->count() == 0)
+    {
+        showErrorMessage("Error", "Deben de haber estaciones y rutas primero.");
+        return;
+    }
     
-    // Mostrar resultados en ventana popup
-    QString resultMsg = QString("arbol de Expansion Minima (Kruskal)\n\n%1\nPeso total: %2\nAristas: %3")
-        .arg(edgesStr)
-        .arg(totalWeight, 0, 'f', 1)
-        .arg(mst.size());
-    showInfoMessage("Resultado - MST (Kruskal)", resultMsg);
+    logGraph("Calculando MST con algoritmo de Kruskal...", "#00BFFF");
+    
+    algorithmWorker->start("Kruskal", graph,
+        [](const Graph& snapshot, JobToken& token) {
+            QList<Edge> mst = mstWithWeights(snapshot, snapshot.kruskalMST(&token));
+            
+            // El reporte tambien se escribe fuera del hilo de la interfaz
+            if (!token.isCancelled() && !mst.isEmpty())
+            {
+                ReportGenerator().generateMSTReport("reporte_mst.txt", snapshot);
+            }
+            return mst;
+        },
+        [this](const QList<Edge>& mst) {
+            if (mst.isEmpty())
+            {
+                logGraph("Error: No se pudo calcular el MST.", "#FF6B6B");
+                return;
+            }
+            
+            double totalWeight = 0.0;
+            QString edgesStr = formatMSTEdges(mst, totalWeight);
+            logGraph("Aristas del MST (Kruskal):", "#00BFFF");
+            for (const Edge& edge : mst)
+            {
+                logGraph(QString("  %1 <-> %2: %3")
+                    .arg(edge.from).arg(edge.to).arg(edge.weight, 0, 'f', 1), "black");
+            }
+            
+            logGraph(QString("Peso total del MST: %1").arg(totalWeight, 0, 'f', 1), "green");
+            statusBar()->showMessage(QString("MST (Kruskal) - Peso: %1").arg(totalWeight, 0, 'f', 1), 5000);
+            
+            // Mostrar resultados en ventana popup
+            QString resultMsg = QString("arbol de Expansion Minima (Kruskal)\n\n%1\nPeso total: %2\nAristas: %3")
+                .arg(edgesStr)
+                .arg(totalWeight, 0, 'f', 1)
+                .arg(mst.size());
+            showInfoMessage("Resultado - MST (Kruskal)", resultMsg);
+        });
 }
 
 // Slot: BFS
@@ -836,24 +1320,28 @@ void MainWindow::onBFSClicked()
     
     logGraph(QString("Ejecutando BFS desde estacion %1...").arg(origin), "#00BFFF");
     
-    QList<int> bfsResult = graph.bfs(origin);
-    
-    QString result = "BFS: ";
-    for (int i = 0; i < bfsResult.size(); i++)
-    {
-        result += QString::number(bfsResult[i]);
-        if (i < bfsResult.size() - 1) result += " -> ";
-    }
-    
-    logGraph(result, "green");
-    statusBar()->showMessage(QString("BFS: %1 estaciones alcanzadas").arg(bfsResult.size()), 3000);
-    
-    // Mostrar resultados en ventana popup
-    QString resultMsg = QString("Recorrido en Anchura (BFS)\n\nOrigen: Estacion %1\n\n%2\n\nEstaciones alcanzadas: %3")
-        .arg(origin)
-        .arg(result)
-        .arg(bfsResult.size());
-    showInfoMessage("Resultado - BFS", resultMsg);
+    algorithmWorker->start("BFS", graph,
+        [origin](const Graph& snapshot, JobToken& token) {
+            return snapshot.bfs(origin, &token);
+        },
+        [this, origin](const QList<int>& bfsResult) {
+            QString result = "BFS: ";
+            for (int i = 0; i < bfsResult.size(); i++)
+            {
+                result += QString::number(bfsResult[i]);
+                if (i < bfsResult.size() - 1) result += " -> ";
+            }
+            
+            logGraph(result, "green");
+            statusBar()->showMessage(QString("BFS: %1 estaciones alcanzadas").arg(bfsResult.size()), 3000);
+            
+            // Mostrar resultados en ventana popup
+            QString resultMsg = QString("Recorrido en Anchura (BFS)\n\nOrigen: Estacion %1\n\n%2\n\nEstaciones alcanzadas: %3")
+                .arg(origin)
+                .arg(result)
+                .arg(bfsResult.size());
+            showInfoMessage("Resultado - BFS", resultMsg);
+        });
 }
 
 // Slot: DFS
@@ -869,24 +1357,77 @@ void MainWindow::onDFSClicked()
     
     logGraph(QString("Ejecutando DFS desde estacion %1...").arg(origin), "#00BFFF");
     
-    QList<int> dfsResult = graph.dfs(origin);
+    algorithmWorker->start("DFS", graph,
+        [origin](const Graph& snapshot, JobToken& token) {
+            return snapshot.dfs(origin, &token);
+        },
+        [this, origin](const QList<int>& dfsResult) {
+            QString result = "DFS: ";
+            for (int i = 0; i < dfsResult.size(); i++)
+            {
+                result += QString::number(dfsResult[i]);
+                if (i < dfsResult.size() - 1) result += " -> ";
+            }
+            
+            logGraph(result, "green");
+            statusBar()->showMessage(QString("DFS: %1 estaciones alcanzadas").arg(dfsResult.size()), 3000);
+            
+            // Mostrar resultados en ventana popup
+            QString resultMsg = QString("Recorrido en Profundidad (DFS)\n\nOrigen: Estacion %1\n\n%2\n\nEstaciones alcanzadas: %3")
+                .arg(origin)
+                .arg(result)
+                .arg(dfsResult.size());
+            showInfoMessage("Resultado - DFS", resultMsg);
+        });
+}
+
+// Slot: tarea en segundo plano iniciada
+void MainWindow::onJobStarted(int jobId, const QString& name)
+{
+    latestJobId = jobId;
     
-    QString result = "DFS: ";
-    for (int i = 0; i < dfsResult.size(); i++)
+    jobProgressBar->setValue(0);
+    jobProgressBar->setFormat(QString("%1 %p%").arg(name));
+    jobProgressBar->show();
+    cancelJobsButton->show();
+}
+
+// Slot: progreso de una tarea
+void MainWindow::onJobProgress(int jobId, int percent)
+{
+    // Solo la tarea mas reciente se refleja en la barra
+    if (jobId == latestJobId)
     {
-        result += QString::number(dfsResult[i]);
-        if (i < dfsResult.size() - 1) result += " -> ";
+        jobProgressBar->setValue(percent);
     }
+}
+
+// Slot: tarea terminada o cancelada
+void MainWindow::onJobFinished(int jobId, const QString& name, bool cancelled, qint64 elapsedMs)
+{
+    Q_UNUSED(jobId);
     
-    logGraph(result, "green");
-    statusBar()->showMessage(QString("DFS: %1 estaciones alcanzadas").arg(dfsResult.size()), 3000);
+    if (cancelled)
+    {
+        logGraph(QString("%1 cancelado.").arg(name), "orange");
+    }
+    else
+    {
+        logGraph(QString("%1 completado en %2 ms.").arg(name).arg(elapsedMs), "#00BFFF");
+    }
     
-    // Mostrar resultados en ventana popup
-    QString resultMsg = QString("Recorrido en Profundidad (DFS)\n\nOrigen: Estacion %1\n\n%2\n\nEstaciones alcanzadas: %3")
-        .arg(origin)
-        .arg(result)
-        .arg(dfsResult.size());
-    showInfoMessage("Resultado - DFS", resultMsg);
+    if (algorithmWorker->runningCount() == 0)
+    {
+        jobProgressBar->hide();
+        cancelJobsButton->hide();
+    }
+}
+
+// Slot: Cancelar tareas en segundo plano
+void MainWindow::onCancelJobsClicked()
+{
+    algorithmWorker->cancelAll();
+    statusBar()->showMessage("Cancelando calculo en curso...", 2000);
 }
 
 // Slot: Dibujar Grafo
@@ -940,10 +1481,10 @@ void MainWindow::onCloseStationClicked()
     
     logGraph(QString(" Estacion cerrada manualmente: %1").arg(stationName), "orange");
     
-    // Redibujar para mostrar cierre
+    // Mostrar cierre (solo la estacion afectada)
     if (visualizer)
     {
-        visualizer->drawGraph();
+        visualizer->updateStation(stationId);
     }
     
     statusBar()->showMessage(QString("Estacion %1 cerrada").arg(stationId), 3000);
@@ -1000,10 +1541,10 @@ void MainWindow::onCloseRouteClicked()
     
     logGraph(QString(" Ruta cerrada manualmente: %1  <->  %2").arg(origin).arg(dest), "orange");
     
-    // Redibujar para mostrar cierre
+    // Mostrar cierre (solo la ruta afectada)
     if (visualizer)
     {
-        visualizer->drawGraph();
+        visualizer->updateRoute(origin, dest);
     }
     
     statusBar()->showMessage(QString("Ruta %1-%2 cerrada").arg(origin).arg(dest), 3000);
@@ -1053,10 +1594,10 @@ void MainWindow::onApplyClosuresClicked()
                 .arg(affectedRoutes), "#FFD700");
         }
         
-        // Redibujar grafo para mostrar cierres y accidentes visualmente
+        // Actualizar estilos para mostrar cierres y accidentes visualmente
         if (visualizer)
         {
-            visualizer->drawGraph();
+            visualizer->refresh();
         }
         
         QString statusMsg = QString("Aplicados: %1 estaciones cerradas, %2 rutas cerradas, %3 accidentes")
@@ -1115,10 +1656,10 @@ void MainWindow::onClearClosuresClicked()
     
     logGraph(" Todos los cierres han sido eliminados.", "green");
     
-    // Redibujar grafo para mostrar todas las rutas y estaciones activas nuevamente
+    // Actualizar estilos para mostrar todas las rutas y estaciones activas nuevamente
     if (visualizer)
     {
-        visualizer->drawGraph();
+        visualizer->refresh();
     }
     
     statusBar()->showMessage("Cierres eliminados - Estaciones y rutas reactivadas", 3000);
@@ -1138,32 +1679,73 @@ void MainWindow::onActionCargarDatos()
     logGraph("Cargando datos del sistema...", "#00BFFF");
     statusBar()->showMessage("Cargando datos...");
     
+    // Lo que se carga de disco no se anota en el diario
+    journal.commit();
+    journal.setRecording(false);
+    
+    if (!journal.isOpen())
+    {
+        // El diario y lo que compacta quedan junto a los datos cargados, no en el directorio actual
+        journal.open(fileManager.siblingPath("data/datos/estaciones.txt", "eventos.journal"));
+        journalClosuresFile = fileManager.siblingPath("data/datos/estaciones.txt", "cierres.txt");
+        journalAccidentsFile = fileManager.siblingPath("data/datos/estaciones.txt", "accidentes.txt");
+    }
+    
     // Limpiar datos existentes
     graph.clear();
     bst.clear();
     
-    // Cargar estaciones
-    bool stationsLoaded = fileManager.loadStations("data/datos/estaciones.txt", bst, graph);
+    // Usar la instantanea binaria si no es anterior a los archivos de texto
+    QString snapshotFile = fileManager.snapshotPathFor("data/datos/estaciones.txt");
+    QStringList sourceFiles = { "data/datos/estaciones.txt", "data/datos/rutas.txt",
+                                "data/datos/cierres.txt", "data/datos/accidentes.txt" };
+    bool snapshotLoaded = false;
     
-    if (!stationsLoaded)
+    if (fileManager.isSnapshotCurrent(snapshotFile, sourceFiles))
     {
-        QString error = fileManager.getLastError();
-        if (error.isEmpty())
+        snapshotLoaded = fileManager.loadSnapshot(snapshotFile, bst, graph);
+        
+        if (snapshotLoaded)
         {
-            error = "No se pudo cargar el archivo data/datos/estaciones.txt. Verifique que exista.";
+            logGraph(QString("Red cargada desde la instantanea %1").arg(snapshotFile), "#00BFFF");
+        }
+        else
+        {
+            logGraph(QString("Advertencia: %1. Se usaran los archivos de texto.").arg(fileManager.getLastError()), "orange");
+            graph.clear();
+            bst.clear();
         }
-        logBST(QString("Error: %1").arg(error), "#FF6B6B");
-        logGraph(QString("Error: %1").arg(error), "#FF6B6B");
-        showErrorMessage("Error de Carga", error);
-        statusBar()->showMessage("Error al cargar datos");
-        return;
     }
     
-    // Cargar rutas
-    bool routesLoaded = fileManager.loadRoutes("data/datos/rutas.txt", graph);
+    bool routesLoaded = true;
+    
+    if (!snapshotLoaded)
+    {
+        // Cargar estaciones
+        bool stationsLoaded = fileManager.loadStations("data/datos/estaciones.txt", bst, graph);
+        
+        if (!stationsLoaded)
+        {
+            QString error = fileManager.getLastError();
+            if (error.isEmpty())
+            {
+                error = "No se pudo cargar el archivo data/datos/estaciones.txt. Verifique que exista.";
+            }
+            logBST(QString("Error: %1").arg(error), "#FF6B6B");
+            logGraph(QString("Error: %1").arg(error), "#FF6B6B");
+            showErrorMessage("Error de Carga", error);
+            statusBar()->showMessage("Error al cargar datos");
+            journal.setRecording(true);
+            return;
+        }
+        
+        // Cargar rutas
+        routesLoaded = fileManager.loadRoutes("data/datos/rutas.txt", graph);
+    }
     
     dataLoaded = true;
     updateComboBoxes();
+    nameIndex.build(graph);
     
     logBST(QString("Datos cargados: %1 estaciones.").arg(bst.count()), "green");
     if (graph.getStationCount() == 0)
@@ -1178,15 +1760,13 @@ void MainWindow::onActionCargarDatos()
     // Contar rutas unicas cargadas evitar duplicados en grafo no dirigido
     QSet<QPair<int, int>> countedEdges;
     int routeCount = 0;
-    QList<Station> loadedStations = graph.getAllStations();
-    for (const Station& station : loadedStations)
+    for (int fromIndex : graph.getStationTable().indices())
     {
-        int fromId = station.getId();
-        QList<QPair<int, double>> neighbors = graph.getNeighbors(fromId);
+        const QList<QPair<int, double>>& neighbors = graph.neighborsAt(fromIndex);
         for (const auto& neighbor : neighbors)
         {
-            int toId = neighbor.first;
-            QPair<int, int> edgeKey(std::min(fromId, toId), std::max(fromId, toId));
+            int toIndex = neighbor.first;
+            QPair<int, int> edgeKey(std::min(fromIndex, toIndex), std::max(fromIndex, toIndex));
             if (!countedEdges.contains(edgeKey))
             {
                 countedEdges.insert(edgeKey);
@@ -1215,7 +1795,7 @@ void MainWindow::onActionCargarDatos()
     
     // Cargar cierres automatically if file exists
     bool closuresLoaded = false;
-    if (fileManager.fileExists("data/datos/cierres.txt"))
+    if (!snapshotLoaded && fileManager.fileExists("data/datos/cierres.txt"))
     {
         closuresLoaded = fileManager.loadClosures("data/datos/cierres.txt", graph);
         
@@ -1236,7 +1816,7 @@ void MainWindow::onActionCargarDatos()
     
     // Cargar accidentes automatically if file exists
     bool accidentsLoaded = false;
-    if (fileManager.fileExists("data/datos/accidentes.txt"))
+    if (!snapshotLoaded && fileManager.fileExists("data/datos/accidentes.txt"))
     {
         accidentsLoaded = fileManager.loadAccidents(graph, "data/datos/accidentes.txt");
         
@@ -1252,6 +1832,24 @@ void MainWindow::onActionCargarDatos()
         }
     }
     
+    // Guardar la instantanea para que el proximo arranque no tenga que analizar el texto
+    if (!snapshotLoaded && graph.getStationCount() > 0)
+    {
+        fileManager.saveSnapshot(snapshotFile, graph);
+    }
+    
+    // Recuperar los eventos que no llegaron a compactarse (cierre inesperado)
+    int recovered = journal.replay(graph);
+    if (recovered > 0)
+    {
+        logGraph(QString("Recuperados %1 eventos del diario %2").arg(recovered).arg(journal.getPath()), "#FFD700");
+    }
+    else if (recovered < 0)
+    {
+        logGraph(QString("Advertencia: %1").arg(journal.getLastError()), "orange");
+    }
+    journal.setRecording(true);
+    
     logGraph("Presiona 'Dibujar Grafo' para visualizar la red.", "orange");
     
     statusBar()->showMessage("Datos cargados correctamente", 3000);
@@ -1282,6 +1880,51 @@ void MainWindow::onActionCargarDatos()
         .arg(closureInfo));
 }
 
+// Accion del Menu: Recargar Cambios (aplica solo lo que cambio en estaciones y rutas)
+void MainWindow::onActionRecargarCambios()
+{
+    if (!dataLoaded)
+    {
+        onActionCargarDatos();
+        return;
+    }
+    
+    DeltaSummary summary;
+    if (!fileManager.reloadChanged("data/datos/estaciones.txt", "data/datos/rutas.txt", bst, graph, summary))
+    {
+        logGraph(QString("Advertencia: %1 Se hara una carga completa.").arg(fileManager.getLastError()), "orange");
+        onActionCargarDatos();
+        return;
+    }
+    
+    if (!summary.hasChanges())
+    {
+        logGraph("Recarga: sin cambios en los archivos de datos.", "white");
+        statusBar()->showMessage("Sin cambios en los archivos de datos", 3000);
+        return;
+    }
+    
+    // Las rutas no cambian los combos ni el indice de nombres
+    if (summary.stationsAdded + summary.stationsUpdated + summary.stationsRemoved > 0)
+    {
+        updateComboBoxes();
+        nameIndex.build(graph);
+    }
+    
+    // Redibujar si el grafo estaba en pantalla (cierres y accidentes se conservan)
+    if (visualizer && visualizer->isGraphDrawn())
+    {
+        visualizer->refresh();
+    }
+    
+    QString message = QString("Recarga incremental: estaciones +%1 ~%2 -%3, rutas +%4 ~%5 -%6")
+        .arg(summary.stationsAdded).arg(summary.stationsUpdated).arg(summary.stationsRemoved)
+        .arg(summary.routesAdded).arg(summary.routesReweighted).arg(summary.routesRemoved);
+    logBST(QString("Estaciones en el arbol: %1").arg(bst.count()), "green");
+    logGraph(message, "green");
+    statusBar()->showMessage(message, 5000);
+}
+
 // Accion del Menu: Guardar Datos
 void MainWindow::onActionGuardarDatos()
 {
@@ -1315,6 +1958,19 @@ void MainWindow::onActionGuardarDatos()
     bool accidentsSaved = fileManager.saveAccidents("data/datos/accidentes.txt", graph);
     QString accidentError = accidentsSaved ? QString() : fileManager.getLastError();
     
+    // Cierres y accidentes ya estan en disco: el diario puede vaciarse si son los archivos junto a el
+    if (closuresSaved && accidentsSaved &&
+        QFileInfo("data/datos/cierres.txt").absoluteFilePath() == QFileInfo(journalClosuresFile).absoluteFilePath())
+    {
+        journal.truncate();
+    }
+    
+    // La instantanea binaria se escribe despues, para que no quede mas antigua que el texto
+    if (!fileManager.saveSnapshot("data/datos/red.upsnap", graph))
+    {
+        logGraph(QString("Advertencia: %1").arg(fileManager.getLastError()), "orange");
+    }
+    
     if (stationsSaved && routesSaved && closuresSaved && accidentsSaved)
     {
         logBST("Estaciones guardadas en data/datos/estaciones.txt", "green");
@@ -1424,20 +2080,56 @@ void MainWindow::onActionGenerarReportes()
         dir.mkpath("data/reportes");
     }
     
-    logGraph("Generando reportes del sistema...", "#00BFFF");
-    statusBar()->showMessage("Generando reportes...");
+    // Formatos para otros programas, ademas del texto
+    QList<ReportGenerator::OutputFormat> formats = { ReportGenerator::Text };
+    if (ui.actionFormatoJsonl->isChecked())
+    {
+        formats.append(ReportGenerator::JsonLines);
+    }
+    if (ui.actionFormatoCsv->isChecked())
+    {
+        formats.append(ReportGenerator::Csv);
+    }
+    if (ui.actionFormatoColumnar->isChecked())
+    {
+        formats.append(ReportGenerator::Columnar);
+    }
+    reportPipeline.setOutputFormats(formats);
     
-    bool statsReport = reportGenerator.generateSystemStats("data/reportes/reporte_estadisticas.txt", graph, bst);
-    bool mstReport = reportGenerator.generateMSTReport("data/reportes/reporte_mst.txt", graph);
-    bool connectivityReport = reportGenerator.generateConnectivityReport("data/reportes/reporte_conectividad.txt", graph);
-    bool traversalReport = reportGenerator.generateTraversalReport("data/reportes/reporte_recorridos.txt", bst);
-    bool accidentReport = reportGenerator.generateAccidentReport("data/reportes/reporte_accidentes.txt", graph);
+    // Los reportes se generan en segundo plano; la ventana sigue respondiendo
+    bool started = reportPipeline.start(graph, bst, "data/reportes", this,
+        [this](int done, int total, const QString& filename, bool ok, const QString& error) {
+            if (ok)
+            {
+                logGraph(QString("Reporte generado: %1").arg(filename), "white");
+            }
+            else
+            {
+                logGraph(QString("Error en %1: %2").arg(filename).arg(error), "#FF6B6B");
+            }
+            statusBar()->showMessage(QString("Generando reportes... (%1/%2)").arg(done).arg(total));
+        },
+        [this](int succeeded, int total) {
+            ui.actionGenerarReportes->setEnabled(true);
+            onReportsFinished(succeeded, total);
+        });
     
-    int successCount = (statsReport ? 1 : 0) + (mstReport ? 1 : 0) + 
-                       (connectivityReport ? 1 : 0) + (traversalReport ? 1 : 0) +
-                       (accidentReport ? 1 : 0);
+    if (!started)
+    {
+        statusBar()->showMessage("Ya se estan generando reportes", 3000);
+        return;
+    }
     
-    logGraph(QString("Reportes generados exitosamente en data/reportes/ (%1/5).").arg(successCount), "green");
+    ui.actionGenerarReportes->setEnabled(false);
+    logGraph("Generando reportes del sistema...", "#00BFFF");
+    statusBar()->showMessage("Generando reportes...");
+}
+
+// Reportes terminados: resumen y opcion de abrir la carpeta
+void MainWindow::onReportsFinished(int successCount, int total)
+{
+    logGraph(QString("Reportes generados exitosamente en data/reportes/ (%1/%2).").arg(successCount).arg(total),
+             successCount == total ? "green" : "orange");
     statusBar()->showMessage("Reportes generados en data/reportes/", 3000);
     
     // Obtener ruta absoluta
@@ -1448,12 +2140,8 @@ void MainWindow::onActionGenerarReportes()
     msgBox.setWindowTitle("Reportes Generados");
     msgBox.setIcon(QMessageBox::Information);
     msgBox.setText(QString("Se han generado %1 reportes del sistema:\n\n"
-                "• reporte_estadisticas.txt\n"
-                "• reporte_mst.txt\n"
-                "• reporte_conectividad.txt\n"
-                "• reporte_recorridos.txt\n"
-                "• reporte_accidentes.txt\n\n"
-                "Ruta completa:\n%2").arg(successCount).arg(absolutePath));
+                "• %2\n\n"
+                "Ruta completa:\n%3").arg(successCount).arg(ReportPipeline::reportNames().join("\n• ")).arg(absolutePath));
     
     QPushButton* openFolderBtn = msgBox.addButton("Abrir Carpeta", QMessageBox::ActionRole);
     msgBox.addButton("Cerrar", QMessageBox::AcceptRole);
@@ -1580,6 +2268,65 @@ void MainWindow::onActionAcercaDe()
     aboutDialog.exec();
 }
 
+// Mostrar las metricas de los algoritmos
+void MainWindow::onMetricsClicked()
+{
+    QDialog metricsDialog(this);
+    metricsDialog.setWindowTitle("Metricas de algoritmos");
+    metricsDialog.setMinimumSize(700, 300);
+    metricsDialog.resize(1100, 400);
+    
+    QVBoxLayout* layout = new QVBoxLayout(&metricsDialog);
+    
+    // Tabla en fuente de ancho fijo para que las columnas queden alineadas
+    QTextEdit* textEdit = new QTextEdit(&metricsDialog);
+    textEdit->setReadOnly(true);
+    textEdit->setLineWrapMode(QTextEdit::NoWrap);
+    textEdit->setFont(QFontDatabase::systemFont(QFontDatabase::FixedFont));
+    textEdit->setPlainText(Metrics::formatTable(Metrics::snapshot()));
+    
+    // Reiniciar los contadores o cerrar
+    QPushButton* resetButton = new QPushButton("Reiniciar", &metricsDialog);
+    connect(resetButton, &QPushButton::clicked, textEdit, [textEdit]() {
+        Metrics::reset();
+        textEdit->setPlainText(Metrics::formatTable(Metrics::snapshot()));
+    });
+    
+    // Memoria y tiempo de pintado de las rutas: un solo item por lotes contra un item por ruta
+    QPushButton* compareButton = new QPushButton("Comparar lineas", &metricsDialog);
+    compareButton->setToolTip("Dibuja el grafo de las dos formas y mide memoria y tiempo de pintado de las rutas");
+    connect(compareButton, &QPushButton::clicked, textEdit, [this, textEdit]() {
+        EdgeModeComparison comparison;
+        if (!visualizer || !visualizer->compareEdgeModes(comparison))
+        {
+            textEdit->append("\nDibuje el grafo antes de comparar las lineas de las rutas.");
+            return;
+        }
+        
+        textEdit->append(QString("\nLineas de rutas (%1 rutas dibujadas):").arg(comparison.routes));
+        textEdit->append(QString("  Item por lotes:  %1 KB, pintado %2 ms")
+            .arg(comparison.batchBytes / 1024.0, 0, 'f', 1).arg(comparison.batchPaintNs / 1e6, 0, 'f', 3));
+        textEdit->append(QString("  Item por ruta:   %1 KB, pintado %2 ms")
+            .arg(comparison.itemBytes / 1024.0, 0, 'f', 1).arg(comparison.itemPaintNs / 1e6, 0, 'f', 3));
+    });
+    
+    QPushButton* okButton = new QPushButton("Cerrar", &metricsDialog);
+    okButton->setDefault(true);
+    connect(okButton, &QPushButton::clicked, &metricsDialog, &QDialog::accept);
+    
+    QHBoxLayout* buttons = new QHBoxLayout();
+    buttons->addStretch();
+    buttons->addWidget(compareButton);
+    buttons->addWidget(resetButton);
+    buttons->addWidget(okButton);
+    
+    // Agregar widgets al layout
+    layout->addWidget(textEdit);
+    layout->addLayout(buttons);
+    
+    metricsDialog.exec();
+}
+
 // Configurar conexiones signal/slot
 void MainWindow::setupConnections()
 {
@@ -1597,6 +2344,8 @@ void MainWindow::setupConnections()
     connect(ui.btnAddRoute, &QPushButton::clicked, this, &MainWindow::onAddRouteClicked);
     connect(ui.btnRemoveRoute, &QPushButton::clicked, this, &MainWindow::onRemoveRouteClicked);
     connect(ui.btnShortestPath, &QPushButton::clicked, this, &MainWindow::onShortestPathClicked);
+    connect(ui.btnAlternativeRoutes, &QPushButton::clicked, this, &MainWindow::onAlternativeRoutesClicked);
+    connect(ui.btnCoverage, &QPushButton::clicked, this, &MainWindow::onCoverageClicked);
     connect(ui.btnFloyd, &QPushButton::clicked, this, &MainWindow::onFloydClicked);
     connect(ui.btnPrimMST, &QPushButton::clicked, this, &MainWindow::onPrimMSTClicked);
     connect(ui.btnKruskalMST, &QPushButton::clicked, this, &MainWindow::onKruskalMSTClicked);
@@ -1625,6 +2374,7 @@ void MainWindow::setupConnections()
     
     // Conexiones de acciones del menu
     connect(ui.actionCargarDatos, &QAction::triggered, this, &MainWindow::onActionCargarDatos);
+    connect(ui.actionRecargarCambios, &QAction::triggered, this, &MainWindow::onActionRecargarCambios);
     connect(ui.actionGuardarDatos, &QAction::triggered, this, &MainWindow::onActionGuardarDatos);
     connect(ui.actionSalir, &QAction::triggered, this, &MainWindow::onActionSalir);
     connect(ui.actionGenerarReportes, &QAction::triggered, this, &MainWindow::onActionGenerarReportes);
@@ -1677,10 +2427,11 @@ void MainWindow::onAddAccidentClicked()
     }
     
     // Get station names for confirmation
-    Station* originStation = graph.getStation(originId);
-    Station* destStation = graph.getStation(destId);
-    QString originName = originStation ? originStation->getName() : QString::number(originId);
-    QString destName = destStation ? destStation->getName() : QString::number(destId);
+    const StationTable& table = graph.getStationTable();
+    int originIndex = table.indexOf(originId);
+    int destIndex = table.indexOf(destId);
+    QString originName = (originIndex != StationTable::InvalidIndex) ? table.nameAt(originIndex) : QString::number(originId);
+    QString destName = (destIndex != StationTable::InvalidIndex) ? table.nameAt(destIndex) : QString::number(destId);
     
     double currentWeight = graph.getEdgeWeight(originId, destId);
     double newWeight = currentWeight + (currentWeight * (increment / 100.0));
@@ -1717,7 +2468,7 @@ void MainWindow::onAddAccidentClicked()
         // Redraw graph if visible
         if (visualizer->isGraphDrawn())
         {
-            visualizer->drawGraph();
+            visualizer->updateRoute(originId, destId);
             logGraph("[INFO] Grafo redibujado con peso actualizado", "#00CC88");
         }
         
@@ -1772,7 +2523,7 @@ void MainWindow::onClearAccidentsClicked()
     // Redraw graph to show changes (if already drawn)
     if (visualizer->isGraphDrawn())
     {
-        visualizer->drawGraph();
+        visualizer->refresh();
         logGraph("[INFO] Grafo redibujado con pesos originales", "#00CC88");
     }
     
@@ -4,12 +4,26 @@
 #include <QMessageBox>
 #include <QFileDialog>
 #include <QInputDialog>
+#include <QComboBox>
+#include <QCompleter>
+#include <QStringListModel>
 #include "ui_MainWindow.h"
 #include "Graph.h"
 #include "StationBST.h"
 #include "FileManager.h"
 #include "ReportGenerator.h"
 #include "GraphVisualizer.h"
+#include "StationNameIndex.h"
+#include "EventJournal.h"
+#include "ReportPipeline.h"
+#include "AlgorithmWorker.h"
+#include "ShortestPathCache.h"
+#include "KShortestPaths.h"
+#include "Isochrone.h"
+
+class QTimer;
+class QProgressBar;
+class QPushButton;
 
 using namespace std;
 
@@ -39,6 +53,8 @@ private slots:
     void onAddRouteClicked();
     void onRemoveRouteClicked();
     void onShortestPathClicked();
+    void onAlternativeRoutesClicked();
+    void onCoverageClicked();
     void onFloydClicked();
     void onPrimMSTClicked();
     void onKruskalMSTClicked();
@@ -59,11 +75,19 @@ private slots:
     
     // Menu action slots
     void onActionCargarDatos();
+    void onActionRecargarCambios();
     void onActionGuardarDatos();
     void onActionSalir();
     void onActionGenerarReportes();
     void onActionVerUltimoReporte();
     void onActionAcercaDe();
+    
+    // Background algorithm slots
+    void onJobStarted(int jobId, const QString& name);
+    void onJobProgress(int jobId, int percent);
+    void onJobFinished(int jobId, const QString& name, bool cancelled, qint64 elapsedMs);
+    void onCancelJobsClicked();
+    void onMetricsClicked();
 
 private:
     Ui::MainWindowClass ui;
@@ -73,21 +97,43 @@ private:
     StationBST bst;
     FileManager fileManager;
     ReportGenerator reportGenerator;
+    ReportPipeline reportPipeline;
     GraphVisualizer* visualizer;
     QGraphicsScene* scene;
+    StationNameIndex nameIndex;
+    EventJournal journal;
+    QTimer* journalTimer;
+    QString journalClosuresFile;    // Compaction targets, next to the journal
+    QString journalAccidentsFile;
+    AlgorithmWorker* algorithmWorker;
+    ShortestPathCache pathCache;
+    QProgressBar* jobProgressBar;
+    QPushButton* cancelJobsButton;
+    QPushButton* metricsButton;
     
     // Helper methods
     void setupConnections();
     void loadBackgroundImage();
     void updateComboBoxes();
+    void addStationToCombos(int id);
+    void removeStationFromCombos(int id);
+    void selectComboStation(QComboBox* combo, int id);
+    QList<QComboBox*> stationCombos() const;
+    void setupStationCompleters();
+    void updateStationSuggestions(QComboBox* combo, QStringListModel* model, const QString& text);
     void logBST(const QString& message, const QString& color = "black");
     void logGraph(const QString& message, const QString& color = "black");
     void showInfoMessage(const QString& title, const QString& message);
     void showErrorMessage(const QString& title, const QString& message);
     bool confirmAction(const QString& title, const QString& message);
     void applyDarkTheme();
+    void onReportsFinished(int successCount, int total);
+    void showShortestPath(const QList<int>& route, double distance);
     
     // Data loaded flag
     bool dataLoaded;
+    
+    // Job shown in the progress bar (the last one started)
+    int latestJobId;
 };
 
@@ -0,0 +1,290 @@
+#include "Metrics.h"
+#include <QMutex>
+#include <QMutexLocker>
+#include <QList>
+#include <QStringList>
+#include <QTextStream>
+#include <atomic>
+
+namespace
+{
+
+// Counters of one thread. Only that thread adds to them; readers take relaxed
+// loads, so a snapshot may miss a call in progress but never sees a torn value.
+struct ThreadBlock
+{
+    atomic<qint64> calls[Metrics::ScopeCount];
+    atomic<qint64> totalNs[Metrics::ScopeCount];
+    atomic<qint64> maxNs[Metrics::ScopeCount];
+    atomic<qint64> counters[Metrics::ScopeCount][Metrics::CounterCount];
+
+    ThreadBlock()
+    {
+        clear();
+    }
+
+    void clear()
+    {
+        for (int s = 0; s < Metrics::ScopeCount; s++)
+        {
+            calls[s].store(0, memory_order_relaxed);
+            totalNs[s].store(0, memory_order_relaxed);
+            maxNs[s].store(0, memory_order_relaxed);
+            for (int c = 0; c < Metrics::CounterCount; c++)
+            {
+                counters[s][c].store(0, memory_order_relaxed);
+            }
+        }
+    }
+
+    void addTo(Metrics::Snapshot& snapshot) const
+    {
+        for (int s = 0; s < Metrics::ScopeCount; s++)
+        {
+            Metrics::ScopeStats& stats = snapshot.scopes[s];
+            stats.calls += calls[s].load(memory_order_relaxed);
+            stats.totalNs += totalNs[s].load(memory_order_relaxed);
+            stats.maxNs = qMax(stats.maxNs, maxNs[s].load(memory_order_relaxed));
+            for (int c = 0; c < Metrics::CounterCount; c++)
+            {
+                stats.counters[c] += counters[s][c].load(memory_order_relaxed);
+            }
+        }
+    }
+};
+
+// Blocks of the running threads, plus the totals of the threads that ended
+struct Registry
+{
+    QMutex mutex;
+    QList<ThreadBlock*> blocks;
+    Metrics::Snapshot retired;
+};
+
+Registry& registry()
+{
+    static Registry instance;
+    return instance;
+}
+
+// Registers the block of a thread on first use and folds it into the
+// retired totals when the thread ends (pool threads come and go)
+struct ThreadSlot
+{
+    ThreadBlock block;
+
+    ThreadSlot()
+    {
+        Registry& r = registry();
+        QMutexLocker locker(&r.mutex);
+        r.blocks.append(&block);
+    }
+
+    ~ThreadSlot()
+    {
+        Registry& r = registry();
+        QMutexLocker locker(&r.mutex);
+        block.addTo(r.retired);
+        r.blocks.removeOne(&block);
+    }
+};
+
+ThreadBlock& localBlock()
+{
+    thread_local ThreadSlot slot;
+    return slot.block;
+}
+
+const char* const ScopeNames[Metrics::ScopeCount] = {
+    "bfs", "dfs", "dijkstra", "floyd_warshall", "prim_mst", "kruskal_mst",
+    "load_stations", "load_routes", "load_closures", "load_snapshot", "reports",
+    "path_cache", "landmark_build", "landmark_query", "hub_label_build", "hub_label_query",
+    "k_shortest_paths", "isochrone"
+};
+
+const char* const CounterNames[Metrics::CounterCount] = {
+    "nodes_settled", "edges_scanned", "edges_relaxed", "heap_operations", "closure_checks",
+    "cache_hits", "cache_misses", "cache_invalidations"
+};
+
+}
+
+// Add one timed call
+void Metrics::record(Scope scope, qint64 nanoseconds)
+{
+    ThreadBlock& block = localBlock();
+    block.calls[scope].fetch_add(1, memory_order_relaxed);
+    block.totalNs[scope].fetch_add(nanoseconds, memory_order_relaxed);
+    if (nanoseconds > block.maxNs[scope].load(memory_order_relaxed))
+    {
+        block.maxNs[scope].store(nanoseconds, memory_order_relaxed);
+    }
+}
+
+// Add the counters of one call
+void Metrics::add(Scope scope, const qint64* counters)
+{
+    ThreadBlock& block = localBlock();
+    for (int c = 0; c < CounterCount; c++)
+    {
+        if (counters[c] != 0)
+        {
+            block.counters[scope][c].fetch_add(counters[c], memory_order_relaxed);
+        }
+    }
+}
+
+// Sum of all threads
+Metrics::Snapshot Metrics::snapshot()
+{
+    Registry& r = registry();
+    QMutexLocker locker(&r.mutex);
+
+    Snapshot result = r.retired;
+    for (const ThreadBlock* block : r.blocks)
+    {
+        block->addTo(result);
+    }
+    return result;
+}
+
+// Start counting again
+void Metrics::reset()
+{
+    Registry& r = registry();
+    QMutexLocker locker(&r.mutex);
+
+    r.retired = Snapshot();
+    for (ThreadBlock* block : r.blocks)
+    {
+        block->clear();
+    }
+}
+
+// Check if the probes were compiled in
+bool Metrics::isEnabled()
+{
+#ifdef URBANPATH_NO_METRICS
+    return false;
+#else
+    return true;
+#endif
+}
+
+// Get scope name
+QString Metrics::scopeName(Scope scope)
+{
+    return (scope >= 0 && scope < ScopeCount) ? QString(ScopeNames[scope]) : QString();
+}
+
+// Get counter name
+QString Metrics::counterName(Counter counter)
+{
+    return (counter >= 0 && counter < CounterCount) ? QString(CounterNames[counter]) : QString();
+}
+
+// Format as a table
+QString Metrics::formatTable(const Snapshot& snapshot)
+{
+    QString text;
+    QTextStream out(&text);
+
+    if (!isEnabled())
+    {
+        out << "Metricas desactivadas en esta compilacion (URBANPATH_NO_METRICS).\n";
+        return text;
+    }
+
+    out << QString("%1 %2 %3 %4 %5").arg("Ambito", -16).arg("Llamadas", 10).arg("Total ms", 12)
+                                    .arg("Media ms", 10).arg("Max ms", 10);
+    for (int c = 0; c < CounterCount; c++)
+    {
+        out << QString(" %1").arg(counterName(static_cast<Counter>(c)), 19);
+    }
+    out << "\n";
+
+    bool any = false;
+    for (int s = 0; s < ScopeCount; s++)
+    {
+        const ScopeStats& stats = snapshot.scopes[s];
+        if (stats.calls == 0)
+        {
+            continue;
+        }
+        any = true;
+
+        out << QString("%1 %2 %3 %4 %5").arg(scopeName(static_cast<Scope>(s)), -16).arg(stats.calls, 10)
+            .arg(stats.totalNs / 1e6, 12, 'f', 3).arg(stats.totalNs / 1e6 / stats.calls, 10, 'f', 3)
+            .arg(stats.maxNs / 1e6, 10, 'f', 3);
+        for (int c = 0; c < CounterCount; c++)
+        {
+            out << QString(" %1").arg(stats.counters[c], 19);
+        }
+        out << "\n";
+    }
+
+    if (!any)
+    {
+        out << "(sin llamadas registradas)\n";
+    }
+
+    // Hit rate of the shortest-path cache
+    qint64 hits = 0;
+    qint64 lookups = 0;
+    for (int s = 0; s < ScopeCount; s++)
+    {
+        hits += snapshot.scopes[s].counters[CacheHits];
+        lookups += snapshot.scopes[s].counters[CacheHits] + snapshot.scopes[s].counters[CacheMisses];
+    }
+    if (lookups > 0)
+    {
+        out << QString("Aciertos de cache: %1 de %2 (%3%)\n").arg(hits).arg(lookups)
+                   .arg(100.0 * hits / lookups, 0, 'f', 1);
+    }
+    return text;
+}
+
+// Format as Prometheus text
+QString Metrics::formatPrometheus(const Snapshot& snapshot)
+{
+    QString text;
+    QTextStream out(&text);
+
+    out << "# HELP urbanpath_calls_total Calls per algorithm or operation.\n";
+    out << "# TYPE urbanpath_calls_total counter\n";
+    for (int s = 0; s < ScopeCount; s++)
+    {
+        out << "urbanpath_calls_total{scope=\"" << scopeName(static_cast<Scope>(s)) << "\"} "
+            << snapshot.scopes[s].calls << "\n";
+    }
+
+    out << "# HELP urbanpath_seconds_total Time spent per algorithm or operation.\n";
+    out << "# TYPE urbanpath_seconds_total counter\n";
+    for (int s = 0; s < ScopeCount; s++)
+    {
+        out << "urbanpath_seconds_total{scope=\"" << scopeName(static_cast<Scope>(s)) << "\"} "
+            << QString::number(snapshot.scopes[s].totalNs / 1e9, 'f', 9) << "\n";
+    }
+
+    out << "# HELP urbanpath_max_seconds Longest single call.\n";
+    out << "# TYPE urbanpath_max_seconds gauge\n";
+    for (int s = 0; s < ScopeCount; s++)
+    {
+        out << "urbanpath_max_seconds{scope=\"" << scopeName(static_cast<Scope>(s)) << "\"} "
+            << QString::number(snapshot.scopes[s].maxNs / 1e9, 'f', 9) << "\n";
+    }
+
+    for (int c = 0; c < CounterCount; c++)
+    {
+        QString metric = "urbanpath_" + counterName(static_cast<Counter>(c)) + "_total";
+        out << "# TYPE " << metric << " counter\n";
+        for (int s = 0; s < ScopeCount; s++)
+        {
+            out << metric << "{scope=\"" << scopeName(static_cast<Scope>(s)) << "\"} "
+                << snapshot.scopes[s].counters[c] << "\n";
+        }
+    }
+
+    return text;
+}
+
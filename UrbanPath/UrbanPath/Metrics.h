@@ -0,0 +1,150 @@
+#pragma once
+
+#include <QString>
+#include <QElapsedTimer>
+#include <QtGlobal>
+
+using namespace std;
+
+// Hot-path instrumentation: call counts, times and work counters per algorithm.
+// Every thread adds into its own block of counters (no locks, no shared cache
+// lines on the hot path); snapshot() sums the blocks of all threads, including
+// the ones that already finished. The probes are meant for the algorithms, not
+// for their inner loops: a timer per call and a tally that keeps the counters
+// in local variables and adds them once when it goes out of scope.
+//
+//   MetricsTimer timer(Metrics::Dijkstra);
+//   MetricsTally tally(Metrics::Dijkstra);
+//   ...
+//   tally.count(Metrics::EdgesRelaxed);
+//
+// Building with URBANPATH_NO_METRICS turns both probes into empty classes,
+// so they compile away; snapshot() then stays empty.
+class Metrics
+{
+public:
+    enum Scope
+    {
+        Bfs,
+        Dfs,
+        Dijkstra,
+        FloydWarshall,
+        PrimMST,
+        KruskalMST,
+        LoadStations,
+        LoadRoutes,
+        LoadClosures,
+        LoadSnapshot,
+        Reports,
+        PathCache,
+        LandmarkBuild,
+        LandmarkQuery,
+        HubLabelBuild,
+        HubLabelQuery,
+        KShortestPaths,
+        Isochrone,
+        ScopeCount
+    };
+
+    enum Counter
+    {
+        NodesSettled,        // Stations taken out of the queue / heap (or pivots in Floyd-Warshall)
+        EdgesScanned,        // Adjacency entries looked at
+        EdgesRelaxed,        // Entries that improved a distance or joined the tree
+        HeapOperations,      // Pushes and pops of the priority queue
+        ClosureChecks,       // Lookups in the closed-route set (only made while routes are closed)
+        CacheHits,           // Queries answered from a cache
+        CacheMisses,         // Queries the cache could not answer
+        CacheInvalidations,  // Cached results dropped because the network changed
+        CounterCount
+    };
+
+    struct ScopeStats
+    {
+        qint64 calls = 0;
+        qint64 totalNs = 0;
+        qint64 maxNs = 0;
+        qint64 counters[CounterCount] = {};
+    };
+
+    struct Snapshot
+    {
+        ScopeStats scopes[ScopeCount];
+    };
+
+    // Add one call (timers) or the counters of one call (tallies)
+    static void record(Scope scope, qint64 nanoseconds);
+    static void add(Scope scope, const qint64* counters);
+
+    // Totals of all threads since the start (or the last reset)
+    static Snapshot snapshot();
+    static void reset();
+
+    // False when built with URBANPATH_NO_METRICS
+    static bool isEnabled();
+
+    // Names used in tables and in the Prometheus text ("dijkstra", "edges_relaxed")
+    static QString scopeName(Scope scope);
+    static QString counterName(Counter counter);
+
+    // Table for people (scopes that were never called are left out; cache hit rate at the end)
+    static QString formatTable(const Snapshot& snapshot);
+
+    // Prometheus text exposition format
+    static QString formatPrometheus(const Snapshot& snapshot);
+
+    // Times the enclosing block
+    class ScopedTimer
+    {
+    public:
+        explicit ScopedTimer(Scope scope) : scope(scope) { timer.start(); }
+        ~ScopedTimer() { record(scope, timer.nsecsElapsed()); }
+
+        ScopedTimer(const ScopedTimer&) = delete;
+        ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+    private:
+        Scope scope;
+        QElapsedTimer timer;
+    };
+
+    // Counts work in local variables and adds it on destruction
+    class Tally
+    {
+    public:
+        explicit Tally(Scope scope) : scope(scope) {}
+        ~Tally() { add(scope, values); }
+
+        void count(Counter counter, qint64 amount = 1) { values[counter] += amount; }
+
+        Tally(const Tally&) = delete;
+        Tally& operator=(const Tally&) = delete;
+
+    private:
+        Scope scope;
+        qint64 values[CounterCount] = {};
+    };
+
+    // Same interface, no code (URBANPATH_NO_METRICS)
+    class NullTimer
+    {
+    public:
+        explicit NullTimer(Scope) {}
+    };
+
+    class NullTally
+    {
+    public:
+        explicit NullTally(Scope) {}
+        void count(Counter, qint64 = 1) {}
+    };
+};
+
+#ifdef URBANPATH_NO_METRICS
+using MetricsTimer = Metrics::NullTimer;
+using MetricsTally = Metrics::NullTally;
+#else
+using MetricsTimer = Metrics::ScopedTimer;
+using MetricsTally = Metrics::Tally;
+#endif
+
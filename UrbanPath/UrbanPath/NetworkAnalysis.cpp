@@ -0,0 +1,340 @@
+#include "NetworkAnalysis.h"
+#include "StationBST.h"
+#include "DisjointSet.h"
+
+// Constructor
+NetworkAnalysis::NetworkAnalysis(const Graph& graph)
+    : network(graph), computedParts(0), kruskalWeight(0.0), primWeight(0.0),
+      totalRoutes(0), minDegree(0), maxDegree(0), componentCount(0), largestComponent(0),
+      reachabilityStart(-1), traversalsCaptured(false), bstCount(0)
+{
+    // The copy only reads; it must not report changes to the original's listener
+    network.setChangeListener(nullptr);
+    stationIndices = network.getStationTable().indices();
+}
+
+// Store BST traversals
+void NetworkAnalysis::captureTraversals(const StationBST& bst)
+{
+    bstCount = bst.count();
+    inOrderList = bst.inOrder();
+    preOrderList = bst.preOrder();
+    postOrderList = bst.postOrder();
+    traversalsCaptured = true;
+}
+
+// Compute the requested parts
+void NetworkAnalysis::compute(int parts)
+{
+    if ((parts & KruskalMST) && !has(KruskalMST))
+    {
+        computeKruskal();
+    }
+    if ((parts & PrimMST) && !has(PrimMST))
+    {
+        computePrim();
+    }
+    if ((parts & Degrees) && !has(Degrees))
+    {
+        computeDegrees();
+    }
+    if ((parts & Components) && !has(Components))
+    {
+        computeComponents();
+    }
+    if ((parts & Reachability) && !has(Reachability))
+    {
+        computeReachability();
+    }
+
+    computedParts |= parts;
+}
+
+// Check if a part was computed
+bool NetworkAnalysis::has(Part part) const
+{
+    return (computedParts & part) != 0;
+}
+
+// Attach the current weight to each MST edge (IDs)
+QList<Edge> NetworkAnalysis::withWeights(const QList<QPair<int, int>>& edges) const
+{
+    QList<Edge> result;
+    result.reserve(edges.size());
+
+    for (const auto& edge : edges)
+    {
+        result.append(Edge(edge.first, edge.second, network.getEdgeWeight(edge.first, edge.second)));
+    }
+
+    return result;
+}
+
+// Kruskal MST
+void NetworkAnalysis::computeKruskal()
+{
+    kruskalEdges.clear();
+    kruskalWeight = 0.0;
+
+    if (stationIndices.isEmpty())
+    {
+        return;
+    }
+
+    kruskalEdges = withWeights(network.kruskalMST());
+    for (const Edge& edge : kruskalEdges)
+    {
+        kruskalWeight += edge.weight;
+    }
+}
+
+// Prim MST
+void NetworkAnalysis::computePrim()
+{
+    primEdges.clear();
+    primWeight = 0.0;
+
+    if (stationIndices.isEmpty())
+    {
+        return;
+    }
+
+    primEdges = withWeights(network.primMST());
+    for (const Edge& edge : primEdges)
+    {
+        primWeight += edge.weight;
+    }
+}
+
+// Routes per station
+void NetworkAnalysis::computeDegrees()
+{
+    degrees.fill(0, network.getStationTable().slotCount());
+    totalRoutes = 0;
+    minDegree = 0;
+    maxDegree = 0;
+
+    for (int i = 0; i < stationIndices.size(); i++)
+    {
+        int index = stationIndices[i];
+        int degree = network.neighborsAt(index).size();
+        degrees[index] = degree;
+        totalRoutes += degree;
+
+        if (i == 0 || degree < minDegree)
+        {
+            minDegree = degree;
+        }
+        if (degree > maxDegree)
+        {
+            maxDegree = degree;
+        }
+    }
+
+    // For undirected graphs, every route is stored twice
+    if (!network.isDirected())
+    {
+        totalRoutes /= 2;
+    }
+}
+
+// Connected components over open stations and routes
+void NetworkAnalysis::computeComponents()
+{
+    const StationTable& table = network.getStationTable();
+    componentCount = 0;
+    largestComponent = 0;
+
+    // Elements are index + 1
+    DisjointSet ds(table.slotCount());
+
+    for (int index : stationIndices)
+    {
+        int id = table.idAt(index);
+        if (network.isStationClosed(id))
+        {
+            continue;
+        }
+
+        for (const auto& neighbor : network.neighborsAt(index))
+        {
+            int neighborId = table.idAt(neighbor.first);
+            if (!network.isStationClosed(neighborId) && !network.isRouteClosed(id, neighborId))
+            {
+                ds.unionSets(index + 1, neighbor.first + 1);
+            }
+        }
+    }
+
+    // Components are numbered by their first station in slot order
+    QHash<int, int> componentSizes;
+    QHash<int, int> componentNumbers;
+    componentIds.fill(-1, table.slotCount());
+    for (int index : stationIndices)
+    {
+        if (!network.isStationClosed(table.idAt(index)))
+        {
+            int root = ds.find(index + 1);
+            componentSizes[root]++;
+            if (!componentNumbers.contains(root))
+            {
+                componentNumbers.insert(root, componentNumbers.size());
+            }
+            componentIds[index] = componentNumbers.value(root);
+        }
+    }
+
+    componentCount = componentSizes.size();
+    for (int size : componentSizes)
+    {
+        largestComponent = qMax(largestComponent, size);
+    }
+}
+
+// BFS from the first station
+void NetworkAnalysis::computeReachability()
+{
+    reachable.clear();
+    reachabilityStart = -1;
+
+    if (stationIndices.isEmpty())
+    {
+        return;
+    }
+
+    reachabilityStart = network.getStationTable().idAt(stationIndices.first());
+    reachable = network.bfs(reachabilityStart);
+}
+
+// Get the analysed graph
+const Graph& NetworkAnalysis::getGraph() const
+{
+    return network;
+}
+
+// Get the station table of the analysed graph
+const StationTable& NetworkAnalysis::getStationTable() const
+{
+    return network.getStationTable();
+}
+
+// Get live station indices
+const QList<int>& NetworkAnalysis::getStationIndices() const
+{
+    return stationIndices;
+}
+
+// Get Kruskal MST edges
+const QList<Edge>& NetworkAnalysis::getKruskalEdges() const
+{
+    return kruskalEdges;
+}
+
+// Get Prim MST edges
+const QList<Edge>& NetworkAnalysis::getPrimEdges() const
+{
+    return primEdges;
+}
+
+// Get Kruskal MST weight
+double NetworkAnalysis::getKruskalWeight() const
+{
+    return kruskalWeight;
+}
+
+// Get Prim MST weight
+double NetworkAnalysis::getPrimWeight() const
+{
+    return primWeight;
+}
+
+// Get routes of a station index
+int NetworkAnalysis::degreeAt(int index) const
+{
+    return (index >= 0 && index < degrees.size()) ? degrees[index] : 0;
+}
+
+// Get total routes
+int NetworkAnalysis::getTotalRoutes() const
+{
+    return totalRoutes;
+}
+
+// Get smallest number of routes of a station
+int NetworkAnalysis::getMinDegree() const
+{
+    return minDegree;
+}
+
+// Get largest number of routes of a station
+int NetworkAnalysis::getMaxDegree() const
+{
+    return maxDegree;
+}
+
+// Get average routes per station
+double NetworkAnalysis::getAverageDegree() const
+{
+    return stationIndices.isEmpty() ? 0.0 : (2.0 * totalRoutes) / stationIndices.size();
+}
+
+// Get number of connected components
+int NetworkAnalysis::getComponentCount() const
+{
+    return componentCount;
+}
+
+// Get size of the largest component
+int NetworkAnalysis::getLargestComponentSize() const
+{
+    return largestComponent;
+}
+
+// Get the component of a slot index
+int NetworkAnalysis::componentAt(int index) const
+{
+    return (index >= 0 && index < componentIds.size()) ? componentIds[index] : -1;
+}
+
+// Get BFS start station
+int NetworkAnalysis::getReachabilityStart() const
+{
+    return reachabilityStart;
+}
+
+// Get stations reached by the BFS
+const QList<int>& NetworkAnalysis::getReachable() const
+{
+    return reachable;
+}
+
+// Check if BST traversals were captured
+bool NetworkAnalysis::hasTraversals() const
+{
+    return traversalsCaptured;
+}
+
+// Get number of stations in the BST
+int NetworkAnalysis::getBSTCount() const
+{
+    return bstCount;
+}
+
+// Get InOrder traversal
+const QList<int>& NetworkAnalysis::getInOrder() const
+{
+    return inOrderList;
+}
+
+// Get PreOrder traversal
+const QList<int>& NetworkAnalysis::getPreOrder() const
+{
+    return preOrderList;
+}
+
+// Get PostOrder traversal
+const QList<int>& NetworkAnalysis::getPostOrder() const
+{
+    return postOrderList;
+}
+
@@ -0,0 +1,111 @@
+#pragma once
+
+#include "Graph.h"
+#include <QList>
+#include <QVector>
+
+using namespace std;
+
+// Forward declarations
+class StationBST;
+
+// Results shared by the reports (MST, degrees, components, reachability, BST traversals).
+// Each result is computed once per report run instead of once per report.
+// The analysis keeps its own copy of the graph (implicitly shared, no deep copy), so
+// compute() and the report renderers can run on worker threads while the GUI keeps
+// editing the network.
+class NetworkAnalysis
+{
+public:
+    // Parts that compute() can fill
+    enum Part
+    {
+        KruskalMST = 0x01,      // Kruskal edges and weight
+        PrimMST = 0x02,         // Prim edges and weight
+        Degrees = 0x04,         // Routes per station, min/max/average
+        Components = 0x08,      // Connected components of the open network
+        Reachability = 0x10,    // BFS from the first station
+        All = 0x1F
+    };
+
+    // Constructor (copies the graph; call from the thread that owns it)
+    explicit NetworkAnalysis(const Graph& graph);
+
+    // Store BST traversals and size (the tree cannot be shared; call from the owner thread)
+    void captureTraversals(const StationBST& bst);
+
+    // Compute the requested parts (any thread)
+    void compute(int parts = All);
+    bool has(Part part) const;
+
+    // Network
+    const Graph& getGraph() const;
+    const StationTable& getStationTable() const;
+    const QList<int>& getStationIndices() const;     // Live indices in slot order
+
+    // MST (station IDs and weights)
+    const QList<Edge>& getKruskalEdges() const;
+    const QList<Edge>& getPrimEdges() const;
+    double getKruskalWeight() const;
+    double getPrimWeight() const;
+
+    // Degrees (routes per station, by slot index)
+    int degreeAt(int index) const;
+    int getTotalRoutes() const;
+    int getMinDegree() const;
+    int getMaxDegree() const;
+    double getAverageDegree() const;
+
+    // Components (closed stations and routes are left out)
+    int getComponentCount() const;
+    int getLargestComponentSize() const;
+    int componentAt(int index) const;                // Component of a slot index, -1 if closed
+
+    // Reachability
+    int getReachabilityStart() const;                // Station ID, -1 without stations
+    const QList<int>& getReachable() const;          // Station IDs in BFS order
+
+    // BST traversals (station table indices)
+    bool hasTraversals() const;
+    int getBSTCount() const;
+    const QList<int>& getInOrder() const;
+    const QList<int>& getPreOrder() const;
+    const QList<int>& getPostOrder() const;
+
+private:
+    Graph network;
+    QList<int> stationIndices;
+    int computedParts;
+
+    QList<Edge> kruskalEdges;
+    QList<Edge> primEdges;
+    double kruskalWeight;
+    double primWeight;
+
+    QVector<int> degrees;
+    int totalRoutes;
+    int minDegree;
+    int maxDegree;
+
+    int componentCount;
+    int largestComponent;
+    QVector<int> componentIds;                       // By slot index (-1 = closed or removed)
+
+    int reachabilityStart;
+    QList<int> reachable;
+
+    bool traversalsCaptured;
+    int bstCount;
+    QList<int> inOrderList;
+    QList<int> preOrderList;
+    QList<int> postOrderList;
+
+    // Helpers for compute()
+    void computeKruskal();
+    void computePrim();
+    void computeDegrees();
+    void computeComponents();
+    void computeReachability();
+    QList<Edge> withWeights(const QList<QPair<int, int>>& edges) const;
+};
+
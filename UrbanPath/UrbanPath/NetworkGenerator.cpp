@@ -0,0 +1,647 @@
+#include "NetworkGenerator.h"
+#include "StationBST.h"
+#include "FileManager.h"
+#include "ReportWriter.h"
+#include "Log.h"
+#include <QDateTime>
+#include <QDir>
+#include <QList>
+#include <cmath>
+
+static const double Pi = 3.14159265358979323846;
+
+// Sine and cosine with basic arithmetic only: the library functions may round the last
+// bit differently on each platform, and the network has to be the same everywhere
+static void portableSinCos(double angle, double& sine, double& cosine)
+{
+    // Reduce to [-Pi, Pi), then add Taylor terms until they are far below one ulp
+    angle -= 2.0 * Pi * std::floor((angle + Pi) / (2.0 * Pi));
+    double square = angle * angle;
+    double sineTerm = angle;
+    double cosineTerm = 1.0;
+    sine = sineTerm;
+    cosine = cosineTerm;
+
+    for (int k = 1; k <= 15; k++)
+    {
+        sineTerm *= -square / ((2.0 * k) * (2.0 * k + 1.0));
+        cosineTerm *= -square / ((2.0 * k - 1.0) * (2.0 * k));
+        sine += sineTerm;
+        cosine += cosineTerm;
+    }
+}
+
+// Constructor
+NetworkGenerator::NetworkGenerator() : spacing(1.0)
+{
+}
+
+// Uniform random number in [low, high), built from 53 bits of two raw mt19937 outputs.
+// mt19937 gives the same sequence everywhere; the standard distributions do not.
+double NetworkGenerator::uniform(double low, double high)
+{
+    quint32 upper = static_cast<quint32>(rng()) >> 5;
+    quint32 lower = static_cast<quint32>(rng()) >> 6;
+    double unit = (upper * 67108864.0 + lower) / 9007199254740992.0;
+    return low + (high - low) * unit;
+}
+
+// Normal random number: sum of twelve uniforms (Irwin-Hall), so only basic arithmetic
+// is involved; the tails stop at six standard deviations
+double NetworkGenerator::gaussian(double mean, double deviation)
+{
+    double sum = 0.0;
+    for (int i = 0; i < 12; i++)
+    {
+        sum += uniform(0.0, 1.0);
+    }
+    return mean + (sum - 6.0) * deviation;
+}
+
+// Build the network
+bool NetworkGenerator::generate(const Options& options)
+{
+    lastError.clear();
+
+    if (options.stations < 1 || options.stations > MaxStations)
+    {
+        lastError = QString("El numero de estaciones debe estar entre 1 y %1.").arg(MaxStations);
+    }
+    else if (options.degree < 1)
+    {
+        lastError = "El grado medio debe ser al menos 1.";
+    }
+    else if (options.width <= 0.0 || options.height <= 0.0)
+    {
+        lastError = "El area del mapa debe ser positiva.";
+    }
+    else if (options.closedStations < 0.0 || options.closedStations > 1.0 ||
+             options.closedRoutes < 0.0 || options.closedRoutes > 1.0 ||
+             options.accidentRoutes < 0.0 || options.accidentRoutes > 1.0)
+    {
+        lastError = "Las densidades de cierres y accidentes deben estar entre 0 y 1.";
+    }
+    else if (options.minIncrement <= 0.0 || options.maxIncrement < options.minIncrement)
+    {
+        lastError = "El rango de incrementos de accidentes no es valido.";
+    }
+
+    if (!lastError.isEmpty())
+    {
+        LOG_ERROR << "Error:" << lastError;
+        return false;
+    }
+
+    this->options = options;
+    rng.seed(options.seed);
+    spacing = std::sqrt(options.width * options.height / options.stations);
+
+    xs.clear();
+    ys.clear();
+    routes.clear();
+    xs.reserve(options.stations);
+    ys.reserve(options.stations);
+    routes.reserve(static_cast<qint64>(options.stations) * options.degree / 2 + 16);
+
+    switch (options.topology)
+    {
+    case Grid:
+        generateGrid();
+        break;
+    case RadialRing:
+        generateRadialRing();
+        break;
+    case RandomGeometric:
+        generateRandomGeometric();
+        break;
+    case ScaleFree:
+        generateScaleFree();
+        break;
+    }
+
+    pickIncidents();
+
+    LOG_INFO << "Red generada (" << topologyName(options.topology) << "):" << xs.size() << "estaciones,"
+             << routes.size() << "rutas.";
+    return true;
+}
+
+// Append a route with a travel-time weight
+void NetworkGenerator::addRoute(int a, int b)
+{
+    double dx = xs[a] - xs[b];
+    double dy = ys[a] - ys[b];
+    double length = std::sqrt(dx * dx + dy * dy);
+
+    // About two minutes between neighbouring stations, +-30% for traffic
+    double weight = std::round(length / spacing * 2.0 * uniform(0.7, 1.3) * 10.0) / 10.0;
+    routes.append(Edge(a, b, qMax(0.5, weight)));
+}
+
+// Jittered grid
+void NetworkGenerator::generateGrid()
+{
+    int n = options.stations;
+    int columns = qMax(1, static_cast<int>(std::ceil(std::sqrt(n * options.width / options.height))));
+    int rows = (n + columns - 1) / columns;
+    double cellWidth = options.width / columns;
+    double cellHeight = options.height / rows;
+
+    for (int i = 0; i < n; i++)
+    {
+        int column = i % columns;
+        int row = i / columns;
+        xs.append((column + 0.5 + uniform(-0.2, 0.2)) * cellWidth);
+        ys.append((row + 0.5 + uniform(-0.2, 0.2)) * cellHeight);
+    }
+
+    for (int i = 0; i < n; i++)
+    {
+        int column = i % columns;
+
+        if (column + 1 < columns && i + 1 < n)
+        {
+            addRoute(i, i + 1);
+        }
+        if (i + columns < n)
+        {
+            addRoute(i, i + columns);
+        }
+        if (options.degree >= 6 && column + 1 < columns && i + columns + 1 < n)
+        {
+            addRoute(i, i + columns + 1);
+        }
+        if (options.degree >= 8 && column > 0 && i + columns - 1 < n)
+        {
+            addRoute(i, i + columns - 1);
+        }
+    }
+}
+
+// Rings of 6k stations around a central station, each joined to the ring inside it
+void NetworkGenerator::generateRadialRing()
+{
+    int n = options.stations;
+    double centerX = options.width / 2.0;
+    double centerY = options.height / 2.0;
+
+    // Rings needed for n stations (the last one may be partial)
+    int rings = 0;
+    for (qint64 total = 1; total < n; total += 6 * (rings + 1))
+    {
+        rings++;
+    }
+
+    xs.append(centerX);
+    ys.append(centerY);
+
+    int previousStart = 0;
+    int previousCount = 1;
+
+    for (int ring = 1; ring <= rings; ring++)
+    {
+        int ringSize = 6 * ring;
+        int start = xs.size();
+        int count = qMin(ringSize, n - start);
+        double radius = static_cast<double>(ring) / rings * 0.48;
+        double offset = ring * 0.37;     // Keep the avenues from lining up exactly
+
+        for (int j = 0; j < count; j++)
+        {
+            double angle = offset + 2.0 * Pi * j / ringSize;
+            double r = radius * uniform(0.97, 1.03);
+            double sine, cosine;
+            portableSinCos(angle, sine, cosine);
+            xs.append(centerX + r * options.width * cosine);
+            ys.append(centerY + r * options.height * sine);
+
+            // Ring street to the previous station of the ring (and closing the ring)
+            if (j > 0)
+            {
+                addRoute(start + j - 1, start + j);
+            }
+            if (j == ringSize - 1 && ringSize > 2)
+            {
+                addRoute(start + j, start);
+            }
+
+            // Radial avenue to the closest station (by angle) of the ring inside
+            int inner = previousCount == 1 ? 0 : static_cast<int>(std::lround(static_cast<double>(j) / ringSize * previousCount)) % previousCount;
+            addRoute(previousStart + inner, start + j);
+        }
+
+        previousStart = start;
+        previousCount = count;
+    }
+}
+
+// Random stations joined to every station within a radius (bucket grid search)
+void NetworkGenerator::generateRandomGeometric()
+{
+    int n = options.stations;
+    for (int i = 0; i < n; i++)
+    {
+        xs.append(uniform(0.0, options.width));
+        ys.append(uniform(0.0, options.height));
+    }
+
+    // pi r^2 n / area = degree
+    double radius = std::sqrt(options.degree * options.width * options.height / (Pi * n));
+    double radius2 = radius * radius;
+
+    // Cells at least one radius wide, so neighbours are in the 3x3 block around a cell
+    int columns = qBound(1, static_cast<int>(options.width / radius), 4096);
+    int rows = qBound(1, static_cast<int>(options.height / radius), 4096);
+    double cellWidth = options.width / columns;
+    double cellHeight = options.height / rows;
+
+    auto cellOf = [&](int i) {
+        int column = qMin(columns - 1, static_cast<int>(xs[i] / cellWidth));
+        int row = qMin(rows - 1, static_cast<int>(ys[i] / cellHeight));
+        return row * columns + column;
+    };
+
+    // Counting sort of the stations by cell
+    QVector<int> cellStart(columns * rows + 1, 0);
+    QVector<int> cells(n);
+    for (int i = 0; i < n; i++)
+    {
+        cells[i] = cellOf(i);
+        cellStart[cells[i] + 1]++;
+    }
+    for (int c = 0; c < columns * rows; c++)
+    {
+        cellStart[c + 1] += cellStart[c];
+    }
+    QVector<int> order(n);
+    QVector<int> fill = cellStart;
+    for (int i = 0; i < n; i++)
+    {
+        order[fill[cells[i]]++] = i;
+    }
+
+    for (int i = 0; i < n; i++)
+    {
+        int column = cells[i] % columns;
+        int row = cells[i] / columns;
+
+        for (int r = qMax(0, row - 1); r <= qMin(rows - 1, row + 1); r++)
+        {
+            for (int c = qMax(0, column - 1); c <= qMin(columns - 1, column + 1); c++)
+            {
+                int cell = r * columns + c;
+                for (int k = cellStart[cell]; k < cellStart[cell + 1]; k++)
+                {
+                    int j = order[k];
+                    double dx = xs[i] - xs[j];
+                    double dy = ys[i] - ys[j];
+                    if (j > i && dx * dx + dy * dy <= radius2)
+                    {
+                        addRoute(i, j);
+                    }
+                }
+            }
+        }
+    }
+}
+
+// Preferential attachment; a uniformly chosen route end is a degree-weighted station
+void NetworkGenerator::generateScaleFree()
+{
+    int n = options.stations;
+    int links = qMax(1, options.degree / 2);
+    int seedStations = qMin(n, links + 1);
+
+    // Fully connected core
+    for (int i = 0; i < seedStations; i++)
+    {
+        xs.append(uniform(options.width * 0.25, options.width * 0.75));
+        ys.append(uniform(options.height * 0.25, options.height * 0.75));
+        for (int j = 0; j < i; j++)
+        {
+            addRoute(j, i);
+        }
+    }
+
+    QVector<int> targets;
+
+    for (int i = seedStations; i < n; i++)
+    {
+        targets.clear();
+        for (int attempt = 0; targets.size() < qMin(links, i) && attempt < links * 10; attempt++)
+        {
+            int target;
+            if (routes.isEmpty())
+            {
+                target = static_cast<int>(rng() % i);
+            }
+            else
+            {
+                const Edge& route = routes[rng() % routes.size()];
+                target = (rng() & 1) ? route.from : route.to;
+            }
+
+            if (!targets.contains(target))
+            {
+                targets.append(target);
+            }
+        }
+
+        // Near the first hub, inside the map
+        xs.append(qBound(0.0, xs[targets.first()] + gaussian(0.0, spacing * 2.0), options.width));
+        ys.append(qBound(0.0, ys[targets.first()] + gaussian(0.0, spacing * 2.0), options.height));
+
+        for (int target : targets)
+        {
+            addRoute(target, i);
+        }
+    }
+}
+
+// Choose the closed stations, closed routes and accidents
+void NetworkGenerator::pickIncidents()
+{
+    closedStationIndices.clear();
+    closedRouteIndices.clear();
+    accidents.clear();
+
+    if (options.closedStations > 0.0)
+    {
+        for (int i = 0; i < xs.size(); i++)
+        {
+            if (uniform(0.0, 1.0) < options.closedStations)
+            {
+                closedStationIndices.append(i);
+            }
+        }
+    }
+
+    if (options.closedRoutes > 0.0 || options.accidentRoutes > 0.0)
+    {
+        for (int i = 0; i < routes.size(); i++)
+        {
+            if (options.closedRoutes > 0.0 && uniform(0.0, 1.0) < options.closedRoutes)
+            {
+                closedRouteIndices.append(i);
+            }
+            if (options.accidentRoutes > 0.0 && uniform(0.0, 1.0) < options.accidentRoutes)
+            {
+                accidents.append(qMakePair(i, std::round(uniform(options.minIncrement, options.maxIncrement))));
+            }
+        }
+    }
+}
+
+// Get number of stations
+int NetworkGenerator::getStationCount() const
+{
+    return xs.size();
+}
+
+// Get number of routes
+qint64 NetworkGenerator::getRouteCount() const
+{
+    return routes.size();
+}
+
+// Get number of closed stations
+int NetworkGenerator::getClosedStationCount() const
+{
+    return closedStationIndices.size();
+}
+
+// Get number of closed routes
+int NetworkGenerator::getClosedRouteCount() const
+{
+    return closedRouteIndices.size();
+}
+
+// Get number of accidents
+int NetworkGenerator::getAccidentCount() const
+{
+    return accidents.size();
+}
+
+// Load the network into a graph and tree
+void NetworkGenerator::buildGraph(Graph& graph, StationBST& bst) const
+{
+    int n = xs.size();
+
+    graph.clear();
+    bst.clear();
+    graph.reserve(n, n * 12);
+
+    QList<int> ids;
+    ids.reserve(n);
+    for (int i = 0; i < n; i++)
+    {
+        graph.addStation(Station(i + 1, "Estacion " + QString::number(i + 1), xs[i], ys[i]));
+        ids.append(i + 1);
+    }
+    bst.insertBulk(ids);
+
+    // Generator indices -> graph ringSize
+    QVector<Edge> edges;
+    edges.reserve(routes.size());
+    for (const Edge& route : routes)
+    {
+        edges.append(Edge(graph.indexOf(route.from + 1), graph.indexOf(route.to + 1), route.weight));
+    }
+    graph.addEdgesBulk(edges);
+
+    for (int i : closedStationIndices)
+    {
+        graph.closeStation(i + 1);
+    }
+    for (int i : closedRouteIndices)
+    {
+        graph.closeRoute(routes[i].from + 1, routes[i].to + 1);
+    }
+    for (const auto& accident : accidents)
+    {
+        const Edge& route = routes[accident.first];
+        graph.applyAccident(route.from + 1, route.to + 1, accident.second);
+    }
+}
+
+// Write the text data files
+bool NetworkGenerator::writeText(const QString& directory) const
+{
+    lastError.clear();
+
+    QDir dir(directory);
+    if (!dir.mkpath("."))
+    {
+        lastError = QString("No se pudo crear el directorio %1.").arg(directory);
+        LOG_ERROR << "Error:" << lastError;
+        return false;
+    }
+
+    QString generated = "# Generado: " + QDateTime::currentDateTime().toString("yyyy-MM-dd HH:mm:ss") +
+                        " (" + topologyName(options.topology) + ", semilla " + QString::number(options.seed) + ")\n\n";
+
+    ReportWriter out;
+
+    // Stations
+    if (!out.open(dir.filePath("estaciones.txt")))
+    {
+        lastError = out.getLastError();
+        return false;
+    }
+    out << "# Archivo de estaciones - UrbanPath\n";
+    out << "# Formato: id, nombre, coordenada_x, coordenada_y\n";
+    out << generated;
+    for (int i = 0; i < xs.size(); i++)
+    {
+        out << (i + 1) << ", Estacion " << (i + 1) << ", ";
+        out.writeFixed(xs[i], 3) << ", ";
+        out.writeFixed(ys[i], 3) << '\n';
+    }
+    if (!out.close())
+    {
+        lastError = out.getLastError();
+        return false;
+    }
+
+    // Routes
+    if (!out.open(dir.filePath("rutas.txt")))
+    {
+        lastError = out.getLastError();
+        return false;
+    }
+    out << "# Archivo de rutas - UrbanPath\n";
+    out << "# Formato: origen, destino, peso\n";
+    out << generated;
+    for (const Edge& route : routes)
+    {
+        out << (route.from + 1) << ", " << (route.to + 1) << ", ";
+        out.writeDouble(route.weight) << '\n';
+    }
+    if (!out.close())
+    {
+        lastError = out.getLastError();
+        return false;
+    }
+
+    // Closures
+    if (!out.open(dir.filePath("cierres.txt")))
+    {
+        lastError = out.getLastError();
+        return false;
+    }
+    out << "# Archivo de cierres - UrbanPath\n";
+    out << "# Formato: TIPO,identificador(es)\n";
+    out << "# \n";
+    out << "# ESTACION,id          -> Cierra una estacion (aparece en GRIS)\n";
+    out << "# RUTA,origen,destino  -> Cierra una ruta (aparece en ROJO)\n";
+    out << "#\n";
+    out << generated;
+    for (int i : closedStationIndices)
+    {
+        out << "ESTACION," << (i + 1) << '\n';
+    }
+    for (int i : closedRouteIndices)
+    {
+        out << "RUTA," << (routes[i].from + 1) << ',' << (routes[i].to + 1) << '\n';
+    }
+    if (!out.close())
+    {
+        lastError = out.getLastError();
+        return false;
+    }
+
+    // Accidents
+    if (!out.open(dir.filePath("accidentes.txt")))
+    {
+        lastError = out.getLastError();
+        return false;
+    }
+    out << "# Archivo de accidentes - UrbanPath\n";
+    out << "# Formato: origen,destino,incremento_porcentual\n";
+    out << "#\n";
+    out << generated;
+    for (const auto& accident : accidents)
+    {
+        const Edge& route = routes[accident.first];
+        out << (route.from + 1) << ',' << (route.to + 1) << ',';
+        out.writeDouble(accident.second) << '\n';
+    }
+    if (!out.close())
+    {
+        lastError = out.getLastError();
+        return false;
+    }
+
+    LOG_INFO << "Red escrita en" << directory << "(" << xs.size() << "estaciones," << routes.size() << "rutas)";
+    return true;
+}
+
+// Write a binary snapshot
+bool NetworkGenerator::writeSnapshot(const QString& filename) const
+{
+    lastError.clear();
+
+    Graph graph;
+    StationBST bst(&graph.getStationTable());
+    buildGraph(graph, bst);
+
+    FileManager fileManager;
+    if (!fileManager.saveSnapshot(filename, graph))
+    {
+        lastError = fileManager.getLastError();
+        return false;
+    }
+    return true;
+}
+
+// Get topology name
+QString NetworkGenerator::topologyName(Topology topology)
+{
+    switch (topology)
+    {
+    case Grid:
+        return "cuadricula";
+    case RadialRing:
+        return "radial";
+    case RandomGeometric:
+        return "geometrica";
+    case ScaleFree:
+        return "libre_escala";
+    }
+    return QString();
+}
+
+// Parse a topology name (Spanish or English)
+bool NetworkGenerator::parseTopology(const QString& name, Topology& topology)
+{
+    QString key = name.trimmed().toLower();
+
+    if (key == "cuadricula" || key == "grid")
+    {
+        topology = Grid;
+    }
+    else if (key == "radial" || key == "anillos" || key == "ring")
+    {
+        topology = RadialRing;
+    }
+    else if (key == "geometrica" || key == "geometric")
+    {
+        topology = RandomGeometric;
+    }
+    else if (key == "libre_escala" || key == "scalefree" || key == "scale-free")
+    {
+        topology = ScaleFree;
+    }
+    else
+    {
+        return false;
+    }
+    return true;
+}
+
+// Get last error message
+QString NetworkGenerator::getLastError() const
+{
+    return lastError;
+}
+
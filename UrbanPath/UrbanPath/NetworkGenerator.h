@@ -0,0 +1,112 @@
+#pragma once
+
+#include "Graph.h"
+#include <QString>
+#include <QVector>
+#include <QPair>
+#include <random>
+
+using namespace std;
+
+// Forward declarations
+class StationBST;
+
+// Synthetic city networks for scale and load testing.
+// Stations get IDs 1..n and names "Estacion <id>", spread over the map area
+// (1032 x 676 by default, the size of mapa.png). Route weights are travel times:
+// the length of the route relative to the mean station spacing, with some noise,
+// so they stay in the same range at every network size. The same options and
+// seed always give the same network, on every compiler and standard library
+// (random numbers come straight from mt19937, mapped without std distributions).
+//
+//   Grid              streets on a jittered grid (degree 6 or 8 adds diagonals)
+//   RadialRing        concentric rings around the centre joined by radial avenues
+//   RandomGeometric   random stations joined to every station within a radius
+//                     chosen for the requested average degree
+//   ScaleFree         preferential attachment (Barabasi-Albert, degree / 2 routes
+//                     per new station); new stations appear near their first hub
+//
+// Closures and accidents are drawn per station / route with the given densities.
+class NetworkGenerator
+{
+public:
+    enum Topology
+    {
+        Grid,
+        RadialRing,
+        RandomGeometric,
+        ScaleFree
+    };
+
+    struct Options
+    {
+        Topology topology = RandomGeometric;
+        int stations = 1000;
+        int degree = 4;                  // Average routes per station (RandomGeometric, ScaleFree, Grid)
+        quint32 seed = 12345;
+        double width = 1032.0;           // Map area
+        double height = 676.0;
+        double closedStations = 0.0;     // Fraction of stations closed
+        double closedRoutes = 0.0;       // Fraction of routes closed
+        double accidentRoutes = 0.0;     // Fraction of routes with an accident
+        double minIncrement = 10.0;      // Accident increment range, in percent
+        double maxIncrement = 100.0;
+    };
+
+    static const int MaxStations = 10000000;
+
+    // Constructor
+    NetworkGenerator();
+
+    // Build the network in memory (compact arrays, no Graph yet)
+    bool generate(const Options& options);
+
+    // Generated network
+    int getStationCount() const;
+    qint64 getRouteCount() const;
+    int getClosedStationCount() const;
+    int getClosedRouteCount() const;
+    int getAccidentCount() const;
+
+    // Load it into a graph and tree (cleared first; closures and accidents applied)
+    void buildGraph(Graph& graph, StationBST& bst) const;
+
+    // Write estaciones.txt, rutas.txt, cierres.txt and accidentes.txt into a directory
+    bool writeText(const QString& directory) const;
+
+    // Write a binary snapshot (FileManager format)
+    bool writeSnapshot(const QString& filename) const;
+
+    // Topology names ("cuadricula", "radial", "geometrica", "libre_escala")
+    static QString topologyName(Topology topology);
+    static bool parseTopology(const QString& name, Topology& topology);
+
+    // Get last error message
+    QString getLastError() const;
+
+private:
+    Options options;
+    QVector<double> xs;                        // Station coordinates by index (ID = index + 1)
+    QVector<double> ys;
+    QVector<Edge> routes;                      // Station indices, each route once
+    QVector<int> closedStationIndices;
+    QVector<int> closedRouteIndices;           // Positions in 'routes'
+    QVector<QPair<int, double>> accidents;     // Position in 'routes', increment (%)
+    double spacing;                            // Mean distance between neighbouring stations
+    mt19937 rng;
+
+    mutable QString lastError;
+
+    // Topologies
+    void generateGrid();
+    void generateRadialRing();
+    void generateRandomGeometric();
+    void generateScaleFree();
+
+    // Helpers
+    void addRoute(int a, int b);               // Travel-time weight from the positions
+    void pickIncidents();
+    double uniform(double low, double high);
+    double gaussian(double mean, double deviation);
+};
+
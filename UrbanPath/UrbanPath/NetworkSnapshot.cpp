@@ -0,0 +1,401 @@
+#include "NetworkSnapshot.h"
+#include "Graph.h"
+#include "StationBST.h"
+#include "FileFingerprint.h"
+#include "Log.h"
+#include <QFile>
+#include <QSaveFile>
+#include <QByteArray>
+#include <cstring>
+#include <utility>
+
+// File header (native byte order, checked with byteOrder)
+struct SnapshotHeader
+{
+    char magic[8];                 // "UPSNAP" + two zero bytes
+    quint32 version;
+    quint32 byteOrder;             // 0x01020304 as written by the saving machine
+    quint32 flags;                 // Bit 0: directed graph
+    quint32 slotCount;             // Station slots (includes removed ones)
+    quint32 edgeCount;             // Adjacency entries
+    quint32 nameChars;             // UTF-16 units in the string table
+    quint32 closedStationCount;
+    quint32 closedRouteCount;
+    quint32 accidentCount;
+    quint32 reserved;
+    quint64 payloadSize;           // Bytes after the header
+    quint64 payloadChecksum;
+};
+
+static_assert(sizeof(SnapshotHeader) == 64, "Snapshot header must be 64 bytes");
+
+// Accident record
+struct SnapshotAccident
+{
+    qint32 origin;
+    qint32 destination;
+    double originalWeight;
+};
+
+static_assert(sizeof(SnapshotAccident) == 16, "Snapshot accident record must be 16 bytes");
+
+static const char SnapshotMagic[8] = { 'U', 'P', 'S', 'N', 'A', 'P', 0, 0 };
+static const quint32 SnapshotByteOrder = 0x01020304;
+
+// Payload sections, in file order
+enum SnapshotSection
+{
+    SectionIds,
+    SectionXs,
+    SectionYs,
+    SectionNameOffsets,
+    SectionNameLengths,
+    SectionEdgeOffsets,
+    SectionEdgeTargets,
+    SectionEdgeWeights,
+    SectionNames,
+    SectionClosedStations,
+    SectionClosedRoutes,
+    SectionAccidents,
+    SectionCount
+};
+
+// Offsets and sizes of every section inside the payload
+struct SnapshotLayout
+{
+    qint64 offset[SectionCount];
+    qint64 size[SectionCount];
+    qint64 total;
+
+    explicit SnapshotLayout(const SnapshotHeader& header)
+    {
+        qint64 slotTotal = header.slotCount;
+        qint64 edges = header.edgeCount;
+
+        size[SectionIds] = slotTotal * sizeof(qint32);
+        size[SectionXs] = slotTotal * sizeof(double);
+        size[SectionYs] = slotTotal * sizeof(double);
+        size[SectionNameOffsets] = slotTotal * sizeof(qint32);
+        size[SectionNameLengths] = slotTotal * sizeof(qint32);
+        size[SectionEdgeOffsets] = (slotTotal + 1) * sizeof(qint32);
+        size[SectionEdgeTargets] = edges * sizeof(qint32);
+        size[SectionEdgeWeights] = edges * sizeof(double);
+        size[SectionNames] = static_cast<qint64>(header.nameChars) * sizeof(char16_t);
+        size[SectionClosedStations] = static_cast<qint64>(header.closedStationCount) * sizeof(qint32);
+        size[SectionClosedRoutes] = static_cast<qint64>(header.closedRouteCount) * 2 * sizeof(qint32);
+        size[SectionAccidents] = static_cast<qint64>(header.accidentCount) * sizeof(SnapshotAccident);
+
+        // Every section starts on an 8 byte boundary
+        total = 0;
+        for (int i = 0; i < SectionCount; i++)
+        {
+            offset[i] = total;
+            total += (size[i] + 7) & ~static_cast<qint64>(7);
+        }
+    }
+};
+
+// Checksum of the payload
+quint64 NetworkSnapshot::checksum(const char* data, qint64 size)
+{
+    return FileFingerprint::hashBytes(data, size);
+}
+
+// Get last error message
+QString NetworkSnapshot::getLastError() const
+{
+    return lastError;
+}
+
+// Save the network to a binary snapshot
+bool NetworkSnapshot::save(const QString& filename, const Graph& graph)
+{
+    lastError.clear();
+
+    const StationTable& table = graph.getStationTable();
+    int slotCount = table.slotCount();
+
+    // Routes in CSR form (indices, as stored in the adjacency lists)
+    QVector<qint32> edgeOffsets(slotCount + 1, 0);
+    for (int i = 0; i < slotCount; i++)
+    {
+        edgeOffsets[i + 1] = edgeOffsets[i] + graph.neighborsAt(i).size();
+    }
+
+    QSet<int> closedStations = graph.getClosedStations();
+    QList<QPair<int, int>> closedRoutes = graph.getClosedRoutes();
+    QSet<QPair<int, int>> affectedRoutes = graph.getAffectedRoutes();
+    QHash<QPair<int, int>, double> originalWeights = graph.getOriginalWeights();
+
+    SnapshotHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, SnapshotMagic, sizeof(header.magic));
+    header.version = FormatVersion;
+    header.byteOrder = SnapshotByteOrder;
+    header.flags = graph.isDirected() ? 1u : 0u;
+    header.slotCount = static_cast<quint32>(slotCount);
+    header.edgeCount = static_cast<quint32>(edgeOffsets[slotCount]);
+    header.nameChars = static_cast<quint32>(table.nameArenaData().size());
+    header.closedStationCount = static_cast<quint32>(closedStations.size());
+    header.closedRouteCount = static_cast<quint32>(closedRoutes.size());
+    header.accidentCount = static_cast<quint32>(affectedRoutes.size());
+
+    SnapshotLayout layout(header);
+    QByteArray payload(layout.total, '\0');
+    char* base = payload.data();
+
+    // Station columns and string table are copied as they are
+    memcpy(base + layout.offset[SectionIds], table.idColumn().constData(), layout.size[SectionIds]);
+    memcpy(base + layout.offset[SectionXs], table.xColumn().constData(), layout.size[SectionXs]);
+    memcpy(base + layout.offset[SectionYs], table.yColumn().constData(), layout.size[SectionYs]);
+    memcpy(base + layout.offset[SectionNameOffsets], table.nameOffsetColumn().constData(), layout.size[SectionNameOffsets]);
+    memcpy(base + layout.offset[SectionNameLengths], table.nameLengthColumn().constData(), layout.size[SectionNameLengths]);
+    memcpy(base + layout.offset[SectionNames], table.nameArenaData().constData(), layout.size[SectionNames]);
+    memcpy(base + layout.offset[SectionEdgeOffsets], edgeOffsets.constData(), layout.size[SectionEdgeOffsets]);
+
+    // Routes
+    qint32* targets = reinterpret_cast<qint32*>(base + layout.offset[SectionEdgeTargets]);
+    double* weights = reinterpret_cast<double*>(base + layout.offset[SectionEdgeWeights]);
+    for (int i = 0; i < slotCount; i++)
+    {
+        qint32 position = edgeOffsets[i];
+        for (const auto& neighbor : graph.neighborsAt(i))
+        {
+            targets[position] = neighbor.first;
+            weights[position] = neighbor.second;
+            position++;
+        }
+    }
+
+    // Closures
+    qint32* stationIds = reinterpret_cast<qint32*>(base + layout.offset[SectionClosedStations]);
+    for (int stationId : closedStations)
+    {
+        *stationIds++ = stationId;
+    }
+
+    qint32* routeIds = reinterpret_cast<qint32*>(base + layout.offset[SectionClosedRoutes]);
+    for (const auto& route : closedRoutes)
+    {
+        *routeIds++ = route.first;
+        *routeIds++ = route.second;
+    }
+
+    // Accidents (current weights already include the increment)
+    SnapshotAccident* accidents = reinterpret_cast<SnapshotAccident*>(base + layout.offset[SectionAccidents]);
+    for (const auto& route : affectedRoutes)
+    {
+        accidents->origin = route.first;
+        accidents->destination = route.second;
+        accidents->originalWeight = originalWeights.value(route, graph.getEdgeWeight(route.first, route.second));
+        accidents++;
+    }
+
+    header.payloadSize = static_cast<quint64>(payload.size());
+    header.payloadChecksum = checksum(payload.constData(), payload.size());
+
+    // Write atomically so a failed save never leaves a broken snapshot behind
+    QSaveFile file(filename);
+
+    if (!file.open(QIODevice::WriteOnly))
+    {
+        lastError = QString("No se pudo abrir el archivo %1 para escritura.").arg(filename);
+        LOG_ERROR << "Error:" << lastError;
+        return false;
+    }
+
+    if (file.write(reinterpret_cast<const char*>(&header), sizeof(header)) != sizeof(header) ||
+        file.write(payload) != payload.size() ||
+        !file.commit())
+    {
+        lastError = QString("No se pudo escribir la instantanea %1.").arg(filename);
+        LOG_ERROR << "Error:" << lastError;
+        return false;
+    }
+
+    LOG_INFO << "[INFO] Instantanea guardada en" << filename << "(" << table.size() << "estaciones,"
+             << header.edgeCount << "entradas de adyacencia," << (sizeof(header) + payload.size()) << "bytes)";
+    return true;
+}
+
+// Load the network from a binary snapshot
+bool NetworkSnapshot::load(const QString& filename, Graph& graph, StationBST& bst)
+{
+    lastError.clear();
+
+    QFile file(filename);
+
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        lastError = QString("No se pudo abrir el archivo %1 para lectura.").arg(filename);
+        LOG_ERROR << "Error:" << lastError;
+        return false;
+    }
+
+    qint64 fileSize = file.size();
+    if (fileSize < static_cast<qint64>(sizeof(SnapshotHeader)))
+    {
+        lastError = QString("La instantanea %1 esta incompleta.").arg(filename);
+        LOG_ERROR << "Error:" << lastError;
+        return false;
+    }
+
+    uchar* mapped = file.map(0, fileSize);
+    if (mapped == nullptr)
+    {
+        lastError = QString("No se pudo mapear la instantanea %1 en memoria.").arg(filename);
+        LOG_ERROR << "Error:" << lastError;
+        return false;
+    }
+
+    const char* data = reinterpret_cast<const char*>(mapped);
+    SnapshotHeader header;
+    memcpy(&header, data, sizeof(header));
+
+    // Validate header
+    if (memcmp(header.magic, SnapshotMagic, sizeof(header.magic)) != 0)
+    {
+        lastError = QString("%1 no es una instantanea de UrbanPath.").arg(filename);
+    }
+    else if (header.byteOrder != SnapshotByteOrder)
+    {
+        lastError = QString("La instantanea %1 fue creada en una arquitectura incompatible.").arg(filename);
+    }
+    else if (header.version != FormatVersion)
+    {
+        lastError = QString("Version de instantanea no soportada: %1 (se esperaba %2).").arg(header.version).arg(FormatVersion);
+    }
+    else if (((header.flags & 1u) != 0) != graph.isDirected())
+    {
+        lastError = QString("La instantanea %1 no coincide con el tipo de grafo (dirigido/no dirigido).").arg(filename);
+    }
+    else if (static_cast<qint64>(header.payloadSize) != fileSize - static_cast<qint64>(sizeof(header)) ||
+             SnapshotLayout(header).total != static_cast<qint64>(header.payloadSize))
+    {
+        lastError = QString("La instantanea %1 tiene un tamano inconsistente.").arg(filename);
+    }
+    else if (checksum(data + sizeof(header), header.payloadSize) != header.payloadChecksum)
+    {
+        lastError = QString("La instantanea %1 esta danada (checksum invalido).").arg(filename);
+    }
+
+    if (!lastError.isEmpty())
+    {
+        LOG_ERROR << "Error:" << lastError;
+        file.unmap(mapped);
+        return false;
+    }
+
+    SnapshotLayout layout(header);
+    const char* base = data + sizeof(header);
+    int slotCount = static_cast<int>(header.slotCount);
+
+    // The graph and the table own growable containers (stations and routes are edited after
+    // loading), and the mapping is released before returning so the snapshot can be rewritten.
+    // So the data is copied once: one memcpy per station column, one pass over the routes.
+    // Station columns: one copy per column straight from the mapping
+    QVector<int> ids(slotCount);
+    QVector<double> xs(slotCount);
+    QVector<double> ys(slotCount);
+    QVector<int> nameOffsets(slotCount);
+    QVector<int> nameLengths(slotCount);
+    memcpy(ids.data(), base + layout.offset[SectionIds], layout.size[SectionIds]);
+    memcpy(xs.data(), base + layout.offset[SectionXs], layout.size[SectionXs]);
+    memcpy(ys.data(), base + layout.offset[SectionYs], layout.size[SectionYs]);
+    memcpy(nameOffsets.data(), base + layout.offset[SectionNameOffsets], layout.size[SectionNameOffsets]);
+    memcpy(nameLengths.data(), base + layout.offset[SectionNameLengths], layout.size[SectionNameLengths]);
+    QString names(reinterpret_cast<const QChar*>(base + layout.offset[SectionNames]), static_cast<int>(header.nameChars));
+
+    // Routes: rebuild the adjacency lists with their exact sizes
+    const qint32* edgeOffsets = reinterpret_cast<const qint32*>(base + layout.offset[SectionEdgeOffsets]);
+    const qint32* targets = reinterpret_cast<const qint32*>(base + layout.offset[SectionEdgeTargets]);
+    const double* weights = reinterpret_cast<const double*>(base + layout.offset[SectionEdgeWeights]);
+
+    QVector<QList<QPair<int, double>>> adjacency(slotCount);
+    bool consistent = edgeOffsets[0] == 0 && edgeOffsets[slotCount] == static_cast<qint32>(header.edgeCount);
+
+    for (int i = 0; i < slotCount && consistent; i++)
+    {
+        if (ids[i] != StationTable::RemovedId &&
+            (nameOffsets[i] < 0 || nameLengths[i] < 0 ||
+             static_cast<qint64>(nameOffsets[i]) + nameLengths[i] > header.nameChars))
+        {
+            consistent = false;
+            break;
+        }
+
+        qint32 first = edgeOffsets[i];
+        qint32 last = edgeOffsets[i + 1];
+        if (last < first)
+        {
+            consistent = false;
+            break;
+        }
+
+        QList<QPair<int, double>>& neighbors = adjacency[i];
+        neighbors.reserve(last - first);
+        for (qint32 e = first; e < last; e++)
+        {
+            if (targets[e] < 0 || targets[e] >= slotCount)
+            {
+                consistent = false;
+                break;
+            }
+            neighbors.append(QPair<int, double>(targets[e], weights[e]));
+        }
+    }
+
+    if (!consistent)
+    {
+        lastError = QString("La instantanea %1 contiene datos inconsistentes.").arg(filename);
+        LOG_ERROR << "Error:" << lastError;
+        file.unmap(mapped);
+        return false;
+    }
+
+    StationTable table;
+    table.assignColumns(std::move(ids), std::move(xs), std::move(ys),
+                        std::move(nameOffsets), std::move(nameLengths), std::move(names));
+    graph.assignNetwork(std::move(table), std::move(adjacency));
+
+    // Closures
+    const qint32* stationIds = reinterpret_cast<const qint32*>(base + layout.offset[SectionClosedStations]);
+    for (quint32 i = 0; i < header.closedStationCount; i++)
+    {
+        graph.closeStation(stationIds[i]);
+    }
+
+    const qint32* routeIds = reinterpret_cast<const qint32*>(base + layout.offset[SectionClosedRoutes]);
+    for (quint32 i = 0; i < header.closedRouteCount; i++)
+    {
+        graph.closeRoute(routeIds[2 * i], routeIds[2 * i + 1]);
+    }
+
+    // Accidents
+    const SnapshotAccident* accidents = reinterpret_cast<const SnapshotAccident*>(base + layout.offset[SectionAccidents]);
+    for (quint32 i = 0; i < header.accidentCount; i++)
+    {
+        graph.restoreAccident(accidents[i].origin, accidents[i].destination, accidents[i].originalWeight);
+    }
+
+    file.unmap(mapped);
+    file.close();
+
+    // Rebuild the BST over the new table
+    const StationTable& loaded = graph.getStationTable();
+    QList<int> liveIds;
+    liveIds.reserve(loaded.size());
+    for (int index : loaded.indices())
+    {
+        liveIds.append(loaded.idAt(index));
+    }
+
+    bst.clear();
+    bst.setStationTable(&loaded);
+    bst.insertBulk(liveIds);
+
+    LOG_INFO << "[INFO] Instantanea" << filename << "cargada. (" << loaded.size() << "estaciones,"
+             << header.edgeCount << "entradas de adyacencia)";
+    return true;
+}
+
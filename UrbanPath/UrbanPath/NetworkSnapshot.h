@@ -0,0 +1,46 @@
+#pragma once
+
+#include <QString>
+#include <QtGlobal>
+
+using namespace std;
+
+// Forward declarations
+class Graph;
+class StationBST;
+
+// Binary image of the whole network (stations, routes, closures and accidents)
+// used to skip the text parsers at startup.
+//
+// Layout: a fixed 64 byte header followed by 8-byte aligned sections:
+//   station columns  id, x, y, name offset, name length   (one entry per slot)
+//   routes (CSR)     offsets (slots + 1), target indices, weights
+//   string table     all station names, UTF-16
+//   closures         closed station IDs, closed routes (ID pairs)
+//   accidents        origin ID, destination ID, original weight
+// The payload is protected with an FNV-1a checksum. Loading maps the file and copies
+// each section once into the graph (no parsing); the mapping is not kept.
+class NetworkSnapshot
+{
+public:
+    static const quint32 FormatVersion = 1;
+
+    // Constructor
+    NetworkSnapshot() = default;
+
+    // Write the current network
+    bool save(const QString& filename, const Graph& graph);
+
+    // Replace graph and BST contents with the snapshot
+    bool load(const QString& filename, Graph& graph, StationBST& bst);
+
+    // Get last error
+    QString getLastError() const;
+
+private:
+    QString lastError;
+
+    // FNV-1a over 64-bit words (same hash as FileFingerprint)
+    static quint64 checksum(const char* data, qint64 size);
+};
+
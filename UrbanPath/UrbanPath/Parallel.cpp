@@ -0,0 +1,36 @@
+#include "Parallel.h"
+#include <QtGlobal>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+// Run every task on up to threadCount threads
+void Parallel::run(int count, int threadCount, const function<void(int)>& task)
+{
+    runWithWorker(count, threadCount, [&task](int index, int) {
+        task(index);
+    });
+}
+
+// Run every task, passing the worker number as well
+void Parallel::runWithWorker(int count, int threadCount, const function<void(int, int)>& task)
+{
+    atomic<int> next(0);
+    auto work = [&](int worker) {
+        for (int i = next++; i < count; i = next++)
+        {
+            task(i, worker);
+        }
+    };
+
+    vector<thread> workers;
+    for (int i = 1; i < qMin(count, threadCount); i++)
+    {
+        workers.emplace_back(work, i);
+    }
+    work(0);
+    for (thread& worker : workers)
+    {
+        worker.join();
+    }
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <functional>
+
+using namespace std;
+
+// Work sharing for the index builds, the multi-search queries and the route parser.
+// Tasks 0..count-1 are handed out one at a time (an atomic counter), so tasks of
+// uneven cost still spread over the threads. The calling thread takes part as
+// worker 0; the others are plain std::threads that live for one call.
+class Parallel
+{
+public:
+    // Run every task on up to threadCount threads; returns when all are done
+    static void run(int count, int threadCount, const function<void(int)>& task);
+
+    // Same, also passing the worker number (0 .. threadCount - 1) for per-thread work space
+    static void runWithWorker(int count, int threadCount, const function<void(int, int)>& task);
+};
@@ -0,0 +1,586 @@
+#include "RecordWriter.h"
+#include "Log.h"
+#include <QtEndian>
+#include <cmath>
+#include <cstring>
+
+static const char ColumnarMagic[8] = { 'U', 'P', 'C', 'O', 'L', 'v', '1', '\0' };
+static const quint32 ColumnarVersion = 1;
+
+// Columnar: write a fixed-size value, little-endian
+template <typename T>
+void RecordWriter::writeRaw(T value)
+{
+    T stored = qToLittleEndian(value);
+    out.writeBlock(reinterpret_cast<const char*>(&stored), sizeof(T));
+}
+
+// Columnar: append a fixed-size value to a column buffer, little-endian
+template <typename T>
+void RecordWriter::appendRaw(QByteArray& data, T value)
+{
+    T stored = qToLittleEndian(value);
+    data.append(reinterpret_cast<const char*>(&stored), sizeof(T));
+}
+
+// Constructor
+RecordWriter::RecordWriter(Format format)
+    : format(format), failed(false), tableId(-1), column(0), rowCount(0),
+      bytesFromClosedFiles(0), groupRows(0)
+{
+}
+
+// Destructor
+RecordWriter::~RecordWriter()
+{
+    close();
+}
+
+// Get file extension of a format
+QString RecordWriter::extension(Format format)
+{
+    switch (format)
+    {
+    case JsonLines:
+        return ".jsonl";
+    case Csv:
+        return ".csv";
+    case Columnar:
+        return ".upcol";
+    }
+    return QString();
+}
+
+// Open the output
+bool RecordWriter::open(const QString& basePath)
+{
+    close();
+
+    this->basePath = basePath;
+    lastError.clear();
+    failed = false;
+    tableId = -1;
+    column = 0;
+    rowCount = 0;
+    bytesFromClosedFiles = 0;
+    columns.clear();
+
+    // CSV opens one file per table in beginTable()
+    if (format == Csv)
+    {
+        return true;
+    }
+
+    QString path = basePath + extension(format);
+    if (!out.open(path, false, format != Columnar))
+    {
+        lastError = QString("No se pudo crear el archivo %1.").arg(path);
+        LOG_ERROR << "Error:" << lastError;
+        failed = true;
+        return false;
+    }
+
+    if (format == Columnar)
+    {
+        out.writeBlock(ColumnarMagic, sizeof(ColumnarMagic));
+        writeRaw<quint32>(ColumnarVersion);
+        writeRaw<quint32>(0);
+    }
+
+    return true;
+}
+
+// Finish and close the output
+bool RecordWriter::close()
+{
+    if (!out.isOpen())
+    {
+        return !failed;
+    }
+
+    finishTable();
+
+    if (format == Columnar)
+    {
+        out.writeBlock("END", 4);
+        writeRaw<quint64>(static_cast<quint64>(rowCount));
+    }
+
+    if (!out.close())
+    {
+        failed = true;
+        lastError = out.getLastError();
+    }
+
+    return !failed;
+}
+
+// Start a table
+bool RecordWriter::beginTable(const QString& name, const QList<Column>& columns)
+{
+    if (failed || (format != Csv && !out.isOpen()))
+    {
+        return false;
+    }
+
+    finishTable();
+
+    this->columns = columns;
+    tableId++;
+    column = 0;
+
+    if (format == JsonLines)
+    {
+        // Keys are built once per table; rows only copy them
+        jsonKeys.clear();
+        for (int i = 0; i < columns.size(); i++)
+        {
+            QByteArray key;
+            if (i == 0)
+            {
+                key += "{\"tabla\":\"";
+                key += name.toUtf8();
+                key += "\",\"";
+            }
+            else
+            {
+                key += ",\"";
+            }
+            key += columns[i].name.toUtf8();
+            key += "\":";
+            jsonKeys.append(key);
+        }
+    }
+    else if (format == Csv)
+    {
+        if (out.isOpen())
+        {
+            bytesFromClosedFiles += out.bytesWritten();
+            if (!out.close())
+            {
+                failed = true;
+                lastError = out.getLastError();
+                return false;
+            }
+        }
+
+        QString path = basePath + "_" + name + ".csv";
+        if (!out.open(path))
+        {
+            lastError = QString("No se pudo crear el archivo %1.").arg(path);
+            LOG_ERROR << "Error:" << lastError;
+            failed = true;
+            return false;
+        }
+
+        for (int i = 0; i < columns.size(); i++)
+        {
+            if (i > 0)
+            {
+                out << ',';
+            }
+            writeCsvString(columns[i].name);
+        }
+        out << '\n';
+    }
+    else
+    {
+        out.writeBlock("TABL", 4);
+        writeRaw<quint32>(static_cast<quint32>(tableId));
+        writeName(name);
+        writeRaw<quint16>(static_cast<quint16>(columns.size()));
+        for (const Column& col : columns)
+        {
+            writeRaw<quint8>(static_cast<quint8>(col.type));
+            writeName(col.name);
+        }
+
+        columnData.resize(columns.size());
+        textOffsets.resize(columns.size());
+        for (int i = 0; i < columns.size(); i++)
+        {
+            columnData[i].clear();
+            textOffsets[i].clear();
+            textOffsets[i].append(0);
+        }
+        groupRows = 0;
+    }
+
+    return true;
+}
+
+// Finish the current table
+void RecordWriter::finishTable()
+{
+    if (column > 0)
+    {
+        endRow();
+    }
+
+    if (format == Columnar)
+    {
+        flushGroup();
+    }
+}
+
+// Advance to the next field and write its separator
+bool RecordWriter::nextField(ColumnType& type)
+{
+    if (column >= columns.size())
+    {
+        if (tableId < 0 && lastError.isEmpty())
+        {
+            lastError = "Se escribio una fila antes de declarar la tabla.";
+            LOG_ERROR << "Error:" << lastError;
+        }
+        return false;
+    }
+
+    type = columns[column].type;
+
+    if (format == JsonLines)
+    {
+        const QByteArray& key = jsonKeys[column];
+        out.writeBlock(key.constData(), key.size());
+    }
+    else if (format == Csv && column > 0)
+    {
+        out << ',';
+    }
+
+    column++;
+    return true;
+}
+
+// Write an int field
+RecordWriter& RecordWriter::operator<<(int value)
+{
+    return *this << static_cast<qint64>(value);
+}
+
+// Write an integer field
+RecordWriter& RecordWriter::operator<<(qint64 value)
+{
+    ColumnType type;
+    if (!nextField(type))
+    {
+        return *this;
+    }
+
+    if (format != Columnar)
+    {
+        out << value;
+        return *this;
+    }
+
+    QByteArray& data = columnData[column - 1];
+    if (type == Integer)
+    {
+        appendRaw<qint64>(data, value);
+    }
+    else if (type == Real)
+    {
+        appendRaw<double>(data, static_cast<double>(value));
+    }
+    else
+    {
+        data += QByteArray::number(value);
+        textOffsets[column - 1].append(static_cast<quint32>(data.size()));
+    }
+    return *this;
+}
+
+// Write a real field
+RecordWriter& RecordWriter::operator<<(double value)
+{
+    ColumnType type;
+    if (!nextField(type))
+    {
+        return *this;
+    }
+
+    if (format != Columnar)
+    {
+        // NaN and infinity have no JSON form: null (JSON) or empty (CSV)
+        if (std::isfinite(value))
+        {
+            out.writeDouble(value);
+        }
+        else if (format == JsonLines)
+        {
+            out << "null";
+        }
+        return *this;
+    }
+
+    QByteArray& data = columnData[column - 1];
+    if (type == Real)
+    {
+        appendRaw<double>(data, value);
+    }
+    else if (type == Integer)
+    {
+        appendRaw<qint64>(data, std::isfinite(value) ? static_cast<qint64>(std::llround(value)) : 0);
+    }
+    else
+    {
+        data += QByteArray::number(value, 'g', 17);
+        textOffsets[column - 1].append(static_cast<quint32>(data.size()));
+    }
+    return *this;
+}
+
+// Write a text field
+RecordWriter& RecordWriter::operator<<(QStringView value)
+{
+    ColumnType type;
+    if (!nextField(type))
+    {
+        return *this;
+    }
+
+    if (format == JsonLines)
+    {
+        writeJsonString(value);
+        return *this;
+    }
+    if (format == Csv)
+    {
+        writeCsvString(value);
+        return *this;
+    }
+
+    QByteArray& data = columnData[column - 1];
+    if (type == Text)
+    {
+        data += value.toUtf8();
+        textOffsets[column - 1].append(static_cast<quint32>(data.size()));
+    }
+    else if (type == Integer)
+    {
+        appendRaw<qint64>(data, value.toString().toLongLong());
+    }
+    else
+    {
+        appendRaw<double>(data, value.toDouble());
+    }
+    return *this;
+}
+
+// Write a QString field
+RecordWriter& RecordWriter::operator<<(const QString& value)
+{
+    return *this << QStringView(value);
+}
+
+// Write a C string field
+RecordWriter& RecordWriter::operator<<(const char* value)
+{
+    return *this << QString::fromUtf8(value);
+}
+
+// Finish the current row
+void RecordWriter::endRow()
+{
+    if (columns.isEmpty())
+    {
+        return;
+    }
+
+    // Missing fields are written empty
+    while (column < columns.size())
+    {
+        ColumnType type = columns[column].type;
+        if (format == Columnar)
+        {
+            nextField(type);
+            QByteArray& data = columnData[column - 1];
+            if (type == Integer)
+            {
+                appendRaw<qint64>(data, 0);
+            }
+            else if (type == Real)
+            {
+                appendRaw<double>(data, std::nan(""));
+            }
+            else
+            {
+                textOffsets[column - 1].append(static_cast<quint32>(data.size()));
+            }
+        }
+        else if (format == JsonLines)
+        {
+            nextField(type);
+            out << "null";
+        }
+        else
+        {
+            nextField(type);
+        }
+    }
+
+    if (format == JsonLines)
+    {
+        out << "}\n";
+    }
+    else if (format == Csv)
+    {
+        out << '\n';
+    }
+    else if (++groupRows >= GroupRows)
+    {
+        flushGroup();
+    }
+
+    column = 0;
+    rowCount++;
+}
+
+// Write a JSON string (quoted and escaped)
+void RecordWriter::writeJsonString(QStringView value)
+{
+    out << '"';
+
+    qsizetype start = 0;
+    for (qsizetype i = 0; i < value.size(); i++)
+    {
+        char16_t c = value.utf16()[i];
+        if (c != '"' && c != '\\' && c >= 0x20)
+        {
+            continue;
+        }
+
+        out << value.mid(start, i - start);
+        switch (c)
+        {
+        case '"':
+            out << "\\\"";
+            break;
+        case '\\':
+            out << "\\\\";
+            break;
+        case '\n':
+            out << "\\n";
+            break;
+        case '\r':
+            out << "\\r";
+            break;
+        case '\t':
+            out << "\\t";
+            break;
+        default:
+        {
+            static const char hex[] = "0123456789abcdef";
+            char escaped[7] = { '\\', 'u', '0', '0', hex[(c >> 4) & 0xF], hex[c & 0xF], '\0' };
+            out << escaped;
+            break;
+        }
+        }
+        start = i + 1;
+    }
+
+    out << value.mid(start) << '"';
+}
+
+// Write a CSV field (quoted only when needed)
+void RecordWriter::writeCsvString(QStringView value)
+{
+    bool needsQuotes = false;
+    for (QChar c : value)
+    {
+        if (c == ',' || c == '"' || c == '\n' || c == '\r')
+        {
+            needsQuotes = true;
+            break;
+        }
+    }
+
+    if (!needsQuotes)
+    {
+        out << value;
+        return;
+    }
+
+    out << '"';
+    qsizetype start = 0;
+    for (qsizetype i = 0; i < value.size(); i++)
+    {
+        if (value[i] == '"')
+        {
+            out << value.mid(start, i + 1 - start) << '"';
+            start = i + 1;
+        }
+    }
+    out << value.mid(start) << '"';
+}
+
+// Columnar: write a name (u16 length + UTF-8)
+void RecordWriter::writeName(const QString& name)
+{
+    QByteArray bytes = name.toUtf8();
+    writeRaw<quint16>(static_cast<quint16>(bytes.size()));
+    out.writeBlock(bytes.constData(), bytes.size());
+}
+
+// Columnar: write the buffered rows of the current table
+void RecordWriter::flushGroup()
+{
+    if (groupRows == 0)
+    {
+        return;
+    }
+
+    static const char padding[8] = {};
+
+    out.writeBlock("ROWS", 4);
+    writeRaw<quint32>(static_cast<quint32>(tableId));
+    writeRaw<quint32>(static_cast<quint32>(groupRows));
+
+    for (int i = 0; i < columns.size(); i++)
+    {
+        QByteArray& data = columnData[i];
+        qint64 length = data.size();
+
+        // Pad to the file position, so the data after the u64 length starts 8-byte aligned
+        out.writeBlock(padding, (8 - out.bytesWritten() % 8) % 8);
+
+        if (columns[i].type == Text)
+        {
+            QVector<quint32>& offsets = textOffsets[i];
+            qint64 offsetBytes = offsets.size() * static_cast<qint64>(sizeof(quint32));
+            qToLittleEndian<quint32>(offsets.constData(), offsets.size(), offsets.data());
+            writeRaw<quint64>(static_cast<quint64>(offsetBytes + length));
+            out.writeBlock(reinterpret_cast<const char*>(offsets.constData()), offsetBytes);
+        }
+        else
+        {
+            writeRaw<quint64>(static_cast<quint64>(length));
+        }
+
+        out.writeBlock(data.constData(), data.size());
+
+        data.resize(0);
+        textOffsets[i].resize(1);
+    }
+
+    groupRows = 0;
+}
+
+// Get rows written
+qint64 RecordWriter::getRowCount() const
+{
+    return rowCount;
+}
+
+// Get bytes written
+qint64 RecordWriter::bytesWritten() const
+{
+    return bytesFromClosedFiles + out.bytesWritten();
+}
+
+// Get last error message
+QString RecordWriter::getLastError() const
+{
+    return lastError;
+}
+
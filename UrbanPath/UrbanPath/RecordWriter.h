@@ -0,0 +1,124 @@
+#pragma once
+
+#include "ReportWriter.h"
+#include <QString>
+#include <QStringView>
+#include <QList>
+#include <QVector>
+#include <QByteArray>
+
+using namespace std;
+
+// Streaming writer for the machine-readable report formats.
+// A report is a sequence of tables; each table declares its columns once and
+// rows are written field by field, straight into the output buffer.
+//
+//   JsonLines  one JSON object per row: {"tabla":"<table>","<column>":value,...}
+//   Csv        one file per table, <base>_<table>.csv, with a header row
+//   Columnar   binary, little-endian, columns stored contiguously in row groups:
+//                file header   "UPCOLv1\0", u32 version, u32 reserved
+//                table block   "TABL", u32 table id, name, u16 column count,
+//                              per column: u8 type (0 integer, 1 real, 2 text), name
+//                row group     "ROWS", u32 table id, u32 row count, then per column:
+//                              zero padding up to a multiple of 8 in the file,
+//                              u64 byte length + data (so every column's data starts
+//                              8-byte aligned and can be mapped as an array)
+//                                integer  i64[rows]
+//                                real     f64[rows]
+//                                text     u32 offsets[rows + 1] + UTF-8 bytes
+//                end block     "END\0", u64 total rows
+//              Names are u16 byte length + UTF-8. Row groups hold up to GroupRows rows,
+//              so memory stays bounded while a table is streamed.
+class RecordWriter
+{
+public:
+    enum Format
+    {
+        JsonLines,
+        Csv,
+        Columnar
+    };
+
+    enum ColumnType
+    {
+        Integer,
+        Real,
+        Text
+    };
+
+    struct Column
+    {
+        QString name;
+        ColumnType type;
+    };
+
+    static const int GroupRows = 65536;
+
+    // Constructor and Destructor (the output is closed)
+    explicit RecordWriter(Format format);
+    ~RecordWriter();
+
+    // Open the output; 'basePath' is the report path without extension
+    bool open(const QString& basePath);
+
+    // Finish the current table and close; false if any write failed
+    bool close();
+
+    // Start a table (finishes the previous one)
+    bool beginTable(const QString& name, const QList<Column>& columns);
+
+    // Fields of the current row, in column order
+    RecordWriter& operator<<(int value);
+    RecordWriter& operator<<(qint64 value);
+    RecordWriter& operator<<(double value);
+    RecordWriter& operator<<(QStringView value);
+    RecordWriter& operator<<(const QString& value);
+    RecordWriter& operator<<(const char* value);
+
+    // Finish the current row
+    void endRow();
+
+    // File extension of a format (".jsonl", ".csv", ".upcol")
+    static QString extension(Format format);
+
+    // Statistics
+    qint64 getRowCount() const;
+    qint64 bytesWritten() const;
+
+    // Get last error
+    QString getLastError() const;
+
+private:
+    Format format;
+    ReportWriter out;
+    QString basePath;
+    QString lastError;
+    bool failed;
+
+    // Current table
+    QList<Column> columns;
+    QVector<QByteArray> jsonKeys;    // ,"<column>": (first one opens the object)
+    int tableId;
+    int column;                      // Next field of the row
+    qint64 rowCount;
+    qint64 bytesFromClosedFiles;     // CSV: output of the tables already closed
+
+    // Columnar row group
+    QVector<QByteArray> columnData;
+    QVector<QVector<quint32>> textOffsets;
+    int groupRows;
+
+    // Field helpers
+    bool nextField(ColumnType& type);
+    void writeText(QStringView value);
+    void writeJsonString(QStringView value);
+    void writeCsvString(QStringView value);
+
+    // Columnar helpers
+    void writeName(const QString& name);
+    void flushGroup();
+    void finishTable();
+    template <typename T> void writeRaw(T value);
+    template <typename T> static void appendRaw(QByteArray& data, T value);
+};
+
@@ -1,7 +1,9 @@
 #include "ReportGenerator.h"
 #include "Graph.h"
 #include "StationBST.h"
-#include <QDebug>
+#include "NetworkAnalysis.h"
+#include "Log.h"
+#include <cmath>
 
 // Get last error message
 QString ReportGenerator::getLastError() const
@@ -9,6 +11,73 @@ QString ReportGenerator::getLastError() const
     return lastError;
 }
 
+// Set output format
+void ReportGenerator::setOutputFormat(OutputFormat format)
+{
+    outputFormat = format;
+}
+
+// Get output format
+ReportGenerator::OutputFormat ReportGenerator::getOutputFormat() const
+{
+    return outputFormat;
+}
+
+// File written for a report name in a format
+QString ReportGenerator::outputPath(const QString& filename, OutputFormat format)
+{
+    if (format == Text)
+    {
+        return filename;
+    }
+    
+    QString base = filename.endsWith(".txt") ? filename.left(filename.length() - 4) : filename;
+    return base + RecordWriter::extension(static_cast<RecordWriter::Format>(format - JsonLines));
+}
+
+// Get size of the last report
+qint64 ReportGenerator::getLastReportBytes() const
+{
+    return lastReportBytes;
+}
+
+// Get output speed of the last report in MB/s
+double ReportGenerator::getLastReportThroughput() const
+{
+    return lastReportThroughput;
+}
+
+// Open a report file
+bool ReportGenerator::openReport(ReportWriter& out, const QString& filename, bool append)
+{
+    if (!out.open(filename, append))
+    {
+        lastError = append ? QString("No se pudo abrir el archivo %1 para agregar contenido.").arg(filename)
+                           : QString("No se pudo crear el archivo %1.").arg(filename);
+        LOG_ERROR << "Error:" << lastError;
+        return false;
+    }
+    
+    return true;
+}
+
+// Close a report file and record its size and output speed
+bool ReportGenerator::finishReport(ReportWriter& out, const QString& filename)
+{
+    if (!out.close())
+    {
+        lastError = out.getLastError();
+        return false;
+    }
+    
+    lastReportBytes = out.bytesWritten();
+    lastReportThroughput = out.throughputMBs();
+    
+    LOG_INFO << "[INFO]" << filename << ":" << lastReportBytes / 1024 << "KB en"
+             << out.elapsedNanoseconds() / 1000000.0 << "ms (" << lastReportThroughput << "MB/s)";
+    return true;
+}
+
 // Format current date and time
 QString ReportGenerator::formatDateTime() const
 {
@@ -16,29 +85,34 @@ QString ReportGenerator::formatDateTime() const
     return now.toString("yyyy-MM-dd HH:mm:ss");
 }
 
-// Format station information
-QString ReportGenerator::formatStationInfo(int id, const QString& name, double x, double y) const
+// Write station information
+void ReportGenerator::writeStationInfo(ReportWriter& out, int id, QStringView name, double x, double y)
+{
+    out << "Estacion " << id << ": " << name << " (X: ";
+    out.writeFixed(x, 1) << ", Y: ";
+    out.writeFixed(y, 1) << ')';
+}
+
+// Write station information straight from the station table
+void ReportGenerator::writeStationInfo(ReportWriter& out, const StationTable& table, int index)
 {
-    return QString("Estacion %1: %2 (X: %3, Y: %4)")
-        .arg(id)
-        .arg(name)
-        .arg(x, 0, 'f', 1)
-        .arg(y, 0, 'f', 1);
+    writeStationInfo(out, table.idAt(index), table.nameViewAt(index), table.xAt(index), table.yAt(index));
 }
 
 // Write report header
-void ReportGenerator::writeHeader(QTextStream& out, const QString& title)
+void ReportGenerator::writeHeader(ReportWriter& out, const QString& title)
 {
+    QDateTime now = QDateTime::currentDateTime();
     out << "========================================\n";
     out << "  " << title << "\n";
     out << "========================================\n";
-    out << "Fecha: " << QDateTime::currentDateTime().toString("yyyy-MM-dd") << "\n";
-    out << "Hora: " << QDateTime::currentDateTime().toString("HH:mm:ss") << "\n";
+    out << "Fecha: " << now.toString("yyyy-MM-dd") << "\n";
+    out << "Hora: " << now.toString("HH:mm:ss") << "\n";
     out << "========================================\n\n";
 }
 
 // Write report footer
-void ReportGenerator::writeFooter(QTextStream& out)
+void ReportGenerator::writeFooter(ReportWriter& out)
 {
     out << "\n========================================\n";
     out << "  Fin del reporte\n";
@@ -46,14 +120,14 @@ void ReportGenerator::writeFooter(QTextStream& out)
 }
 
 // Write section title
-void ReportGenerator::writeSectionTitle(QTextStream& out, const QString& title)
+void ReportGenerator::writeSectionTitle(ReportWriter& out, const QString& title)
 {
     out << "\n" << title << "\n";
-    out << QString(title.length(), '-') << "\n";
+    out.writeRepeated('-', static_cast<int>(title.length())) << "\n";
 }
 
 // Write separator line
-void ReportGenerator::writeSeparator(QTextStream& out)
+void ReportGenerator::writeSeparator(ReportWriter& out)
 {
     out << "----------------------------------------\n";
 }
@@ -61,17 +135,18 @@ void ReportGenerator::writeSeparator(QTextStream& out)
 // Generate route report (shortest path or specific route)
 bool ReportGenerator::generateRouteReport(const QString& filename, const QList<int>& route, const Graph& graph)
 {
-    QFile file(filename);
+    if (outputFormat != Text)
+    {
+        return writeRouteRecords(filename, route, graph);
+    }
+    
+    ReportWriter out;
     
-    if (!file.open(QIODevice::WriteOnly | QIODevice::Text))
+    if (!openReport(out, filename))
     {
-        lastError = QString("No se pudo crear el archivo %1.").arg(filename);
-        qDebug() << "Error:" << lastError;
         return false;
     }
     
-    QTextStream out(&file);
-    
     // Write header
     writeHeader(out, "REPORTE DE RUTA");
     
@@ -84,32 +159,30 @@ bool ReportGenerator::generateRouteReport(const QString& filename, const QList<i
     {
         out << "\nNo hay ruta disponible.\n";
         writeFooter(out);
-        file.close();
-        qDebug() << "Reporte de ruta generado:" << filename;
-        return true;
+        LOG_INFO << "Reporte de ruta generado:" << filename;
+        return finishReport(out, filename);
     }
     
     out << "\nRecorrido:\n";
     
     double totalDistance = 0.0;
     
+    const StationTable& table = graph.getStationTable();
+    
     for (int i = 0; i < route.size(); i++)
     {
         int stationId = route[i];
-        Station* station = const_cast<Graph&>(graph).getStation(stationId);
+        int index = table.indexOf(stationId);
         
-        if (station != nullptr)
+        if (index != StationTable::InvalidIndex)
         {
-            out << QString("  %1. %2\n")
-                .arg(i + 1)
-                .arg(formatStationInfo(station->getId(), station->getName(), 
-                                      station->getX(), station->getY()));
+            out << "  " << (i + 1) << ". ";
+            writeStationInfo(out, table, index);
+            out << '\n';
         }
         else
         {
-            out << QString("  %1. Estacion %2 (informacion no disponible)\n")
-                .arg(i + 1)
-                .arg(stationId);
+            out << "  " << (i + 1) << ". Estacion " << stationId << " (informacion no disponible)\n";
         }
         
         // Calculate distance to next station
@@ -121,7 +194,8 @@ bool ReportGenerator::generateRouteReport(const QString& filename, const QList<i
             if (weight < std::numeric_limits<double>::infinity())
             {
                 totalDistance += weight;
-                out << QString("     -> Distancia al siguiente: %1\n").arg(weight, 0, 'f', 1);
+                out << "     -> Distancia al siguiente: ";
+                out.writeFixed(weight, 1) << '\n';
             }
             else
             {
@@ -131,30 +205,64 @@ bool ReportGenerator::generateRouteReport(const QString& filename, const QList<i
     }
     
     writeSeparator(out);
-    out << QString("Distancia total de la ruta: %1\n").arg(totalDistance, 0, 'f', 1);
+    out << "Distancia total de la ruta: ";
+    out.writeFixed(totalDistance, 1) << '\n';
     
     // Write footer
     writeFooter(out);
     
-    file.close();
+    if (!finishReport(out, filename))
+    {
+        return false;
+    }
     
-    qDebug() << "Reporte de ruta generado exitosamente:" << filename;
+    LOG_INFO << "Reporte de ruta generado exitosamente:" << filename;
     return true;
 }
 
 // Generate traversal report (InOrder, PreOrder, PostOrder)
 bool ReportGenerator::generateTraversalReport(const QString& filename, const StationBST& bst)
 {
-    QFile file(filename);
+    if (!bst.getStationTable())
+    {
+        lastError = "El arbol de estaciones no tiene tabla de estaciones asociada.";
+        LOG_ERROR << "Error:" << lastError;
+        return false;
+    }
     
-    if (!file.open(QIODevice::WriteOnly | QIODevice::Text))
+    return writeTraversalReport(filename, *bst.getStationTable(), bst.inOrder(), bst.preOrder(), bst.postOrder());
+}
+
+// Generate traversal report from the traversals captured in the analysis
+bool ReportGenerator::generateTraversalReport(const QString& filename, const NetworkAnalysis& analysis)
+{
+    if (!analysis.hasTraversals())
     {
-        lastError = QString("No se pudo crear el archivo %1.").arg(filename);
-        qDebug() << "Error:" << lastError;
+        lastError = "El analisis no incluye los recorridos del arbol de estaciones.";
+        LOG_ERROR << "Error:" << lastError;
         return false;
     }
     
-    QTextStream out(&file);
+    return writeTraversalReport(filename, analysis.getStationTable(),
+                                analysis.getInOrder(), analysis.getPreOrder(), analysis.getPostOrder());
+}
+
+// Write the traversal report
+bool ReportGenerator::writeTraversalReport(const QString& filename, const StationTable& table,
+                                           const QList<int>& inOrderList, const QList<int>& preOrderList,
+                                           const QList<int>& postOrderList)
+{
+    if (outputFormat != Text)
+    {
+        return writeTraversalRecords(filename, table, inOrderList, preOrderList, postOrderList);
+    }
+    
+    ReportWriter out;
+    
+    if (!openReport(out, filename))
+    {
+        return false;
+    }
     
     // Write header
     writeHeader(out, "REPORTE DE RECORRIDOS DEL ARBOL BST");
@@ -163,132 +271,123 @@ bool ReportGenerator::generateTraversalReport(const QString& filename, const Sta
     writeSectionTitle(out, "RECORRIDO IN-ORDER (Izquierda - Raiz - Derecha)");
     out << "Orden: Ascendente por ID de estacion\n\n";
     
-    QList<Station> inOrderList = bst.inOrder();
     for (int i = 0; i < inOrderList.size(); i++)
     {
-        const Station& station = inOrderList[i];
-        out << QString("  %1. %2\n")
-            .arg(i + 1)
-            .arg(formatStationInfo(station.getId(), station.getName(), 
-                                  station.getX(), station.getY()));
+        out << "  " << (i + 1) << ". ";
+        writeStationInfo(out, table, inOrderList[i]);
+        out << '\n';
     }
     
-    out << QString("\nTotal de estaciones (InOrder): %1\n").arg(inOrderList.size());
+    out << "\nTotal de estaciones (InOrder): " << inOrderList.size() << "\n";
     
     // PreOrder traversal
     writeSectionTitle(out, "RECORRIDO PRE-ORDER (Raiz - Izquierda - Derecha)");
     out << "Orden: Visita raiz primero, luego subarboles\n\n";
     
-    QList<Station> preOrderList = bst.preOrder();
     for (int i = 0; i < preOrderList.size(); i++)
     {
-        const Station& station = preOrderList[i];
-        out << QString("  %1. %2\n")
-            .arg(i + 1)
-            .arg(formatStationInfo(station.getId(), station.getName(), 
-                                  station.getX(), station.getY()));
+        out << "  " << (i + 1) << ". ";
+        writeStationInfo(out, table, preOrderList[i]);
+        out << '\n';
     }
     
-    out << QString("\nTotal de estaciones (PreOrder): %1\n").arg(preOrderList.size());
+    out << "\nTotal de estaciones (PreOrder): " << preOrderList.size() << "\n";
     
     // PostOrder traversal
     writeSectionTitle(out, "RECORRIDO POST-ORDER (Izquierda - Derecha - Raiz)");
     out << "Orden: Visita subarboles primero, luego raiz\n\n";
     
-    QList<Station> postOrderList = bst.postOrder();
     for (int i = 0; i < postOrderList.size(); i++)
     {
-        const Station& station = postOrderList[i];
-        out << QString("  %1. %2\n")
-            .arg(i + 1)
-            .arg(formatStationInfo(station.getId(), station.getName(), 
-                                  station.getX(), station.getY()));
+        out << "  " << (i + 1) << ". ";
+        writeStationInfo(out, table, postOrderList[i]);
+        out << '\n';
     }
     
-    out << QString("\nTotal de estaciones (PostOrder): %1\n").arg(postOrderList.size());
+    out << "\nTotal de estaciones (PostOrder): " << postOrderList.size() << "\n";
     
     // Write footer
     writeFooter(out);
     
-    file.close();
+    if (!finishReport(out, filename))
+    {
+        return false;
+    }
     
-    qDebug() << "Reporte de recorridos generado exitosamente:" << filename;
+    LOG_INFO << "Reporte de recorridos generado exitosamente:" << filename;
     return true;
 }
 
 // Generate system statistics report
 bool ReportGenerator::generateSystemStats(const QString& filename, const Graph& graph, const StationBST& bst)
 {
-    QFile file(filename);
+    NetworkAnalysis analysis(graph);
+    analysis.captureTraversals(bst);
+    analysis.compute(NetworkAnalysis::KruskalMST | NetworkAnalysis::Degrees);
+    return generateSystemStats(filename, analysis);
+}
+
+// Generate system statistics report from a precomputed analysis
+bool ReportGenerator::generateSystemStats(const QString& filename, const NetworkAnalysis& analysis)
+{
+    if (outputFormat != Text)
+    {
+        return writeStatsRecords(filename, analysis);
+    }
+    
+    ReportWriter out;
     
-    if (!file.open(QIODevice::WriteOnly | QIODevice::Text))
+    if (!openReport(out, filename))
     {
-        lastError = QString("No se pudo crear el archivo %1.").arg(filename);
-        qDebug() << "Error:" << lastError;
         return false;
     }
     
-    QTextStream out(&file);
-    
     // Write header
     writeHeader(out, "ESTADISTICAS DEL SISTEMA URBANPATH");
     
     // General statistics
     writeSectionTitle(out, "ESTADISTICAS GENERALES");
     
-    int totalStations = graph.getStationCount();
-    int totalStationsBST = bst.count();
-    
-    out << QString("Total de estaciones en el grafo: %1\n").arg(totalStations);
-    out << QString("Total de estaciones en el BST: %1\n").arg(totalStationsBST);
+    const StationTable& table = analysis.getStationTable();
+    const QList<int>& stationIndices = analysis.getStationIndices();
+    int totalStations = stationIndices.size();
     
-    // Count total routes
-    int totalRoutes = 0;
-    QList<Station> stations = graph.getAllStations();
-    for (const Station& station : stations)
-    {
-        QList<QPair<int, double>> neighbors = graph.getNeighbors(station.getId());
-        totalRoutes += neighbors.size();
-    }
-    // For undirected graphs, divide by 2
-    totalRoutes /= 2;
+    out << "Total de estaciones en el grafo: " << totalStations << "\n";
+    out << "Total de estaciones en el BST: " << analysis.getBSTCount() << "\n";
     
-    out << QString("Total de rutas (conexiones): %1\n").arg(totalRoutes);
-    out << QString("Tipo de grafo: No dirigido\n");
+    out << "Total de rutas (conexiones): " << analysis.getTotalRoutes() << "\n";
+    out << (analysis.getGraph().isDirected() ? "Tipo de grafo: Dirigido\n" : "Tipo de grafo: No dirigido\n");
     
-    // Calculate average connectivity
-    double avgConnectivity = totalStations > 0 ? 
-        (2.0 * totalRoutes) / totalStations : 0.0;
-    out << QString("Conectividad promedio por estacion: %1\n")
-        .arg(avgConnectivity, 0, 'f', 2);
+    // Average and range of routes per station
+    out << "Conectividad promedio por estacion: ";
+    out.writeFixed(analysis.getAverageDegree(), 2) << "\n";
+    out << "Conexiones minimas / maximas por estacion: " << analysis.getMinDegree()
+        << " / " << analysis.getMaxDegree() << "\n";
     
     // Minimum Spanning Tree statistics
     writeSectionTitle(out, "ARBOL DE EXPANSION MINIMA (MST)");
     
     if (totalStations > 0)
     {
-        QList<QPair<int, int>> mstEdges = const_cast<Graph&>(graph).kruskalMST();
-        double mstWeight = 0.0;
+        const QList<Edge>& mstEdges = analysis.getKruskalEdges();
+        double mstWeight = analysis.getKruskalWeight();
         
         out << "Aristas del MST:\n";
-        for (const auto& edge : mstEdges)
+        for (const Edge& edge : mstEdges)
         {
-            double weight = graph.getEdgeWeight(edge.first, edge.second);
-            mstWeight += weight;
-            out << QString("  Estacion %1 <-> Estacion %2: %3\n")
-                .arg(edge.first)
-                .arg(edge.second)
-                .arg(weight, 0, 'f', 1);
+            out << "  Estacion " << edge.from << " <-> Estacion " << edge.to << ": ";
+            out.writeFixed(edge.weight, 1) << '\n';
         }
         
-        out << QString("\nTotal de aristas en MST: %1\n").arg(mstEdges.size());
-        out << QString("Peso total del MST: %1\n").arg(mstWeight, 0, 'f', 1);
+        out << "\nTotal de aristas en MST: " << mstEdges.size() << "\n";
+        out << "Peso total del MST: ";
+        out.writeFixed(mstWeight, 1) << "\n";
         
         if (totalStations > 1)
         {
             double avgMSTWeight = mstWeight / mstEdges.size();
-            out << QString("Peso promedio por arista: %1\n")
-                .arg(avgMSTWeight, 0, 'f', 2);
+            out << "Peso promedio por arista: ";
+            out.writeFixed(avgMSTWeight, 2) << "\n";
         }
     }
     else
@@ -299,133 +398,148 @@ bool ReportGenerator::generateSystemStats(const QString& filename, const Graph&
     // Station list
     writeSectionTitle(out, "LISTADO DE ESTACIONES");
     
-    QList<Station> allStations = graph.getAllStations();
-    for (int i = 0; i < allStations.size(); i++)
+    for (int i = 0; i < stationIndices.size(); i++)
     {
-        const Station& station = allStations[i];
-        out << QString("  %1. %2\n")
-            .arg(i + 1)
-            .arg(formatStationInfo(station.getId(), station.getName(), 
-                                  station.getX(), station.getY()));
+        int index = stationIndices[i];
+        out << "  " << (i + 1) << ". ";
+        writeStationInfo(out, table, index);
+        out << '\n';
         
         // Show connections
-        QList<QPair<int, double>> neighbors = graph.getNeighbors(station.getId());
-        out << QString("     Conexiones: %1\n").arg(neighbors.size());
+        out << "     Conexiones: " << analysis.degreeAt(index) << "\n";
     }
     
     // Write footer
     writeFooter(out);
     
-    file.close();
+    if (!finishReport(out, filename))
+    {
+        return false;
+    }
     
-    qDebug() << "Reporte de estadisticas generado exitosamente:" << filename;
+    LOG_INFO << "Reporte de estadisticas generado exitosamente:" << filename;
     return true;
 }
 
 // Generate MST-specific report
 bool ReportGenerator::generateMSTReport(const QString& filename, const Graph& graph)
 {
-    QFile file(filename);
+    NetworkAnalysis analysis(graph);
+    analysis.compute(NetworkAnalysis::KruskalMST | NetworkAnalysis::PrimMST);
+    return generateMSTReport(filename, analysis);
+}
+
+// Generate MST-specific report from a precomputed analysis
+bool ReportGenerator::generateMSTReport(const QString& filename, const NetworkAnalysis& analysis)
+{
+    if (outputFormat != Text)
+    {
+        return writeMSTRecords(filename, analysis);
+    }
     
-    if (!file.open(QIODevice::WriteOnly | QIODevice::Text))
+    ReportWriter out;
+    
+    if (!openReport(out, filename))
     {
-        lastError = QString("No se pudo crear el archivo %1.").arg(filename);
-        qDebug() << "Error:" << lastError;
         return false;
     }
     
-    QTextStream out(&file);
-    
     // Write header
     writeHeader(out, "REPORTE DE ARBOL DE EXPANSION MINIMA");
     
     // Kruskal MST
     writeSectionTitle(out, "ALGORITMO DE KRUSKAL");
     
-    QList<QPair<int, int>> kruskalEdges = const_cast<Graph&>(graph).kruskalMST();
-    double kruskalWeight = 0.0;
+    const QList<Edge>& kruskalEdges = analysis.getKruskalEdges();
+    double kruskalWeight = analysis.getKruskalWeight();
     
     out << "Aristas seleccionadas (ordenadas por peso):\n";
     for (int i = 0; i < kruskalEdges.size(); i++)
     {
-        const auto& edge = kruskalEdges[i];
-        double weight = graph.getEdgeWeight(edge.first, edge.second);
-        kruskalWeight += weight;
-        
-        out << QString("  %1. (%2, %3) - Peso: %4\n")
-            .arg(i + 1)
-            .arg(edge.first)
-            .arg(edge.second)
-            .arg(weight, 0, 'f', 1);
+        const Edge& edge = kruskalEdges[i];
+        out << "  " << (i + 1) << ". (" << edge.from << ", " << edge.to << ") - Peso: ";
+        out.writeFixed(edge.weight, 1) << '\n';
     }
     
-    out << QString("\nPeso total (Kruskal): %1\n").arg(kruskalWeight, 0, 'f', 1);
-    out << QString("Total de aristas: %1\n").arg(kruskalEdges.size());
+    out << "\nPeso total (Kruskal): ";
+    out.writeFixed(kruskalWeight, 1) << "\n";
+    out << "Total de aristas: " << kruskalEdges.size() << "\n";
     
     // Prim MST
     writeSectionTitle(out, "ALGORITMO DE PRIM");
     
-    QList<QPair<int, int>> primEdges = const_cast<Graph&>(graph).primMST();
-    double primWeight = 0.0;
+    const QList<Edge>& primEdges = analysis.getPrimEdges();
+    double primWeight = analysis.getPrimWeight();
     
     out << "Aristas seleccionadas (orden de construccion):\n";
     for (int i = 0; i < primEdges.size(); i++)
     {
-        const auto& edge = primEdges[i];
-        double weight = graph.getEdgeWeight(edge.first, edge.second);
-        primWeight += weight;
-        
-        out << QString("  %1. (%2, %3) - Peso: %4\n")
-            .arg(i + 1)
-            .arg(edge.first)
-            .arg(edge.second)
-            .arg(weight, 0, 'f', 1);
+        const Edge& edge = primEdges[i];
+        out << "  " << (i + 1) << ". (" << edge.from << ", " << edge.to << ") - Peso: ";
+        out.writeFixed(edge.weight, 1) << '\n';
     }
     
-    out << QString("\nPeso total (Prim): %1\n").arg(primWeight, 0, 'f', 1);
-    out << QString("Total de aristas: %1\n").arg(primEdges.size());
+    out << "\nPeso total (Prim): ";
+    out.writeFixed(primWeight, 1) << "\n";
+    out << "Total de aristas: " << primEdges.size() << "\n";
     
     // Comparison
     writeSectionTitle(out, "COMPARACION DE ALGORITMOS");
-    out << QString("Peso Kruskal: %1\n").arg(kruskalWeight, 0, 'f', 1);
-    out << QString("Peso Prim: %1\n").arg(primWeight, 0, 'f', 1);
-    out << QString("Diferencia: %1\n").arg(qAbs(kruskalWeight - primWeight), 0, 'f', 4);
+    out << "Peso Kruskal: ";
+    out.writeFixed(kruskalWeight, 1) << "\n";
+    out << "Peso Prim: ";
+    out.writeFixed(primWeight, 1) << "\n";
+    out << "Diferencia: ";
+    out.writeFixed(qAbs(kruskalWeight - primWeight), 4) << "\n";
     out << "Nota: Ambos algoritmos deben producir el mismo peso total.\n";
     
     // Write footer
     writeFooter(out);
     
-    file.close();
+    if (!finishReport(out, filename))
+    {
+        return false;
+    }
     
-    qDebug() << "Reporte de MST generado exitosamente:" << filename;
+    LOG_INFO << "Reporte de MST generado exitosamente:" << filename;
     return true;
 }
 
 // Generate connectivity report
 bool ReportGenerator::generateConnectivityReport(const QString& filename, const Graph& graph)
 {
-    QFile file(filename);
+    NetworkAnalysis analysis(graph);
+    analysis.compute(NetworkAnalysis::Components | NetworkAnalysis::Reachability);
+    return generateConnectivityReport(filename, analysis);
+}
+
+// Generate connectivity report from a precomputed analysis
+bool ReportGenerator::generateConnectivityReport(const QString& filename, const NetworkAnalysis& analysis)
+{
+    if (outputFormat != Text)
+    {
+        return writeConnectivityRecords(filename, analysis);
+    }
     
-    if (!file.open(QIODevice::WriteOnly | QIODevice::Text))
+    ReportWriter out;
+    
+    if (!openReport(out, filename))
     {
-        lastError = QString("No se pudo crear el archivo %1.").arg(filename);
-        qDebug() << "Error:" << lastError;
         return false;
     }
     
-    QTextStream out(&file);
-    
     // Write header
     writeHeader(out, "REPORTE DE CONECTIVIDAD DEL SISTEMA");
     
-    QList<Station> stations = graph.getAllStations();
+    const Graph& graph = analysis.getGraph();
+    const StationTable& table = analysis.getStationTable();
+    const QList<int>& stations = analysis.getStationIndices();
     
     if (stations.isEmpty())
     {
         out << "No hay estaciones en el sistema.\n";
         writeFooter(out);
-        file.close();
-        return true;
+        return finishReport(out, filename);
     }
     
     // Connectivity matrix
@@ -434,14 +548,12 @@ bool ReportGenerator::generateConnectivityReport(const QString& filename, const
     out << "Estaciones en el sistema: " << stations.size() << "\n\n";
     
     // For each station, show its connections
-    for (const Station& station : stations)
+    for (int index : stations)
     {
-        int stationId = station.getId();
-        QList<QPair<int, double>> neighbors = graph.getNeighbors(stationId);
+        int stationId = table.idAt(index);
+        const QList<QPair<int, double>>& neighbors = graph.neighborsAt(index);
         
-        out << QString("Estacion %1 (%2):\n")
-            .arg(stationId)
-            .arg(station.getName());
+        out << "Estacion " << stationId << " (" << table.nameViewAt(index) << "):\n";
         
         if (neighbors.isEmpty())
         {
@@ -449,12 +561,11 @@ bool ReportGenerator::generateConnectivityReport(const QString& filename, const
         }
         else
         {
-            out << QString("  Conexiones directas: %1\n").arg(neighbors.size());
+            out << "  Conexiones directas: " << neighbors.size() << "\n";
             for (const auto& neighbor : neighbors)
             {
-                out << QString("    -> Estacion %1 (peso: %2)\n")
-                    .arg(neighbor.first)
-                    .arg(neighbor.second, 0, 'f', 1);
+                out << "    -> Estacion " << table.idAt(neighbor.first) << " (peso: ";
+                out.writeFixed(neighbor.second, 1) << ")\n";
             }
         }
         out << "\n";
@@ -463,22 +574,18 @@ bool ReportGenerator::generateConnectivityReport(const QString& filename, const
     // BFS from first station
     if (!stations.isEmpty())
     {
-        int startId = stations.first().getId();
+        int startId = analysis.getReachabilityStart();
         writeSectionTitle(out, "PRUEBA DE ALCANZABILIDAD (BFS)");
-        out << QString("Inicio desde estacion %1:\n\n").arg(startId);
+        out << "Inicio desde estacion " << startId << ":\n\n";
         
-        QList<int> bfsResult = const_cast<Graph&>(graph).bfs(startId);
+        const QList<int>& bfsResult = analysis.getReachable();
         out << "Estaciones alcanzables:\n";
         for (int i = 0; i < bfsResult.size(); i++)
         {
-            out << QString("  %1. Estacion %2\n")
-                .arg(i + 1)
-                .arg(bfsResult[i]);
+            out << "  " << (i + 1) << ". Estacion " << bfsResult[i] << "\n";
         }
         
-        out << QString("\nTotal alcanzable: %1 de %2\n")
-            .arg(bfsResult.size())
-            .arg(stations.size());
+        out << "\nTotal alcanzable: " << bfsResult.size() << " de " << stations.size() << "\n";
         
         if (bfsResult.size() == stations.size())
         {
@@ -489,31 +596,33 @@ bool ReportGenerator::generateConnectivityReport(const QString& filename, const
             out << "Conclusion: El grafo NO esta completamente conectado.\n";
             out << "Existen estaciones aisladas o componentes desconectadas.\n";
         }
+        
+        out << "Componentes conexas (estaciones abiertas): " << analysis.getComponentCount()
+            << ", la mayor con " << analysis.getLargestComponentSize() << " estaciones\n";
     }
     
     // Write footer
     writeFooter(out);
     
-    file.close();
+    if (!finishReport(out, filename))
+    {
+        return false;
+    }
     
-    qDebug() << "Reporte de conectividad generado exitosamente:" << filename;
+    LOG_INFO << "Reporte de conectividad generado exitosamente:" << filename;
     return true;
 }
 
 // Append to existing report
 bool ReportGenerator::appendToReport(const QString& filename, const QString& sectionTitle, const QString& content)
 {
-    QFile file(filename);
+    ReportWriter out;
     
-    if (!file.open(QIODevice::Append | QIODevice::Text))
+    if (!openReport(out, filename, true))
     {
-        lastError = QString("No se pudo abrir el archivo %1 para agregar contenido.").arg(filename);
-        qDebug() << "Error:" << lastError;
         return false;
     }
     
-    QTextStream out(&file);
-    
     // Write section
     out << "\n";
     writeSeparator(out);
@@ -523,26 +632,36 @@ bool ReportGenerator::appendToReport(const QString& filename, const QString& sec
     out << "\n";
     writeSeparator(out);
     
-    file.close();
+    if (!finishReport(out, filename))
+    {
+        return false;
+    }
     
-    qDebug() << "Seccion agregada al reporte:" << filename;
+    LOG_INFO << "Seccion agregada al reporte:" << filename;
     return true;
 }
 
+// Generate accident report from the graph copy held by the analysis
+bool ReportGenerator::generateAccidentReport(const QString& filename, const NetworkAnalysis& analysis)
+{
+    return generateAccidentReport(filename, analysis.getGraph());
+}
+
 // Generate accident report
 bool ReportGenerator::generateAccidentReport(const QString& filename, const Graph& graph)
 {
-    QFile file(filename);
+    if (outputFormat != Text)
+    {
+        return writeAccidentRecords(filename, graph);
+    }
     
-    if (!file.open(QIODevice::WriteOnly | QIODevice::Text))
+    ReportWriter out;
+    
+    if (!openReport(out, filename))
     {
-        lastError = QString("No se pudo crear el archivo %1.").arg(filename);
-        qDebug() << "Error:" << lastError;
         return false;
     }
     
-    QTextStream out(&file);
-    
     // Write header
     writeHeader(out, "REPORTE DE ACCIDENTES EN RUTAS");
     
@@ -553,20 +672,20 @@ bool ReportGenerator::generateAccidentReport(const QString& filename, const Grap
     {
         out << "No hay accidentes activos en el sistema.\n";
         writeFooter(out);
-        file.close();
-        qDebug() << "Reporte de accidentes generado (sin accidentes):" << filename;
-        return true;
+        LOG_INFO << "Reporte de accidentes generado (sin accidentes):" << filename;
+        return finishReport(out, filename);
     }
     
     // Summary section
     writeSectionTitle(out, "RESUMEN DE ACCIDENTES");
-    out << QString("Total de rutas afectadas: %1\n").arg(affectedRoutes.size() / 2); // Divide by 2 for undirected
-    out << QString("Fecha del reporte: %1\n\n").arg(formatDateTime());
+    out << "Total de rutas afectadas: " << affectedRoutes.size() / 2 << "\n"; // Divide by 2 for undirected
+    out << "Fecha del reporte: " << formatDateTime() << "\n\n";
     
     // Detail section
     writeSectionTitle(out, "DETALLE DE RUTAS AFECTADAS");
     
     QSet<QPair<int, int>> processedRoutes;
+    const StationTable& table = graph.getStationTable();
     
     for (const auto& route : affectedRoutes)
     {
@@ -586,24 +705,19 @@ bool ReportGenerator::generateAccidentReport(const QString& filename, const Grap
         double currentWeight = graph.getEdgeWeight(origin, dest);
         
         // Get station info
-        Station* originStation = const_cast<Graph&>(graph).getStation(origin);
-        Station* destStation = const_cast<Graph&>(graph).getStation(dest);
+        int originIndex = table.indexOf(origin);
+        int destIndex = table.indexOf(dest);
         
-        QString originName = originStation ? originStation->getName() : QString("Desconocida");
-        QString destName = destStation ? destStation->getName() : QString("Desconocida");
+        static const QString unknown("Desconocida");
+        QStringView originName = (originIndex != StationTable::InvalidIndex) ? table.nameViewAt(originIndex) : QStringView(unknown);
+        QStringView destName = (destIndex != StationTable::InvalidIndex) ? table.nameViewAt(destIndex) : QStringView(unknown);
         
-        out << QString("Ruta %1 <-> %2:\n")
-            .arg(origin)
-            .arg(dest);
-        out << QString("  Origen: %1 (%2)\n")
-            .arg(origin)
-            .arg(originName);
-        out << QString("  Destino: %1 (%2)\n")
-            .arg(dest)
-            .arg(destName);
-        out << QString("  Peso actual (con accidente): %1\n")
-            .arg(currentWeight, 0, 'f', 1);
-        out << QString("  Estado: AFECTADA POR ACCIDENTE\n");
+        out << "Ruta " << origin << " <-> " << dest << ":\n";
+        out << "  Origen: " << origin << " (" << originName << ")\n";
+        out << "  Destino: " << dest << " (" << destName << ")\n";
+        out << "  Peso actual (con accidente): ";
+        out.writeFixed(currentWeight, 1) << "\n";
+        out << "  Estado: AFECTADA POR ACCIDENTE\n";
         out << "\n";
     }
     
@@ -617,8 +731,402 @@ bool ReportGenerator::generateAccidentReport(const QString& filename, const Grap
     // Write footer
     writeFooter(out);
     
-    file.close();
+    if (!finishReport(out, filename))
+    {
+        return false;
+    }
+    
+    LOG_INFO << "Reporte de accidentes generado exitosamente:" << filename;
+    return true;
+}
+
+// Generate metrics report (calls, times and counters per algorithm)
+bool ReportGenerator::generateMetricsReport(const QString& filename, const Metrics::Snapshot& snapshot)
+{
+    if (outputFormat != Text)
+    {
+        return writeMetricsRecords(filename, snapshot);
+    }
+    
+    ReportWriter out;
+    
+    if (!openReport(out, filename))
+    {
+        return false;
+    }
+    
+    writeHeader(out, "REPORTE DE METRICAS DE ALGORITMOS");
+    
+    writeSectionTitle(out, "LLAMADAS, TIEMPOS Y CONTADORES");
+    out << Metrics::formatTable(snapshot) << "\n";
+    
+    writeSectionTitle(out, "FORMATO PROMETHEUS");
+    out << Metrics::formatPrometheus(snapshot);
+    
+    writeFooter(out);
+    
+    if (!finishReport(out, filename))
+    {
+        return false;
+    }
+    
+    LOG_INFO << "Reporte de metricas generado exitosamente:" << filename;
+    return true;
+}
+
+// ==================== Structured output ====================
+
+// Open the structured output of a report
+bool ReportGenerator::openRecords(RecordWriter& records, const QString& filename)
+{
+    QString base = filename.endsWith(".txt") ? filename.left(filename.length() - 4) : filename;
+    
+    if (!records.open(base))
+    {
+        lastError = records.getLastError();
+        return false;
+    }
+    
+    return true;
+}
+
+// Close the structured output and record its size
+bool ReportGenerator::finishRecords(RecordWriter& records, const QString& filename)
+{
+    if (!records.close())
+    {
+        lastError = records.getLastError();
+        LOG_ERROR << "Error:" << lastError;
+        return false;
+    }
+    
+    lastReportBytes = records.bytesWritten();
+    lastReportThroughput = 0.0;
     
-    qDebug() << "Reporte de accidentes generado exitosamente:" << filename;
+    LOG_INFO << "[INFO]" << outputPath(filename, outputFormat) << ":" << records.getRowCount() << "filas,"
+             << lastReportBytes / 1024 << "KB";
     return true;
 }
+
+// Station ID, name and coordinates
+void ReportGenerator::writeStationColumns(RecordWriter& records, const StationTable& table, int index)
+{
+    records << table.idAt(index) << table.nameViewAt(index) << table.xAt(index) << table.yAt(index);
+}
+
+// Route report rows
+bool ReportGenerator::writeRouteRecords(const QString& filename, const QList<int>& route, const Graph& graph)
+{
+    RecordWriter records(static_cast<RecordWriter::Format>(outputFormat - JsonLines));
+    
+    if (!openRecords(records, filename))
+    {
+        return false;
+    }
+    
+    const StationTable& table = graph.getStationTable();
+    double totalDistance = 0.0;
+    
+    // One row per stop; distancia_siguiente is empty on the last stop and without a direct route
+    records.beginTable("ruta", {
+        { "paso", RecordWriter::Integer }, { "estacion", RecordWriter::Integer },
+        { "nombre", RecordWriter::Text }, { "x", RecordWriter::Real }, { "y", RecordWriter::Real },
+        { "distancia_siguiente", RecordWriter::Real } });
+    
+    for (int i = 0; i < route.size(); i++)
+    {
+        int stationId = route[i];
+        int index = table.indexOf(stationId);
+        
+        records << (i + 1);
+        if (index != StationTable::InvalidIndex)
+        {
+            writeStationColumns(records, table, index);
+        }
+        else
+        {
+            records << stationId << "" << std::nan("") << std::nan("");
+        }
+        
+        double weight = std::nan("");
+        if (i < route.size() - 1)
+        {
+            double edgeWeight = graph.getEdgeWeight(stationId, route[i + 1]);
+            if (edgeWeight < std::numeric_limits<double>::infinity())
+            {
+                weight = edgeWeight;
+                totalDistance += edgeWeight;
+            }
+        }
+        records << weight;
+        records.endRow();
+    }
+    
+    records.beginTable("resumen", {
+        { "estaciones", RecordWriter::Integer }, { "distancia_total", RecordWriter::Real } });
+    records << static_cast<int>(route.size()) << totalDistance;
+    records.endRow();
+    
+    return finishRecords(records, filename);
+}
+
+// Traversal report rows
+bool ReportGenerator::writeTraversalRecords(const QString& filename, const StationTable& table,
+                                            const QList<int>& inOrderList, const QList<int>& preOrderList,
+                                            const QList<int>& postOrderList)
+{
+    RecordWriter records(static_cast<RecordWriter::Format>(outputFormat - JsonLines));
+    
+    if (!openRecords(records, filename))
+    {
+        return false;
+    }
+    
+    records.beginTable("recorridos", {
+        { "recorrido", RecordWriter::Text }, { "posicion", RecordWriter::Integer },
+        { "estacion", RecordWriter::Integer }, { "nombre", RecordWriter::Text },
+        { "x", RecordWriter::Real }, { "y", RecordWriter::Real } });
+    
+    const QList<int>* lists[] = { &inOrderList, &preOrderList, &postOrderList };
+    const char* names[] = { "inorder", "preorder", "postorder" };
+    
+    for (int order = 0; order < 3; order++)
+    {
+        QString orderName(names[order]);
+        const QList<int>& list = *lists[order];
+        for (int i = 0; i < list.size(); i++)
+        {
+            records << orderName << (i + 1);
+            writeStationColumns(records, table, list[i]);
+            records.endRow();
+        }
+    }
+    
+    return finishRecords(records, filename);
+}
+
+// Statistics report rows
+bool ReportGenerator::writeStatsRecords(const QString& filename, const NetworkAnalysis& analysis)
+{
+    RecordWriter records(static_cast<RecordWriter::Format>(outputFormat - JsonLines));
+    
+    if (!openRecords(records, filename))
+    {
+        return false;
+    }
+    
+    const StationTable& table = analysis.getStationTable();
+    const QList<int>& stationIndices = analysis.getStationIndices();
+    
+    records.beginTable("resumen", {
+        { "estaciones_grafo", RecordWriter::Integer }, { "estaciones_bst", RecordWriter::Integer },
+        { "rutas", RecordWriter::Integer }, { "dirigido", RecordWriter::Integer },
+        { "conectividad_promedio", RecordWriter::Real }, { "conexiones_min", RecordWriter::Integer },
+        { "conexiones_max", RecordWriter::Integer }, { "aristas_mst", RecordWriter::Integer },
+        { "peso_mst", RecordWriter::Real } });
+    records << static_cast<int>(stationIndices.size()) << analysis.getBSTCount() << analysis.getTotalRoutes()
+            << (analysis.getGraph().isDirected() ? 1 : 0) << analysis.getAverageDegree()
+            << analysis.getMinDegree() << analysis.getMaxDegree()
+            << static_cast<int>(analysis.getKruskalEdges().size()) << analysis.getKruskalWeight();
+    records.endRow();
+    
+    records.beginTable("mst", {
+        { "origen", RecordWriter::Integer }, { "destino", RecordWriter::Integer }, { "peso", RecordWriter::Real } });
+    for (const Edge& edge : analysis.getKruskalEdges())
+    {
+        records << edge.from << edge.to << edge.weight;
+        records.endRow();
+    }
+    
+    records.beginTable("estaciones", {
+        { "posicion", RecordWriter::Integer }, { "estacion", RecordWriter::Integer },
+        { "nombre", RecordWriter::Text }, { "x", RecordWriter::Real }, { "y", RecordWriter::Real },
+        { "conexiones", RecordWriter::Integer } });
+    for (int i = 0; i < stationIndices.size(); i++)
+    {
+        int index = stationIndices[i];
+        records << (i + 1);
+        writeStationColumns(records, table, index);
+        records << analysis.degreeAt(index);
+        records.endRow();
+    }
+    
+    return finishRecords(records, filename);
+}
+
+// MST report rows
+bool ReportGenerator::writeMSTRecords(const QString& filename, const NetworkAnalysis& analysis)
+{
+    RecordWriter records(static_cast<RecordWriter::Format>(outputFormat - JsonLines));
+    
+    if (!openRecords(records, filename))
+    {
+        return false;
+    }
+    
+    records.beginTable("aristas", {
+        { "algoritmo", RecordWriter::Text }, { "posicion", RecordWriter::Integer },
+        { "origen", RecordWriter::Integer }, { "destino", RecordWriter::Integer },
+        { "peso", RecordWriter::Real } });
+    
+    QString kruskal("kruskal");
+    QString prim("prim");
+    
+    const QList<Edge>& kruskalEdges = analysis.getKruskalEdges();
+    for (int i = 0; i < kruskalEdges.size(); i++)
+    {
+        records << kruskal << (i + 1) << kruskalEdges[i].from << kruskalEdges[i].to << kruskalEdges[i].weight;
+        records.endRow();
+    }
+    
+    const QList<Edge>& primEdges = analysis.getPrimEdges();
+    for (int i = 0; i < primEdges.size(); i++)
+    {
+        records << prim << (i + 1) << primEdges[i].from << primEdges[i].to << primEdges[i].weight;
+        records.endRow();
+    }
+    
+    records.beginTable("resumen", {
+        { "algoritmo", RecordWriter::Text }, { "aristas", RecordWriter::Integer },
+        { "peso_total", RecordWriter::Real } });
+    records << kruskal << static_cast<int>(kruskalEdges.size()) << analysis.getKruskalWeight();
+    records.endRow();
+    records << prim << static_cast<int>(primEdges.size()) << analysis.getPrimWeight();
+    records.endRow();
+    
+    return finishRecords(records, filename);
+}
+
+// Connectivity report rows
+bool ReportGenerator::writeConnectivityRecords(const QString& filename, const NetworkAnalysis& analysis)
+{
+    RecordWriter records(static_cast<RecordWriter::Format>(outputFormat - JsonLines));
+    
+    if (!openRecords(records, filename))
+    {
+        return false;
+    }
+    
+    const Graph& graph = analysis.getGraph();
+    const StationTable& table = analysis.getStationTable();
+    const QList<int>& stations = analysis.getStationIndices();
+    
+    // One row per direct connection
+    records.beginTable("conexiones", {
+        { "estacion", RecordWriter::Integer }, { "nombre", RecordWriter::Text },
+        { "destino", RecordWriter::Integer }, { "peso", RecordWriter::Real } });
+    for (int index : stations)
+    {
+        int stationId = table.idAt(index);
+        QStringView name = table.nameViewAt(index);
+        for (const auto& neighbor : graph.neighborsAt(index))
+        {
+            records << stationId << name << table.idAt(neighbor.first) << neighbor.second;
+            records.endRow();
+        }
+    }
+    
+    const QList<int>& reachable = analysis.getReachable();
+    records.beginTable("alcanzables", {
+        { "posicion", RecordWriter::Integer }, { "estacion", RecordWriter::Integer } });
+    for (int i = 0; i < reachable.size(); i++)
+    {
+        records << (i + 1) << reachable[i];
+        records.endRow();
+    }
+    
+    records.beginTable("resumen", {
+        { "estaciones", RecordWriter::Integer }, { "inicio_bfs", RecordWriter::Integer },
+        { "alcanzables", RecordWriter::Integer }, { "conectado", RecordWriter::Integer },
+        { "componentes", RecordWriter::Integer }, { "componente_mayor", RecordWriter::Integer } });
+    records << static_cast<int>(stations.size()) << analysis.getReachabilityStart()
+            << static_cast<int>(reachable.size()) << (reachable.size() == stations.size() ? 1 : 0)
+            << analysis.getComponentCount() << analysis.getLargestComponentSize();
+    records.endRow();
+    
+    return finishRecords(records, filename);
+}
+
+// Accident report rows
+bool ReportGenerator::writeAccidentRecords(const QString& filename, const Graph& graph)
+{
+    RecordWriter records(static_cast<RecordWriter::Format>(outputFormat - JsonLines));
+    
+    if (!openRecords(records, filename))
+    {
+        return false;
+    }
+    
+    const StationTable& table = graph.getStationTable();
+    QSet<QPair<int, int>> affectedRoutes = graph.getAffectedRoutes();
+    QHash<QPair<int, int>, double> originalWeights = graph.getOriginalWeights();
+    
+    records.beginTable("accidentes", {
+        { "origen", RecordWriter::Integer }, { "nombre_origen", RecordWriter::Text },
+        { "destino", RecordWriter::Integer }, { "nombre_destino", RecordWriter::Text },
+        { "peso_original", RecordWriter::Real }, { "peso_actual", RecordWriter::Real },
+        { "incremento_porcentaje", RecordWriter::Real } });
+    
+    QSet<QPair<int, int>> processedRoutes;
+    for (const auto& route : affectedRoutes)
+    {
+        // Each undirected route once
+        if (processedRoutes.contains(route) || processedRoutes.contains(qMakePair(route.second, route.first)))
+        {
+            continue;
+        }
+        processedRoutes.insert(route);
+        
+        int originIndex = table.indexOf(route.first);
+        int destIndex = table.indexOf(route.second);
+        
+        records << route.first;
+        records << (originIndex != StationTable::InvalidIndex ? table.nameViewAt(originIndex) : QStringView());
+        records << route.second;
+        records << (destIndex != StationTable::InvalidIndex ? table.nameViewAt(destIndex) : QStringView());
+        records << originalWeights.value(route, std::nan(""));
+        records << graph.getEdgeWeight(route.first, route.second);
+        records << graph.getAccidentIncrement(route.first, route.second);
+        records.endRow();
+    }
+    
+    return finishRecords(records, filename);
+}
+
+// Metrics report rows (one per scope that was called)
+bool ReportGenerator::writeMetricsRecords(const QString& filename, const Metrics::Snapshot& snapshot)
+{
+    RecordWriter records(static_cast<RecordWriter::Format>(outputFormat - JsonLines));
+    
+    if (!openRecords(records, filename))
+    {
+        return false;
+    }
+    
+    QList<RecordWriter::Column> columns = {
+        { "ambito", RecordWriter::Text }, { "llamadas", RecordWriter::Integer },
+        { "total_ns", RecordWriter::Integer }, { "max_ns", RecordWriter::Integer } };
+    for (int c = 0; c < Metrics::CounterCount; c++)
+    {
+        columns.append({ Metrics::counterName(static_cast<Metrics::Counter>(c)), RecordWriter::Integer });
+    }
+    records.beginTable("metricas", columns);
+    
+    for (int s = 0; s < Metrics::ScopeCount; s++)
+    {
+        const Metrics::ScopeStats& stats = snapshot.scopes[s];
+        if (stats.calls == 0)
+        {
+            continue;
+        }
+        
+        records << Metrics::scopeName(static_cast<Metrics::Scope>(s)) << stats.calls << stats.totalNs << stats.maxNs;
+        for (int c = 0; c < Metrics::CounterCount; c++)
+        {
+            records << stats.counters[c];
+        }
+        records.endRow();
+    }
+    
+    return finishRecords(records, filename);
+}
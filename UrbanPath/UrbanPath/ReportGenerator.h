@@ -1,10 +1,11 @@
 #pragma once
 
 #include "FileManager.h"
+#include "ReportWriter.h"
+#include "RecordWriter.h"
+#include "Metrics.h"
 #include <QString>
 #include <QList>
-#include <QFile>
-#include <QTextStream>
 #include <QDateTime>
 
 using namespace std;
@@ -12,13 +13,30 @@ using namespace std;
 // Forward declarations
 class Graph;
 class StationBST;
+class StationTable;
+class NetworkAnalysis;
 
 class ReportGenerator
 {
 public:
+    // Output of the generate* methods: the text reports, or rows for other programs
+    // (the .txt extension of the file name is replaced, see RecordWriter)
+    enum OutputFormat
+    {
+        Text,
+        JsonLines,
+        Csv,
+        Columnar
+    };
+    
     // Constructor
     ReportGenerator() = default;
     
+    // Output format
+    void setOutputFormat(OutputFormat format);
+    OutputFormat getOutputFormat() const;
+    static QString outputPath(const QString& filename, OutputFormat format);
+    
     // Report generation methods
     bool generateRouteReport(const QString& filename, const QList<int>& route, const Graph& graph);
     bool generateTraversalReport(const QString& filename, const StationBST& bst);
@@ -27,21 +45,63 @@ public:
     bool generateConnectivityReport(const QString& filename, const Graph& graph);
     bool generateAccidentReport(const QString& filename, const Graph& graph);
     
+    // Same reports from a precomputed analysis (see ReportPipeline); the analysis must
+    // include the parts each report reads
+    bool generateTraversalReport(const QString& filename, const NetworkAnalysis& analysis);
+    bool generateSystemStats(const QString& filename, const NetworkAnalysis& analysis);
+    bool generateMSTReport(const QString& filename, const NetworkAnalysis& analysis);
+    bool generateConnectivityReport(const QString& filename, const NetworkAnalysis& analysis);
+    bool generateAccidentReport(const QString& filename, const NetworkAnalysis& analysis);
+    
+    // Algorithm metrics (see Metrics; usually Metrics::snapshot())
+    bool generateMetricsReport(const QString& filename, const Metrics::Snapshot& snapshot);
+    
     // Incremental report (append mode)
     bool appendToReport(const QString& filename, const QString& sectionTitle, const QString& content);
     
+    // Size and output speed of the last report written
+    qint64 getLastReportBytes() const;
+    double getLastReportThroughput() const;    // MB/s
+    
     // Get last error
     QString getLastError() const;
     
 private:
     QString lastError;
+    OutputFormat outputFormat = Text;
+    qint64 lastReportBytes = 0;
+    double lastReportThroughput = 0.0;
+    
+    // Open the output file, close it and record its statistics
+    bool openReport(ReportWriter& out, const QString& filename, bool append = false);
+    bool finishReport(ReportWriter& out, const QString& filename);
+    
+    // Traversal report body (shared by the BST and the analysis versions)
+    bool writeTraversalReport(const QString& filename, const StationTable& table,
+                              const QList<int>& inOrderList, const QList<int>& preOrderList,
+                              const QList<int>& postOrderList);
+    
+    // Structured output (one method per report, rows streamed as they are computed)
+    bool openRecords(RecordWriter& records, const QString& filename);
+    bool finishRecords(RecordWriter& records, const QString& filename);
+    bool writeRouteRecords(const QString& filename, const QList<int>& route, const Graph& graph);
+    bool writeTraversalRecords(const QString& filename, const StationTable& table,
+                               const QList<int>& inOrderList, const QList<int>& preOrderList,
+                               const QList<int>& postOrderList);
+    bool writeStatsRecords(const QString& filename, const NetworkAnalysis& analysis);
+    bool writeMSTRecords(const QString& filename, const NetworkAnalysis& analysis);
+    bool writeConnectivityRecords(const QString& filename, const NetworkAnalysis& analysis);
+    bool writeAccidentRecords(const QString& filename, const Graph& graph);
+    bool writeMetricsRecords(const QString& filename, const Metrics::Snapshot& snapshot);
+    void writeStationColumns(RecordWriter& records, const StationTable& table, int index);
     
     // Helper methods for formatting
-    void writeHeader(QTextStream& out, const QString& title);
-    void writeFooter(QTextStream& out);
-    void writeSectionTitle(QTextStream& out, const QString& title);
-    void writeSeparator(QTextStream& out);
+    void writeHeader(ReportWriter& out, const QString& title);
+    void writeFooter(ReportWriter& out);
+    void writeSectionTitle(ReportWriter& out, const QString& title);
+    void writeSeparator(ReportWriter& out);
     QString formatDateTime() const;
-    QString formatStationInfo(int id, const QString& name, double x, double y) const;
+    void writeStationInfo(ReportWriter& out, int id, QStringView name, double x, double y);
+    void writeStationInfo(ReportWriter& out, const StationTable& table, int index);
 };
 
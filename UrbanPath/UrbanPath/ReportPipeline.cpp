@@ -0,0 +1,199 @@
+#include "ReportPipeline.h"
+#include "NetworkAnalysis.h"
+#include "StationBST.h"
+#include "Log.h"
+#include <QElapsedTimer>
+#include <QThread>
+#include <QList>
+
+// One report of the pipeline
+struct ReportJob
+{
+    QString filename;
+    bool needsAnalysis;     // Waits for NetworkAnalysis::compute()
+    function<bool(ReportGenerator&, const QString&, const NetworkAnalysis&)> render;
+};
+
+// Shared state of one run
+struct PipelineRun
+{
+    shared_ptr<NetworkAnalysis> analysis;
+    QString directory;
+    QObject* receiver;
+    ReportPipeline::ProgressCallback progress;
+    ReportPipeline::FinishedCallback finished;
+    int total = 0;
+    atomic<int> done{0};
+    atomic<int> succeeded{0};
+    QElapsedTimer timer;
+};
+
+// The reports, in queue order
+static QList<ReportJob> reportJobs()
+{
+    return {
+        { "reporte_estadisticas.txt", true,
+          [](ReportGenerator& g, const QString& f, const NetworkAnalysis& a) { return g.generateSystemStats(f, a); } },
+        { "reporte_mst.txt", true,
+          [](ReportGenerator& g, const QString& f, const NetworkAnalysis& a) { return g.generateMSTReport(f, a); } },
+        { "reporte_conectividad.txt", true,
+          [](ReportGenerator& g, const QString& f, const NetworkAnalysis& a) { return g.generateConnectivityReport(f, a); } },
+        { "reporte_recorridos.txt", false,
+          [](ReportGenerator& g, const QString& f, const NetworkAnalysis& a) { return g.generateTraversalReport(f, a); } },
+        { "reporte_accidentes.txt", false,
+          [](ReportGenerator& g, const QString& f, const NetworkAnalysis& a) { return g.generateAccidentReport(f, a); } },
+        // Queued after the analysis so its algorithms are counted too
+        { "reporte_metricas.txt", true,
+          [](ReportGenerator& g, const QString& f, const NetworkAnalysis&) { return g.generateMetricsReport(f, Metrics::snapshot()); } }
+    };
+}
+
+// Constructor
+ReportPipeline::ReportPipeline() : running(false), outputFormats({ ReportGenerator::Text })
+{
+}
+
+// Destructor
+ReportPipeline::~ReportPipeline()
+{
+    waitForDone();
+}
+
+// Get report file names
+QStringList ReportPipeline::reportNames()
+{
+    QStringList names;
+    for (const ReportJob& job : reportJobs())
+    {
+        names.append(job.filename);
+    }
+    return names;
+}
+
+// Set worker threads
+void ReportPipeline::setMaxThreads(int threads)
+{
+    pool.setMaxThreadCount(threads > 0 ? threads : QThread::idealThreadCount());
+}
+
+// Set output formats
+void ReportPipeline::setOutputFormats(const QList<ReportGenerator::OutputFormat>& formats)
+{
+    outputFormats = formats.isEmpty() ? QList<ReportGenerator::OutputFormat>({ ReportGenerator::Text }) : formats;
+}
+
+// Get output formats
+QList<ReportGenerator::OutputFormat> ReportPipeline::getOutputFormats() const
+{
+    return outputFormats;
+}
+
+// Check if a run is in progress
+bool ReportPipeline::isRunning() const
+{
+    return running;
+}
+
+// Wait for the current run
+void ReportPipeline::waitForDone()
+{
+    pool.waitForDone();
+}
+
+// Start a run
+bool ReportPipeline::start(const Graph& graph, const StationBST& bst, const QString& directory,
+                           QObject* receiver, ProgressCallback progress, FinishedCallback finished)
+{
+    bool expected = false;
+    if (!running.compare_exchange_strong(expected, true))
+    {
+        return false;
+    }
+
+    // Copies taken on the caller's thread; the GUI can keep editing the originals
+    auto run = make_shared<PipelineRun>();
+    run->analysis = make_shared<NetworkAnalysis>(graph);
+    run->analysis->captureTraversals(bst);
+    run->directory = directory.endsWith("/") ? directory : directory + "/";
+    run->receiver = receiver;
+    run->progress = progress;
+    run->finished = finished;
+    run->timer.start();
+
+    QList<ReportJob> jobs = reportJobs();
+    QList<ReportGenerator::OutputFormat> formats = outputFormats;
+    run->total = jobs.size() * formats.size();
+
+    // Render one report in one format and post its result
+    auto renderJob = [this, run](const ReportJob& job, ReportGenerator::OutputFormat format)
+    {
+        MetricsTimer timer(Metrics::Reports);
+        ReportGenerator generator;
+        generator.setOutputFormat(format);
+        QString path = run->directory + job.filename;
+        bool ok = job.render(generator, path, *run->analysis);
+        path = ReportGenerator::outputPath(path, format);
+        QString error = ok ? QString() : generator.getLastError();
+
+        if (ok)
+        {
+            run->succeeded++;
+        }
+        int done = ++run->done;
+
+        QMetaObject::invokeMethod(run->receiver, [run, done, path, ok, error]() {
+            if (run->progress)
+            {
+                run->progress(done, run->total, path, ok, error);
+            }
+        }, Qt::QueuedConnection);
+
+        if (done == run->total)
+        {
+            int succeeded = run->succeeded;
+            LOG_INFO << "[INFO] Reportes generados:" << succeeded << "de" << run->total
+                     << "en" << run->timer.elapsed() << "ms";
+
+            running = false;
+            QMetaObject::invokeMethod(run->receiver, [run, succeeded]() {
+                if (run->finished)
+                {
+                    run->finished(succeeded, run->total);
+                }
+            }, Qt::QueuedConnection);
+        }
+    };
+
+    // Reports that only read the copied network start right away
+    QList<ReportJob> analysisJobs;
+    for (const ReportJob& job : jobs)
+    {
+        if (job.needsAnalysis)
+        {
+            analysisJobs.append(job);
+        }
+        else
+        {
+            for (ReportGenerator::OutputFormat format : formats)
+            {
+                pool.start([renderJob, job, format]() { renderJob(job, format); });
+            }
+        }
+    }
+
+    // The rest wait for the shared analysis, computed once
+    pool.start([this, run, renderJob, analysisJobs, formats]() {
+        run->analysis->compute(NetworkAnalysis::All);
+
+        for (const ReportJob& job : analysisJobs)
+        {
+            for (ReportGenerator::OutputFormat format : formats)
+            {
+                pool.start([renderJob, job, format]() { renderJob(job, format); });
+            }
+        }
+    });
+
+    return true;
+}
+
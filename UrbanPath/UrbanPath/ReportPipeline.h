@@ -0,0 +1,63 @@
+#pragma once
+
+#include "ReportGenerator.h"
+#include <QString>
+#include <QStringList>
+#include <QList>
+#include <QObject>
+#include <QThreadPool>
+#include <atomic>
+#include <functional>
+#include <memory>
+
+using namespace std;
+
+// Forward declarations
+class Graph;
+class StationBST;
+class NetworkAnalysis;
+
+// Generates the system reports off the GUI thread.
+// start() copies the network and the BST traversals (cheap, implicitly shared),
+// then a worker computes the shared analysis once (MST, degrees, components,
+// reachability) and the report files are rendered concurrently, one task each.
+// Callbacks run on the receiver's thread, so they can touch widgets directly.
+// Every report is written once per selected output format (text by default).
+class ReportPipeline
+{
+public:
+    // Called after each report: reports finished so far, total, file and result
+    using ProgressCallback = function<void(int done, int total, const QString& filename, bool ok, const QString& error)>;
+
+    // Called once at the end: reports written successfully and total
+    using FinishedCallback = function<void(int succeeded, int total)>;
+
+    // Constructor and Destructor (waits for running reports)
+    ReportPipeline();
+    ~ReportPipeline();
+
+    // Start a run; false if one is already running
+    bool start(const Graph& graph, const StationBST& bst, const QString& directory,
+               QObject* receiver, ProgressCallback progress, FinishedCallback finished);
+
+    bool isRunning() const;
+
+    // Block until the current run ends
+    void waitForDone();
+
+    // Report file names, in the order they are queued
+    static QStringList reportNames();
+
+    // Worker threads (0 = one per core)
+    void setMaxThreads(int threads);
+
+    // Formats written by the next run (empty = text only)
+    void setOutputFormats(const QList<ReportGenerator::OutputFormat>& formats);
+    QList<ReportGenerator::OutputFormat> getOutputFormats() const;
+
+private:
+    QThreadPool pool;
+    atomic<bool> running;
+    QList<ReportGenerator::OutputFormat> outputFormats;
+};
+
@@ -0,0 +1,312 @@
+#include "ReportWriter.h"
+#include <QDebug>
+#include <charconv>
+#include <cstring>
+
+// Constructor
+ReportWriter::ReportWriter(int bufferSize)
+    : buffer(qMax(bufferSize, 4096), '\0'), used(0), written(0), failed(false), elapsedNs(0)
+{
+}
+
+// Destructor
+ReportWriter::~ReportWriter()
+{
+    close();
+}
+
+// Open the report file
+bool ReportWriter::open(const QString& filename, bool append, bool textMode)
+{
+    close();
+    lastError.clear();
+
+    used = 0;
+    written = 0;
+    failed = false;
+    elapsedNs = 0;
+
+    file.setFileName(filename);
+    QIODevice::OpenMode mode = append ? QIODevice::Append : QIODevice::WriteOnly;
+    if (textMode)
+    {
+        mode |= QIODevice::Text;
+    }
+
+    if (!file.open(mode))
+    {
+        return false;
+    }
+
+    timer.start();
+    return true;
+}
+
+// Flush and close the file
+bool ReportWriter::close()
+{
+    if (!file.isOpen())
+    {
+        return !failed;
+    }
+
+    flush();
+    file.close();
+    elapsedNs = timer.nsecsElapsed();
+
+    return !failed;
+}
+
+// Check if the file is open
+bool ReportWriter::isOpen() const
+{
+    return file.isOpen();
+}
+
+// Write the buffered bytes
+bool ReportWriter::flush()
+{
+    if (used == 0)
+    {
+        return !failed;
+    }
+
+    bool ok = writeToFile(buffer.constData(), used);
+    used = 0;
+    return ok;
+}
+
+// Write to the file and remember failures
+bool ReportWriter::writeToFile(const char* data, qint64 size)
+{
+    if (failed)
+    {
+        return false;
+    }
+
+    if (file.write(data, size) != size)
+    {
+        failed = true;
+        lastError = QString("No se pudo escribir en el archivo %1.").arg(file.fileName());
+        qDebug() << "Error:" << lastError;
+        return false;
+    }
+
+    written += size;
+    return true;
+}
+
+// Make room in the buffer
+char* ReportWriter::reserve(int bytes)
+{
+    if (used + bytes > buffer.size())
+    {
+        flush();
+    }
+    return buffer.data() + used;
+}
+
+// Append a C string
+ReportWriter& ReportWriter::operator<<(const char* text)
+{
+    return writeBlock(text, static_cast<qint64>(strlen(text)));
+}
+
+// Append one character
+ReportWriter& ReportWriter::operator<<(char c)
+{
+    *reserve(1) = c;
+    used++;
+    return *this;
+}
+
+// Append a QString
+ReportWriter& ReportWriter::operator<<(const QString& text)
+{
+    return *this << QStringView(text);
+}
+
+// Append a string view
+ReportWriter& ReportWriter::operator<<(QStringView text)
+{
+    appendUtf16(text.utf16(), text.size());
+    return *this;
+}
+
+// Encode UTF-16 as UTF-8 straight into the buffer
+void ReportWriter::appendUtf16(const char16_t* text, qsizetype length)
+{
+    // Worst case is 3 bytes per UTF-16 unit; encode in pieces that always fit
+    const qsizetype piece = buffer.size() / 3 - 1;
+
+    qsizetype position = 0;
+    while (position < length)
+    {
+        qsizetype end = qMin(length, position + piece);
+
+        // Do not split a surrogate pair between pieces
+        if (end < length && end > position + 1 && text[end - 1] >= 0xD800 && text[end - 1] <= 0xDBFF)
+        {
+            end--;
+        }
+
+        char* out = reserve(static_cast<int>((end - position) * 3));
+        char* start = out;
+
+        for (qsizetype i = position; i < end; i++)
+        {
+            char32_t unit = text[i];
+
+            if (unit < 0x80)
+            {
+                *out++ = static_cast<char>(unit);
+            }
+            else if (unit < 0x800)
+            {
+                *out++ = static_cast<char>(0xC0 | (unit >> 6));
+                *out++ = static_cast<char>(0x80 | (unit & 0x3F));
+            }
+            else if (unit >= 0xD800 && unit <= 0xDBFF && i + 1 < end &&
+                     text[i + 1] >= 0xDC00 && text[i + 1] <= 0xDFFF)
+            {
+                char32_t codePoint = 0x10000 + ((unit - 0xD800) << 10) + (text[i + 1] - 0xDC00);
+                i++;
+                *out++ = static_cast<char>(0xF0 | (codePoint >> 18));
+                *out++ = static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F));
+                *out++ = static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+                *out++ = static_cast<char>(0x80 | (codePoint & 0x3F));
+            }
+            else
+            {
+                // Lone surrogates become U+FFFD, like QString::toUtf8()
+                if (unit >= 0xD800 && unit <= 0xDFFF)
+                {
+                    unit = 0xFFFD;
+                }
+                *out++ = static_cast<char>(0xE0 | (unit >> 12));
+                *out++ = static_cast<char>(0x80 | ((unit >> 6) & 0x3F));
+                *out++ = static_cast<char>(0x80 | (unit & 0x3F));
+            }
+        }
+
+        used += static_cast<int>(out - start);
+        position = end;
+    }
+}
+
+// Append an int
+ReportWriter& ReportWriter::operator<<(int value)
+{
+    char* out = reserve(16);
+    used += static_cast<int>(to_chars(out, out + 16, value).ptr - out);
+    return *this;
+}
+
+// Append a 64-bit integer
+ReportWriter& ReportWriter::operator<<(qint64 value)
+{
+    char* out = reserve(24);
+    used += static_cast<int>(to_chars(out, out + 24, value).ptr - out);
+    return *this;
+}
+
+// Append a fixed-point number
+ReportWriter& ReportWriter::writeFixed(double value, int decimals)
+{
+    // Finite doubles need at most 309 integer digits
+    const int room = 320 + decimals;
+    char* out = reserve(room);
+
+    to_chars_result result = to_chars(out, out + room, value, chars_format::fixed, decimals);
+    if (result.ec == errc())
+    {
+        used += static_cast<int>(result.ptr - out);
+    }
+    else
+    {
+        // Not expected; fall back to Qt formatting
+        *this << QString::number(value, 'f', decimals);
+    }
+    return *this;
+}
+
+// Append a double in its shortest round-trip form
+ReportWriter& ReportWriter::writeDouble(double value)
+{
+    char* out = reserve(32);
+    used += static_cast<int>(to_chars(out, out + 32, value).ptr - out);
+    return *this;
+}
+
+// Append a run of one character
+ReportWriter& ReportWriter::writeRepeated(char c, int count)
+{
+    while (count > 0)
+    {
+        int chunk = qMin(count, static_cast<int>(buffer.size()));
+        memset(reserve(chunk), c, chunk);
+        used += chunk;
+        count -= chunk;
+    }
+    return *this;
+}
+
+// Append raw bytes
+ReportWriter& ReportWriter::writeBlock(const char* data, qint64 size)
+{
+    if (size <= 0)
+    {
+        return *this;
+    }
+
+    if (used + size <= buffer.size())
+    {
+        memcpy(buffer.data() + used, data, size);
+        used += static_cast<int>(size);
+        return *this;
+    }
+
+    // Does not fit: write what is buffered, then the block itself if it is large
+    flush();
+
+    if (size >= buffer.size() / 2)
+    {
+        writeToFile(data, size);
+    }
+    else
+    {
+        memcpy(buffer.data(), data, size);
+        used = static_cast<int>(size);
+    }
+    return *this;
+}
+
+// Get bytes written so far (including the buffered ones)
+qint64 ReportWriter::bytesWritten() const
+{
+    return written + used;
+}
+
+// Get time since open(), or from open() to close()
+qint64 ReportWriter::elapsedNanoseconds() const
+{
+    return file.isOpen() ? timer.nsecsElapsed() : elapsedNs;
+}
+
+// Get output throughput in MB/s
+double ReportWriter::throughputMBs() const
+{
+    qint64 ns = elapsedNanoseconds();
+    if (ns <= 0)
+    {
+        return 0.0;
+    }
+    return (bytesWritten() / (1024.0 * 1024.0)) / (ns / 1e9);
+}
+
+// Get last error message
+QString ReportWriter::getLastError() const
+{
+    return lastError;
+}
+
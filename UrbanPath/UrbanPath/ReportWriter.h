@@ -0,0 +1,87 @@
+#pragma once
+
+#include <QString>
+#include <QStringView>
+#include <QFile>
+#include <QByteArray>
+#include <QElapsedTimer>
+
+using namespace std;
+
+// Buffered UTF-8 text writer used by ReportGenerator.
+// Text, integers and fixed-point numbers are formatted straight into one
+// reusable output buffer (no temporary QString per line) and the buffer is
+// written to the file when it fills up. Blocks larger than the buffer go to
+// the file directly. Output matches QTextStream (UTF-8, '\n' translated by the
+// file in text mode).
+class ReportWriter
+{
+private:
+    QFile file;
+    QByteArray buffer;
+    int used;                 // Bytes of buffer in use
+    qint64 written;           // Bytes handed to the file
+    bool failed;              // A write failed since open()
+    QElapsedTimer timer;      // Started by open()
+    qint64 elapsedNs;         // Time from open() to close()
+
+    QString lastError;
+
+    // Make room for at least 'bytes' more bytes (flushes the buffer when needed)
+    char* reserve(int bytes);
+
+    // Write 'size' bytes from 'data' to the file
+    bool writeToFile(const char* data, qint64 size);
+
+    // Append UTF-16 text encoded as UTF-8
+    void appendUtf16(const char16_t* text, qsizetype length);
+
+public:
+    static const int DefaultBufferSize = 256 * 1024;
+
+    // Constructor and Destructor (the file is closed)
+    explicit ReportWriter(int bufferSize = DefaultBufferSize);
+    ~ReportWriter();
+
+    // Open for writing (truncates) or appending; binary files skip newline translation
+    bool open(const QString& filename, bool append = false, bool textMode = true);
+
+    // Flush and close; false if any write failed
+    bool close();
+
+    bool isOpen() const;
+
+    // Write the buffered bytes to the file
+    bool flush();
+
+    // Text
+    ReportWriter& operator<<(const char* text);
+    ReportWriter& operator<<(char c);
+    ReportWriter& operator<<(const QString& text);
+    ReportWriter& operator<<(QStringView text);
+
+    // Integers (decimal)
+    ReportWriter& operator<<(int value);
+    ReportWriter& operator<<(qint64 value);
+
+    // Fixed-point number, same output as QString::arg(value, 0, 'f', decimals)
+    ReportWriter& writeFixed(double value, int decimals);
+
+    // Shortest text that reads back as the same double
+    ReportWriter& writeDouble(double value);
+
+    // 'count' copies of one character
+    ReportWriter& writeRepeated(char c, int count);
+
+    // Raw UTF-8 block; large blocks skip the buffer
+    ReportWriter& writeBlock(const char* data, qint64 size);
+
+    // Statistics (bytes before newline translation)
+    qint64 bytesWritten() const;
+    qint64 elapsedNanoseconds() const;
+    double throughputMBs() const;
+
+    // Get last error
+    QString getLastError() const;
+};
+
@@ -0,0 +1,227 @@
+#include "ShortestPathCache.h"
+#include "Metrics.h"
+#include <limits>
+
+namespace
+{
+
+const double INF = std::numeric_limits<double>::infinity();
+
+double distAt(const ShortestPathCache::Tree& tree, int index)
+{
+    return (index >= 0 && index < tree.dist.size()) ? tree.dist[index] : INF;
+}
+
+int predAt(const ShortestPathCache::Tree& tree, int index)
+{
+    return (index >= 0 && index < tree.pred.size()) ? tree.pred[index] : -1;
+}
+
+}
+
+// Constructor
+ShortestPathCache::ShortestPathCache(qint64 budgetBytes)
+{
+    setBudget(budgetBytes);
+}
+
+// Compute the tree of an origin
+bool ShortestPathCache::computeTree(const Graph& graph, int originId, Tree& tree, JobToken* token)
+{
+    tree.version = graph.getVersion();
+    return graph.shortestPathTree(originId, tree.dist, tree.pred, token);
+}
+
+// Rebuild the route to a destination
+QList<int> ShortestPathCache::routeOf(const Graph& graph, const Tree& tree, int destId, double& distance)
+{
+    QList<int> route;
+    int index = graph.indexOf(destId);
+    distance = distAt(tree, index);
+
+    if (distance >= INF)
+    {
+        return route;
+    }
+
+    // Follow the predecessors back to the origin (at most one step per station)
+    const StationTable& table = graph.getStationTable();
+    for (int steps = 0; index != -1 && steps <= tree.pred.size(); steps++)
+    {
+        route.prepend(table.idAt(index));
+        index = predAt(tree, index);
+    }
+    return route;
+}
+
+// Look up a route
+bool ShortestPathCache::lookup(const Graph& graph, int originId, int destId, QList<int>& route, double& distance)
+{
+    MetricsTimer timer(Metrics::PathCache);
+    MetricsTally tally(Metrics::PathCache);
+    quint64 current = graph.getVersion();
+
+    // Same pair on the same network
+    QPair<int, int> pathKey(originId, destId);
+    Entry* path = entries.object(pathKey);
+    if (path && path->tree.version == current)
+    {
+        route = path->route;
+        distance = path->distance;
+        tally.count(Metrics::CacheHits);
+        return true;
+    }
+    if (path)
+    {
+        entries.remove(pathKey);   // Rebuilt from the tree below if it still holds
+    }
+
+    // Tree of the origin
+    QPair<int, int> treeKey(originId, -1);
+    Entry* entry = entries.object(treeKey);
+    if (!entry)
+    {
+        tally.count(Metrics::CacheMisses);
+        return false;
+    }
+
+    if (entry->tree.version != current && !revalidate(graph, entry->tree))
+    {
+        entries.remove(treeKey);
+        tally.count(Metrics::CacheInvalidations);
+        tally.count(Metrics::CacheMisses);
+        return false;
+    }
+
+    route = routeOf(graph, entry->tree, destId, distance);
+    tally.count(Metrics::CacheHits);
+
+    // Keep the reconstructed route for the next time
+    Entry* created = new Entry;
+    created->tree.version = current;
+    created->route = route;
+    created->distance = distance;
+    entries.insert(pathKey, created, costOf(*created));
+    return true;
+}
+
+// Store a tree
+void ShortestPathCache::insertTree(int originId, const Tree& tree)
+{
+    QPair<int, int> treeKey(originId, -1);
+    const Entry* cached = entries.object(treeKey);
+    if (cached && cached->tree.version > tree.version)
+    {
+        return;   // A job started before the cached one finished later
+    }
+
+    Entry* created = new Entry;
+    created->tree = tree;
+    entries.insert(treeKey, created, costOf(*created));   // Deleted right away if over the budget
+}
+
+// Set the byte budget
+void ShortestPathCache::setBudget(qint64 bytes)
+{
+    entries.setMaxCost(qMax<qint64>(1, bytes));
+}
+
+// Get the byte budget
+qint64 ShortestPathCache::getBudget() const
+{
+    return entries.maxCost();
+}
+
+// Get the bytes in use
+qint64 ShortestPathCache::getUsedBytes() const
+{
+    return entries.totalCost();
+}
+
+// Get the number of trees and paths
+int ShortestPathCache::getEntryCount() const
+{
+    return entries.size();
+}
+
+// Drop everything
+void ShortestPathCache::clear()
+{
+    entries.clear();
+}
+
+// Carry a tree over the changes made since it was computed
+bool ShortestPathCache::revalidate(const Graph& graph, Tree& tree)
+{
+    QVector<NetworkChange> changes;
+    if (!graph.getChangesSince(tree.version, changes))
+    {
+        return false;
+    }
+
+    for (const NetworkChange& change : changes)
+    {
+        if (isAffectedBy(graph, tree, change))
+        {
+            return false;
+        }
+    }
+
+    tree.version = graph.getVersion();
+    return true;
+}
+
+// Check if a change may alter a tree
+bool ShortestPathCache::isAffectedBy(const Graph& graph, const Tree& tree, const NetworkChange& change)
+{
+    bool undirected = !graph.isDirected();
+
+    switch (change.kind)
+    {
+    case NetworkChange::EdgeChanged:
+    case NetworkChange::EdgeRemoved:
+    case NetworkChange::RouteClosed:
+    case NetworkChange::RouteOpened:
+        // One of the tree's edges was removed, closed or re-weighted
+        if (predAt(tree, change.to) == change.from || (undirected && predAt(tree, change.from) == change.to))
+        {
+            return true;
+        }
+        // A shorter way into one of its ends
+        if (distAt(tree, change.from) + change.weight < distAt(tree, change.to))
+        {
+            return true;
+        }
+        return undirected && distAt(tree, change.to) + change.weight < distAt(tree, change.from);
+
+    case NetworkChange::StationClosed:
+        return distAt(tree, change.from) < INF;
+
+    case NetworkChange::StationOpened:
+        // Reachable through one of its routes (incoming routes are not indexed in directed graphs)
+        if (!undirected || distAt(tree, change.from) < INF)
+        {
+            return true;
+        }
+        for (const auto& neighbor : graph.neighborsAt(change.from))
+        {
+            if (distAt(tree, neighbor.first) < INF)
+            {
+                return true;
+            }
+        }
+        return false;
+
+    case NetworkChange::Reset:
+        return true;
+    }
+    return true;
+}
+
+// Approximate size of an entry in bytes
+qint64 ShortestPathCache::costOf(const Entry& entry)
+{
+    return sizeof(Entry) + entry.tree.dist.size() * sizeof(double) + entry.tree.pred.size() * sizeof(int)
+           + entry.route.size() * sizeof(int);
+}
+
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "Graph.h"
+#include <QCache>
+#include <QList>
+#include <QPair>
+#include <QVector>
+#include <QtGlobal>
+
+using namespace std;
+
+// Cache of shortest-path results over one Graph, for the origin/destination pairs
+// that operators keep asking for.
+// Two kinds of entries share one LRU with a byte budget:
+//   - trees: distances and predecessors of a whole Dijkstra run from an origin,
+//     so every destination from that origin is answered without a new run;
+//   - paths: the route and distance already reconstructed for one (origin, destination).
+// Every entry remembers the network version it was computed on. When the graph has
+// moved on, the tree is checked against Graph::getChangesSince(): it is only dropped
+// if a change touches one of its edges, closes one of its stations or opens a shorter
+// way; otherwise it is carried over to the current version.
+// Not thread safe: meant for the GUI thread (the trees are computed by AlgorithmWorker).
+class ShortestPathCache
+{
+public:
+    static const qint64 DefaultBudgetBytes = 64LL * 1024 * 1024;
+
+    // Shortest-path tree of one origin, by station index
+    struct Tree
+    {
+        quint64 version = 0;       // Network version it was computed on
+        QVector<double> dist;      // Infinity where unreachable
+        QVector<int> pred;         // -1 where there is no predecessor
+    };
+
+    explicit ShortestPathCache(qint64 budgetBytes = DefaultBudgetBytes);
+
+    // Run Dijkstra from an origin (safe on a worker snapshot); false if the station does not exist
+    static bool computeTree(const Graph& graph, int originId, Tree& tree, JobToken* token = nullptr);
+
+    // Route (station IDs, empty if unreachable) and distance to a destination of a tree
+    static QList<int> routeOf(const Graph& graph, const Tree& tree, int destId, double& distance);
+
+    // Route and distance from the cache; false on a miss
+    bool lookup(const Graph& graph, int originId, int destId, QList<int>& route, double& distance);
+
+    // Store the tree of an origin (one older than the cached tree is ignored)
+    void insertTree(int originId, const Tree& tree);
+
+    // Byte budget (least recently used entries go first)
+    void setBudget(qint64 bytes);
+    qint64 getBudget() const;
+    qint64 getUsedBytes() const;
+    int getEntryCount() const;
+
+    void clear();
+
+private:
+    // Trees use (origin, -1) as key; paths only fill in the version of 'tree'
+    struct Entry
+    {
+        Tree tree;
+        QList<int> route;
+        double distance = 0.0;
+    };
+
+    QCache<QPair<int, int>, Entry> entries;
+
+    // Bring a tree up to the graph's version; false if a change may have altered it
+    static bool revalidate(const Graph& graph, Tree& tree);
+    static bool isAffectedBy(const Graph& graph, const Tree& tree, const NetworkChange& change);
+
+    static qint64 costOf(const Entry& entry);
+};
+
@@ -2,9 +2,10 @@
 #include <QFile>
 #include <QTextStream>
 #include <QDebug>
+#include <algorithm>
 
 // Constructor
-StationBST::StationBST() : root(nullptr)
+StationBST::StationBST(const StationTable* table) : root(nullptr), table(table)
 {
 }
 
@@ -14,45 +15,127 @@ StationBST::~StationBST()
     clear();
 }
 
-// Insert a station into the BST
-void StationBST::insert(const Station& station)
+// Set the station table the tree indexes
+void StationBST::setStationTable(const StationTable* table)
 {
-    root = insertHelper(root, station);
+    this->table = table;
+}
+
+// Get the station table
+const StationTable* StationBST::getStationTable() const
+{
+    return table;
+}
+
+// Insert a station (already registered in the table) into the BST
+bool StationBST::insert(int id)
+{
+    int index = table ? table->indexOf(id) : StationTable::InvalidIndex;
+    
+    if (index == StationTable::InvalidIndex)
+    {
+        qDebug() << "Error: La estacion" << id << "no esta registrada en la tabla de estaciones.";
+        return false;
+    }
+    
+    root = insertHelper(root, id, index);
+    return true;
+}
+
+// Insert many stations at once; returns how many were inserted
+// On an empty tree the nodes are linked as a balanced tree from the sorted IDs,
+// otherwise they are inserted one by one
+int StationBST::insertBulk(const QList<int>& ids)
+{
+    if (!table)
+    {
+        qDebug() << "Error: El arbol no tiene tabla de estaciones asociada.";
+        return 0;
+    }
+    
+    if (root != nullptr)
+    {
+        int inserted = 0;
+        for (int id : ids)
+        {
+            if (insert(id))
+            {
+                inserted++;
+            }
+        }
+        return inserted;
+    }
+    
+    // Collect (ID, index) pairs of the registered stations
+    QList<QPair<int, int>> entries;
+    entries.reserve(ids.size());
+    for (int id : ids)
+    {
+        int index = table->indexOf(id);
+        if (index == StationTable::InvalidIndex)
+        {
+            qDebug() << "Error: La estacion" << id << "no esta registrada en la tabla de estaciones.";
+            continue;
+        }
+        entries.append(QPair<int, int>(id, index));
+    }
+    
+    // Sort by ID and drop duplicates
+    std::sort(entries.begin(), entries.end());
+    auto last = std::unique(entries.begin(), entries.end(),
+        [](const QPair<int, int>& a, const QPair<int, int>& b) { return a.first == b.first; });
+    entries.erase(last, entries.end());
+    
+    root = buildBalanced(entries, 0, static_cast<int>(entries.size()) - 1);
+    return static_cast<int>(entries.size());
+}
+
+// Private helper to build a balanced subtree from sorted entries (recursive)
+TreeNode* StationBST::buildBalanced(const QList<QPair<int, int>>& entries, int low, int high)
+{
+    if (low > high)
+    {
+        return nullptr;
+    }
+    
+    int middle = low + (high - low) / 2;
+    TreeNode* node = new TreeNode(entries[middle].first, entries[middle].second);
+    node->setLeft(buildBalanced(entries, low, middle - 1));
+    node->setRight(buildBalanced(entries, middle + 1, high));
+    
+    return node;
 }
 
 // Private helper for insertion (recursive)
-TreeNode* StationBST::insertHelper(TreeNode* node, const Station& station)
+TreeNode* StationBST::insertHelper(TreeNode* node, int key, int index)
 {
     if (node == nullptr)
     {
-        return new TreeNode(station);
+        return new TreeNode(key, index);
     }
     
-    if (station.getId() < node->getStation().getId())
+    if (key < node->getKey())
     {
-        node->setLeft(insertHelper(node->getLeft(), station));
+        node->setLeft(insertHelper(node->getLeft(), key, index));
     }
-    else if (station.getId() > node->getStation().getId())
+    else if (key > node->getKey())
     {
-        node->setRight(insertHelper(node->getRight(), station));
+        node->setRight(insertHelper(node->getRight(), key, index));
     }
     // If IDs are equal, don't insert (no duplicates)
     
     return node;
 }
 
-// Search for a station by ID
-Station* StationBST::search(int id)
+// Search for a station by ID (returns its index in the station table)
+int StationBST::search(int id) const
 {
     TreeNode* result = searchHelper(root, id);
     if (result != nullptr)
     {
-        // Return pointer to the station in the node
-        static Station temp;
-        temp = result->getStation();
-        return &temp;
+        return result->getIndex();
     }
-    return nullptr;
+    return StationTable::InvalidIndex;
 }
 
 // Private helper for search (recursive)
@@ -63,7 +146,7 @@ TreeNode* StationBST::searchHelper(TreeNode* node, int id) const
         return nullptr;
     }
     
-    int nodeId = node->getStation().getId();
+    int nodeId = node->getKey();
     
     if (id == nodeId)
     {
@@ -96,7 +179,7 @@ TreeNode* StationBST::removeHelper(TreeNode* node, int id, bool& found)
         return nullptr;
     }
     
-    int nodeId = node->getStation().getId();
+    int nodeId = node->getKey();
     
     if (id < nodeId)
     {
@@ -134,8 +217,8 @@ TreeNode* StationBST::removeHelper(TreeNode* node, int id, bool& found)
         else
         {
             TreeNode* minNode = findMin(node->getRight());
-            node->setStation(minNode->getStation());
-            node->setRight(removeHelper(node->getRight(), minNode->getStation().getId(), found));
+            node->setEntry(minNode->getKey(), minNode->getIndex());
+            node->setRight(removeHelper(node->getRight(), minNode->getKey(), found));
         }
     }
     
@@ -175,62 +258,68 @@ int StationBST::countHelper(TreeNode* node) const
 }
 
 // In-order traversal (Left, Root, Right)
-QList<Station> StationBST::inOrder() const
+QList<int> StationBST::inOrder() const
 {
-    QList<Station> result;
+    QList<int> result;
     inOrderHelper(root, result);
     return result;
 }
 
-void StationBST::inOrderHelper(TreeNode* node, QList<Station>& result) const
+void StationBST::inOrderHelper(TreeNode* node, QList<int>& result) const
 {
     if (node != nullptr)
     {
         inOrderHelper(node->getLeft(), result);
-        result.append(node->getStation());
+        result.append(node->getIndex());
         inOrderHelper(node->getRight(), result);
     }
 }
 
 // Pre-order traversal (Root, Left, Right)
-QList<Station> StationBST::preOrder() const
+QList<int> StationBST::preOrder() const
 {
-    QList<Station> result;
+    QList<int> result;
     preOrderHelper(root, result);
     return result;
 }
 
-void StationBST::preOrderHelper(TreeNode* node, QList<Station>& result) const
+void StationBST::preOrderHelper(TreeNode* node, QList<int>& result) const
 {
     if (node != nullptr)
     {
-        result.append(node->getStation());
+        result.append(node->getIndex());
         preOrderHelper(node->getLeft(), result);
         preOrderHelper(node->getRight(), result);
     }
 }
 
 // Post-order traversal (Left, Right, Root)
-QList<Station> StationBST::postOrder() const
+QList<int> StationBST::postOrder() const
 {
-    QList<Station> result;
+    QList<int> result;
     postOrderHelper(root, result);
     return result;
 }
 
-void StationBST::postOrderHelper(TreeNode* node, QList<Station>& result) const
+void StationBST::postOrderHelper(TreeNode* node, QList<int>& result) const
 {
     if (node != nullptr)
     {
         postOrderHelper(node->getLeft(), result);
         postOrderHelper(node->getRight(), result);
-        result.append(node->getStation());
+        result.append(node->getIndex());
     }
 }
 
 // Export traversals to file
 bool StationBST::exportTraversals(const QString& filename) const
 {
+    if (!table)
+    {
+        qDebug() << "Error: El arbol no tiene tabla de estaciones asociada.";
+        return false;
+    }
+    
     QFile file(filename);
     
     if (!file.open(QIODevice::WriteOnly | QIODevice::Text))
@@ -243,28 +332,28 @@ bool StationBST::exportTraversals(const QString& filename) const
     
     // Export In-Order traversal
     out << "=== RECORRIDO IN-ORDER (Izquierda, Raiz, Derecha) ===\n";
-    QList<Station> inOrderList = inOrder();
-    for (const Station& station : inOrderList)
+    QList<int> inOrderList = inOrder();
+    for (int index : inOrderList)
     {
-        out << station.toString() << "\n";
+        out << table->stationAt(index).toString() << "\n";
     }
     out << "\n";
     
     // Export Pre-Order traversal
     out << "=== RECORRIDO PRE-ORDER (Raiz, Izquierda, Derecha) ===\n";
-    QList<Station> preOrderList = preOrder();
-    for (const Station& station : preOrderList)
+    QList<int> preOrderList = preOrder();
+    for (int index : preOrderList)
     {
-        out << station.toString() << "\n";
+        out << table->stationAt(index).toString() << "\n";
     }
     out << "\n";
     
     // Export Post-Order traversal
     out << "=== RECORRIDO POST-ORDER (Izquierda, Derecha, Raiz) ===\n";
-    QList<Station> postOrderList = postOrder();
-    for (const Station& station : postOrderList)
+    QList<int> postOrderList = postOrder();
+    for (int index : postOrderList)
     {
-        out << station.toString() << "\n";
+        out << table->stationAt(index).toString() << "\n";
     }
     
     file.close();
@@ -2,6 +2,7 @@
 
 #include "TreeNode.h"
 #include "Station.h"
+#include "StationTable.h"
 #include <QString>
 #include <QList>
 
@@ -11,37 +12,44 @@ class StationBST
 {
 private:
     TreeNode* root;
+    const StationTable* table;   // Station data lives in the table; nodes keep only ID and index
     
     // Private helper methods for recursive operations
-    TreeNode* insertHelper(TreeNode* node, const Station& station);
+    TreeNode* insertHelper(TreeNode* node, int key, int index);
     TreeNode* searchHelper(TreeNode* node, int id) const;
     TreeNode* removeHelper(TreeNode* node, int id, bool& found);
     TreeNode* findMin(TreeNode* node) const;
+    TreeNode* buildBalanced(const QList<QPair<int, int>>& entries, int low, int high);
     
-    // Recursive traversal helpers
-    void inOrderHelper(TreeNode* node, QList<Station>& result) const;
-    void preOrderHelper(TreeNode* node, QList<Station>& result) const;
-    void postOrderHelper(TreeNode* node, QList<Station>& result) const;
+    // Recursive traversal helpers (collect station table indices)
+    void inOrderHelper(TreeNode* node, QList<int>& result) const;
+    void preOrderHelper(TreeNode* node, QList<int>& result) const;
+    void postOrderHelper(TreeNode* node, QList<int>& result) const;
     
     // Memory management
     void clearHelper(TreeNode* node);
     
 public:
     // Constructor and Destructor
-    StationBST();
+    StationBST(const StationTable* table = nullptr);
     ~StationBST();
     
+    // Station table the tree indexes
+    void setStationTable(const StationTable* table);
+    const StationTable* getStationTable() const;
+    
     // Core BST operations
-    void insert(const Station& station);
-    Station* search(int id);
+    bool insert(int id);          // The station must already be in the table
+    int insertBulk(const QList<int>& ids);   // Balanced build when the tree is empty
+    int search(int id) const;     // Table index, or StationTable::InvalidIndex
     bool remove(int id);
     bool isEmpty() const;
     int count() const;
     
-    // Traversal methods
-    QList<Station> inOrder() const;
-    QList<Station> preOrder() const;
-    QList<Station> postOrder() const;
+    // Traversal methods (station table indices)
+    QList<int> inOrder() const;
+    QList<int> preOrder() const;
+    QList<int> postOrder() const;
     
     // File export
     bool exportTraversals(const QString& filename) const;
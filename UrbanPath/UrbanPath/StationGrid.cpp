@@ -0,0 +1,177 @@
+#include "StationGrid.h"
+#include <algorithm>
+#include <cmath>
+
+// Constructor
+StationGrid::StationGrid() : cellSize(0.0), columns(0), rows(0)
+{
+}
+
+// Cell of a point (clamped to the grid)
+int StationGrid::cellOf(double x, double y) const
+{
+    int column = static_cast<int>((x - bounds.left()) / cellSize);
+    int row = static_cast<int>((y - bounds.top()) / cellSize);
+    column = std::max(0, std::min(column, columns - 1));
+    row = std::max(0, std::min(row, rows - 1));
+    return row * columns + column;
+}
+
+// Build the grid
+void StationGrid::build(const StationTable& table, int stationsPerCell)
+{
+    clear();
+
+    QList<int> stations = table.indices();
+    if (stations.isEmpty())
+    {
+        return;
+    }
+
+    // Bounding box
+    double minX = table.xAt(stations.first());
+    double maxX = minX;
+    double minY = table.yAt(stations.first());
+    double maxY = minY;
+    for (int index : stations)
+    {
+        minX = std::min(minX, table.xAt(index));
+        maxX = std::max(maxX, table.xAt(index));
+        minY = std::min(minY, table.yAt(index));
+        maxY = std::max(maxY, table.yAt(index));
+    }
+
+    // Square cells sized for the requested density (at least 1 unit, at most 2048 per side)
+    double width = std::max(maxX - minX, 1.0);
+    double height = std::max(maxY - minY, 1.0);
+    int cellCount = std::max(1, static_cast<int>(stations.size()) / std::max(1, stationsPerCell));
+    cellSize = std::max({ std::sqrt(width * height / cellCount), width / 2048.0, height / 2048.0, 1.0 });
+    columns = static_cast<int>(width / cellSize) + 1;
+    rows = static_cast<int>(height / cellSize) + 1;
+    bounds = QRectF(minX, minY, columns * cellSize, rows * cellSize);
+
+    // Counting sort by cell
+    int cells = columns * rows;
+    cellStart.fill(0, cells + 1);
+    cellSumX.fill(0.0, cells);
+    cellSumY.fill(0.0, cells);
+
+    QVector<int> cellOfStation(stations.size());
+    for (int i = 0; i < stations.size(); i++)
+    {
+        double x = table.xAt(stations[i]);
+        double y = table.yAt(stations[i]);
+        int cell = cellOf(x, y);
+        cellOfStation[i] = cell;
+        cellStart[cell + 1]++;
+        cellSumX[cell] += x;
+        cellSumY[cell] += y;
+    }
+
+    for (int cell = 0; cell < cells; cell++)
+    {
+        cellStart[cell + 1] += cellStart[cell];
+    }
+
+    QVector<int> next(cellStart.constBegin(), cellStart.constEnd() - 1);
+    cellIndices.resize(stations.size());
+    for (int i = 0; i < stations.size(); i++)
+    {
+        cellIndices[next[cellOfStation[i]]++] = stations[i];
+    }
+}
+
+// Remove all cells
+void StationGrid::clear()
+{
+    bounds = QRectF();
+    cellSize = 0.0;
+    columns = 0;
+    rows = 0;
+    cellStart.clear();
+    cellIndices.clear();
+    cellSumX.clear();
+    cellSumY.clear();
+}
+
+// Check if the grid has cells
+bool StationGrid::isEmpty() const
+{
+    return columns == 0;
+}
+
+// Get bounding box
+QRectF StationGrid::getBounds() const
+{
+    return bounds;
+}
+
+// Get cell size
+double StationGrid::getCellSize() const
+{
+    return cellSize;
+}
+
+// Get number of columns
+int StationGrid::getColumns() const
+{
+    return columns;
+}
+
+// Get number of rows
+int StationGrid::getRows() const
+{
+    return rows;
+}
+
+// Get cells overlapping a rectangle
+bool StationGrid::cellRange(const QRectF& rect, int& firstColumn, int& firstRow, int& lastColumn, int& lastRow) const
+{
+    if (isEmpty() || !rect.intersects(bounds))
+    {
+        return false;
+    }
+
+    firstColumn = std::max(0, static_cast<int>((rect.left() - bounds.left()) / cellSize));
+    firstRow = std::max(0, static_cast<int>((rect.top() - bounds.top()) / cellSize));
+    lastColumn = std::min(columns - 1, static_cast<int>((rect.right() - bounds.left()) / cellSize));
+    lastRow = std::min(rows - 1, static_cast<int>((rect.bottom() - bounds.top()) / cellSize));
+    return true;
+}
+
+// Get stations near a rectangle
+QList<int> StationGrid::query(const QRectF& rect) const
+{
+    QList<int> result;
+    int firstColumn, firstRow, lastColumn, lastRow;
+    if (!cellRange(rect, firstColumn, firstRow, lastColumn, lastRow))
+    {
+        return result;
+    }
+
+    for (int row = firstRow; row <= lastRow; row++)
+    {
+        int begin = cellStart[row * columns + firstColumn];
+        int end = cellStart[row * columns + lastColumn + 1];
+        for (int i = begin; i < end; i++)
+        {
+            result.append(cellIndices[i]);
+        }
+    }
+    return result;
+}
+
+// Get number of stations in a cell
+int StationGrid::countAt(int column, int row) const
+{
+    int cell = row * columns + column;
+    return cellStart[cell + 1] - cellStart[cell];
+}
+
+// Get coordinate sums of a cell
+QPointF StationGrid::sumAt(int column, int row) const
+{
+    int cell = row * columns + column;
+    return QPointF(cellSumX[cell], cellSumY[cell]);
+}
+
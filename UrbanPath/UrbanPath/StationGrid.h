@@ -0,0 +1,55 @@
+#pragma once
+
+#include "StationTable.h"
+#include <QRectF>
+#include <QPointF>
+#include <QVector>
+#include <QList>
+
+using namespace std;
+
+// Uniform grid over station coordinates, used by the visualizer to find the stations
+// near the viewport and to aggregate far-away stations into clusters.
+// Cells are stored as one flat array of station table indices sorted by cell
+// (cellStart[c] .. cellStart[c + 1]); build() is a counting sort, O(stations).
+class StationGrid
+{
+private:
+    QRectF bounds;              // Bounding box of the stations
+    double cellSize;            // Side of a cell in scene units
+    int columns;
+    int rows;
+
+    QVector<int> cellStart;     // First entry of each cell (columns * rows + 1 entries)
+    QVector<int> cellIndices;   // Station table indices, grouped by cell
+    QVector<double> cellSumX;   // Sum of X per cell (cluster centers)
+    QVector<double> cellSumY;   // Sum of Y per cell
+
+    int cellOf(double x, double y) const;
+
+public:
+    // Constructor
+    StationGrid();
+
+    // Rebuild from the live stations; cells hold about 'stationsPerCell' stations on average
+    void build(const StationTable& table, int stationsPerCell = 16);
+    void clear();
+    bool isEmpty() const;
+
+    // Geometry
+    QRectF getBounds() const;
+    double getCellSize() const;
+    int getColumns() const;
+    int getRows() const;
+
+    // Cell range (inclusive) overlapping a rectangle; false if it misses the grid
+    bool cellRange(const QRectF& rect, int& firstColumn, int& firstRow, int& lastColumn, int& lastRow) const;
+
+    // Station indices in the cells overlapping a rectangle (may include stations just outside it)
+    QList<int> query(const QRectF& rect) const;
+
+    // Stations of one cell: count and coordinate sums
+    int countAt(int column, int row) const;
+    QPointF sumAt(int column, int row) const;
+};
+
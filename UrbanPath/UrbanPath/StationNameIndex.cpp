@@ -0,0 +1,516 @@
+#include "StationNameIndex.h"
+#include "Graph.h"
+#include <QSet>
+#include <QDebug>
+#include <algorithm>
+
+// Constructor
+StationNameIndex::StationNameIndex() : stationCount(0), deadChars(0)
+{
+}
+
+// Normalize text for matching: accents removed, case folded, one space between words
+QString StationNameIndex::normalize(const QString& text)
+{
+    QString decomposed = text.normalized(QString::NormalizationForm_D);
+    QString result;
+    result.reserve(decomposed.size());
+
+    bool pendingSpace = false;
+    for (const QChar& c : decomposed)
+    {
+        // Drop combining accents left by the decomposition
+        if (c.category() == QChar::Mark_NonSpacing)
+        {
+            continue;
+        }
+
+        if (c.isLetterOrNumber())
+        {
+            if (pendingSpace && !result.isEmpty())
+            {
+                result.append(QChar(' '));
+            }
+            pendingSpace = false;
+            result.append(c.toCaseFolded());
+        }
+        else
+        {
+            // Punctuation and whitespace act as word separators
+            pendingSpace = true;
+        }
+    }
+
+    return result;
+}
+
+// Build the index from the stations registered in the graph
+void StationNameIndex::build(const Graph& graph)
+{
+    QList<QPair<int, QString>> names;
+    const StationTable& table = graph.getStationTable();
+    names.reserve(table.size());
+
+    for (int index : table.indices())
+    {
+        names.append(QPair<int, QString>(table.idAt(index), table.nameAt(index)));
+    }
+
+    build(names);
+}
+
+// Build the index from (station id, name) pairs
+void StationNameIndex::build(const QList<QPair<int, QString>>& names)
+{
+    clear();
+
+    for (const auto& item : names)
+    {
+        QString key = normalize(item.second);
+        if (key.isEmpty())
+        {
+            continue;
+        }
+
+        int start = arena.size();
+        arena.append(key);
+
+        // Index the suffix that starts at every word boundary
+        int wordIndex = 0;
+        for (int i = 0; i < key.size(); i++)
+        {
+            if (i == 0 || key[i - 1] == QChar(' '))
+            {
+                Entry entry;
+                entry.keyOffset = start + i;
+                entry.keyLength = key.size() - i;
+                entry.stationId = item.first;
+                entry.wordIndex = wordIndex++;
+                entries.append(entry);
+            }
+        }
+
+        stationCount++;
+    }
+
+    arena.squeeze();
+
+    std::sort(entries.begin(), entries.end(), [this](const Entry& a, const Entry& b) {
+        return entryLess(a, b);
+    });
+}
+
+// Index the name of one station without rebuilding the rest
+void StationNameIndex::insert(int stationId, const QString& name)
+{
+    remove(stationId);
+
+    QString key = normalize(name);
+    if (key.isEmpty())
+    {
+        return;
+    }
+
+    int start = arena.size();
+    arena.append(key);
+
+    // Each word suffix goes to its sorted position
+    int wordIndex = 0;
+    for (int i = 0; i < key.size(); i++)
+    {
+        if (i == 0 || key[i - 1] == QChar(' '))
+        {
+            Entry entry;
+            entry.keyOffset = start + i;
+            entry.keyLength = key.size() - i;
+            entry.stationId = stationId;
+            entry.wordIndex = wordIndex++;
+
+            auto position = std::upper_bound(entries.begin(), entries.end(), entry, [this](const Entry& a, const Entry& b) {
+                return entryLess(a, b);
+            });
+            entries.insert(position - entries.begin(), entry);
+        }
+    }
+
+    stationCount++;
+}
+
+// Drop the name of one station (the arena is compacted once half of it is dead text)
+void StationNameIndex::remove(int stationId)
+{
+    int kept = 0;
+    for (int i = 0; i < entries.size(); i++)
+    {
+        if (entries[i].stationId != stationId)
+        {
+            entries[kept++] = entries[i];
+        }
+        else if (entries[i].wordIndex == 0)
+        {
+            deadChars += entries[i].keyLength;
+        }
+    }
+
+    if (kept < entries.size())
+    {
+        entries.resize(kept);
+        stationCount--;
+    }
+
+    if (deadChars > arena.size() / 2)
+    {
+        compactArena();
+    }
+}
+
+// Copy the live names to a fresh arena (the order of the entries does not change)
+void StationNameIndex::compactArena()
+{
+    QString compacted;
+    compacted.reserve(arena.size() - deadChars);
+
+    // Old and new start of every live name (the whole-name entry starts it)
+    QHash<int, QPair<int, int>> starts;
+    starts.reserve(stationCount);
+    for (const Entry& entry : entries)
+    {
+        if (entry.wordIndex == 0)
+        {
+            starts.insert(entry.stationId, QPair<int, int>(entry.keyOffset, compacted.size()));
+            compacted.append(keyOf(entry));
+        }
+    }
+
+    for (Entry& entry : entries)
+    {
+        const QPair<int, int>& start = starts[entry.stationId];
+        entry.keyOffset = start.second + (entry.keyOffset - start.first);
+    }
+
+    arena = compacted;
+    deadChars = 0;
+}
+
+// Clear all indexed data
+void StationNameIndex::clear()
+{
+    arena.clear();
+    entries.clear();
+    stationCount = 0;
+    deadChars = 0;
+}
+
+// Check if the index is empty
+bool StationNameIndex::isEmpty() const
+{
+    return entries.isEmpty();
+}
+
+// Number of indexed stations
+int StationNameIndex::size() const
+{
+    return stationCount;
+}
+
+// Number of indexed word suffixes
+int StationNameIndex::entryCount() const
+{
+    return entries.size();
+}
+
+// Text of an entry inside the arena
+QStringView StationNameIndex::keyOf(const Entry& entry) const
+{
+    return QStringView(arena.constData() + entry.keyOffset, entry.keyLength);
+}
+
+// Sort order of the entries: suffix text, then word position, then station
+bool StationNameIndex::entryLess(const Entry& a, const Entry& b) const
+{
+    int cmp = compareKeys(keyOf(a), keyOf(b));
+    if (cmp != 0)
+    {
+        return cmp < 0;
+    }
+    if (a.wordIndex != b.wordIndex)
+    {
+        return a.wordIndex < b.wordIndex;
+    }
+    return a.stationId < b.stationId;
+}
+
+// Compare two keys by UTF-16 code unit (the order the implicit trie relies on)
+int StationNameIndex::compareKeys(QStringView a, QStringView b) const
+{
+    int n = qMin(a.size(), b.size());
+    for (int i = 0; i < n; i++)
+    {
+        char16_t ca = a[i].unicode();
+        char16_t cb = b[i].unicode();
+        if (ca != cb)
+        {
+            return ca < cb ? -1 : 1;
+        }
+    }
+
+    if (a.size() == b.size())
+    {
+        return 0;
+    }
+    return a.size() < b.size() ? -1 : 1;
+}
+
+// First entry whose key is not smaller than the prefix
+int StationNameIndex::findRangeStart(QStringView prefix) const
+{
+    auto it = std::partition_point(entries.begin(), entries.end(), [this, prefix](const Entry& entry) {
+        return compareKeys(keyOf(entry), prefix) < 0;
+    });
+    return static_cast<int>(it - entries.begin());
+}
+
+// First entry after the block of keys that start with the prefix
+int StationNameIndex::findRangeEnd(QStringView prefix) const
+{
+    auto it = std::partition_point(entries.begin(), entries.end(), [this, prefix](const Entry& entry) {
+        QStringView key = keyOf(entry);
+        return compareKeys(key.left(qMin(key.size(), prefix.size())), prefix) <= 0;
+    });
+    return static_cast<int>(it - entries.begin());
+}
+
+// In [lo, hi) every key is longer than depth; find the end of the block with character c at depth
+int StationNameIndex::findCharEnd(int lo, int hi, int depth, char16_t c) const
+{
+    auto it = std::partition_point(entries.begin() + lo, entries.begin() + hi, [this, depth, c](const Entry& entry) {
+        return keyOf(entry)[depth].unicode() <= c;
+    });
+    return static_cast<int>(it - entries.begin());
+}
+
+// Record every entry in [lo, hi) as a match (bounded per range to keep queries cheap)
+void StationNameIndex::collectRange(int lo, int hi, int distance, int perRangeLimit,
+                                    QHash<int, int>& bestDistance) const
+{
+    int end = (perRangeLimit > 0) ? qMin(hi, lo + perRangeLimit) : hi;
+
+    for (int i = lo; i < end; i++)
+    {
+        int id = entries[i].stationId;
+        auto it = bestDistance.find(id);
+        if (it == bestDistance.end())
+        {
+            bestDistance.insert(id, distance);
+        }
+        else if (distance < it.value())
+        {
+            it.value() = distance;
+        }
+    }
+}
+
+// Walk the implicit trie keeping one Levenshtein row per depth.
+// All keys in [lo, hi) share their first 'depth' characters; rows[depth] holds
+// the edit distances between that shared prefix and every prefix of the query.
+void StationNameIndex::fuzzyWalk(int lo, int hi, int depth, QStringView query, int maxDistance,
+                                 bool prefixMode, QVector<int>& rows, int perRangeLimit,
+                                 QHash<int, int>& bestDistance) const
+{
+    const int m = query.size();
+    const int* prev = rows.constData() + depth * (m + 1);
+
+    // Prefix mode: the whole query is already matched, so every key below matches
+    if (prefixMode && prev[m] <= maxDistance)
+    {
+        collectRange(lo, hi, prev[m], perRangeLimit, bestDistance);
+        if (prev[m] == 0)
+        {
+            return;  // Cannot improve further down
+        }
+    }
+
+    int i = lo;
+
+    // Keys that end exactly at this depth sort first
+    while (i < hi && entries[i].keyLength == depth)
+    {
+        if (!prefixMode && prev[m] <= maxDistance)
+        {
+            collectRange(i, i + 1, prev[m], 0, bestDistance);
+        }
+        i++;
+    }
+
+    // One child per distinct character at this depth
+    while (i < hi)
+    {
+        char16_t c = keyOf(entries[i])[depth].unicode();
+        int groupEnd = findCharEnd(i, hi, depth, c);
+
+        int* current = rows.data() + (depth + 1) * (m + 1);
+        current[0] = prev[0] + 1;
+        int rowMin = current[0];
+
+        for (int j = 1; j <= m; j++)
+        {
+            int cost = (query[j - 1].unicode() == c) ? 0 : 1;
+            int value = qMin(qMin(current[j - 1] + 1, prev[j] + 1), prev[j - 1] + cost);
+            current[j] = value;
+            rowMin = qMin(rowMin, value);
+        }
+
+        // Prune subtrees that can no longer get within the distance bound
+        if (rowMin <= maxDistance)
+        {
+            fuzzyWalk(i, groupEnd, depth + 1, query, maxDistance, prefixMode, rows, perRangeLimit, bestDistance);
+        }
+
+        i = groupEnd;
+    }
+}
+
+// Stations whose full name starts with the given text
+QList<int> StationNameIndex::prefixSearch(const QString& prefix, int limit) const
+{
+    QList<int> result;
+    QString key = normalize(prefix);
+
+    if (key.isEmpty() || entries.isEmpty())
+    {
+        return result;
+    }
+
+    int start = findRangeStart(key);
+    int end = findRangeEnd(key);
+
+    for (int i = start; i < end; i++)
+    {
+        // Only whole-name entries, each station has exactly one
+        if (entries[i].wordIndex == 0)
+        {
+            result.append(entries[i].stationId);
+            if (limit > 0 && result.size() >= limit)
+            {
+                break;
+            }
+        }
+    }
+
+    return result;
+}
+
+// Top-k suggestions for an incremental completer
+QList<int> StationNameIndex::autocomplete(const QString& text, int k) const
+{
+    QList<int> result;
+    QString key = normalize(text);
+
+    if (key.isEmpty() || entries.isEmpty() || k <= 0)
+    {
+        return result;
+    }
+
+    QSet<int> added;
+    int start = findRangeStart(key);
+    int end = findRangeEnd(key);
+
+    // 1. Names that start with the text (lexicographic, so exact matches come first)
+    for (int i = start; i < end && result.size() < k; i++)
+    {
+        if (entries[i].wordIndex == 0 && !added.contains(entries[i].stationId))
+        {
+            added.insert(entries[i].stationId);
+            result.append(entries[i].stationId);
+        }
+    }
+
+    // 2. Names with a later word that starts with the text
+    for (int i = start; i < end && result.size() < k; i++)
+    {
+        if (!added.contains(entries[i].stationId))
+        {
+            added.insert(entries[i].stationId);
+            result.append(entries[i].stationId);
+        }
+    }
+
+    // 3. Typo tolerant fallback: prefixes within one (short text) or two edits
+    if (result.size() < k)
+    {
+        int maxDistance = (key.size() <= 4) ? 1 : 2;
+        const int m = key.size();
+        QVector<int> rows((m + maxDistance + 2) * (m + 1));
+        for (int j = 0; j <= m; j++)
+        {
+            rows[j] = j;
+        }
+
+        QHash<int, int> bestDistance;
+        fuzzyWalk(0, entries.size(), 0, key, maxDistance, true, rows, k, bestDistance);
+
+        QList<QPair<int, int>> candidates;
+        for (auto it = bestDistance.begin(); it != bestDistance.end(); ++it)
+        {
+            if (!added.contains(it.key()))
+            {
+                candidates.append(QPair<int, int>(it.value(), it.key()));
+            }
+        }
+        std::sort(candidates.begin(), candidates.end());
+
+        for (const auto& candidate : candidates)
+        {
+            if (result.size() >= k)
+            {
+                break;
+            }
+            result.append(candidate.second);
+        }
+    }
+
+    return result;
+}
+
+// Bounded edit-distance search over names and their word suffixes
+QList<QPair<int, int>> StationNameIndex::fuzzySearch(const QString& text, int maxDistance, int limit) const
+{
+    QList<QPair<int, int>> result;
+    QString key = normalize(text);
+
+    if (key.isEmpty() || entries.isEmpty() || maxDistance < 0)
+    {
+        return result;
+    }
+
+    const int m = key.size();
+    QVector<int> rows((m + maxDistance + 2) * (m + 1));
+    for (int j = 0; j <= m; j++)
+    {
+        rows[j] = j;
+    }
+
+    QHash<int, int> bestDistance;
+    fuzzyWalk(0, entries.size(), 0, key, maxDistance, false, rows, 0, bestDistance);
+
+    // Order by distance, then by station ID for stable output
+    QList<QPair<int, int>> ordered;
+    ordered.reserve(bestDistance.size());
+    for (auto it = bestDistance.begin(); it != bestDistance.end(); ++it)
+    {
+        ordered.append(QPair<int, int>(it.value(), it.key()));
+    }
+    std::sort(ordered.begin(), ordered.end());
+
+    for (const auto& item : ordered)
+    {
+        if (limit > 0 && result.size() >= limit)
+        {
+            break;
+        }
+        result.append(QPair<int, int>(item.second, item.first));
+    }
+
+    return result;
+}
+
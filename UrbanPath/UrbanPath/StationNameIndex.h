@@ -0,0 +1,88 @@
+#pragma once
+
+#include <QString>
+#include <QStringView>
+#include <QList>
+#include <QVector>
+#include <QPair>
+#include <QHash>
+
+using namespace std;
+
+// Forward declaration to avoid circular dependencies
+class Graph;
+
+// Compact text index over station names.
+// Every normalized name is stored once in a single arena; the index itself is
+// a sorted array of word-start suffixes pointing into that arena, which works
+// as an implicit trie for prefix, autocomplete and bounded edit-distance queries.
+class StationNameIndex
+{
+private:
+    // One entry per word start inside a normalized name
+    struct Entry
+    {
+        int keyOffset;   // Start of the indexed suffix inside the arena
+        int keyLength;   // Length of the suffix (up to the end of the name)
+        int stationId;   // Station the name belongs to
+        int wordIndex;   // 0 when the suffix is the whole name
+    };
+
+    QString arena;              // Normalized names stored back to back
+    QVector<Entry> entries;     // Sorted by suffix text
+    int stationCount;
+    int deadChars;              // Arena text of removed names
+
+    // Copy the live names to a fresh arena
+    void compactArena();
+
+    // Helpers for the implicit trie
+    QStringView keyOf(const Entry& entry) const;
+    bool entryLess(const Entry& a, const Entry& b) const;
+    int compareKeys(QStringView a, QStringView b) const;
+    int findRangeStart(QStringView prefix) const;
+    int findRangeEnd(QStringView prefix) const;
+    int findCharEnd(int lo, int hi, int depth, char16_t c) const;
+
+    // Recursive Levenshtein walk over the implicit trie
+    void fuzzyWalk(int lo, int hi, int depth, QStringView query, int maxDistance,
+                   bool prefixMode, QVector<int>& rows, int perRangeLimit,
+                   QHash<int, int>& bestDistance) const;
+
+    // Add every entry in [lo, hi) as a match with the given distance
+    void collectRange(int lo, int hi, int distance, int perRangeLimit,
+                      QHash<int, int>& bestDistance) const;
+
+public:
+    // Constructor
+    StationNameIndex();
+
+    // Index construction
+    void build(const Graph& graph);
+    void build(const QList<QPair<int, QString>>& names);
+    void clear();
+
+    // Single-station updates (a name already indexed for the station is replaced)
+    void insert(int stationId, const QString& name);
+    void remove(int stationId);
+
+    // Index information
+    bool isEmpty() const;
+    int size() const;         // Indexed stations
+    int entryCount() const;   // Indexed word suffixes
+
+    // Text normalization (case folding, accents removed, single spaces)
+    static QString normalize(const QString& text);
+
+    // Stations whose full name starts with the given text
+    QList<int> prefixSearch(const QString& prefix, int limit = -1) const;
+
+    // Best k suggestions: full-name prefix matches, then word prefix matches,
+    // then prefix matches within one or two edits as a fallback
+    QList<int> autocomplete(const QString& text, int k = 10) const;
+
+    // Stations whose name (or any word suffix of it) is within maxDistance edits
+    // Returns (station id, edit distance) pairs ordered by distance
+    QList<QPair<int, int>> fuzzySearch(const QString& text, int maxDistance = 2, int limit = 10) const;
+};
+
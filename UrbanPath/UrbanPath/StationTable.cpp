@@ -0,0 +1,369 @@
+#include "StationTable.h"
+#include <utility>
+
+// Constructor
+StationTable::StationTable() : liveCount(0), liveNameChars(0)
+{
+}
+
+// Store a name in the arena and return its offset
+int StationTable::appendName(const QString& name)
+{
+    int offset = nameArena.size();
+    nameArena.append(name);
+    return offset;
+}
+
+// Renames and removals leave dead ranges behind; copy the live names once they pass half the arena
+void StationTable::compactNamesIfSparse()
+{
+    if (nameArena.size() - liveNameChars <= nameArena.size() / 2)
+    {
+        return;
+    }
+
+    QString compacted;
+    compacted.reserve(liveNameChars);
+    for (int i = 0; i < ids.size(); i++)
+    {
+        int offset = compacted.size();
+        compacted.append(QStringView(nameArena.constData() + nameOffsets[i], nameLengths[i]));
+        nameOffsets[i] = offset;
+    }
+    nameArena = compacted;
+}
+
+// Add a station from a Station value
+int StationTable::add(const Station& station)
+{
+    return add(station.getId(), station.getName(), station.getX(), station.getY());
+}
+
+// Add a station (or update it in place if the ID already exists)
+int StationTable::add(int id, const QString& name, double x, double y)
+{
+    auto it = indexById.constFind(id);
+    if (it != indexById.constEnd())
+    {
+        int index = it.value();
+        setNameAt(index, name);
+        setPositionAt(index, x, y);
+        return index;
+    }
+
+    // Take a dead slot first so removals and reloads do not grow every per-slot array
+    int index;
+    if (!freeSlots.isEmpty())
+    {
+        index = freeSlots.takeLast();
+        ids[index] = id;
+        xs[index] = x;
+        ys[index] = y;
+        nameOffsets[index] = appendName(name);
+        nameLengths[index] = name.size();
+    }
+    else
+    {
+        index = ids.size();
+        ids.append(id);
+        xs.append(x);
+        ys.append(y);
+        nameOffsets.append(appendName(name));
+        nameLengths.append(name.size());
+    }
+    liveNameChars += name.size();
+
+    indexById.insert(id, index);
+    liveCount++;
+
+    return index;
+}
+
+// Remove a station; its slot stays reserved (other indices remain valid) until a later add reuses it
+bool StationTable::remove(int id)
+{
+    auto it = indexById.find(id);
+    if (it == indexById.end())
+    {
+        return false;
+    }
+
+    int index = it.value();
+    indexById.erase(it);
+
+    ids[index] = RemovedId;
+    liveNameChars -= nameLengths[index];
+    nameLengths[index] = 0;
+    liveCount--;
+    freeSlots.append(index);
+
+    compactNamesIfSparse();
+
+    return true;
+}
+
+// Clear all columns
+void StationTable::clear()
+{
+    ids.clear();
+    xs.clear();
+    ys.clear();
+    nameOffsets.clear();
+    nameLengths.clear();
+    nameArena.clear();
+    indexById.clear();
+    freeSlots.clear();
+    liveCount = 0;
+    liveNameChars = 0;
+}
+
+// Reserve space for bulk loads
+void StationTable::reserve(int stations, int nameChars)
+{
+    ids.reserve(stations);
+    xs.reserve(stations);
+    ys.reserve(stations);
+    nameOffsets.reserve(stations);
+    nameLengths.reserve(stations);
+    indexById.reserve(stations);
+
+    if (nameChars > 0)
+    {
+        nameArena.reserve(nameChars);
+    }
+}
+
+// Get the slot index of a station ID
+int StationTable::indexOf(int id) const
+{
+    return indexById.value(id, InvalidIndex);
+}
+
+// Check if a station ID exists
+bool StationTable::contains(int id) const
+{
+    return indexById.contains(id);
+}
+
+// Check if an index refers to a live station
+bool StationTable::isValidIndex(int index) const
+{
+    return index >= 0 && index < ids.size() && ids[index] != RemovedId;
+}
+
+// Number of live stations
+int StationTable::size() const
+{
+    return liveCount;
+}
+
+// Number of slots (live and removed)
+int StationTable::slotCount() const
+{
+    return ids.size();
+}
+
+// Check if there are no live stations
+bool StationTable::isEmpty() const
+{
+    return liveCount == 0;
+}
+
+// Column getters
+int StationTable::idAt(int index) const
+{
+    return ids[index];
+}
+
+double StationTable::xAt(int index) const
+{
+    return xs[index];
+}
+
+double StationTable::yAt(int index) const
+{
+    return ys[index];
+}
+
+QStringView StationTable::nameViewAt(int index) const
+{
+    return QStringView(nameArena.constData() + nameOffsets[index], nameLengths[index]);
+}
+
+QString StationTable::nameAt(int index) const
+{
+    return nameViewAt(index).toString();
+}
+
+// Build a Station value (for code that still works with Station objects)
+Station StationTable::stationAt(int index) const
+{
+    return Station(ids[index], nameAt(index), xs[index], ys[index]);
+}
+
+// Update the name of a station
+void StationTable::setNameAt(int index, const QString& name)
+{
+    // Reuse the current arena range when the new name fits
+    if (name.size() <= nameLengths[index])
+    {
+        int offset = nameOffsets[index];
+        for (int i = 0; i < name.size(); i++)
+        {
+            nameArena[offset + i] = name[i];
+        }
+    }
+    else
+    {
+        nameOffsets[index] = appendName(name);
+    }
+    liveNameChars += name.size() - nameLengths[index];
+    nameLengths[index] = name.size();
+
+    compactNamesIfSparse();
+}
+
+// Update the position of a station
+void StationTable::setPositionAt(int index, double x, double y)
+{
+    xs[index] = x;
+    ys[index] = y;
+}
+
+// Live indices in slot order
+QList<int> StationTable::indices() const
+{
+    QList<int> result;
+    result.reserve(liveCount);
+
+    for (int i = 0; i < ids.size(); i++)
+    {
+        if (ids[i] != RemovedId)
+        {
+            result.append(i);
+        }
+    }
+
+    return result;
+}
+
+// Raw column access
+const QVector<int>& StationTable::idColumn() const
+{
+    return ids;
+}
+
+const QVector<double>& StationTable::xColumn() const
+{
+    return xs;
+}
+
+const QVector<double>& StationTable::yColumn() const
+{
+    return ys;
+}
+
+const QVector<int>& StationTable::nameOffsetColumn() const
+{
+    return nameOffsets;
+}
+
+const QVector<int>& StationTable::nameLengthColumn() const
+{
+    return nameLengths;
+}
+
+const QString& StationTable::nameArenaData() const
+{
+    return nameArena;
+}
+
+// Replace all columns at once and rebuild the ID lookup
+void StationTable::assignColumns(QVector<int> idColumn, QVector<double> xColumn, QVector<double> yColumn,
+                                 QVector<int> nameOffsetColumn, QVector<int> nameLengthColumn, QString arena)
+{
+    ids = std::move(idColumn);
+    xs = std::move(xColumn);
+    ys = std::move(yColumn);
+    nameOffsets = std::move(nameOffsetColumn);
+    nameLengths = std::move(nameLengthColumn);
+    nameArena = std::move(arena);
+
+    indexById.clear();
+    indexById.reserve(ids.size());
+    freeSlots.clear();
+    liveCount = 0;
+    liveNameChars = 0;
+
+    for (int i = 0; i < ids.size(); i++)
+    {
+        if (ids[i] != RemovedId)
+        {
+            indexById.insert(ids[i], i);
+            liveCount++;
+            liveNameChars += nameLengths[i];
+        }
+        else
+        {
+            nameLengths[i] = 0;
+            freeSlots.append(i);
+        }
+    }
+}
+
+// Build a dense ID -> index array when the ID range is compact enough
+bool StationTable::makeDenseLookup(QVector<int>& lookup, int& minId) const
+{
+    lookup.clear();
+    minId = 0;
+
+    if (liveCount == 0)
+    {
+        return false;
+    }
+
+    int maxId = INT_MIN;
+    minId = INT_MAX;
+    for (int id : ids)
+    {
+        if (id != RemovedId)
+        {
+            minId = qMin(minId, id);
+            maxId = qMax(maxId, id);
+        }
+    }
+
+    // Only worth it when the array stays close to the number of stations
+    qint64 span = static_cast<qint64>(maxId) - minId + 1;
+    if (span > 4 * static_cast<qint64>(liveCount) + 1024)
+    {
+        return false;
+    }
+
+    lookup.fill(InvalidIndex, static_cast<int>(span));
+    for (int i = 0; i < ids.size(); i++)
+    {
+        if (ids[i] != RemovedId)
+        {
+            lookup[ids[i] - minId] = i;
+        }
+    }
+
+    return true;
+}
+
+// Approximate memory used by the table
+qint64 StationTable::memoryUsage() const
+{
+    qint64 bytes = 0;
+    bytes += ids.capacity() * static_cast<qint64>(sizeof(int));
+    bytes += xs.capacity() * static_cast<qint64>(sizeof(double));
+    bytes += ys.capacity() * static_cast<qint64>(sizeof(double));
+    bytes += nameOffsets.capacity() * static_cast<qint64>(sizeof(int));
+    bytes += nameLengths.capacity() * static_cast<qint64>(sizeof(int));
+    bytes += nameArena.capacity() * static_cast<qint64>(sizeof(QChar));
+    bytes += indexById.capacity() * static_cast<qint64>(2 * sizeof(int) + sizeof(void*));
+    bytes += freeSlots.capacity() * static_cast<qint64>(sizeof(int));
+    return bytes;
+}
+
@@ -0,0 +1,97 @@
+#pragma once
+
+#include "Station.h"
+#include <QString>
+#include <QStringView>
+#include <QVector>
+#include <QList>
+#include <QHash>
+#include <climits>
+
+using namespace std;
+
+// Central station storage shared by the graph, the BST, the visualizer and the reports.
+// Stations live in parallel columns (struct-of-arrays) addressed by a dense index;
+// all names are kept back to back in a single string arena.
+// Indices are stable: removing a station leaves a dead slot instead of shifting the columns,
+// and the next station added takes the most recently freed slot.
+class StationTable
+{
+private:
+    // Columns (one entry per slot)
+    QVector<int> ids;            // Station ID, RemovedId for dead slots
+    QVector<double> xs;          // Coordinate X for map positioning
+    QVector<double> ys;          // Coordinate Y for map positioning
+    QVector<int> nameOffsets;    // Start of the name inside the arena
+    QVector<int> nameLengths;    // Length of the name
+
+    QString nameArena;           // All station names stored once
+    QHash<int, int> indexById;   // Station ID -> slot index
+    QVector<int> freeSlots;      // Dead slots waiting to be reused (last freed at the back)
+    int liveCount;               // Slots that are not removed
+    int liveNameChars;           // Arena characters still used by live names
+
+    // Store a name in the arena and return its offset
+    int appendName(const QString& name);
+
+    // Copy the live names to a fresh arena once more than half of it is dead
+    void compactNamesIfSparse();
+
+public:
+    static const int InvalidIndex = -1;
+    static const int RemovedId = INT_MIN;
+
+    // Constructor
+    StationTable();
+
+    // Station management
+    int add(const Station& station);              // Returns the slot index (updates in place if the ID exists, reuses dead slots)
+    int add(int id, const QString& name, double x, double y);
+    bool remove(int id);
+    void clear();
+    void reserve(int stations, int nameChars = 0);
+
+    // Lookup
+    int indexOf(int id) const;
+    bool contains(int id) const;
+    bool isValidIndex(int index) const;
+
+    // Sizes
+    int size() const;         // Live stations
+    int slotCount() const;    // Upper bound for indices (includes removed slots)
+    bool isEmpty() const;
+
+    // Column access by index
+    int idAt(int index) const;
+    double xAt(int index) const;
+    double yAt(int index) const;
+    QStringView nameViewAt(int index) const;
+    QString nameAt(int index) const;
+    Station stationAt(int index) const;
+
+    // Column updates by index
+    void setNameAt(int index, const QString& name);
+    void setPositionAt(int index, double x, double y);
+
+    // Live indices in slot order
+    QList<int> indices() const;
+
+    // Raw columns (binary snapshots)
+    const QVector<int>& idColumn() const;
+    const QVector<double>& xColumn() const;
+    const QVector<double>& yColumn() const;
+    const QVector<int>& nameOffsetColumn() const;
+    const QVector<int>& nameLengthColumn() const;
+    const QString& nameArenaData() const;
+
+    // Replace the whole table with ready-made columns (all the same length; dead slots use RemovedId)
+    void assignColumns(QVector<int> idColumn, QVector<double> xColumn, QVector<double> yColumn,
+                       QVector<int> nameOffsetColumn, QVector<int> nameLengthColumn, QString arena);
+
+    // Dense ID -> index array (lookup[id - minId]) for bulk loads; false if the IDs are too sparse
+    bool makeDenseLookup(QVector<int>& lookup, int& minId) const;
+
+    // Approximate memory used by the columns and the arena, in bytes
+    qint64 memoryUsage() const;
+};
+
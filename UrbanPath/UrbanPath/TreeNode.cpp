@@ -1,13 +1,13 @@
 #include "TreeNode.h"
 
 // Default constructor
-TreeNode::TreeNode() : station(), left(nullptr), right(nullptr)
+TreeNode::TreeNode() : key(-1), index(-1), left(nullptr), right(nullptr)
 {
 }
 
 // Parameterized constructor
-TreeNode::TreeNode(const Station& station) 
-    : station(station), left(nullptr), right(nullptr)
+TreeNode::TreeNode(int key, int index) 
+    : key(key), index(index), left(nullptr), right(nullptr)
 {
 }
 
@@ -20,9 +20,14 @@ TreeNode::~TreeNode()
 }
 
 // Getters
-Station TreeNode::getStation() const
+int TreeNode::getKey() const
 {
-    return station;
+    return key;
+}
+
+int TreeNode::getIndex() const
+{
+    return index;
 }
 
 TreeNode* TreeNode::getLeft() const
@@ -36,9 +41,10 @@ TreeNode* TreeNode::getRight() const
 }
 
 // Setters
-void TreeNode::setStation(const Station& station)
+void TreeNode::setEntry(int key, int index)
 {
-    this->station = station;
+    this->key = key;
+    this->index = index;
 }
 
 void TreeNode::setLeft(TreeNode* left)
@@ -1,35 +1,35 @@
 #pragma once
 
-#include "Station.h"
-
 using namespace std;
 
+// BST node: holds the station ID used as key and the station's slot in the StationTable
 class TreeNode
 {
 private:
-    Station station;     // Station data stored in this node
+    int key;             // Station ID (ordering key)
+    int index;           // Station slot in the StationTable
     TreeNode* left;      // Pointer to left child
     TreeNode* right;     // Pointer to right child
 
 public:
     // Constructors
     TreeNode();
-    TreeNode(const Station& station);
+    TreeNode(int key, int index);
     
     // Destructor
     ~TreeNode();
     
     // Getters
-    Station getStation() const;
+    int getKey() const;
+    int getIndex() const;
     TreeNode* getLeft() const;
     TreeNode* getRight() const;
     
     // Setters
-    void setStation(const Station& station);
+    void setEntry(int key, int index);
     void setLeft(TreeNode* left);
     void setRight(TreeNode* right);
     
     // Utility
     bool isLeaf() const;  // Check if node is a leaf (no children)
 };
-
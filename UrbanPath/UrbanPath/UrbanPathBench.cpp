@@ -0,0 +1,749 @@
+#include "Graph.h"
+#include "StationBST.h"
+#include "FileManager.h"
+#include "NetworkAnalysis.h"
+#include "ReportGenerator.h"
+#include "RecordWriter.h"
+#include "NetworkGenerator.h"
+#include "LandmarkIndex.h"
+#include "HubLabelIndex.h"
+#include "Log.h"
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QCommandLineOption>
+#include <QDateTime>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QTextStream>
+#include <QThread>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <functional>
+
+#if defined(_WIN32)
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+// Benchmarks for the Graph algorithms (micro) and for loading and reports (macro).
+// Every network comes from NetworkGenerator with a fixed seed, so two builds run exactly
+// the same work; the results go to the console and, with --salida, to JSON Lines (or CSV)
+// files that can be compared between builds.
+
+// One measured case
+struct BenchResult
+{
+    qint64 medianNs = 0;
+    qint64 minNs = 0;
+    qint64 peakRssKb = 0;
+};
+
+// qDebug output is dropped (the algorithms and loaders log per station)
+static void messageHandler(QtMsgType type, const QMessageLogContext&, const QString& message)
+{
+    if (type != QtDebugMsg)
+    {
+        fprintf(stderr, "%s\n", qPrintable(message));
+    }
+}
+
+// Start a new peak RSS measurement (Linux resets the high-water mark; elsewhere it only grows)
+static void resetPeakRss()
+{
+#if defined(__linux__)
+    QFile clearRefs("/proc/self/clear_refs");
+    if (clearRefs.open(QIODevice::WriteOnly))
+    {
+        clearRefs.write("5");
+    }
+#endif
+}
+
+// Peak resident set size since the last reset, in KB
+static qint64 peakRssKb()
+{
+#if defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+    {
+        return static_cast<qint64>(counters.PeakWorkingSetSize / 1024);
+    }
+    return 0;
+#else
+#if defined(__linux__)
+    QFile status("/proc/self/status");
+    if (status.open(QIODevice::ReadOnly | QIODevice::Text))
+    {
+        for (QByteArray line = status.readLine(); !line.isEmpty(); line = status.readLine())
+        {
+            if (line.startsWith("VmHWM:"))
+            {
+                return line.mid(6).trimmed().split(' ').first().toLongLong();
+            }
+        }
+    }
+#endif
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+#if defined(__APPLE__)
+    return usage.ru_maxrss / 1024;
+#else
+    return usage.ru_maxrss;
+#endif
+#endif
+}
+
+// Run 'op' once to warm up, then 'repeats' times; 'op' gets the repetition number
+static BenchResult measure(int repeats, const function<void(int)>& op)
+{
+    resetPeakRss();
+    op(0);
+
+    QVector<qint64> samples;
+    samples.reserve(repeats);
+    QElapsedTimer timer;
+
+    for (int i = 0; i < repeats; i++)
+    {
+        timer.start();
+        op(i);
+        samples.append(timer.nsecsElapsed());
+    }
+
+    std::sort(samples.begin(), samples.end());
+
+    BenchResult result;
+    result.medianNs = samples[samples.size() / 2];
+    result.minNs = samples.first();
+    result.peakRssKb = peakRssKb();
+    return result;
+}
+
+// Parse a comma separated list of positive integers
+static QList<int> parseList(const QString& text)
+{
+    QList<int> values;
+    for (const QString& part : text.split(',', Qt::SkipEmptyParts))
+    {
+        int value = part.trimmed().toInt();
+        if (value > 0)
+        {
+            values.append(value);
+        }
+    }
+    return values;
+}
+
+// Bytes of a file (0 if it does not exist)
+static qint64 fileSize(const QString& path)
+{
+    return QFileInfo(path).size();
+}
+
+// Same distance as Dijkstra: both infinite, or equal up to the rounding of the sums
+static bool sameDistance(double distance, double expected)
+{
+    if (std::isinf(distance) || std::isinf(expected))
+    {
+        return distance == expected;
+    }
+    return std::fabs(distance - expected) <= 1e-9 * qMax(1.0, std::fabs(expected));
+}
+
+// Check the distances of an index against Dijkstra on some pairs; prints the first mismatch
+static int countWrongDistances(const Graph& graph, const QList<QPair<int, int>>& pairs, const QString& name,
+                               const std::function<double(int, int)>& query)
+{
+    QVector<double> dist;
+    QVector<int> pred;
+    int wrong = 0;
+
+    for (const auto& pair : pairs)
+    {
+        graph.shortestPathTree(pair.first, dist, pred);
+        double expected = dist[graph.indexOf(pair.second)];
+        double distance = query(pair.first, pair.second);
+
+        if (!sameDistance(distance, expected))
+        {
+            if (wrong == 0)
+            {
+                qCritical().noquote() << QString("Error: %1 da %2 entre %3 y %4; Dijkstra da %5.")
+                    .arg(name).arg(distance, 0, 'g', 17).arg(pair.first).arg(pair.second).arg(expected, 0, 'g', 17);
+            }
+            wrong++;
+        }
+    }
+    return wrong;
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    app.setApplicationName("urbanpath-bench");
+    app.setApplicationVersion("1.0");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Pruebas de rendimiento de los algoritmos, la carga y los reportes de UrbanPath.");
+    parser.addHelpOption();
+    parser.addVersionOption();
+
+    QCommandLineOption sizesOption("estaciones", "Tamanos de red, separados por comas.", "lista", "1000,10000,100000");
+    QCommandLineOption topologiesOption("topologias", "Topologias: cuadricula, radial, geometrica, libre_escala.",
+                                        "lista", "geometrica");
+    QCommandLineOption degreesOption("grados", "Grado medio de las estaciones, separados por comas.", "lista", "4,8");
+    QCommandLineOption seedOption("semilla", "Semilla de las redes generadas.", "n", "12345");
+    QCommandLineOption repeatsOption("repeticiones", "Repeticiones de cada caso (se informa la mediana).", "n", "7");
+    QCommandLineOption floydOption("limite-floyd", "Maximo de estaciones para Floyd-Warshall (O(n^3)).", "n", "800");
+    QCommandLineOption filterOption("solo", "Ejecutar solo estos algoritmos o secciones (alt, hubs, carga, reportes).", "lista");
+    QCommandLineOption outputOption({ "o", "salida" }, "Ruta base de los resultados (sin extension).", "ruta");
+    QCommandLineOption formatOption("formato", "Formato de los resultados: jsonl o csv.", "formato", "jsonl");
+    QCommandLineOption quickOption("rapido", "Redes pequenas y pocas repeticiones (comprobacion rapida).");
+    parser.addOption(sizesOption);
+    parser.addOption(topologiesOption);
+    parser.addOption(degreesOption);
+    parser.addOption(seedOption);
+    parser.addOption(repeatsOption);
+    parser.addOption(floydOption);
+    parser.addOption(filterOption);
+    parser.addOption(outputOption);
+    parser.addOption(formatOption);
+    parser.addOption(quickOption);
+    parser.process(app);
+
+    qInstallMessageHandler(messageHandler);
+    Log::setLevel(Log::Warning);   // Loads are measured without their debug messages
+
+    bool quick = parser.isSet(quickOption);
+    QList<int> sizes = parseList(quick ? QString("500,2000") : parser.value(sizesOption));
+    QList<int> degrees = parseList(parser.value(degreesOption));
+    quint32 seed = parser.value(seedOption).toUInt();
+
+    QList<NetworkGenerator::Topology> topologies;
+    for (const QString& name : parser.value(topologiesOption).split(',', Qt::SkipEmptyParts))
+    {
+        NetworkGenerator::Topology topology;
+        if (!NetworkGenerator::parseTopology(name, topology))
+        {
+            qCritical().noquote() << "Error: Topologia desconocida" << name;
+            return 2;
+        }
+        topologies.append(topology);
+    }
+    if (topologies.isEmpty() || sizes.isEmpty() || degrees.isEmpty())
+    {
+        qCritical().noquote() << "Error: Se necesita al menos una topologia, un tamano y un grado.";
+        return 2;
+    }
+    int repeats = qMax(1, quick ? 3 : parser.value(repeatsOption).toInt());
+    int floydLimit = parser.value(floydOption).toInt();
+    QStringList only = parser.value(filterOption).split(',', Qt::SkipEmptyParts);
+
+    auto selected = [&only](const QString& name) { return only.isEmpty() || only.contains(name); };
+
+    // Indexes that answer differently from Dijkstra fail the run (their timings mean nothing)
+    int wrongDistances = 0;
+
+    // Results: console table plus the optional machine-readable file
+    QTextStream console(stdout);
+    RecordWriter::Format format = parser.value(formatOption) == "csv" ? RecordWriter::Csv : RecordWriter::JsonLines;
+    RecordWriter records(format);
+    bool recording = parser.isSet(outputOption);
+
+    if (recording && !records.open(parser.value(outputOption)))
+    {
+        return 2;
+    }
+
+    if (recording)
+    {
+        records.beginTable("entorno", {
+            { "fecha", RecordWriter::Text }, { "qt", RecordWriter::Text }, { "compilador", RecordWriter::Text },
+            { "hilos", RecordWriter::Integer }, { "semilla", RecordWriter::Integer },
+            { "repeticiones", RecordWriter::Integer } });
+#if defined(_MSC_VER)
+        QString compiler = QString("MSVC %1").arg(_MSC_VER);
+#elif defined(__clang__)
+        QString compiler = QString("Clang %1.%2").arg(__clang_major__).arg(__clang_minor__);
+#elif defined(__GNUC__)
+        QString compiler = QString("GCC %1.%2").arg(__GNUC__).arg(__GNUC_MINOR__);
+#else
+        QString compiler = "desconocido";
+#endif
+        records << QDateTime::currentDateTime().toString(Qt::ISODate) << QT_VERSION_STR << compiler
+                << QThread::idealThreadCount() << static_cast<qint64>(seed) << repeats;
+        records.endRow();
+    }
+
+    // Micro benchmarks: one row per algorithm, topology, variant, size and degree
+    QStringList algorithms = { "bfs", "dfs", "dijkstra", "dijkstraWithPath", "floydWarshall", "primMST", "kruskalMST" };
+    QStringList variants = { "base", "cierres", "accidentes" };
+
+    if (recording)
+    {
+        records.beginTable("algoritmos", {
+            { "algoritmo", RecordWriter::Text }, { "topologia", RecordWriter::Text },
+            { "variante", RecordWriter::Text },
+            { "estaciones", RecordWriter::Integer }, { "grado", RecordWriter::Integer },
+            { "rutas", RecordWriter::Integer }, { "ns_op", RecordWriter::Integer },
+            { "ns_min", RecordWriter::Integer }, { "rutas_s", RecordWriter::Real },
+            { "pico_rss_kb", RecordWriter::Integer } });
+    }
+
+    console << QString("%1 %2 %3 %4 %5 %6 %7 %8\n")
+        .arg("algoritmo", -18).arg("topologia", -13).arg("variante", -11).arg("estaciones", 10).arg("grado", 6)
+        .arg("ns/op", 14).arg("rutas/s", 14).arg("pico RSS KB", 12);
+
+    Graph graph;
+    StationBST bst(&graph.getStationTable());
+    NetworkGenerator generator;
+
+    // Network of one case (closure- and accident-heavy variants differ only in their incidents)
+    auto buildNetwork = [&](NetworkGenerator::Topology topology, int stations, int degree, const QString& variant)
+    {
+        NetworkGenerator::Options options;
+        options.topology = topology;
+        options.stations = stations;
+        options.degree = degree;
+        options.seed = seed + stations + degree;
+        if (variant == "cierres")
+        {
+            options.closedStations = 0.10;
+            options.closedRoutes = 0.10;
+        }
+        else if (variant == "accidentes")
+        {
+            options.accidentRoutes = 0.25;
+        }
+
+        generator.generate(options);
+        generator.buildGraph(graph, bst);
+    };
+
+    for (NetworkGenerator::Topology topology : topologies)
+    {
+        QString topologyName = NetworkGenerator::topologyName(topology);
+        for (int stations : sizes)
+        {
+            for (int degree : degrees)
+            {
+                for (const QString& variant : variants)
+                {
+                    buildNetwork(topology, stations, degree, variant);
+
+                    // Directed entries / 2 = routes
+                    qint64 routes = 0;
+                    for (int index : graph.getStationTable().indices())
+                    {
+                        routes += graph.neighborsAt(index).size();
+                    }
+                    routes /= 2;
+
+                    // Traversals and Dijkstra start from a different station each repetition
+                    QList<int> ids = graph.getStationTable().indices();
+                    auto source = [&graph, &ids, seed](int repetition)
+                    {
+                        return graph.getStationTable().idAt(ids[(seed + repetition * 7919u) % ids.size()]);
+                    };
+
+                    for (const QString& algorithm : algorithms)
+                    {
+                        if (!selected(algorithm) || (algorithm == "floydWarshall" && stations > floydLimit))
+                        {
+                            continue;
+                        }
+
+                        int count = 0;
+                        BenchResult result = measure(repeats, [&](int repetition) {
+                            if (algorithm == "bfs")
+                            {
+                                count += graph.bfs(source(repetition)).size();
+                            }
+                            else if (algorithm == "dfs")
+                            {
+                                count += graph.dfs(source(repetition)).size();
+                            }
+                            else if (algorithm == "dijkstra")
+                            {
+                                count += graph.dijkstra(source(repetition)).size();
+                            }
+                            else if (algorithm == "dijkstraWithPath")
+                            {
+                                count += graph.dijkstraWithPath(source(repetition)).first.size();
+                            }
+                            else if (algorithm == "floydWarshall")
+                            {
+                                count += graph.floydWarshall().size();
+                            }
+                            else if (algorithm == "primMST")
+                            {
+                                count += graph.primMST().size();
+                            }
+                            else
+                            {
+                                count += graph.kruskalMST().size();
+                            }
+                        });
+
+                        double routesPerSecond = result.medianNs > 0 ? routes * 1e9 / result.medianNs : 0.0;
+
+                        console << QString("%1 %2 %3 %4 %5 %6 %7 %8\n")
+                            .arg(algorithm, -18).arg(topologyName, -13).arg(variant, -11).arg(stations, 10).arg(degree, 6)
+                            .arg(result.medianNs, 14).arg(routesPerSecond, 14, 'e', 3).arg(result.peakRssKb, 12);
+                        console.flush();
+
+                        if (recording)
+                        {
+                            records << algorithm << topologyName << variant << stations << degree << routes
+                                    << result.medianNs << result.minNs << routesPerSecond << result.peakRssKb;
+                            records.endRow();
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    // Macro benchmarks work on files in a temporary directory
+    QDir workDir(QDir::tempPath() + QString("/urbanpath-bench-%1").arg(QCoreApplication::applicationPid()));
+    workDir.mkpath(".");
+    int degree = degrees.first();
+
+    // ALT: landmark tables per selection and precision, point-to-point queries against Dijkstra
+    if (selected("alt"))
+    {
+        if (recording)
+        {
+            records.beginTable("alt", {
+                { "seleccion", RecordWriter::Text }, { "bits", RecordWriter::Integer },
+                { "estaciones", RecordWriter::Integer }, { "referencias", RecordWriter::Integer },
+                { "ms_construccion", RecordWriter::Integer }, { "bytes_tablas", RecordWriter::Integer },
+                { "ns_consulta", RecordWriter::Integer }, { "ns_dijkstra", RecordWriter::Integer } });
+        }
+
+        console << QString("\n%1 %2 %3 %4 %5 %6 %7\n")
+            .arg("alt", -18).arg("bits", 6).arg("estaciones", 10).arg("ms constr.", 12).arg("KB tablas", 10)
+            .arg("ns/consulta", 14).arg("ns/Dijkstra", 14);
+
+        const int pairCount = 64;
+        QList<QPair<LandmarkIndex::Selection, LandmarkIndex::Precision>> configurations = {
+            { LandmarkIndex::Farthest, LandmarkIndex::Bits16 }, { LandmarkIndex::Avoid, LandmarkIndex::Bits16 },
+            { LandmarkIndex::Avoid, LandmarkIndex::Bits32 } };
+
+        for (int stations : sizes)
+        {
+            buildNetwork(topologies.first(), stations, degree, "base");
+
+            // The same origin/destination pairs for every configuration
+            QList<int> ids;
+            for (int index : graph.getStationTable().indices())
+            {
+                ids.append(graph.getStationTable().idAt(index));
+            }
+            QList<QPair<int, int>> pairs;
+            for (int i = 0; i < pairCount; i++)
+            {
+                pairs.append(qMakePair(ids[(seed + i * 7919u) % ids.size()], ids[(seed + i * 104729u + 1) % ids.size()]));
+            }
+
+            // Dijkstra answers a pair with the whole tree of the origin
+            QVector<double> dist;
+            QVector<int> pred;
+            BenchResult baseline = measure(repeats, [&](int) {
+                for (const auto& pair : pairs)
+                {
+                    graph.shortestPathTree(pair.first, dist, pred);
+                }
+            });
+
+            for (const auto& configuration : configurations)
+            {
+                LandmarkIndex index;
+                index.build(graph, LandmarkIndex::DefaultLandmarks, configuration.first, configuration.second);
+
+                QList<int> route;
+                double distance = 0.0;
+                wrongDistances += countWrongDistances(graph, pairs, "ALT " + LandmarkIndex::selectionName(configuration.first),
+                                                      [&](int origin, int dest) {
+                    index.findPath(graph, origin, dest, route, distance);
+                    return distance;
+                });
+
+                BenchResult result = measure(repeats, [&](int) {
+                    for (const auto& pair : pairs)
+                    {
+                        index.findPath(graph, pair.first, pair.second, route, distance);
+                    }
+                });
+
+                int bits = (configuration.second == LandmarkIndex::Bits16) ? 16 : 32;
+                QString name = LandmarkIndex::selectionName(configuration.first);
+                qint64 queryNs = result.medianNs / pairCount;
+                qint64 dijkstraNs = baseline.medianNs / pairCount;
+
+                console << QString("%1 %2 %3 %4 %5 %6 %7\n")
+                    .arg(name, -18).arg(bits, 6).arg(stations, 10).arg(index.getBuildMs(), 12)
+                    .arg(index.getTableBytes() / 1024, 10).arg(queryNs, 14).arg(dijkstraNs, 14);
+                console.flush();
+
+                if (recording)
+                {
+                    records << name << bits << stations << index.getLandmarkCount() << index.getBuildMs()
+                            << index.getTableBytes() << queryNs << dijkstraNs;
+                    records.endRow();
+                }
+            }
+        }
+    }
+
+    // Hub labels: construction, label size per station, file size and distance queries against Dijkstra
+    if (selected("hubs"))
+    {
+        if (recording)
+        {
+            records.beginTable("hubs", {
+                { "estaciones", RecordWriter::Integer }, { "ms_construccion", RecordWriter::Integer },
+                { "entradas_estacion", RecordWriter::Real }, { "bytes_estacion", RecordWriter::Real },
+                { "bytes_archivo", RecordWriter::Integer }, { "ms_carga", RecordWriter::Real },
+                { "ns_consulta", RecordWriter::Integer }, { "ns_dijkstra", RecordWriter::Integer } });
+        }
+
+        console << QString("\n%1 %2 %3 %4 %5 %6 %7\n")
+            .arg("hubs", -18).arg("estaciones", 10).arg("ms constr.", 12).arg("entr./est.", 10).arg("KB archivo", 10)
+            .arg("ns/consulta", 14).arg("ns/Dijkstra", 14);
+
+        const int pairCount = 1024;
+
+        for (int stations : sizes)
+        {
+            buildNetwork(topologies.first(), stations, degree, "base");
+
+            QList<int> ids;
+            for (int index : graph.getStationTable().indices())
+            {
+                ids.append(graph.getStationTable().idAt(index));
+            }
+            QList<QPair<int, int>> pairs;
+            for (int i = 0; i < pairCount; i++)
+            {
+                pairs.append(qMakePair(ids[(seed + i * 7919u) % ids.size()], ids[(seed + i * 104729u + 1) % ids.size()]));
+            }
+
+            HubLabelIndex index;
+            index.build(graph);
+
+            // Round trip through the file the pricing service would load at startup
+            QString labelsFile = workDir.filePath("red.uphubs");
+            FileManager files;
+            files.saveHubLabels(labelsFile, index);
+            BenchResult load = measure(repeats, [&](int) {
+                files.loadHubLabels(labelsFile, graph, index);
+            });
+
+            double distance = 0.0;
+            double checksum = 0.0;
+            BenchResult result = measure(repeats, [&](int) {
+                for (const auto& pair : pairs)
+                {
+                    index.distance(graph, pair.first, pair.second, distance);
+                    checksum += distance;
+                }
+            });
+
+            // Dijkstra answers a pair with the whole tree of the origin (a sample of the pairs)
+            const int dijkstraPairs = 32;
+            wrongDistances += countWrongDistances(graph, pairs.mid(0, dijkstraPairs), "Etiquetas de hubs",
+                                                  [&](int origin, int dest) {
+                index.distance(graph, origin, dest, distance);
+                return distance;
+            });
+
+            QVector<double> dist;
+            QVector<int> pred;
+            BenchResult baseline = measure(repeats, [&](int) {
+                for (int i = 0; i < dijkstraPairs; i++)
+                {
+                    graph.shortestPathTree(pairs[i].first, dist, pred);
+                }
+            });
+
+            int live = qMax(1, index.getStationCount());
+            double entriesPerStation = static_cast<double>(index.getEntryCount()) / live;
+            double bytesPerStation = static_cast<double>(index.getLabelBytes()) / live;
+            qint64 labelsBytes = fileSize(labelsFile);
+            qint64 queryNs = result.medianNs / pairCount;
+            qint64 dijkstraNs = baseline.medianNs / dijkstraPairs;
+
+            console << QString("%1 %2 %3 %4 %5 %6 %7\n")
+                .arg("", -18).arg(stations, 10).arg(index.getBuildMs(), 12).arg(entriesPerStation, 10, 'f', 1)
+                .arg(labelsBytes / 1024, 10).arg(queryNs, 14).arg(dijkstraNs, 14);
+            console.flush();
+
+            if (recording)
+            {
+                records << stations << index.getBuildMs() << entriesPerStation << bytesPerStation << labelsBytes
+                        << load.medianNs / 1e6 << queryNs << dijkstraNs;
+                records.endRow();
+            }
+        }
+    }
+
+    // Loading: text (classic and mapped with 1..N parse threads) against the binary snapshot
+    if (selected("carga"))
+    {
+        if (recording)
+        {
+            records.beginTable("carga", {
+                { "modo", RecordWriter::Text }, { "hilos", RecordWriter::Integer },
+                { "estaciones", RecordWriter::Integer }, { "bytes", RecordWriter::Integer },
+                { "ms", RecordWriter::Real }, { "mb_s", RecordWriter::Real },
+                { "pico_rss_kb", RecordWriter::Integer } });
+        }
+
+        console << QString("\n%1 %2 %3 %4 %5\n")
+            .arg("carga", -18).arg("hilos", 6).arg("estaciones", 10).arg("ms", 12).arg("MB/s", 10);
+
+        QList<int> threadCounts = { 1 };
+        for (int threads = 2; threads <= QThread::idealThreadCount(); threads *= 2)
+        {
+            threadCounts.append(threads);
+        }
+
+        for (int stations : sizes)
+        {
+            QString stationsFile = workDir.filePath("estaciones.txt");
+            QString routesFile = workDir.filePath("rutas.txt");
+            QString snapshotFile = workDir.filePath("red.upsnap");
+
+            FileManager writer;
+            buildNetwork(topologies.first(), stations, degree, "base");
+            writer.saveStations(stationsFile, bst);
+            writer.saveRoutes(routesFile, graph);
+            writer.saveSnapshot(snapshotFile, graph);
+
+            qint64 textBytes = fileSize(stationsFile) + fileSize(routesFile);
+
+            // Mode name, parse threads (0 = not applicable), bytes read, loader
+            auto runLoad = [&](const QString& mode, int threads, qint64 bytes, const function<void(FileManager&)>& load)
+            {
+                BenchResult result = measure(repeats, [&](int) {
+                    FileManager loader;
+                    loader.setFastLoading(mode != "texto");
+                    loader.setParseThreads(threads);
+                    graph.clear();
+                    bst.clear();
+                    load(loader);
+                });
+
+                double ms = result.medianNs / 1e6;
+                double mbPerSecond = ms > 0.0 ? (bytes / 1048576.0) / (ms / 1000.0) : 0.0;
+
+                console << QString("%1 %2 %3 %4 %5\n")
+                    .arg(mode, -18).arg(threads, 6).arg(stations, 10).arg(ms, 12, 'f', 2).arg(mbPerSecond, 10, 'f', 1);
+                console.flush();
+
+                if (recording)
+                {
+                    records << mode << threads << stations << bytes << ms << mbPerSecond << result.peakRssKb;
+                    records.endRow();
+                }
+            };
+
+            auto loadText = [&](FileManager& loader) {
+                loader.loadStations(stationsFile, bst, graph);
+                loader.loadRoutes(routesFile, graph);
+            };
+
+            runLoad("texto", 0, textBytes, loadText);
+            for (int threads : threadCounts)
+            {
+                runLoad("texto_mapeado", threads, textBytes, loadText);
+            }
+            runLoad("instantanea", 0, fileSize(snapshotFile), [&](FileManager& loader) {
+                loader.loadSnapshot(snapshotFile, bst, graph);
+            });
+        }
+    }
+
+    // Reports: shared analysis plus the five system reports, in every output format
+    if (selected("reportes"))
+    {
+        if (recording)
+        {
+            records.beginTable("reportes", {
+                { "formato", RecordWriter::Text }, { "estaciones", RecordWriter::Integer },
+                { "bytes", RecordWriter::Integer }, { "ms", RecordWriter::Real },
+                { "mb_s", RecordWriter::Real }, { "pico_rss_kb", RecordWriter::Integer } });
+        }
+
+        console << QString("\n%1 %2 %3 %4\n").arg("reportes", -18).arg("estaciones", 10).arg("ms", 12).arg("MB/s", 10);
+
+        QList<QPair<QString, ReportGenerator::OutputFormat>> formats = {
+            { "texto", ReportGenerator::Text }, { "jsonl", ReportGenerator::JsonLines },
+            { "csv", ReportGenerator::Csv }, { "columnar", ReportGenerator::Columnar } };
+
+        for (int stations : sizes)
+        {
+            buildNetwork(topologies.first(), stations, degree, "base");
+
+            for (const auto& format : formats)
+            {
+                QDir reportDir(workDir.filePath("reportes_" + format.first));
+                reportDir.mkpath(".");
+
+                BenchResult result = measure(repeats, [&](int) {
+                    NetworkAnalysis analysis(graph);
+                    analysis.captureTraversals(bst);
+                    analysis.compute(NetworkAnalysis::All);
+
+                    ReportGenerator generator;
+                    generator.setOutputFormat(format.second);
+                    generator.generateSystemStats(reportDir.filePath("reporte_estadisticas.txt"), analysis);
+                    generator.generateMSTReport(reportDir.filePath("reporte_mst.txt"), analysis);
+                    generator.generateConnectivityReport(reportDir.filePath("reporte_conectividad.txt"), analysis);
+                    generator.generateTraversalReport(reportDir.filePath("reporte_recorridos.txt"), analysis);
+                    generator.generateAccidentReport(reportDir.filePath("reporte_accidentes.txt"), analysis);
+                });
+
+                // Each format writes to its own directory (CSV writes one file per table)
+                qint64 bytes = 0;
+                for (const QFileInfo& info : reportDir.entryInfoList(QDir::Files))
+                {
+                    bytes += info.size();
+                }
+
+                double ms = result.medianNs / 1e6;
+                double mbPerSecond = ms > 0.0 ? (bytes / 1048576.0) / (ms / 1000.0) : 0.0;
+
+                console << QString("%1 %2 %3 %4\n")
+                    .arg(format.first, -18).arg(stations, 10).arg(ms, 12, 'f', 2).arg(mbPerSecond, 10, 'f', 1);
+                console.flush();
+
+                if (recording)
+                {
+                    records << format.first << stations << bytes << ms << mbPerSecond << result.peakRssKb;
+                    records.endRow();
+                }
+            }
+        }
+    }
+
+    workDir.removeRecursively();
+
+    if (recording && !records.close())
+    {
+        return 2;
+    }
+    if (wrongDistances > 0)
+    {
+        qCritical().noquote() << QString("Error: %1 distancias no coinciden con Dijkstra.").arg(wrongDistances);
+        return 1;
+    }
+    return 0;
+}
+
@@ -0,0 +1,194 @@
+#include "BatchRouter.h"
+#include "FileManager.h"
+#include "Graph.h"
+#include "Log.h"
+#include "Metrics.h"
+#include "StationBST.h"
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QCommandLineOption>
+#include <QFile>
+#include <QTextStream>
+#include <QDebug>
+#include <cstdio>
+
+// qDebug output is only shown with --verbose (errors and warnings always are)
+static bool verboseOutput = false;
+
+static void messageHandler(QtMsgType type, const QMessageLogContext&, const QString& message)
+{
+    if (type == QtDebugMsg && !verboseOutput)
+    {
+        return;
+    }
+    fprintf(stderr, "%s\n", qPrintable(message));
+}
+
+// Load the network the same way the GUI does: binary snapshot if it is current,
+// otherwise the text files (stations, routes, closures, accidents)
+static bool loadNetwork(FileManager& fileManager, const QString& directory, StationBST& bst, Graph& graph)
+{
+    QString stationsFile = directory + "/estaciones.txt";
+    QString routesFile = directory + "/rutas.txt";
+    QString closuresFile = directory + "/cierres.txt";
+    QString accidentsFile = directory + "/accidentes.txt";
+
+    QString snapshotFile = fileManager.snapshotPathFor(stationsFile);
+    QStringList sourceFiles = { stationsFile, routesFile, closuresFile, accidentsFile };
+
+    if (fileManager.isSnapshotCurrent(snapshotFile, sourceFiles))
+    {
+        if (fileManager.loadSnapshot(snapshotFile, bst, graph))
+        {
+            return true;
+        }
+        qWarning().noquote() << "Advertencia:" << fileManager.getLastError() << "Se usaran los archivos de texto.";
+        graph.clear();
+        bst.clear();
+    }
+
+    if (!fileManager.loadStations(stationsFile, bst, graph))
+    {
+        QString error = fileManager.getLastError();
+        qCritical().noquote() << "Error:" << (error.isEmpty() ? QString("No se pudo cargar %1.").arg(stationsFile) : error);
+        return false;
+    }
+
+    if (!fileManager.loadRoutes(routesFile, graph) && !fileManager.getLastError().isEmpty())
+    {
+        qWarning().noquote() << "Advertencia:" << fileManager.getLastError();
+    }
+    if (fileManager.fileExists(closuresFile))
+    {
+        fileManager.loadClosures(closuresFile, graph);
+    }
+    if (fileManager.fileExists(accidentsFile))
+    {
+        fileManager.loadAccidents(graph, accidentsFile);
+    }
+
+    return true;
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    app.setApplicationName("urbanpath-cli");
+    app.setApplicationVersion("1.0");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(
+        "Responde consultas de rutas sobre la red de UrbanPath, una por linea:\n"
+        "  ruta <origen> <destino>   camino mas corto (Dijkstra)\n"
+        "  distancia <a> <b>         solo la distancia (etiquetas de hubs)\n"
+        "  bfs <origen>              recorrido en anchura\n"
+        "  dfs <origen>              recorrido en profundidad\n"
+        "  mst [kruskal|prim]        arbol de expansion minima\n"
+        "  conectado <a> <b>         si b es alcanzable desde a\n"
+        "  componentes               componentes conexas\n"
+        "Cada respuesta es la consulta, un tabulador y el resultado.");
+    parser.addHelpOption();
+    parser.addVersionOption();
+    parser.addPositionalArgument("consultas", "Archivo de consultas (stdin si se omite o es '-').");
+
+    QCommandLineOption dataOption({ "d", "datos" }, "Directorio con estaciones.txt, rutas.txt, cierres.txt y accidentes.txt.",
+                                  "directorio", "data/datos");
+    QCommandLineOption outputOption({ "o", "salida" }, "Archivo de respuestas (stdout por defecto).", "archivo");
+    QCommandLineOption threadsOption({ "j", "hilos" }, "Hilos de trabajo (0 = uno por nucleo).", "n", "0");
+    QCommandLineOption blockOption("bloque", "Consultas leidas por bloque.", "n", "4096");
+    QCommandLineOption verboseOption({ "v", "verbose" }, "Mostrar los mensajes de carga.");
+    QCommandLineOption altOption("alt", "Responder las rutas con A* y n puntos de referencia (0 = solo Dijkstra).",
+                                 "n", "0");
+    QCommandLineOption metricsOption("metricas", "Al terminar, escribir en stderr las metricas de los algoritmos "
+                                     "(tabla o prometheus).", "formato");
+    parser.addOption(dataOption);
+    parser.addOption(outputOption);
+    parser.addOption(threadsOption);
+    parser.addOption(blockOption);
+    parser.addOption(verboseOption);
+    parser.addOption(altOption);
+    parser.addOption(metricsOption);
+    parser.process(app);
+
+    QString metricsFormat = parser.value(metricsOption);
+    if (parser.isSet(metricsOption) && metricsFormat != "tabla" && metricsFormat != "prometheus")
+    {
+        qCritical().noquote() << "Error: Formato de metricas desconocido" << metricsFormat;
+        return 2;
+    }
+
+    verboseOutput = parser.isSet(verboseOption);
+    qInstallMessageHandler(messageHandler);
+    Log::setLevel(verboseOutput ? Log::Debug : Log::Warning);
+
+    // Load the network
+    FileManager fileManager;
+    Graph graph;
+    StationBST bst(&graph.getStationTable());
+
+    if (!loadNetwork(fileManager, parser.value(dataOption), bst, graph))
+    {
+        return 2;
+    }
+    qDebug() << "Red cargada:" << graph.getStationCount() << "estaciones.";
+
+    // Open input and output
+    QFile inputFile;
+    QStringList positional = parser.positionalArguments();
+    if (positional.isEmpty() || positional.first() == "-")
+    {
+        inputFile.open(stdin, QIODevice::ReadOnly | QIODevice::Text);
+    }
+    else
+    {
+        inputFile.setFileName(positional.first());
+        if (!inputFile.open(QIODevice::ReadOnly | QIODevice::Text))
+        {
+            qCritical().noquote() << "Error: No se pudo abrir el archivo de consultas" << positional.first();
+            return 2;
+        }
+    }
+
+    QFile outputFile;
+    if (parser.isSet(outputOption))
+    {
+        outputFile.setFileName(parser.value(outputOption));
+        if (!outputFile.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text))
+        {
+            qCritical().noquote() << "Error: No se pudo crear el archivo" << parser.value(outputOption);
+            return 2;
+        }
+    }
+    else
+    {
+        outputFile.open(stdout, QIODevice::WriteOnly);
+    }
+
+    QTextStream in(&inputFile);
+    QTextStream out(&outputFile);
+
+    // Answer the queries
+    BatchRouter router(graph);
+    router.setMaxThreads(parser.value(threadsOption).toInt());
+    router.setBlockSize(parser.value(blockOption).toInt());
+    router.setLandmarks(parser.value(altOption).toInt());
+    router.setHubLabelsFile(fileManager.hubLabelsPathFor(parser.value(dataOption) + "/estaciones.txt"));
+
+    qint64 answered = router.run(in, out);
+    out.flush();
+
+    qDebug() << "Consultas respondidas:" << answered << "en" << router.getElapsedMs() << "ms,"
+             << router.getErrorCount() << "con error.";
+
+    // Loading and queries, per algorithm
+    if (parser.isSet(metricsOption))
+    {
+        Log::flush();
+        Metrics::Snapshot snapshot = Metrics::snapshot();
+        QString text = (metricsFormat == "prometheus") ? Metrics::formatPrometheus(snapshot) : Metrics::formatTable(snapshot);
+        fprintf(stderr, "%s", qPrintable(text));
+    }
+
+    return router.getErrorCount() > 0 ? 1 : 0;
+}
+
@@ -0,0 +1,124 @@
+#include "NetworkGenerator.h"
+#include "Log.h"
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QCommandLineOption>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QTextStream>
+#include <QDebug>
+#include <cstdio>
+
+// qDebug output is only shown with --verbose (errors and warnings always are)
+static bool verboseOutput = false;
+
+static void messageHandler(QtMsgType type, const QMessageLogContext&, const QString& message)
+{
+    if (type == QtDebugMsg && !verboseOutput)
+    {
+        return;
+    }
+    fprintf(stderr, "%s\n", qPrintable(message));
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    app.setApplicationName("urbanpath-gen");
+    app.setApplicationVersion("1.0");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(
+        "Genera redes sinteticas de UrbanPath (estaciones.txt, rutas.txt, cierres.txt,\n"
+        "accidentes.txt y, opcionalmente, la instantanea binaria red.upsnap).");
+    parser.addHelpOption();
+    parser.addVersionOption();
+    parser.addPositionalArgument("directorio", "Directorio de salida.");
+
+    QCommandLineOption topologyOption({ "t", "topologia" }, "cuadricula, radial, geometrica o libre_escala.",
+                                      "nombre", "geometrica");
+    QCommandLineOption stationsOption({ "n", "estaciones" }, "Numero de estaciones (acepta 1e6).", "n", "1000");
+    QCommandLineOption degreeOption({ "g", "grado" }, "Grado medio de las estaciones.", "n", "4");
+    QCommandLineOption seedOption("semilla", "Semilla.", "n", "12345");
+    QCommandLineOption widthOption("ancho", "Ancho del area del mapa.", "valor", "1032");
+    QCommandLineOption heightOption("alto", "Alto del area del mapa.", "valor", "676");
+    QCommandLineOption closedStationsOption("cierres-estaciones", "Fraccion de estaciones cerradas (0-1).", "f", "0");
+    QCommandLineOption closedRoutesOption("cierres-rutas", "Fraccion de rutas cerradas (0-1).", "f", "0");
+    QCommandLineOption accidentsOption("accidentes", "Fraccion de rutas con accidente (0-1).", "f", "0");
+    QCommandLineOption binaryOption({ "b", "binario" }, "Escribir tambien la instantanea binaria.");
+    QCommandLineOption binaryOnlyOption("solo-binario", "Escribir solo la instantanea binaria.");
+    QCommandLineOption verboseOption({ "v", "verbose" }, "Mostrar los mensajes de depuracion.");
+    for (const QCommandLineOption& option : { topologyOption, stationsOption, degreeOption, seedOption, widthOption,
+                                              heightOption, closedStationsOption, closedRoutesOption, accidentsOption,
+                                              binaryOption, binaryOnlyOption, verboseOption })
+    {
+        parser.addOption(option);
+    }
+    parser.process(app);
+
+    verboseOutput = parser.isSet(verboseOption);
+    qInstallMessageHandler(messageHandler);
+    Log::setLevel(verboseOutput ? Log::Debug : Log::Warning);
+
+    if (parser.positionalArguments().size() != 1)
+    {
+        parser.showHelp(2);
+    }
+    QString directory = parser.positionalArguments().first();
+
+    NetworkGenerator::Options options;
+    if (!NetworkGenerator::parseTopology(parser.value(topologyOption), options.topology))
+    {
+        qCritical().noquote() << "Error: Topologia desconocida" << parser.value(topologyOption);
+        return 2;
+    }
+    options.stations = static_cast<int>(parser.value(stationsOption).toDouble());
+    options.degree = parser.value(degreeOption).toInt();
+    options.seed = parser.value(seedOption).toUInt();
+    options.width = parser.value(widthOption).toDouble();
+    options.height = parser.value(heightOption).toDouble();
+    options.closedStations = parser.value(closedStationsOption).toDouble();
+    options.closedRoutes = parser.value(closedRoutesOption).toDouble();
+    options.accidentRoutes = parser.value(accidentsOption).toDouble();
+
+    QTextStream console(stdout);
+    QElapsedTimer timer;
+    timer.start();
+
+    NetworkGenerator generator;
+    if (!generator.generate(options))
+    {
+        qCritical().noquote() << "Error:" << generator.getLastError();
+        return 2;
+    }
+    console << QString("Red %1: %2 estaciones, %3 rutas, %4 estaciones y %5 rutas cerradas, %6 accidentes (%7 ms)\n")
+        .arg(NetworkGenerator::topologyName(options.topology)).arg(generator.getStationCount())
+        .arg(generator.getRouteCount()).arg(generator.getClosedStationCount())
+        .arg(generator.getClosedRouteCount()).arg(generator.getAccidentCount()).arg(timer.restart());
+
+    if (!parser.isSet(binaryOnlyOption))
+    {
+        if (!generator.writeText(directory))
+        {
+            qCritical().noquote() << "Error:" << generator.getLastError();
+            return 1;
+        }
+        console << QString("Archivos de texto escritos en %1 (%2 ms)\n").arg(directory).arg(timer.restart());
+    }
+
+    if (parser.isSet(binaryOption) || parser.isSet(binaryOnlyOption))
+    {
+        // Same name and place the GUI and the CLI look for (next to estaciones.txt)
+        QDir(directory).mkpath(".");
+        QString snapshotFile = QDir(directory).filePath("red.upsnap");
+        if (!generator.writeSnapshot(snapshotFile))
+        {
+            qCritical().noquote() << "Error:" << generator.getLastError();
+            return 1;
+        }
+        console << QString("Instantanea escrita en %1 (%2 ms)\n").arg(snapshotFile).arg(timer.restart());
+    }
+
+    return 0;
+}
+